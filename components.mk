@@ -15,6 +15,11 @@ COMPONENTS_DEPENDENCIES = host-autoconf host-automake host-libtool liburing log4
 
 # 确保 log4cplus 生成静态库（在 Buildroot 中通过环境变量传递）
 # Buildroot 会自动处理，但我们需要确保链接时使用静态库
+# 可选：lz4（解码帧缓存按帧压缩）
+ifeq ($(BR2_PACKAGE_LZ4),y)
+COMPONENTS_DEPENDENCIES += lz4
+endif
+
 ifeq ($(BR2_ENABLE_DEBUG),y)
 COMPONENTS_CONF_OPTS += --enable-debug
 endif
@@ -47,6 +47,7 @@ public:
     enum class AllocatorType {
         AUTO,           // 自动选择（默认使用 NormalAllocator）
         NORMAL,         // NormalAllocator（普通内存分配）
+        PAGE_ALIGNED,   // NormalAllocator（4096字节对齐，用于 O_DIRECT 读取）
         AVFRAME,        // AVFrameAllocator（FFmpeg AVFrame包装）
         FRAMEBUFFER     // FramebufferAllocator（Framebuffer内存包装）
     };
@@ -61,6 +62,7 @@ public:
      * 
      * 配置策略（工厂内部决定）：
      * - NORMAL: NORMAL_MALLOC + 64字节对齐
+     * - PAGE_ALIGNED: NORMAL_MALLOC + 4096字节对齐
      * - AVFRAME: AVFrameAllocator默认配置
      * - FRAMEBUFFER: FramebufferAllocator默认配置
      * - AUTO: 默认使用NORMAL
@@ -91,7 +93,7 @@ public:
     /**
      * @brief 从名称创建Allocator
      * 
-     * @param name 类型名称（"normal", "avframe", "framebuffer", "auto"）
+     * @param name 类型名称（"normal", "page_aligned", "avframe", "framebuffer", "auto"）
      * @param mem_type 内存分配器类型（用于NormalAllocator）
      * @param alignment 内存对齐（用于NormalAllocator）
      * @return Allocator实例
@@ -179,6 +179,23 @@ public:
      */
     void setImageMetadataFromAVFrame(const AVFrame* frame);
     
+    /**
+     * @brief 直接设置图像元数据（无 AVFrame 场景，如 raw 文件、共享内存）
+     * @param width 图像宽度（像素）
+     * @param height 图像高度（像素）
+     * @param format 像素格式
+     * @param linesize 各plane的stride（4个元素）
+     * @param plane_offset 各plane相对于virt_addr_的偏移（4个元素）
+     * @param nb_planes plane数量（1-4）
+     */
+    void setImageMetadata(int width, int height, AVPixelFormat format,
+                          const int linesize[4], const size_t plane_offset[4], int nb_planes);
+    
+    /**
+     * @brief 清除图像元数据
+     */
+    void clearImageMetadata() { has_image_metadata_ = false; }
+    
     /**
      * @brief 检查是否有图像元数据
      * @return true 如果已设置图像元数据，否则返回 false
@@ -209,6 +226,18 @@ public:
      */
     const int* getImageLinesize() const { return linesize_; }
     
+    /**
+     * @brief 获取plane偏移数组
+     * @return 指向包含4个元素的plane偏移数组的指针（相对于virt_addr_）
+     */
+    const size_t* getImagePlaneOffset() const { return plane_offset_; }
+    
+    /**
+     * @brief 获取plane数量
+     * @return plane数量（1-4），无元数据时返回 0
+     */
+    int getImagePlaneCount() const { return nb_planes_; }
+    
     /**
      * @brief 获取指定plane的数据指针
      * @param plane plane索引（0-3）
@@ -251,6 +280,20 @@ public:
         return (uint8_t*)virt_addr_ + plane_offset_[plane];
     }
     
+    // ========== 帧来源接口 ==========
+    
+    /**
+     * @brief 设置帧来源ID（多源生产线填充时标记）
+     * @param source_id 来源ID（-1 表示未标记）
+     */
+    void setSourceId(int source_id) { source_id_ = source_id; }
+    
+    /**
+     * @brief 获取帧来源ID
+     * @return 来源ID（MultiSourceProductionLine::addSource() 的返回值），未标记返回 -1
+     */
+    int getSourceId() const { return source_id_; }
+    
     // ========== 校验接口 ==========
     
     /**
@@ -295,6 +338,9 @@ private:
     size_t plane_offset_[4];         // 各plane相对于virt_addr_的偏移
     int nb_planes_;                  // plane数量（1-4）
     
+    // ========== 帧来源 ==========
+    int source_id_;                  // 来源ID（多源生产线，-1=未标记）
+    
     // ========== 安全性 ==========
     static constexpr uint32_t MAGIC_NUMBER = 0xBEEFF123;  // 魔数：BEEF + F123
     uint32_t validation_magic_;      // 魔数，用于检测野指针
@@ -113,6 +113,23 @@ public:
      */
     Buffer* acquireFree(bool blocking = true, int timeout_ms = -1);
     
+    /**
+     * @brief 批量获取空闲 Buffer
+     * 
+     * 一次加锁等待至少一个空闲 buffer，再取出队列中现有的 buffer（最多 max_count 个），
+     * 供批量填充（WorkerBase::fillBuffers）使用
+     * 
+     * 线程安全：是
+     * 阻塞行为：由 blocking 参数决定（只等待第一个 buffer）
+     * 
+     * @param out 输出数组（至少 max_count 个元素）
+     * @param max_count 最多获取的 buffer 数
+     * @param blocking 是否阻塞等待
+     * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
+     * @return 获取到的 buffer 数，失败/超时返回 0
+     */
+    int acquireFreeBatch(Buffer** out, int max_count, bool blocking = true, int timeout_ms = -1);
+    
     /**
      * @brief 提交已填充的 Buffer
      * 
@@ -256,6 +273,75 @@ public:
      */
     void clearAllManagedBuffers();
     
+    // ====== NUMA 放置 ======
+    
+    /**
+     * @brief 将所有托管 Buffer 的内存绑定到指定 NUMA 节点
+     * 
+     * 使用场景：
+     * - ProductionLine 启动时，将 Pool 内存迁移到生产者线程所在节点
+     * - 已分配的页面会被迁移（MPOL_MF_MOVE），之后新分配的页面优先落在该节点
+     * 
+     * 限制：
+     * - 没有虚拟地址的 Buffer（如尚未解码的 AVFrame Buffer）会被跳过
+     * - 非 NUMA 系统上返回 0
+     * 
+     * 线程安全：是
+     * 
+     * @param node NUMA 节点编号
+     * @return int 成功绑定的 Buffer 数量
+     */
+    int bindToNumaNode(int node);
+    
+    /**
+     * @brief 获取 bindToNumaNode() 设置的节点
+     * @return 节点编号，未绑定返回 -1
+     */
+    int getNumaNode() const { return numa_node_.load(); }
+    
+    // ====== 事件通知（eventfd，可选）======
+    
+    /**
+     * @brief 获取"有已填充 Buffer"事件的 eventfd（首次调用时创建）
+     * 
+     * 使用场景：
+     * - 将 BufferPool 接入 epoll/poll 事件循环，一个 reactor 线程复用多个 Pool
+     * - 替代 acquireFilled(true, 100) 轮询，shutdown 时立即唤醒
+     * 
+     * 通知语义（边沿触发）：
+     * - filled 队列由空变为非空时写入 eventfd（submitFilled / addBufferToQueue）
+     * - shutdown() 时写入，唤醒事件循环
+     * - 消费者收到可读事件后：先 clearFilledEvent()，再循环 acquireFilled(false, 0) 直到返回 nullptr
+     *   （先清除再取空，可保证不会漏掉清除之后到达的 Buffer）
+     * 
+     * 线程安全：是
+     * 
+     * @return int eventfd（EFD_NONBLOCK | EFD_CLOEXEC），创建失败返回 -1
+     * 
+     * @note fd 由 BufferPool 持有，析构时关闭，调用者不应 close()
+     */
+    int getFilledEventFd();
+    
+    /**
+     * @brief 获取"有空闲 Buffer"事件的 eventfd（首次调用时创建）
+     * 
+     * 通知语义与 getFilledEventFd() 相同：free 队列由空变为非空时写入
+     * （releaseFilled / releaseFree / addBufferToQueue），shutdown() 时写入。
+     * 
+     * @return int eventfd，创建失败返回 -1
+     */
+    int getFreeEventFd();
+    
+    /**
+     * @brief 清除 filled 事件计数（读取 eventfd）
+     */
+    void clearFilledEvent();
+    
+    /**
+     * @brief 清除 free 事件计数（读取 eventfd）
+     */
+    void clearFreeEvent();
+    
     // ====== 生命周期管理 ======
     
     /**
@@ -349,6 +435,16 @@ private:
      */
     bool removeFromQueue(std::queue<Buffer*>& queue, Buffer* target);
     
+    /**
+     * @brief 向 eventfd 写入事件（fd < 0 时不做任何操作）
+     */
+    static void signalEventFd(int fd);
+    
+    /**
+     * @brief 读取并清除 eventfd 计数（fd < 0 时不做任何操作）
+     */
+    static void drainEventFd(int fd);
+    
     // ==================== 成员变量 ====================
     
     // 基本信息
@@ -367,6 +463,13 @@ private:
     std::condition_variable filled_cv_;             // 填充队列条件变量
     std::atomic<bool> running_;                     // 运行状态（用于停止等待）
     
+    // NUMA 放置
+    std::atomic<int> numa_node_;                    // 绑定的节点（-1=未绑定）
+    
+    // 事件通知（eventfd，-1=未启用）
+    std::atomic<int> filled_event_fd_;              // filled 队列由空变非空时通知
+    std::atomic<int> free_event_fd_;                // free 队列由空变非空时通知
+    
     // 日志前缀（用于清晰标识对象）
     std::string log_prefix_;
 };
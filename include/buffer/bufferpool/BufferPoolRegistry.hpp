@@ -10,6 +10,7 @@
 
 // 前向声明
 class BufferPool;
+class SharedMemoryBufferPool;
 class VideoProductionLine;  // 用于 friend 声明
 class BufferAllocatorBase;  // 用于 friend 声明（v2.0 新增）
 
@@ -104,6 +105,48 @@ public:
      */
     size_t getPoolCount() const;
     
+    // ========== 跨进程共享内存 Pool 接口 ==========
+    
+    /**
+     * @brief 创建共享内存 Pool（创建者进程调用）
+     * 
+     * 设计：
+     * - Registry 独占持有 SharedMemoryBufferPool（与 BufferPool 一致）
+     * - 其他进程通过 attachSharedPool(name) 按名称附加
+     * - ID 与普通 BufferPool 共用同一 ID 空间
+     * 
+     * @param name Pool 名称（跨进程唯一）
+     * @param buffer_count Buffer 数量
+     * @param buffer_size 每个 Buffer 大小（字节）
+     * @param category Pool 分类
+     * @return 唯一 ID，失败返回 0
+     */
+    uint64_t createSharedPool(const std::string& name, int buffer_count, 
+                              size_t buffer_size, const std::string& category = "");
+    
+    /**
+     * @brief 按名称附加到其他进程创建的共享内存 Pool
+     * 
+     * @param name Pool 名称（与 createSharedPool() 一致）
+     * @return 唯一 ID，失败返回 0
+     * 
+     * @note 本进程已附加/创建过同名 Pool 时，直接返回已有 ID
+     */
+    uint64_t attachSharedPool(const std::string& name);
+    
+    /**
+     * @brief 获取共享内存 Pool（返回 weak_ptr，观察者模式）
+     * @param id createSharedPool() / attachSharedPool() 返回的 ID
+     * @return weak_ptr<SharedMemoryBufferPool> 如果不存在返回空的 weak_ptr
+     */
+    std::weak_ptr<SharedMemoryBufferPool> getSharedPool(uint64_t id) const;
+    
+    /**
+     * @brief 释放共享内存 Pool（创建者：停止并删除共享内存段；附加者：解除映射）
+     * @param id Pool ID
+     */
+    void releaseSharedPool(uint64_t id);
+    
     
     // ========== 全局监控接口 ==========
     
@@ -223,10 +266,22 @@ private:
         uint64_t allocator_id;                               // 🆕 创建者 Allocator 的唯一 ID
     };
     
+    /**
+     * @brief 共享内存 Pool 信息结构
+     */
+    struct SharedPoolInfo {
+        std::shared_ptr<SharedMemoryBufferPool> pool;        // Pool 的 shared_ptr（独占持有）
+        uint64_t id;                                         // 唯一 ID
+        std::string name;                                    // 跨进程名称
+        std::chrono::system_clock::time_point created_time; // 创建/附加时间
+    };
+    
     // ========== 成员变量 ==========
     mutable std::mutex mutex_;                              // 保护所有成员变量
     std::unordered_map<uint64_t, PoolInfo> pools_;          // ID -> PoolInfo
     std::unordered_map<std::string, uint64_t> name_to_id_;  // Name -> ID（快速查找）
+    std::unordered_map<uint64_t, SharedPoolInfo> shared_pools_;     // ID -> SharedPoolInfo
+    std::unordered_map<std::string, uint64_t> shared_name_to_id_;   // 共享 Pool Name -> ID
     uint64_t next_id_ = 1;                                  // 下一个可用 ID
     
     // ========== 友元声明 ==========
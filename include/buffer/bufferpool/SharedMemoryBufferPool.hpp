@@ -0,0 +1,255 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+/**
+ * @brief SharedMemoryBufferPool - 跨进程共享内存 BufferPool
+ *
+ * 使用场景：
+ * - 采集、分析、显示进程分离部署（故障隔离）
+ * - 帧数据跨进程传递，避免 socket 序列化拷贝
+ *
+ * 设计特点：
+ * - Buffer 数据位于 POSIX 共享内存段（shm_open + mmap），各进程零拷贝访问
+ * - free / filled 队列为共享内存中的无锁 MPMC 环形队列（按序号的有界队列）
+ * - 队列等待使用进程间 futex（FUTEX_WAIT / FUTEX_WAKE，非 PRIVATE）
+ * - 图像元数据（宽高、格式、stride、plane 偏移）随 Buffer 一起放在共享内存中
+ * - 与 BufferPool 保持相同的调度接口（acquire/submit/release）
+ *
+ * 健壮性（对应 robust futex 的 OWNER_DIED 语义）：
+ * - 队列无锁，不存在"持锁进程崩溃导致死锁"的问题
+ * - futex 等待按时间片进行，每次醒来检查 Pool 运行状态和创建者进程存活
+ * - 每个 Buffer 记录持有者 PID，出队时先以 CAS 登记持有者再推进队列位置（登记与出队不可分割），
+ *   reclaimOrphanedBuffers() 回收已退出进程持有的 Buffer
+ *
+ * 共享内存布局：
+ * @code
+ * +-------------+------------------+-------------------+-------------------+------------------+
+ * | ShmHeader   | ShmBufferMeta[N] | free ring (slots) | filled ring       | buffer data[N]   |
+ * +-------------+------------------+-------------------+-------------------+------------------+
+ *                                                                           ^ 4KB 对齐
+ * @endcode
+ *
+ * 使用示例：
+ * @code
+ * // 进程 A（创建者 / 生产者）
+ * uint64_t id = BufferPoolRegistry::getInstance().createSharedPool("cam0", 8, frame_size, "Video");
+ * auto pool = BufferPoolRegistry::getInstance().getSharedPool(id).lock();
+ * Buffer* buf = pool->acquireFree(true, 100);
+ * // ... 填充数据 ...
+ * pool->submitFilled(buf);
+ *
+ * // 进程 B（消费者，按名称附加）
+ * uint64_t id = BufferPoolRegistry::getInstance().attachSharedPool("cam0");
+ * auto pool = BufferPoolRegistry::getInstance().getSharedPool(id).lock();
+ * Buffer* buf = pool->acquireFilled(true, 100);  // 零拷贝访问
+ * // ... 使用数据 ...
+ * pool->releaseFilled(buf);
+ * @endcode
+ */
+class SharedMemoryBufferPool {
+public:
+    // ==================== 工厂方法 ====================
+
+    /**
+     * @brief 创建共享内存 Pool（创建者进程调用）
+     *
+     * @param name Pool 名称（其他进程通过此名称附加）
+     * @param buffer_count Buffer 数量
+     * @param buffer_size 每个 Buffer 大小（字节）
+     * @param category Pool 分类
+     * @return shared_ptr<SharedMemoryBufferPool> 失败返回 nullptr（如同名共享内存已存在）
+     *
+     * @note 创建者析构时会删除共享内存段（shm_unlink），已附加的进程仍可访问到 munmap 为止
+     */
+    static std::shared_ptr<SharedMemoryBufferPool> create(
+        const std::string& name,
+        int buffer_count,
+        size_t buffer_size,
+        const std::string& category = ""
+    );
+
+    /**
+     * @brief 附加到已存在的共享内存 Pool（其他进程调用）
+     *
+     * @param name Pool 名称（与 create() 一致）
+     * @return shared_ptr<SharedMemoryBufferPool> 失败返回 nullptr
+     */
+    static std::shared_ptr<SharedMemoryBufferPool> attach(const std::string& name);
+
+    /**
+     * @brief 析构函数（解除映射；创建者同时停止 Pool 并删除共享内存段）
+     */
+    ~SharedMemoryBufferPool();
+
+    // ====== 生产者接口 ======
+
+    /**
+     * @brief 获取空闲 Buffer
+     * @param blocking 是否阻塞等待
+     * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
+     * @return Buffer* 成功返回 buffer，失败/超时返回 nullptr
+     */
+    Buffer* acquireFree(bool blocking = true, int timeout_ms = -1);
+
+    /**
+     * @brief 提交已填充的 Buffer（图像元数据同步到共享内存）
+     */
+    void submitFilled(Buffer* buffer_ptr);
+
+    /**
+     * @brief 归还未填充的 Buffer（生产者填充失败时使用）
+     */
+    void releaseFree(Buffer* buffer_ptr);
+
+    // ====== 消费者接口 ======
+
+    /**
+     * @brief 获取已填充的 Buffer（图像元数据从共享内存同步到本进程 Buffer）
+     * @param blocking 是否阻塞等待
+     * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
+     * @return Buffer* 成功返回 buffer，失败/超时返回 nullptr
+     */
+    Buffer* acquireFilled(bool blocking = true, int timeout_ms = -1);
+
+    /**
+     * @brief 归还已使用的 Buffer
+     */
+    void releaseFilled(Buffer* buffer_ptr);
+
+    // ====== 健壮性 ======
+
+    /**
+     * @brief 回收已退出进程持有的 Buffer
+     *
+     * 扫描所有 Buffer，持有者进程已不存在（kill(pid, 0) 返回 ESRCH）时，
+     * 将 Buffer 归还到 free 队列。
+     *
+     * @return int 回收的 Buffer 数量
+     */
+    int reclaimOrphanedBuffers();
+
+    // ====== 查询接口 ======
+
+    int getFreeCount() const;
+    int getFilledCount() const;
+    int getTotalCount() const { return static_cast<int>(buffers_.size()); }
+    size_t getBufferSize() const { return buffer_size_; }
+    const std::string& getName() const { return name_; }
+    const std::string& getCategory() const { return category_; }
+
+    /**
+     * @brief 是否为创建者进程
+     */
+    bool isCreator() const { return is_creator_; }
+
+    /**
+     * @brief 检查 Pool 是否仍在运行（创建者未 shutdown 且仍存活）
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 获取共享内存文件描述符（可通过 SCM_RIGHTS 传递给无法按名称访问的进程）
+     */
+    int getFd() const { return fd_; }
+
+    /**
+     * @brief 根据 ID 获取 Buffer
+     */
+    Buffer* getBufferById(uint32_t id) const;
+
+    uint64_t getRegistryId() const { return registry_id_; }
+    void setRegistryId(uint64_t id) { registry_id_ = id; }
+
+    // ====== 生命周期管理 ======
+
+    /**
+     * @brief 停止 Pool（唤醒所有进程中的等待者）
+     */
+    void shutdown();
+
+    // ====== 调试接口 ======
+
+    void printStats() const;
+
+    // ====== 禁止拷贝 ======
+    SharedMemoryBufferPool(const SharedMemoryBufferPool&) = delete;
+    SharedMemoryBufferPool& operator=(const SharedMemoryBufferPool&) = delete;
+
+private:
+    // 共享内存结构（定义在 .cpp 中）
+    struct ShmHeader;
+    struct ShmRing;
+    struct ShmBufferMeta;
+
+    SharedMemoryBufferPool(const std::string& name, bool is_creator);
+
+    /**
+     * @brief 映射共享内存并建立本进程 Buffer 对象
+     */
+    bool mapSegment(int fd, size_t total_size);
+
+    /**
+     * @brief 将共享内存名称转换为 shm_open 路径（"/components_pool_<name>"）
+     */
+    static std::string toShmPath(const std::string& name);
+
+    /**
+     * @brief 入队（发布槽位前清除 Buffer 的持有者）
+     */
+    bool pushRing(ShmRing* ring, uint32_t index);
+
+    /**
+     * @brief 出队（CAS 登记本进程为持有者后才推进出队位置）
+     */
+    bool popRing(ShmRing* ring, uint32_t* index);
+
+    /**
+     * @brief Buffer 是否仍在队列中（回收时区分"出队途中崩溃"与"已取出后崩溃"）
+     */
+    bool isQueued(const ShmRing* ring, uint32_t index) const;
+
+    /**
+     * @brief 从环形队列获取 Buffer（可阻塞，futex 等待）
+     */
+    Buffer* acquireFromRing(ShmRing* ring, std::atomic<uint32_t>* futex_word,
+                            std::atomic<uint32_t>* waiters, bool blocking, int timeout_ms);
+
+    /**
+     * @brief 放入环形队列并唤醒等待者
+     */
+    void postToRing(ShmRing* ring, std::atomic<uint32_t>* futex_word,
+                    std::atomic<uint32_t>* waiters, uint32_t index);
+
+    /**
+     * @brief 校验 Buffer 是否属于此 Pool
+     */
+    bool ownsBuffer(const Buffer* buffer_ptr) const;
+
+    // ==================== 成员变量 ====================
+
+    std::string name_;
+    std::string category_;
+    uint64_t registry_id_;
+    bool is_creator_;
+
+    // 共享内存映射
+    int fd_;
+    void* base_;
+    size_t mapped_size_;
+    ShmHeader* header_;
+    ShmBufferMeta* metas_;
+    ShmRing* free_ring_;
+    ShmRing* filled_ring_;
+    size_t buffer_size_;
+
+    // 本进程的 Buffer 视图（EXTERNAL 所有权，指向共享内存）
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+
+    // 日志前缀（用于清晰标识对象）
+    std::string log_prefix_;
+};
@@ -0,0 +1,132 @@
+#ifndef COMMON_FRAME_COPY_HPP
+#define COMMON_FRAME_COPY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * FrameCopy - 整帧拷贝引擎（流式 SIMD 存储 + 可选条带多线程）
+ *
+ * 使用场景：
+ * - raw 文件映射区 → Buffer、Buffer → framebuffer 等 8~33 MB 的整帧拷贝
+ *
+ * 设计特点：
+ * - 流式（non-temporal）存储：目标数据绕过缓存直接写回内存，不把生产线其他线程的
+ *   工作集挤出 LLC；写合并内存（framebuffer）上也比普通存储快
+ * - 运行时分派：x86 按 CPU 选择 AVX2 / SSE2，aarch64 使用 NEON（stnp），其他平台 memcpy
+ * - 小于 kStreamingThreshold 的拷贝直接 memcpy（数据随后马上被读取时留在缓存里更快）
+ * - 可选辅助线程：一帧按字节（或按行）切成条带，调用线程和辅助线程各拷一条，
+ *   突破单核拷贝带宽上限；辅助线程正忙于另一路拷贝时，调用方退化为单线程拷贝，不排队等待
+ *
+ * 使用示例：
+ * ```cpp
+ * FrameCopy::getInstance().setHelperThreads(3);   // 可选：4 路条带
+ * FrameCopy::getInstance().copy(dst, src, frame_size);
+ * FrameCopy::getInstance().copyRows(dst, dst_stride, src, src_stride, width * 4, height);
+ * ```
+ */
+class FrameCopy {
+public:
+    enum class Isa {
+        SCALAR,     // memcpy
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    // 小于该字节数的拷贝使用 memcpy
+    static constexpr size_t kStreamingThreshold = 256 * 1024;
+
+    // 每个条带至少拷贝的字节数（更小的帧不值得唤醒辅助线程）
+    static constexpr size_t kMinStripeBytes = 1024 * 1024;
+
+    static constexpr int kMaxHelperThreads = 15;
+
+    /**
+     * 获取进程级实例（辅助线程在所有拷贝点之间共享）
+     */
+    static FrameCopy& getInstance();
+
+    ~FrameCopy();
+
+    FrameCopy(const FrameCopy&) = delete;
+    FrameCopy& operator=(const FrameCopy&) = delete;
+
+    /**
+     * 拷贝连续内存（区域不可重叠）
+     */
+    void copy(void* dst, const void* src, size_t size);
+
+    /**
+     * 按行拷贝（源 / 目标行跨度可以不同，如裁剪或去掉 linesize 对齐填充）
+     * @param row_bytes 每行拷贝的字节数（不超过两个 stride）
+     */
+    void copyRows(void* dst, size_t dst_stride, const void* src, size_t src_stride,
+                  size_t row_bytes, int rows);
+
+    /**
+     * 设置辅助线程数（0=只在调用线程拷贝，默认），最多 kMaxHelperThreads
+     */
+    void setHelperThreads(int count);
+    int getHelperThreads() const;
+
+    /**
+     * 启用 / 禁用流式存储（禁用时所有拷贝都是 memcpy，用于对比测试）
+     */
+    void setStreaming(bool enable);
+    bool isStreaming() const;
+
+    /**
+     * 运行时选择的指令集
+     */
+    static Isa getIsa();
+    static const char* getIsaName();
+
+    /**
+     * 单线程流式拷贝（不做阈值判断，结束时带存储屏障）
+     */
+    static void streamCopy(void* dst, const void* src, size_t size);
+
+private:
+    /**
+     * 一次条带拷贝任务（contiguous=true 时按字节切分，否则按行切分）
+     */
+    struct Job {
+        uint8_t* dst = nullptr;
+        const uint8_t* src = nullptr;
+        size_t dst_stride = 0;
+        size_t src_stride = 0;
+        size_t row_bytes = 0;
+        int rows = 0;
+        bool contiguous = false;
+        int stripes = 1;
+    };
+
+    FrameCopy();
+
+    int stripeCount(size_t total_bytes, int max_units) const;
+    void run(const Job& job);
+    void runStripe(const Job& job, int stripe) const;
+    void helperLoop(int helper_index);
+    void stopHelpers();
+
+    std::atomic<bool> streaming_;
+
+    std::mutex job_mutex_;                 // 同一时间只有一个条带任务使用辅助线程
+    std::mutex mutex_;                     // 保护 job_ / generation_ / remaining_ / stop_
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    Job job_;
+    uint64_t generation_;
+    int remaining_;
+    bool stop_;
+    std::vector<std::thread> helpers_;     // job_mutex_ 保护
+    std::atomic<int> helper_count_;
+};
+
+#endif // COMMON_FRAME_COPY_HPP
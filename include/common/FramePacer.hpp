@@ -0,0 +1,121 @@
+#ifndef COMMON_FRAME_PACER_HPP
+#define COMMON_FRAME_PACER_HPP
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <mutex>
+
+/**
+ * FramePacer - 按目标帧率放行帧（绝对时间调度，低抖动）
+ *
+ * 使用场景：
+ * - 模拟摄像头回放：Raw / 文件 Worker 本身全速生产，由生产线按 30/60 fps 放行，
+ *   消费者无需自行 sleep（自行 sleep 会叠加抖动）
+ *
+ * 设计特点：
+ * - 第 N 帧的截止时间 = 锚点 + N × 周期，使用 clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)
+ *   等待到绝对时间点；单帧唤醒延迟不会累积（无漂移）
+ * - 多个生产者共享同一个调度：每次 waitNextSlot() 领取下一个时间槽
+ * - 落后超过 kResyncPeriods 个周期（下游阻塞、填充过慢）时重新锚定，
+ *   避免恢复后连续突发放行
+ * - 统计每帧延迟（实际放行时间 - 截止时间）的直方图，用于评估抖动
+ *
+ * 使用示例：
+ * ```cpp
+ * FramePacer pacer(30.0);
+ * while (running) {
+ *     fill(buffer);
+ *     if (!pacer.waitNextSlot(&running)) break;
+ *     pool->submitFilled(buffer);
+ * }
+ * pacer.printStats();
+ * ```
+ */
+class FramePacer {
+public:
+    // 延迟直方图桶上界（毫秒），最后一个桶为 >= 最后上界
+    static constexpr int kHistogramBuckets = 8;
+    static constexpr double kBucketUpperMs[kHistogramBuckets - 1] = {0.1, 0.5, 1.0, 2.0, 5.0, 10.0, 20.0};
+
+    // 延迟超过该周期数时重新锚定
+    static constexpr int kResyncPeriods = 2;
+
+    /**
+     * 统计快照（getStats() 返回）
+     */
+    struct Stats {
+        double target_fps = 0.0;
+        uint64_t frames = 0;             // 已放行帧数
+        uint64_t late_frames = 0;        // 延迟超过 1ms 的帧数
+        uint64_t resyncs = 0;            // 重新锚定次数
+        double avg_lateness_ms = 0.0;    // 平均延迟
+        double max_lateness_ms = 0.0;    // 最大延迟
+        double actual_fps = 0.0;         // 实际放行帧率（首帧到最近一帧）
+        std::array<uint64_t, kHistogramBuckets> histogram{};   // 延迟分布
+    };
+
+    /**
+     * 构造函数
+     * @param target_fps 目标帧率（<=0 表示不限速，waitNextSlot() 立即返回）
+     */
+    explicit FramePacer(double target_fps = 0.0);
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /**
+     * 修改目标帧率（从下一帧开始按新周期重新锚定，可在运行中调用）
+     */
+    void setRate(double target_fps);
+
+    double getRate() const;
+
+    /**
+     * 清空调度和统计（下一次 waitNextSlot() 作为首帧立即放行）
+     */
+    void reset();
+
+    /**
+     * 领取下一个时间槽并等待到其截止时间
+     * @param running 运行标志（可为 nullptr）；等待期间每 100ms 检查一次，变为 false 时提前返回
+     * @return true 到达截止时间（应放行本帧）；false 因停止而中断
+     */
+    bool waitNextSlot(const std::atomic<bool>* running = nullptr);
+
+    /**
+     * 距离下一个时间槽的时间（纳秒，不领取时间槽）
+     * @return 下一帧还需等待的时间；不限速或已到期返回 0
+     *
+     * @note 用于执行器任务：需要等待较长时间时先挂起任务，不占用执行器线程
+     */
+    int64_t nanosUntilNextSlot() const;
+
+    Stats getStats() const;
+
+    void printStats() const;
+
+private:
+    static int64_t nowNs();
+
+    /**
+     * 记录一帧的放行延迟（调用者持有 mutex_）
+     */
+    void recordLateness(int64_t lateness_ns, int64_t release_ns);
+
+    mutable std::mutex mutex_;
+    int64_t period_ns_;          // 帧周期（0=不限速）
+    int64_t next_deadline_ns_;   // 下一个时间槽的截止时间（0=尚未锚定）
+
+    // 统计（mutex_ 保护）
+    uint64_t frames_;
+    uint64_t late_frames_;
+    uint64_t resyncs_;
+    int64_t total_lateness_ns_;
+    int64_t max_lateness_ns_;
+    int64_t first_release_ns_;
+    int64_t last_release_ns_;
+    std::array<uint64_t, kHistogramBuckets> histogram_;
+};
+
+#endif // COMMON_FRAME_PACER_HPP
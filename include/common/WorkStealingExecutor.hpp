@@ -0,0 +1,196 @@
+#ifndef COMMON_WORK_STEALING_EXECUTOR_HPP
+#define COMMON_WORK_STEALING_EXECUTOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
+/**
+ * WorkStealingExecutor - 进程级共享任务执行器（工作窃取 + 按权重公平调度）
+ *
+ * 使用场景：
+ * - 多路生产线（如 32 路摄像头）共享固定数量的线程，避免每条线各自创建线程
+ *   导致线程数远超核心数、上下文切换开销占主导
+ *
+ * 设计特点：
+ * - 线程数默认等于核心数（getInstance() 为进程级单例）
+ * - 每个工作线程一个本地双端队列：本线程提交的任务压入队尾（LIFO，缓存友好），
+ *   外部提交进入全局注入队列，空闲线程从其他线程队首窃取
+ * - 任务属于某个分组（一条生产线一个分组），分组有权重；
+ *   按分组累计的加权运行时间（vruntime）调度，落后的分组优先执行
+ * - 任务等待资源时不阻塞工作线程：submitWhenReadable() 将任务挂起到 fd 上，
+ *   fd 可读（如 BufferPool 的 eventfd）或超时后重新提交
+ *
+ * 使用示例：
+ * ```cpp
+ * auto& executor = WorkStealingExecutor::getInstance();
+ * uint64_t group = executor.registerGroup("camera0", 2);  // 权重 2
+ * executor.submit(group, [] { ... });
+ * executor.submitWhenReadable(group, pool->getFreeEventFd(), [] { ... }, 10);
+ * executor.unregisterGroup(group);
+ * ```
+ */
+class WorkStealingExecutor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * 分组统计（getGroupStats() 快照）
+     */
+    struct GroupStats {
+        std::string name;
+        int weight = 0;
+        uint64_t executed = 0;       // 已执行任务数
+        uint64_t pending = 0;        // 排队中的任务数（不含挂起在 fd 上的任务）
+        uint64_t parked = 0;         // 挂起在 fd 上的任务数
+        double run_time_ms = 0.0;    // 累计执行时间
+        double vruntime_ms = 0.0;    // 加权运行时间（run_time / weight，用于公平调度）
+    };
+
+    /**
+     * 获取进程级共享实例（首次调用时创建，线程数 = 核心数）
+     */
+    static WorkStealingExecutor& getInstance();
+
+    /**
+     * 构造函数
+     * @param thread_count 工作线程数（<=0 时使用核心数）
+     */
+    explicit WorkStealingExecutor(int thread_count = 0);
+
+    /**
+     * 析构函数 - 停止所有工作线程（未执行的任务被丢弃）
+     */
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    // ============ 分组管理 ============
+
+    /**
+     * 注册任务分组
+     * @param name 分组名称（统计使用）
+     * @param weight 公平调度权重（>=1，权重越大获得的执行时间越多）
+     * @return 分组ID（>0）
+     *
+     * @note 新分组的 vruntime 从当前最小值开始，避免长期占用或长期饥饿
+     */
+    uint64_t registerGroup(const std::string& name, int weight = 1);
+
+    /**
+     * 注销任务分组
+     * @note 调用者需保证该分组已无排队或挂起的任务
+     */
+    void unregisterGroup(uint64_t group_id);
+
+    /**
+     * 修改分组权重
+     */
+    bool setGroupWeight(uint64_t group_id, int weight);
+
+    // ============ 任务提交 ============
+
+    /**
+     * 提交任务
+     * @param group_id 分组ID
+     * @param task 任务
+     * @return true 提交成功；分组不存在或执行器已停止返回 false
+     */
+    bool submit(uint64_t group_id, Task task);
+
+    /**
+     * 挂起任务直到 fd 可读或超时，然后提交执行（不占用工作线程）
+     * @param group_id 分组ID
+     * @param fd 等待的文件描述符（如 eventfd）
+     * @param task 任务
+     * @param timeout_ms 最长挂起时间（毫秒），超时后无论 fd 状态都会提交
+     * @return true 挂起成功
+     *
+     * @note 任务被唤醒后应自行检查条件是否满足（可能是超时或伪唤醒）
+     */
+    bool submitWhenReadable(uint64_t group_id, int fd, Task task, int timeout_ms);
+
+    // ============ 查询接口 ============
+
+    int getThreadCount() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * 当前线程是否为本执行器的工作线程
+     */
+    bool isWorkerThread() const;
+
+    bool getGroupStats(uint64_t group_id, GroupStats* stats) const;
+
+    void printStats() const;
+
+private:
+    struct Group;
+    struct TaskItem {
+        std::shared_ptr<Group> group;
+        Task fn;
+    };
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<TaskItem> tasks;
+    };
+    struct ParkedTask {
+        TaskItem item;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void workerLoop(int index);
+    void wakerLoop();
+
+    /**
+     * 取任务：本地队尾 -> 全局队首 -> 窃取其他线程队首
+     */
+    bool popTask(int index, TaskItem* item);
+
+    /**
+     * 分组是否领先太多（应让出给落后的分组）
+     */
+    bool shouldDefer(const Group& group) const;
+
+    void enqueue(TaskItem item);
+    std::shared_ptr<Group> findGroup(uint64_t group_id) const;
+    uint64_t minVruntime(bool runnable_only) const;
+
+    // 工作线程
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stopping_;
+
+    // 全局注入队列（非工作线程提交）
+    std::mutex global_mutex_;
+    std::deque<TaskItem> global_tasks_;
+
+    // 空闲线程休眠 / 唤醒
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<int> queued_total_;
+    std::atomic<int> sleeping_workers_;
+
+    // 分组
+    mutable std::shared_mutex groups_mutex_;
+    std::unordered_map<uint64_t, std::shared_ptr<Group>> groups_;
+    std::atomic<uint64_t> next_group_id_;
+
+    // 挂起在 fd 上的任务（epoll 唤醒线程）
+    int epoll_fd_;
+    std::thread waker_;
+    std::mutex parked_mutex_;
+    std::unordered_map<int, std::vector<ParkedTask>> parked_;
+};
+
+#endif // COMMON_WORK_STEALING_EXECUTOR_HPP
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "buffer/BufferAllocatorFacade.hpp"
+#include "buffer/bufferpool/BufferPool.hpp"
+#include "productionline/worker/BufferFillingWorkerFacade.hpp"
+#include "productionline/worker/WorkerConfig.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <functional>
+
+/**
+ * @brief SourceConfig - 多源生产线中的一个帧源
+ */
+struct SourceConfig {
+    WorkerConfig worker;                 // Worker 配置（文件、输出、解码器）
+    std::string name;                    // 源名称（日志和统计使用，空=文件路径，测试图案为图案名称）
+    int weight = 1;                      // 公平调度权重（权重 2 的源获得约两倍的填充次数）
+    bool loop = false;                   // 是否循环播放
+
+    // 测试图案不读文件，不需要路径（与 BufferFillingWorkerFacade::open() 一致）
+    bool isValid() const {
+        return (!worker.file.file_path.empty() || worker.worker_type == WorkerType::TEST_PATTERN) && weight > 0;
+    }
+};
+
+/**
+ * @brief MultiSourceProductionLine - 多源复用生产流水线
+ *
+ * 架构角色：ProductionLine（生产流水线）- 一条生产线持有 N 个 Worker（播放列表、摄像头组等）
+ *
+ * 数据流：
+ * @code
+ * [worker 0] ─┐
+ * [worker 1] ─┼─> [producer threads, 加权公平调度] -> 共享输出 Pool -> 消费者（按 Buffer::getSourceId() 区分来源）
+ * [worker N] ─┘
+ * @endcode
+ *
+ * 与 N 条 VideoProductionLine 相比：
+ * - 一组生产者线程服务所有源（线程数与源数无关）
+ * - 只有一个输出 Pool 需要配置容量
+ * - 每个 filled buffer 标记来源ID（Buffer::setSourceId）
+ *
+ * 填充方式：
+ * - Raw Worker（填充调用方提供的内存）：直接填充共享 Pool 的 buffer，零额外拷贝
+ * - FFmpeg 解码 Worker（buffer 绑定 AVFrame）：先解码到 Worker 自己的 Pool，
+ *   再按像素格式紧凑拷贝到共享 buffer（同一时刻每个源只有一个线程在解码）
+ *
+ * 调度（stride scheduling）：
+ * - 每个源维护虚拟时间，每填充一帧前进 1/weight
+ * - 生产者每次选择可运行（未结束、未达并发上限）且虚拟时间最小的源
+ * - 源恢复可运行时虚拟时间不早于全局虚拟时间，不会因等待而突发
+ */
+class MultiSourceProductionLine {
+public:
+    /**
+     * @brief 错误回调函数类型
+     */
+    using ErrorCallback = std::function<void(const std::string&)>;
+
+    /**
+     * @brief 单个源的统计（getSourceStats() 快照）
+     */
+    struct SourceStats {
+        int source_id = -1;
+        std::string name;
+        std::string worker_type;
+        int weight = 1;
+        bool staged = false;               // 是否经 Worker 自己的 Pool 中转（解码 Worker）
+        bool ended = false;                // 非循环模式已播放完毕
+        uint64_t produced = 0;             // 提交到共享 Pool 的帧数
+        uint64_t skipped = 0;              // 填充失败跳过的帧数
+        double share = 0.0;                // 占全部已生产帧的比例
+        double avg_fill_ms = 0.0;          // 平均填充耗时（含中转拷贝）
+    };
+
+    /**
+     * @brief 构造函数
+     * @param thread_count 生产者线程数（默认 1，服务所有源）
+     * @param buffer_count 共享输出 Pool 的 Buffer 数量（0=每个源 2 个，至少 4 个）
+     */
+    explicit MultiSourceProductionLine(int thread_count = 1, int buffer_count = 0);
+
+    /**
+     * @brief 析构函数 - 自动停止并释放所有源
+     */
+    ~MultiSourceProductionLine();
+
+    MultiSourceProductionLine(const MultiSourceProductionLine&) = delete;
+    MultiSourceProductionLine& operator=(const MultiSourceProductionLine&) = delete;
+
+    // ========== 核心接口 ==========
+
+    /**
+     * @brief 添加帧源（必须在 start() 之前调用）
+     * @param config 源配置
+     * @return 源ID（从 0 开始，与 Buffer::getSourceId() 对应）；运行中或配置无效返回 -1
+     */
+    int addSource(const SourceConfig& config);
+
+    /**
+     * @brief 清除所有帧源（必须在 start() 之前调用）
+     */
+    void clearSources();
+
+    /**
+     * @brief 打开所有源、创建共享输出 Pool 并启动生产者线程
+     * @return true 如果启动成功；任一源打开失败时返回 false
+     */
+    bool start();
+
+    /**
+     * @brief 停止生产线，关闭所有源并销毁共享输出 Pool
+     *
+     * @note 调用前消费者应已归还所有 filled buffer
+     */
+    void stop();
+
+    // ========== 查询接口 ==========
+
+    bool isRunning() const { return running_.load(); }
+
+    /**
+     * @brief 获取共享输出 BufferPool ID（消费者从 Registry 获取 Pool）
+     */
+    uint64_t getOutputBufferPoolId() const { return output_pool_id_; }
+
+    /**
+     * @brief 获取源数量
+     */
+    int getSourceCount() const { return static_cast<int>(sources_.size()); }
+
+    /**
+     * @brief 获取全部源已生产的帧数
+     */
+    int getProducedFrames() const { return produced_frames_.load(); }
+
+    /**
+     * @brief 获取全部源跳过的帧数
+     */
+    int getSkippedFrames() const { return skipped_frames_.load(); }
+
+    /**
+     * @brief 获取平均FPS（全部源合计）
+     */
+    double getAverageFPS() const;
+
+    /**
+     * @brief 获取各源统计（按源ID顺序）
+     */
+    std::vector<SourceStats> getSourceStats() const;
+
+    // ========== 错误处理 ==========
+
+    void setErrorCallback(ErrorCallback callback) {
+        error_callback_ = callback;
+    }
+
+    std::string getLastError() const;
+
+    // ========== 调试接口 ==========
+
+    /**
+     * @brief 打印统计信息（合计和每个源）
+     */
+    void printStats() const;
+
+private:
+    /**
+     * @brief 运行时源状态
+     */
+    struct Source {
+        int id = -1;
+        SourceConfig config;
+        std::shared_ptr<BufferFillingWorkerFacade> worker;
+        std::weak_ptr<BufferPool> staging_pool_weak;   // 解码 Worker 自己的 Pool（staged 时有效）
+        bool staged = false;
+        int total_frames = 0;
+        size_t frame_size = 0;
+
+        // 调度状态（schedule_mutex_ 保护）
+        double pass = 0.0;                 // 虚拟时间
+        int next_frame = 0;                // 下一个帧索引
+        int inflight = 0;                  // 正在填充的线程数
+        int max_inflight = 0;              // 并发上限（0=不限）
+        bool ended = false;
+
+        // 统计
+        std::atomic<uint64_t> produced{0};
+        std::atomic<uint64_t> skipped{0};
+        std::atomic<uint64_t> fill_time_us{0};
+    };
+
+    /**
+     * @brief 生产者线程函数
+     */
+    void producerThreadFunc(int thread_id);
+
+    /**
+     * @brief 选择下一个要填充的源并领取帧索引
+     * @param frame_index 输出：领取的帧索引
+     * @return 源指针；当前无可运行源返回 nullptr（all_ended 为 true 时表示全部结束）
+     */
+    Source* pickSource(int* frame_index, bool* all_ended);
+
+    /**
+     * @brief 填充完成后归还源的并发名额
+     */
+    void finishFill(Source* source, bool ended);
+
+    /**
+     * @brief 填充一帧到共享 buffer（直接填充或经 Worker Pool 中转）
+     * @return true 如果填充成功
+     */
+    bool fillFromSource(Source* source, int frame_index, Buffer* buffer);
+
+    /**
+     * @brief 解码 Worker：解码到 Worker 自己的 buffer，再紧凑拷贝到共享 buffer
+     */
+    bool fillStaged(Source* source, int frame_index, Buffer* buffer);
+
+    /**
+     * @brief 打开所有源的 Worker（start() 调用）
+     */
+    bool openSources();
+
+    /**
+     * @brief 关闭所有源的 Worker 并销毁共享 Pool
+     */
+    void releaseResources();
+
+    void setError(const std::string& error_msg);
+
+    // 帧源（start() 之后只读，调度状态由 schedule_mutex_ 保护）
+    std::vector<std::unique_ptr<Source>> sources_;
+    mutable std::mutex schedule_mutex_;
+    std::condition_variable schedule_cv_;         // 源并发名额释放时唤醒等待的生产者
+    double global_pass_;                          // 最近一次被调度源的虚拟时间
+
+    // 共享输出 Pool（由本生产线 Allocator 创建，Registry 持有）
+    std::unique_ptr<BufferAllocatorFacade> allocator_facade_uptr_;
+    uint64_t output_pool_id_;
+    std::weak_ptr<BufferPool> output_pool_weak_;
+    int buffer_count_;
+
+    // 线程管理
+    std::vector<std::thread> threads_;
+    std::atomic<bool> running_;
+    std::atomic<int> active_threads_;
+    std::mutex threads_mutex_;
+    int thread_count_;
+
+    // 统计信息
+    std::atomic<int> produced_frames_;
+    std::atomic<int> skipped_frames_;
+    std::chrono::steady_clock::time_point start_time_;
+    std::atomic<int64_t> elapsed_us_;             // 运行时长（生产者全部退出时记录，0=仍在运行）
+
+    // 错误处理
+    ErrorCallback error_callback_;
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+
+    // 日志前缀（用于清晰标识对象）
+    std::string log_prefix_;
+};
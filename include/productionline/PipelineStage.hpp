@@ -0,0 +1,205 @@
+#pragma once
+
+#include "buffer/BufferAllocatorFacade.hpp"
+#include "buffer/bufferpool/BufferPool.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <functional>
+
+/**
+ * @brief StageConfig - 流水线阶段配置
+ *
+ * 描述 VideoProductionLine 中生产者之后的一个处理阶段（格式转换、缩放、叠加等）
+ */
+struct StageConfig {
+    /**
+     * @brief 阶段处理函数
+     * @param input 上游已填充的 buffer（只读使用，返回后由阶段归还上游）
+     * @param output 本阶段输出 Pool 的空闲 buffer（处理函数负责填充数据和图像元数据）
+     * @return true 提交 output 到下游；false 丢弃本帧（output 归还 free 队列）
+     */
+    using ProcessFunction = std::function<bool(Buffer* input, Buffer* output)>;
+
+    std::string name;                    // 阶段名称（日志和统计使用）
+    ProcessFunction process;             // 处理函数（必填）
+    int thread_count = 1;                // 阶段线程数
+    int output_buffer_count = 4;         // 输出 Pool 的 Buffer 数量
+    size_t output_buffer_size = 0;       // 输出 Buffer 大小（0=与输入 Pool 相同）
+
+    bool isValid() const { return static_cast<bool>(process) && thread_count > 0 && output_buffer_count > 0; }
+};
+
+/**
+ * @brief StageConfig 构建器
+ */
+class StageConfigBuilder {
+public:
+    StageConfigBuilder& setName(const std::string& name) {
+        config_.name = name;
+        return *this;
+    }
+
+    StageConfigBuilder& setProcessFunction(StageConfig::ProcessFunction process) {
+        config_.process = std::move(process);
+        return *this;
+    }
+
+    StageConfigBuilder& setThreadCount(int count) {
+        config_.thread_count = count;
+        return *this;
+    }
+
+    StageConfigBuilder& setOutputBufferCount(int count) {
+        config_.output_buffer_count = count;
+        return *this;
+    }
+
+    StageConfigBuilder& setOutputBufferSize(size_t size) {
+        config_.output_buffer_size = size;
+        return *this;
+    }
+
+    StageConfig build() const { return config_; }
+
+private:
+    StageConfig config_;
+};
+
+/**
+ * @brief PipelineStage - 流水线中的一个处理阶段
+ *
+ * 架构角色：VideoProductionLine 内部组件，生产者之后、消费者之前
+ *
+ * 数据流：
+ * @code
+ * [producers] -> pool0 -> [stage A] -> poolA -> [stage B] -> poolB -> [consumers / 外部]
+ * @endcode
+ *
+ * 职责：
+ * - 管理本阶段线程（独立的线程预算）
+ * - 通过本阶段 Allocator 创建输出 BufferPool（Registry 持有）
+ * - 从上游 Pool acquireFilled，处理后向输出 Pool submitFilled
+ * - 统计处理耗时、等待上游/下游耗时，用于定位瓶颈阶段
+ *
+ * 排空语义：
+ * - 上游全部退出后调用 markUpstreamDone()，阶段处理完上游剩余帧后退出
+ * - 最后一个阶段线程退出时调用 on_finished 回调，通知下一阶段
+ */
+class PipelineStage {
+public:
+    /**
+     * @brief 阶段统计（getStats() 快照）
+     */
+    struct Stats {
+        std::string name;
+        int thread_count = 0;
+        uint64_t frames_in = 0;            // 从上游取到的帧数
+        uint64_t frames_out = 0;           // 提交到下游的帧数
+        uint64_t frames_dropped = 0;       // 处理失败或停止时丢弃的帧数
+        double avg_process_ms = 0.0;       // 平均处理耗时
+        double avg_input_wait_ms = 0.0;    // 平均等待上游帧耗时（大=上游是瓶颈）
+        double avg_output_wait_ms = 0.0;   // 平均等待下游空闲 buffer 耗时（大=下游是瓶颈）
+        double busy_ratio = 0.0;           // 处理耗时 / (线程数 × 运行时长)，接近 1 即本阶段是瓶颈
+    };
+
+    /**
+     * @brief 构造函数
+     * @param config 阶段配置
+     */
+    explicit PipelineStage(const StageConfig& config);
+
+    /**
+     * @brief 析构函数（停止线程并释放输出 Pool）
+     */
+    ~PipelineStage();
+
+    PipelineStage(const PipelineStage&) = delete;
+    PipelineStage& operator=(const PipelineStage&) = delete;
+
+    /**
+     * @brief 创建输出 Pool 并启动阶段线程
+     *
+     * 上一轮 stop() 后未调用 releaseOutputPool() 且规格一致时复用原输出 Pool（热重启）
+     *
+     * @param input_pool_id 上游 BufferPool ID
+     * @param numa_node 输出 Pool 内存和阶段线程所在 NUMA 节点（-1=不限制）
+     * @param on_finished 阶段全部线程退出后的回调（在阶段线程中调用）
+     * @return true 如果启动成功
+     */
+    bool start(uint64_t input_pool_id, int numa_node, std::function<void()> on_finished);
+
+    /**
+     * @brief 通知上游不会再有新帧（阶段排空后自然退出）
+     */
+    void markUpstreamDone() { upstream_done_.store(true); }
+
+    /**
+     * @brief 停止阶段：排空上游剩余帧后等待线程退出
+     *
+     * @note 调用前上游应已停止；停止期间下游无空闲 buffer 时本帧丢弃，避免死锁
+     */
+    void stop();
+
+    /**
+     * @brief 释放输出 Pool（stop() 之后、下游不再使用时调用）
+     */
+    void releaseOutputPool();
+
+    /**
+     * @brief 获取输出 BufferPool ID（未启动返回 0）
+     */
+    uint64_t getOutputPoolId() const { return output_pool_id_; }
+
+    /**
+     * @brief 获取统计快照
+     */
+    Stats getStats() const;
+
+    const std::string& getName() const { return config_.name; }
+
+private:
+    /**
+     * @brief 阶段线程函数
+     */
+    void threadFunc(int thread_id);
+
+    /**
+     * @brief 从输出 Pool 获取空闲 buffer（停止期间超时返回 nullptr）
+     */
+    Buffer* acquireOutput(BufferPool* output_pool);
+
+    StageConfig config_;
+
+    // 输出 Pool（由本阶段 Allocator 创建，Registry 持有）
+    std::unique_ptr<BufferAllocatorFacade> allocator_facade_uptr_;
+    uint64_t output_pool_id_;
+    std::weak_ptr<BufferPool> input_pool_weak_;
+    std::weak_ptr<BufferPool> output_pool_weak_;
+    int numa_node_;
+
+    // 线程管理
+    std::vector<std::thread> threads_;
+    std::atomic<int> active_threads_;
+    std::atomic<bool> upstream_done_;
+    std::atomic<bool> stopping_;
+    std::function<void()> on_finished_;
+    std::mutex threads_mutex_;
+
+    // 统计
+    std::atomic<uint64_t> frames_in_;
+    std::atomic<uint64_t> frames_out_;
+    std::atomic<uint64_t> frames_dropped_;
+    std::atomic<uint64_t> process_time_us_;
+    std::atomic<uint64_t> input_wait_us_;
+    std::atomic<uint64_t> output_wait_us_;
+    std::chrono::steady_clock::time_point start_time_;
+    std::atomic<int64_t> elapsed_us_;     // 运行时长（线程全部退出时记录，0=仍在运行）
+
+    // 日志前缀（用于清晰标识对象）
+    std::string log_prefix_;
+};
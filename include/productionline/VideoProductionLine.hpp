@@ -1,16 +1,26 @@
 #pragma once
 
 #include "buffer/bufferpool/BufferPool.hpp"
+#include "buffer/BufferAllocatorFacade.hpp"
 #include "productionline/worker/BufferFillingWorkerFacade.hpp"
 #include "productionline/worker/WorkerConfig.hpp"
+#include "productionline/PipelineStage.hpp"
+#include "common/WorkStealingExecutor.hpp"
+#include "common/FramePacer.hpp"
 #include "monitor/PerformanceMonitor.hpp"
 #include <string>
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <memory>
 #include <functional>
 #include <optional>
+#include <shared_mutex>
+
+class SharedMemoryBufferPool;
 
 /**
  * @brief VideoProductionLine - 视频生产流水线
@@ -22,6 +32,16 @@
  * - 填充 BufferPool 提供的 buffer
  * - 管理多个生产者线程（循环、线程数控制）
  * - 性能监控和统计
+ * - CPU 亲和性和 NUMA 放置（WorkerConfig::placement）
+ * - 回调式消费（注册 FrameSink 后由内部消费者线程分发 filled buffer）
+ * - 多阶段流水线（生产者之后串联处理阶段，每个阶段独立线程和输出 BufferPool）
+ * - 执行模式：独占生产者线程，或提交到进程级共享执行器（WorkStealingExecutor）
+ * - 生产者线程自动伸缩（根据 filled 队列占用、等待空闲 buffer 耗时、填充耗时）
+ * - 帧率控制：按目标帧率或源帧率放行帧（模拟摄像头实时回放）
+ * - 帧索引分配：逐帧分配，或每个生产者一次领取连续 K 帧（保持顺序 I/O）
+ * - 无缝播放列表：后台预打开下一个源并预填充首帧，复用工作 BufferPool
+ * - 暂停 / 恢复，热重启（兼容时保留 Worker 和 BufferPool，只重建变化的部分）
+ * - 共享内存输出：工作 BufferPool 建在跨进程共享内存上，分析进程零拷贝消费
  * 
  * 设计特点：
  * - Worker必须创建BufferPool（通过调用Allocator）
@@ -37,6 +57,30 @@ public:
      */
     using ErrorCallback = std::function<void(const std::string&)>;
     
+    /**
+     * @brief 帧回调函数类型（消费者线程中调用）
+     * 
+     * @note 回调返回后 buffer 会被自动归还（auto_release=true 时），
+     *       回调内不要保存 buffer 指针；auto_release=false 时需调用 releaseFrame()
+     */
+    using FrameCallback = std::function<void(Buffer*)>;
+    
+    /**
+     * @brief 生产者执行模式
+     */
+    enum class ExecutionMode {
+        DEDICATED_THREADS,   // 每条生产线独占 thread_count 个线程（默认）
+        SHARED_EXECUTOR      // 提交到共享执行器，thread_count 表示并发填充任务数
+    };
+    
+    /**
+     * @brief 帧索引分配模式
+     */
+    enum class FrameClaimMode {
+        PER_FRAME,   // 每帧一次 fetch_add，相邻帧分给不同生产者（默认）
+        CHUNKED      // 每个生产者一次领取连续 K 帧，按顺序填充
+    };
+    
     /**
      * @brief 构造函数
      * 
@@ -80,6 +124,70 @@ public:
      */
     void stop();
     
+    // ========== 暂停 / 热重启 ==========
+    
+    /**
+     * @brief 暂停生产（Worker、BufferPool、处理阶段和消费者保持不变）
+     * @return true 如果已暂停；未运行或生产已结束返回 false
+     * 
+     * 返回时在途填充已全部完成，直到 resume() 之前不会再提交新帧；
+     * 消费者继续分发已填充的帧
+     */
+    bool pause();
+    
+    /**
+     * @brief 恢复生产（不补发暂停期间的帧）
+     * @return true 如果已恢复；未暂停返回 false
+     */
+    bool resume();
+    
+    /**
+     * @brief 是否处于暂停状态
+     */
+    bool isPaused() const { return paused_.load(); }
+    
+    /**
+     * @brief 热重启：按新配置重新开始生产，只重建发生变化的部分
+     * @param worker_config 新的 Worker 配置
+     * @return true 如果重启成功
+     * 
+     * - 源配置（文件、输出、解码器、Worker 类型）不变：保留 Worker（demuxer / decoder）
+     *   和工作 Pool，回到起始帧
+     * - 源配置变化但几何一致（宽高、帧大小、buffer 类型）：先在旧源继续生产的同时打开新 Worker，
+     *   再替换 Worker，工作 Pool 保留
+     * - 几何不一致、播放列表模式或未启动：等同于 stop() + start()
+     * 
+     * 热重启时处理阶段的输出 Pool 同样保留，getOutputBufferPoolId() 不变；
+     * 生产者、阶段和消费者线程按 stop() 的排空语义退出后重新启动，统计清零，暂停状态解除
+     */
+    bool restart(const WorkerConfig& worker_config);
+    
+    // ========== 播放列表 ==========
+    
+    /**
+     * @brief 按播放列表启动（无缝切换）
+     * @param items 播放列表（至少一项），第一项立即播放
+     * @return true 如果第一项启动成功
+     * 
+     * - 当前源播放时，后台线程打开下一个源（open / avformat_find_stream_info 等）
+     *   并预填充前几帧到工作 Pool，当前源结束时直接切换，不产生空档
+     * - 下一个源必须与第一项几何一致（宽高、帧大小、buffer 类型），
+     *   工作 Pool 被复用，消费者和处理阶段无需重新绑定；不一致的项报错并跳过
+     * - 每一项按非循环方式播放；loop=true 时播放列表整体循环
+     */
+    bool startPlaylist(const std::vector<WorkerConfig>& items);
+    
+    /**
+     * @brief 向播放列表末尾追加一项（线程安全，仅播放列表模式）
+     * @return true 如果追加成功
+     */
+    bool appendToPlaylist(const WorkerConfig& item);
+    
+    /**
+     * @brief 获取当前播放项在播放列表中的索引（非播放列表模式返回 -1）
+     */
+    int getPlaylistIndex() const;
+    
     // ========== 查询接口 ==========
     
     /**
@@ -106,6 +214,12 @@ public:
      */
     double getAverageFPS() const;
     
+    /**
+     * @brief 获取生产者线程和 BufferPool 内存所在的 NUMA 节点
+     * @return 节点编号，未配置放置时返回 -1
+     */
+    int getNumaNode() const { return numa_node_; }
+    
     /**
      * @brief 获取工作BufferPool ID
      * @return BufferPool的注册表ID
@@ -114,6 +228,14 @@ public:
      */
     uint64_t getWorkingBufferPoolId() const { return working_buffer_pool_id_; }
     
+    /**
+     * @brief 获取流水线最终输出 BufferPool ID
+     * @return 最后一个阶段的输出 Pool ID；未配置阶段时等于 getWorkingBufferPoolId()
+     * 
+     * @note 配置了阶段时，外部消费者应使用此ID（工作 Pool 由第一个阶段消费）
+     */
+    uint64_t getOutputBufferPoolId() const;
+    
     // ========== 错误处理 ==========
     
     /**
@@ -129,6 +251,241 @@ public:
      */
     std::string getLastError() const;
     
+    /**
+     * @brief 自动伸缩统计（getAutoscaleStats() 快照）
+     */
+    struct AutoscaleStats {
+        bool enabled = false;
+        int min_threads = 0;
+        int max_threads = 0;
+        int active_threads = 0;          // 当前活跃生产者数
+        int scale_ups = 0;               // 扩容次数
+        int scale_downs = 0;             // 缩容次数
+        double filled_occupancy = 0.0;   // 最近窗口 filled 队列占用率（0~1）
+        double avg_fill_ms = 0.0;        // 最近窗口平均填充耗时
+        double avg_free_wait_ms = 0.0;   // 最近窗口平均等待空闲 buffer 耗时
+        double fps = 0.0;                // 最近窗口生产帧率
+        std::string last_decision;       // 最近一次决策及原因
+    };
+    
+    // ========== 自动伸缩 ==========
+    
+    /**
+     * @brief 启用生产者自动伸缩（必须在 start() 之前调用）
+     * @param min_threads 最少活跃生产者数（>=1）
+     * @param max_threads 最多活跃生产者数（>=min_threads）
+     * @param interval_ms 评估周期（毫秒）
+     * @return true 如果设置成功；运行中或参数无效返回 false
+     * 
+     * 启动时创建 max_threads 个生产者（执行器模式为任务），
+     * 只有前 N 个活跃，其余挂起；初始 N 为构造函数 thread_count（限制在 [min, max]）。
+     * 构造函数的 thread_count 单独保存，disableAutoscale() 后恢复为固定线程数。
+     * 
+     * 每个周期由生产者线程顺带评估（不额外创建线程）：
+     * - filled 队列占用高或等待空闲 buffer 耗时超过填充耗时：消费者是瓶颈，缩容
+     * - filled 队列占用低：消费者饥饿，扩容；若上次扩容后帧率无提升（锁竞争），回退并暂停扩容
+     * 
+     * 决策通过 getAutoscaleStats()、printStats() 和性能监控指标
+     * （autoscale_up / autoscale_down）暴露，便于按 Worker 类型调整默认值
+     */
+    bool setAutoscale(int min_threads, int max_threads, int interval_ms = 500);
+    
+    /**
+     * @brief 关闭自动伸缩，恢复构造函数指定的生产者线程数（必须在 start() 之前调用）
+     * @return true 如果设置成功；运行中返回 false
+     */
+    bool disableAutoscale();
+    
+    /**
+     * @brief 获取自动伸缩统计
+     */
+    AutoscaleStats getAutoscaleStats() const;
+    
+    // ========== 帧率控制 ==========
+    
+    /**
+     * @brief 按固定帧率放行帧（必须在 start() 之前调用）
+     * @param target_fps 目标帧率（0=不限速，默认）
+     * @return true 如果设置成功；运行中或参数无效返回 false
+     * 
+     * 生产者填充完成后、submitFilled 之前等待到本帧的时间槽：
+     * - 第 N 帧截止时间 = 首帧时间 + N × 周期，clock_nanosleep(TIMER_ABSTIME) 等待，唤醒误差不累积
+     * - 下游阻塞导致落后超过 2 个周期时重新锚定，恢复后不会突发放行
+     * - 每帧延迟计入直方图（getPacingStats() / printStats()）
+     * 
+     * 执行器模式下，距离下一个时间槽较远的任务先挂起，不占用执行器线程
+     */
+    bool setPacing(double target_fps);
+    
+    /**
+     * @brief 按源帧率放行帧（必须在 start() 之前调用）
+     * @return true 如果设置成功；运行中返回 false
+     * 
+     * start() 时从 Worker 获取帧率（FFmpeg 为流的平均帧率）；
+     * 帧率未知（如 Raw 文件）时输出警告并不限速，此时应使用 setPacing() 指定帧率
+     */
+    bool setPacingFromSource();
+    
+    /**
+     * @brief 获取帧率控制统计（未启用时 target_fps 为 0）
+     */
+    FramePacer::Stats getPacingStats() const;
+    
+    // ========== 执行模式 ==========
+    
+    /**
+     * @brief 设置生产者执行模式（必须在 start() 之前调用）
+     * @param mode 执行模式
+     * @param weight 共享执行器中的公平调度权重（>=1，仅 SHARED_EXECUTOR 有效）
+     * @param executor 使用的执行器（nullptr=进程级共享实例）
+     * @return true 如果设置成功；运行中返回 false
+     * 
+     * SHARED_EXECUTOR 模式：
+     * - 不创建生产者线程，每个填充任务生产一帧后重新提交
+     * - 无空闲 buffer 时任务挂起到 BufferPool 的 free eventfd 上，不占用执行器线程
+     * - 多条生产线按权重分享执行器线程（权重 2 的生产线获得约两倍的填充时间）
+     * - CPU 亲和性由执行器线程决定，placement 中只有 NUMA 内存节点生效
+     */
+    bool setExecutionMode(ExecutionMode mode, int weight = 1, WorkStealingExecutor* executor = nullptr);
+    
+    ExecutionMode getExecutionMode() const { return execution_mode_; }
+    
+    // ========== 帧索引分配 ==========
+    
+    /**
+     * @brief 设置帧索引分配模式（必须在 start() 之前调用）
+     * @param mode 分配模式
+     * @param chunk_size CHUNKED 模式每次领取的帧数（0=自适应，默认）
+     * @return true 如果设置成功；运行中或参数无效返回 false
+     * 
+     * CHUNKED 模式：
+     * - 每个生产者一次 fetch_add 领取 [i, i+K) 连续帧，领完再领下一块
+     * - 同一线程的读取保持顺序（mmap / io_uring 预读有效），原子操作减少为 1/K
+     * - 自适应时 K = 工作 Pool 容量 / 活跃生产者数（限制在 [1, 64]），
+     *   使乱序范围不超过 Pool 容量，下游按帧号重排时窗口足够
+     * - 自动伸缩缩容时，生产者先填完已领取的帧再挂起，不丢帧
+     */
+    bool setFrameClaimMode(FrameClaimMode mode, int chunk_size = 0);
+    
+    FrameClaimMode getFrameClaimMode() const { return claim_mode_; }
+    
+    /**
+     * @brief 获取帧索引领取次数（每次领取即一次 next_frame_index_ 原子操作）
+     */
+    uint64_t getFrameClaims() const { return frame_claims_.load(); }
+    
+    // ========== 批量填充 ==========
+    
+    /**
+     * @brief 设置每次填充的最多帧数（必须在 start() 之前调用）
+     * @param batch_size 每个生产者一次获取的空闲 buffer 数（1=逐帧填充，默认；上限 64）
+     * @return true 如果设置成功；运行中或参数无效返回 false
+     * 
+     * batch_size > 1 时：
+     * - 生产者用 BufferPool::acquireFreeBatch 一次取出最多 batch_size 个空闲 buffer（只等待第一个），
+     *   逐个领取帧索引后调用 WorkerBase::fillBuffers 一次填充整批，再按帧索引顺序提交
+     * - Worker 可把一批帧合并为一次预取（mmap）/ 一次提交（io_uring）/ 一次加锁（FFmpeg）
+     * - 与 CHUNKED 帧索引分配配合时同一批帧连续，预取效果最好
+     * - SHARED_EXECUTOR 模式下启用帧率控制时每个任务仍只填充一帧（不在执行器线程内等待多个时间槽）
+     */
+    bool setFillBatchSize(int batch_size);
+    
+    int getFillBatchSize() const { return fill_batch_size_; }
+    
+    // ========== 多阶段流水线 ==========
+    
+    /**
+     * @brief 追加处理阶段（必须在 start() 之前调用）
+     * @param config 阶段配置（处理函数、线程数、输出 Pool 大小）
+     * @return true 如果添加成功；运行中或配置无效返回 false
+     * 
+     * 数据流：生产者 -> 工作 Pool -> 阶段1 -> Pool1 -> ... -> 阶段N -> PoolN -> 消费者
+     * 
+     * - 各阶段通过 acquireFilled / submitFilled 交接，独立调度到不同核心
+     * - stop() 时按顺序排空：生产者 -> 阶段1 -> ... -> 阶段N -> 消费者
+     * - 每个阶段的输出 Pool 在 start() 时创建，stop() 时销毁
+     */
+    bool addStage(const StageConfig& config);
+    
+    /**
+     * @brief 清除所有处理阶段（必须在 start() 之前调用）
+     */
+    void clearStages();
+    
+    /**
+     * @brief 获取各阶段统计（第一个元素为生产者 "source"，其后按阶段顺序）
+     * 
+     * 用于定位瓶颈：busy_ratio 最高的阶段即为瓶颈；
+     * avg_input_wait_ms 大说明上游慢，avg_output_wait_ms 大说明下游慢
+     */
+    std::vector<PipelineStage::Stats> getStageStats() const;
+    
+    // ========== 回调式消费 ==========
+    
+    /**
+     * @brief 注册帧回调（必须在 start() 之前调用）
+     * @param sink 帧回调，每个 filled buffer 按注册顺序依次调用所有回调
+     * @return true 如果注册成功；运行中或 sink 为空返回 false
+     * 
+     * 注册了至少一个回调时，start() 会同时启动消费者线程：
+     * - 生产者和消费者作为同一条流水线调度，isRunning() 在消费者排空后才变为 false
+     * - stop() 先停止生产者，再等待消费者把已填充的 buffer 全部分发完
+     * 
+     * 未注册回调时行为与之前一致（由外部通过 BufferPool::acquireFilled 消费）
+     */
+    bool addFrameSink(FrameCallback sink);
+    
+    /**
+     * @brief 清除所有帧回调（必须在 start() 之前调用）
+     */
+    void clearFrameSinks();
+    
+    /**
+     * @brief 配置消费者线程
+     * @param thread_count 消费者线程数（默认 1）
+     * @param batch_size 每次最多批量取出的 filled buffer 数（默认 1）
+     * @param auto_release 回调返回后是否自动归还 buffer（默认 true）
+     * @return true 如果配置成功；运行中返回 false
+     */
+    bool setConsumerConfig(int thread_count, int batch_size = 1, bool auto_release = true);
+    
+    /**
+     * @brief 手动归还回调中拿到的 buffer（仅 auto_release=false 时使用）
+     * @param buffer 帧回调收到的 buffer
+     * @return true 如果归还成功
+     */
+    bool releaseFrame(Buffer* buffer);
+    
+    /**
+     * @brief 获取已分发给回调的帧数
+     */
+    int getConsumedFrames() const { return consumed_frames_.load(); }
+    
+    // ========== 共享内存输出（跨进程零拷贝）==========
+    
+    /**
+     * @brief 把输出发布到跨进程共享内存 Pool（必须在 start() 之前调用）
+     * @param name 共享内存 Pool 名称（分析进程通过 attachSharedPool(name) 附加；空字符串关闭共享输出）
+     * @param buffer_count Buffer 数量（0=与 Worker 默认 Pool 相同）
+     * @return true 如果配置成功；运行中返回 false
+     * 
+     * 启用后 start() 在 Worker 打开（帧大小确定）之后：
+     * - 创建 SharedMemoryBufferPool，并用包装其 Buffer 的视图 Pool 替换 Worker 的工作 Pool
+     *   （生产者直接填充共享内存，播放列表 / 热重启的新 Worker 同样填充该 Pool）
+     * - 消费者线程在回调之后把帧提交到共享 filled 队列（未注册回调时也启动消费者线程）
+     * - 后台线程把分析进程归还的 Buffer 放回工作 Pool，并回收已退出进程持有的 Buffer
+     * 
+     * @note 仅支持 raw 源（解码 Worker 的 Buffer 绑定本进程 AVFrame），不能与 addStage() 同时使用
+     * @note 没有分析进程消费时生产者在 Buffer 用尽后等待（背压）
+     * @note stop() 时删除共享内存段，已附加的进程看到 Pool 停止
+     */
+    bool setSharedOutput(const std::string& name, int buffer_count = 0);
+    
+    /**
+     * @brief 获取共享内存输出 Pool ID（Registry::getSharedPool()；未启用或未启动返回 0）
+     */
+    uint64_t getSharedOutputPoolId() const { return shared_output_pool_id_; }
+    
     // ========== 调试接口 ==========
     
     /**
@@ -147,6 +504,89 @@ private:
      */
     void producerThreadFunc(int thread_id);
     
+    /**
+     * @brief 单帧填充结果
+     */
+    enum class FillOutcome {
+        PRODUCED,   // 填充成功并提交
+        SKIPPED,    // 填充失败，跳过本帧
+        RESET,      // 循环模式到达 EOF，已重置到开头
+        END         // 非循环模式到达 EOF，生产结束
+    };
+    
+    /**
+     * @brief 调用 Worker 填充 buffer，并提交或归还（线程模式和执行器模式共用）
+     */
+    FillOutcome fillAndSubmit(BufferPool* pool, Buffer* buffer, int frame_index, int thread_id);
+    
+    /**
+     * @brief 调用 Worker 批量填充，并按帧索引顺序提交或归还（fill_batch_size_ > 1 时使用）
+     * @param produced 输出：提交的帧数
+     * @param skipped 输出：填充失败跳过的帧数
+     * @return 整批结果：有帧到达 EOF 时为 RESET / END（之后的 buffer 归还），否则有帧提交为 PRODUCED
+     */
+    FillOutcome fillBatchAndSubmit(BufferPool* pool, WorkerBase::FillRequest* requests, int count, int thread_id,
+                                   int* produced, int* skipped);
+    
+    /**
+     * @brief 按填充结果提交或归还 buffer，到达 EOF 时按循环模式重置或结束
+     */
+    FillOutcome finishFill(BufferPool* pool, Buffer* buffer, int frame_index, bool fill_success, int thread_id);
+    
+    /**
+     * @brief 为已获取的 buffer 逐个领取帧索引，帧源结束时归还多余的 buffer
+     * @return 领取到帧索引的请求数（0 表示帧源已结束）
+     */
+    int claimFillRequests(BufferPool* pool, Buffer** buffers, int acquired, int producer_id,
+                          WorkerBase::FillRequest* requests);
+    
+    /**
+     * @brief 执行器模式的生产任务（生产一帧后重新提交自身）
+     * @param task_id 任务ID
+     * @param parked_since 挂起等待空闲 buffer 的起始时间（未挂起为默认值）
+     */
+    void producerTask(int task_id, std::chrono::steady_clock::time_point parked_since);
+    
+    /**
+     * @brief 生产者线程/任务退出（最后一个退出时通知下游）
+     */
+    void onProducerExit();
+    
+    /**
+     * @brief 标记帧源已结束（唤醒因缩容而挂起的生产者，使其退出）
+     */
+    void markProductionEnded();
+    
+    /**
+     * @brief 到达评估周期时执行一次伸缩评估（生产者线程顺带调用，CAS 保证同一时刻只有一个评估者）
+     */
+    void maybeAutoscale();
+    
+    /**
+     * @brief 挂起因缩容而不活跃的生产者线程，直到重新激活或生产结束
+     * @return true 如果重新激活；false 应退出
+     */
+    bool waitUntilActive(int thread_id);
+    
+    /**
+     * @brief 消费者线程函数
+     * @param thread_id 消费者线程ID
+     * 
+     * 阻塞取第一个 filled buffer，再非阻塞凑满一批，依次分发给所有回调；
+     * 生产者及所有阶段全部退出且输出 filled 队列为空时退出
+     */
+    void consumerThreadFunc(int thread_id);
+    
+    /**
+     * @brief 将一个 buffer 分发给所有回调，并按配置自动归还
+     */
+    void dispatchFrame(BufferPool* pool, Buffer* buffer);
+    
+    /**
+     * @brief 最终输出 Pool 不会再有新帧时调用（生产者及所有阶段均已退出）
+     */
+    void onOutputFinished();
+    
     /**
      * @brief 获取下一个有效的帧索引
      * @return 有效的帧索引，如果无更多帧则返回 std::nullopt
@@ -158,14 +598,176 @@ private:
      * - 处理溢出保护
      * 
      * 注意：这是生产者线程的进度管理逻辑，完全由 ProductionLine 负责
+     * 
+     * @param producer_id 生产者线程/任务ID（CHUNKED 模式下从该生产者已领取的块中取帧）
+     */
+    std::optional<int> getNextFrameIndex(int producer_id);
+    
+    /**
+     * @brief CHUNKED 模式：为生产者领取下一块连续帧
+     * @return true 如果领取成功；非循环模式已无更多帧时返回 false
      */
-    std::optional<int> getNextFrameIndex();
+    bool claimFrameChunk(int producer_id);
+    
+    /**
+     * @brief 当前每次领取的帧数（固定值或按 Pool 容量 / 活跃生产者数自适应）
+     */
+    int currentClaimChunkSize() const;
+    
+    /**
+     * @brief 生产者是否还有已领取但未填充的帧（缩容时先填完再挂起）
+     */
+    bool hasClaimedFrames(int producer_id) const;
+    
+    /**
+     * @brief start() 实现
+     * @param playlist true 表示由 startPlaylist() 调用
+     */
+    bool startInternal(const WorkerConfig& worker_config, bool playlist);
+    
+    /**
+     * @brief 创建并打开 Worker，获取工作 Pool 并记录源几何（start() 前半部分）
+     */
+    bool openSource(const WorkerConfig& worker_config);
+    
+    /**
+     * @brief 重置状态并启动处理阶段、生产者和消费者（start() 后半部分，热重启复用）
+     */
+    bool launch(const WorkerConfig& worker_config);
+    
+    /**
+     * @brief stop() 实现
+     * @param release_source true 销毁 Worker、工作 Pool 和阶段输出 Pool；false 保留（热重启）
+     */
+    void stopInternal(bool release_source);
+    
+    /**
+     * @brief 销毁阶段输出 Pool、预加载、Worker 和工作 Pool（线程均已退出）
+     */
+    void releaseSource();
+    
+    /**
+     * @brief 创建共享内存输出 Pool 和视图 Pool，Worker 改为填充视图 Pool（openSource() 调用）
+     * @param buffer_count Buffer 数量
+     */
+    bool openSharedOutput(int buffer_count);
+    
+    /**
+     * @brief 把已分发的帧提交到共享 filled 队列（元数据随帧写入共享内存）
+     */
+    void publishSharedFrame(Buffer* buffer);
+    
+    /**
+     * @brief 共享输出归还线程：分析进程归还的 Buffer 放回工作 Pool
+     */
+    void sharedReturnThreadFunc();
+    
+    /**
+     * @brief 停止归还线程，销毁视图 Pool 和共享内存 Pool（Worker 已销毁）
+     */
+    void releaseSharedOutput();
+    
+    /**
+     * @brief 检查 Worker 能否复用当前工作 Pool（几何与第一个源一致）
+     * @return 空字符串表示一致，否则为不一致原因
+     */
+    std::string checkSourceGeometry(BufferFillingWorkerFacade* worker) const;
+    
+    /**
+     * @brief 暂停闸门：登记一次在途填充
+     * @return false 如果已暂停（未登记）
+     */
+    bool enterFill();
+    
+    /**
+     * @brief 在途填充结束（暂停中最后一个在途填充结束时唤醒 pause()）
+     */
+    void leaveFill();
+    
+    /**
+     * @brief 挂起暂停中的生产者线程，直到恢复或停止
+     * @return true 如果已恢复；false 应退出
+     */
+    bool waitWhilePaused();
+    
+    /**
+     * @brief 本轮累计暂停时长（含正在进行的暂停）
+     */
+    int64_t pausedUs() const;
+    
+    /**
+     * @brief 当前源是否按帧循环（播放列表模式下循环作用于整个列表）
+     */
+    bool loopsSource() const { return loop_ && !playlist_mode_; }
+    
+    /**
+     * @brief 播放列表模式：获取填充期间的源共享锁（切换源时生产者让路）
+     * @return 非播放列表模式返回不持有锁的空对象
+     */
+    std::shared_lock<std::shared_mutex> lockSourceForFill();
+    
+    /**
+     * @brief 当前源结束时切换到播放列表下一项
+     * @param generation 生产者领取帧索引时的源代数
+     * @return true 如果已切换（或已被其他生产者切换）；false 播放列表已结束
+     */
+    bool advancePlaylist(int generation);
+    
+    /**
+     * @brief 预加载结果（后台线程写入，done 置位（playlist_mutex_ 保护）之后读取）
+     */
+    struct PreloadedSource {
+        size_t index = 0;                                   // 播放列表索引
+        std::shared_ptr<BufferFillingWorkerFacade> worker;
+        std::vector<Buffer*> preroll;                       // 已预填充的工作 Pool buffer（按帧顺序）
+        bool ok = false;
+        bool done = false;                                  // 预加载已结束（成功或失败），完成时通知 playlist_cv_
+        std::string error;
+    };
+    
+    /**
+     * @brief 在后台启动下一项的预加载（调用方持有 playlist_mutex_）
+     * @param from 从该索引之后查找下一项
+     * @return false 如果没有下一项
+     */
+    bool startPreloadLocked(size_t from);
+    
+    /**
+     * @brief 预加载线程函数：执行 preloadSource()，结束时置位 done 并通知 playlist_cv_
+     */
+    void preloadThreadFunc(std::shared_ptr<PreloadedSource> result, WorkerConfig config);
+    
+    /**
+     * @brief 打开下一项（Worker 直接使用工作 Pool）并预填充首帧
+     */
+    void preloadSource(PreloadedSource* result, const WorkerConfig& config);
+    
+    /**
+     * @brief 回收预加载线程，归还未使用的预填充 buffer
+     */
+    void cancelPreload();
     
     /**
      * @brief 设置错误信息并触发回调
      */
     void setError(const std::string& error_msg);
     
+    /**
+     * @brief 根据 WorkerConfig::placement 解析生产者 CPU 集合和内存节点
+     * 
+     * 规则：
+     * - cpu_affinity 非空：使用指定 CPU；未指定 numa_node 时取第一个 CPU 所在节点
+     * - cpu_affinity 为空且 numa_node >= 0：使用该节点的全部 CPU
+     * - 都未配置：不做任何放置
+     */
+    void resolvePlacement(const WorkerConfig::PlacementConfig& placement);
+    
+    /**
+     * @brief 在生产者线程内应用放置策略（CPU 亲和性 + 内存策略）
+     * @param thread_id 线程ID
+     */
+    void applyThreadPlacement(int thread_id);
+    
     // ========== 成员变量 ==========
     
     /**
@@ -192,26 +794,142 @@ private:
      */
     std::weak_ptr<BufferPool> working_buffer_pool_weak_;
     
-    // Worker Facade（多线程共享）
+    // 最终输出 Pool（最后一个阶段的输出；无阶段时等于工作 Pool）
+    std::weak_ptr<BufferPool> output_buffer_pool_weak_;
+    
+    // 处理阶段（start() 之后只读）
+    std::vector<std::unique_ptr<PipelineStage>> stages_;
+    
+    // Worker Facade（多线程共享；播放列表模式下在 source_switch_mutex_ 独占时替换）
     std::shared_ptr<BufferFillingWorkerFacade> worker_facade_sptr_;
     
+    // 播放列表（无缝切换）
+    bool playlist_mode_;                         // startPlaylist() 启动（start() 之后只读）
+    std::vector<WorkerConfig> playlist_;         // playlist_mutex_ 保护
+    size_t playlist_index_;                      // 当前播放项（playlist_mutex_ 保护）
+    mutable std::mutex playlist_mutex_;
+    std::condition_variable playlist_cv_;        // 切换完成 / 预加载结束时唤醒等待者
+    std::shared_mutex source_switch_mutex_;      // 生产者填充时共享持有，切换源时独占
+    std::atomic<bool> source_switching_;         // 切换进行中（新的填充先等待，避免切换方饥饿）
+    std::atomic<int> playlist_generation_;       // 源代数（每次切换 +1）
+    std::thread preload_thread_;                 // playlist_mutex_ 保护
+    std::shared_ptr<PreloadedSource> preloaded_; // 正在预加载 / 已预加载的下一项（playlist_mutex_ 保护）
+    std::shared_ptr<BufferFillingWorkerFacade> pool_owner_facade_sptr_;  // 工作 Pool 的创建者（保持到 stop()）
+    int source_width_;                           // 第一项几何（后续项必须一致）
+    int source_height_;
+    size_t source_frame_size_;
+    bool source_uses_avframe_;                   // 工作 Pool 的 buffer 是否绑定 AVFrame
+    std::atomic<int> playlist_switches_;
+    std::atomic<int64_t> playlist_max_switch_us_;   // 单次切换最长耗时（持有独占锁的时间）
+    
+    // 暂停 / 热重启
+    WorkerConfig worker_config_;                 // 当前源配置（热重启时比较）
+    std::atomic<bool> paused_;
+    std::atomic<int> fills_in_flight_;           // 已通过暂停闸门、尚未结束的填充数
+    std::mutex pause_mutex_;
+    std::condition_variable pause_cv_;           // 恢复 / 在途填充归零时唤醒
+    std::atomic<int64_t> pause_started_us_;      // 本次暂停开始时间（相对 start_time_）
+    std::atomic<int64_t> paused_us_;             // 本轮已结束暂停的累计时长
+    int warm_restarts_;                          // 热重启次数（控制线程读写）
+    
     // 线程管理
     std::vector<std::thread> threads_;
     std::atomic<bool> running_;
     std::atomic<int> active_threads_;    // 活跃线程计数
     std::mutex threads_mutex_;            // 保护线程相关操作
     
+    // 执行模式（共享执行器）
+    ExecutionMode execution_mode_;
+    int executor_weight_;
+    WorkStealingExecutor* executor_;      // 不持有（默认为进程级共享实例）
+    uint64_t executor_group_id_;          // 本生产线在执行器中的分组（0=未注册）
+    std::mutex producer_exit_mutex_;
+    std::condition_variable producer_exit_cv_;
+    bool producers_exited_;               // 生产者全部退出（producer_exit_mutex_ 保护）
+    
+    // 自动伸缩
+    bool autoscale_enabled_;
+    int autoscale_min_;
+    int autoscale_max_;
+    int autoscale_initial_;               // 启动时活跃生产者数
+    int autoscale_interval_ms_;
+    std::atomic<int> target_threads_;     // 当前活跃生产者数（thread_id < target 的生产者工作）
+    std::atomic<bool> production_ended_;  // 帧源已结束（挂起的生产者直接退出）
+    std::atomic<int64_t> next_autoscale_us_;   // 下次评估时间（相对 start_time_）
+    std::mutex autoscale_mutex_;
+    std::condition_variable autoscale_cv_;
+    mutable std::mutex autoscale_stats_mutex_;  // 保护 autoscale_stats_ 和以下窗口快照
+    AutoscaleStats autoscale_stats_;
+    int64_t autoscale_window_start_us_;
+    int autoscale_last_frames_;
+    uint64_t autoscale_last_fill_us_;
+    uint64_t autoscale_last_wait_us_;
+    double autoscale_last_up_fps_;        // 上次扩容前的帧率（<0 表示上次不是扩容）
+    int64_t autoscale_up_blocked_until_us_;  // 扩容冷却截止时间
+    
+    // 帧率控制
+    double pacing_fps_;                   // setPacing() 指定的帧率（0=不限速）
+    bool pacing_from_source_;             // start() 时使用 Worker 帧率
+    std::unique_ptr<FramePacer> pacer_;   // start() 时创建（不限速时为空）
+    
+    // 帧索引分配（CHUNKED 模式）
+    struct alignas(64) ClaimCursor {      // 每个生产者独占一条缓存行，只由该生产者读写
+        int next = 0;                     // 下一个待填充的原始索引
+        int end = 0;                      // 已领取块的结束位置（不含）
+    };
+    FrameClaimMode claim_mode_;
+    int claim_chunk_size_;                // 固定块大小（0=自适应）
+    int reorder_window_;                  // 工作 Pool 容量（start() 时获取，自适应块大小的上限）
+    std::vector<ClaimCursor> claim_cursors_;   // 按生产者ID索引
+    std::atomic<uint64_t> frame_claims_;  // next_frame_index_ 原子操作次数
+    
+    // 批量填充
+    int fill_batch_size_;                 // 每次获取 / 填充的最多帧数（1=逐帧）
+    std::atomic<uint64_t> fill_batches_;  // fillBuffers 调用次数
+    
+    // 消费者（回调式消费）
+    std::vector<FrameCallback> frame_sinks_;      // 帧回调（start() 之后只读）
+    std::vector<std::thread> consumer_threads_;
+    int consumer_thread_count_;                   // 消费者线程数
+    int consumer_batch_size_;                     // 每批最多取出的 buffer 数
+    bool auto_release_;                           // 回调返回后自动归还
+    std::atomic<int> active_consumers_;           // 活跃消费者线程计数
+    std::atomic<bool> producers_done_;            // 生产者已全部退出
+    std::atomic<bool> output_done_;               // 最终输出 Pool 不会再有新帧
+    std::atomic<int> consumed_frames_;            // 已分发给回调的帧数
+    
+    // 共享内存输出
+    std::string shared_output_name_;              // setSharedOutput() 名称（空=不启用）
+    int shared_output_count_;                     // Buffer 数量（0=与 Worker 默认 Pool 相同）
+    uint64_t shared_output_pool_id_;              // Registry 中的 SharedMemoryBufferPool（0=未创建）
+    std::weak_ptr<SharedMemoryBufferPool> shared_output_pool_weak_;
+    std::unique_ptr<BufferAllocatorFacade> shared_view_facade_;  // 包装共享内存 Buffer 的工作 Pool（FRAMEBUFFER）
+    std::vector<Buffer*> shared_view_buffers_;    // 视图 Buffer，按共享内存 Buffer ID 索引（ID 一致）
+    std::thread shared_return_thread_;
+    std::atomic<bool> shared_return_running_;
+    
     // 统计信息
     std::atomic<int> produced_frames_;
     std::atomic<int> skipped_frames_;
     std::atomic<int> next_frame_index_;  // 下一个要读取的帧索引（原子递增）
+    std::atomic<uint64_t> fill_time_us_;  // 生产者填充总耗时（阶段统计）
+    std::atomic<uint64_t> free_wait_us_;  // 生产者等待空闲 buffer 总耗时（阶段统计）
+    std::atomic<int64_t> producer_elapsed_us_;  // 生产者运行时长（全部退出时记录，0=仍在运行）
     
     // 配置（存储启动时的参数）
     bool loop_;                          // 是否循环播放
-    int thread_count_;                   // 生产者线程数
+    int thread_count_;                   // 生产者线程数（自动伸缩时为 max_threads）
+    int configured_thread_count_;        // 构造函数指定的生产者线程数（自动伸缩的初始值，关闭时恢复）
     int total_frames_;                   // 总帧数
     bool enable_monitor_;                // 是否启用性能监控
     
+    // 放置（CPU 亲和性 / NUMA）
+    int numa_node_;                      // 内存和线程所在节点（-1=不限制）
+    std::vector<int> producer_cpus_;     // 生产者线程可用 CPU（空=不限制）
+    bool pin_per_thread_;                // 每个线程独占一个 CPU
+    std::vector<int> thread_cpus_;       // 每个线程启动时实际所在 CPU（用于统计）
+    mutable std::mutex placement_mutex_; // 保护 thread_cpus_
+    
     // 错误处理
     ErrorCallback error_callback_;
     mutable std::mutex error_mutex_;
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "buffer/bufferpool/Buffer.hpp"
+#include "productionline/io/RawFrameFile.hpp"
 #include <atomic>
 #include <cstdio>
+#include <memory>
 #include <string>
+#include <vector>
 
 // FFmpeg标准格式定义
 extern "C" {
@@ -18,7 +21,9 @@ namespace io {
  * 
  * 设计原则：
  * - 使用FFmpeg标准格式定义（AVPixelFormat）
- * - 只保存裸YUV/RGB数据（无容器格式）
+ * - 默认只保存裸YUV/RGB数据（无容器格式）
+ * - openIndexed() 输出 RawFrameFile 容器（文件头记录格式和 plane 布局，帧按 4 KiB 对齐），
+ *   raw Worker 可直接 open(path) 播放
  * - 接口极简化（open/close/write）
  * - 原子计数器（线程安全）
  * 
@@ -104,6 +109,25 @@ public:
               int width, 
               int height);
     
+    /**
+     * @brief 打开输出文件（RawFrameFile 容器格式）
+     * 
+     * @param path 文件路径（写入期间使用临时文件，close() 时 rename 到 path）
+     * @param format 像素格式（同 open()）
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param frame_rate 帧率（写入文件头，0=未知）
+     * @return true 成功，false 失败
+     * 
+     * @note 帧数据与 open() 输出相同（去除 stride），每帧从 4 KiB 边界开始，可用 O_DIRECT 读取
+     * @note 未写入任何帧就 close() 时不生成文件
+     */
+    bool openIndexed(const char* path,
+                     AVPixelFormat format,
+                     int width,
+                     int height,
+                     double frame_rate = 0.0);
+    
     /**
      * @brief 写入Buffer
      * 
@@ -141,11 +165,13 @@ public:
      * @brief 检查文件是否已打开
      * @return true 如果文件已打开，否则返回 false
      */
-    bool isOpen() const { return file_ != nullptr; }
+    bool isOpen() const { return file_ != nullptr || indexed_writer_uptr_ != nullptr; }
 
 private:
     // ============ 核心成员 ============
-    FILE* file_;                     // 文件句柄
+    FILE* file_;                     // 文件句柄（裸数据模式）
+    std::unique_ptr<RawFrameFileWriter> indexed_writer_uptr_;  // RawFrameFile 模式
+    std::vector<uint8_t> frame_scratch_;                      // RawFrameFile 模式：当前帧（去除 stride 后）
     AVPixelFormat format_;           // 像素格式（FFmpeg标准）
     int width_;                      // 图像宽度
     int height_;                     // 图像高度
@@ -167,6 +193,16 @@ private:
      */
     static bool isSupportedFormat(AVPixelFormat format);
     
+    /**
+     * @brief 校验 open()/openIndexed() 的参数
+     */
+    static bool checkOpenParams(const char* path, AVPixelFormat format, int width, int height);
+    
+    /**
+     * @brief 输出数据（裸数据模式写文件，RawFrameFile 模式追加到当前帧）
+     */
+    bool emit(const void* data, size_t size);
+    
     /**
      * @brief 计算帧大小
      * @param format 像素格式
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace productionline {
+namespace io {
+
+/**
+ * @brief CompressedSample - 映射文件中的一个压缩帧（H.264 访问单元 / MP4 sample）
+ *
+ * 只记录文件内的位置，数据由读者直接从 mmap 区域取用（零拷贝送入解码器）。
+ */
+struct CompressedSample {
+    uint64_t offset = 0;        // 文件偏移
+    uint32_t size = 0;          // 字节数
+    bool keyframe = false;      // 可独立解码（IDR / 同步 sample），用于随机访问
+};
+
+} // namespace io
+} // namespace productionline
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <liburing.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct AVIOContext;
+
+namespace productionline {
+namespace io {
+
+/**
+ * @brief FileAVIOContext - 为 libavformat 提供文件读取的自定义 AVIOContext
+ *
+ * FFmpeg 默认的 file 协议在解码线程上做小块同步 read()（每次一个 AVIO 缓冲区）。
+ * 本类的 read / seek 回调改由以下两种后端之一提供：
+ * - MMAP：整个文件只读映射，回调是一次 memcpy；每前进半个预读窗口做一次 madvise(WILLNEED)，
+ *   由内核在后台把窗口内的页读入
+ * - IO_URING：预读窗口均分为 depth 个块，以 io_uring 保持 depth 个块在途；
+ *   回调只在当前块尚未读完时等待，解复用读取与解码重叠
+ *
+ * 使用方式：
+ * ```cpp
+ * FileAVIOContext io;
+ * if (io.open("video.mp4", FileAVIOContext::Mode::IO_URING, 4 << 20, 4)) {
+ *     format_ctx->pb = io.get();
+ *     format_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+ *     avformat_open_input(&format_ctx, "video.mp4", nullptr, nullptr);
+ * }
+ * // avformat_close_input() 之后再 io.close()（CUSTOM_IO 模式下 FFmpeg 不释放 pb）
+ * ```
+ *
+ * @note 非线程安全，回调由持有 AVFormatContext 的线程串行调用
+ */
+class FileAVIOContext {
+public:
+    enum class Mode {
+        MMAP,       // 映射整个文件
+        IO_URING    // io_uring 预读块环
+    };
+
+    static constexpr size_t kAvioBufferSize = 256 * 1024;   // AVIO 内部缓冲区（FFmpeg 默认 32 KiB）
+    static constexpr size_t kMinBlockSize = 64 * 1024;      // IO_URING 单块最小字节数
+
+    FileAVIOContext();
+    ~FileAVIOContext();
+
+    FileAVIOContext(const FileAVIOContext&) = delete;
+    FileAVIOContext& operator=(const FileAVIOContext&) = delete;
+
+    /**
+     * @brief 打开文件并创建 AVIOContext
+     * @param path 文件路径（必须是普通文件）
+     * @param mode 读取后端
+     * @param window_bytes 预读窗口字节数（0=MMAP 不做 madvise；IO_URING 使用 depth * kMinBlockSize）
+     * @param depth IO_URING 在途块数（限制在 [2, 64]；MMAP 忽略）
+     * @return true 如果成功
+     */
+    bool open(const char* path, Mode mode, size_t window_bytes, int depth);
+
+    /**
+     * @brief 释放 AVIOContext、等待在途读取并关闭文件
+     */
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+    AVIOContext* get() const { return avio_ctx_ptr_; }
+    Mode getMode() const { return mode_; }
+
+    /**
+     * @brief 统计：read 回调次数 / 读取相关系统调用次数（io_uring_submit、io_uring_wait_cqe 或 madvise）
+     */
+    uint64_t getReadCallbackCount() const { return read_callbacks_; }
+    uint64_t getSyscallCount() const { return syscalls_; }
+
+private:
+    struct Block {
+        uint8_t* data = nullptr;
+        uint64_t index = 0;        // 文件块号（文件偏移 / block_size_）
+        size_t length = 0;         // 块内有效字节（文件末尾的块较短）
+        size_t filled = 0;         // 已读入字节
+        bool valid = false;        // 已分配给 index
+        bool pending = false;      // 有在途读取
+        int error = 0;             // errno（0=成功）
+    };
+
+    static int readPacket(void* opaque, uint8_t* buf, int size);
+    static int64_t seekPacket(void* opaque, int64_t offset, int whence);
+
+    int readMapped(uint8_t* buf, int size);
+    int readRing(uint8_t* buf, int size);
+    int64_t seek(int64_t offset, int whence);
+
+    bool openMapped();
+    bool openRing(size_t window_bytes, int depth);
+
+    Block& slotFor(uint64_t index) { return blocks_[index % blocks_.size()]; }
+    bool queueBlock(uint64_t index);
+    bool queueRead(Block* block);
+    bool submitQueued();
+    bool reapOne();                  // 等待一个完成事件（false=io_uring 本身出错）
+    bool waitBlock(Block* block);    // 等待该块的在途读取结束（读取结果见 block->error）
+
+    int fd_;
+    std::string path_;
+    Mode mode_;
+    uint64_t file_size_;
+    uint64_t pos_;
+    AVIOContext* avio_ctx_ptr_;
+
+    // MMAP
+    const uint8_t* map_ptr_;
+    size_t window_bytes_;
+    uint64_t advised_begin_;
+    uint64_t advised_end_;
+
+    // IO_URING
+    struct io_uring ring_;
+    bool ring_ready_;
+    size_t block_size_;
+    std::vector<uint8_t> block_memory_;
+    std::vector<Block> blocks_;
+    int queued_;               // 已准备未提交的 SQE
+    int in_flight_;            // 已提交未完成的读取
+
+    // 统计
+    uint64_t read_callbacks_;
+    uint64_t syscalls_;
+};
+
+} // namespace io
+} // namespace productionline
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "productionline/io/RawFrameFile.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace productionline {
+namespace io {
+
+/**
+ * @brief FrameCrop - raw 帧的感兴趣区域（ROI）裁剪布局
+ *
+ * 由源帧布局（RawFrameFileInfo：几何、像素格式、plane 布局）和 ROI（x, y, w, h）计算：
+ * - 裁剪后的紧凑布局（与 RawFrameFile::setImageLayout 一致，可直接设置 Buffer 图像元数据）
+ * - 每个 plane 需要拷贝 / 读取的行区间（源偏移、源行跨度、每行字节数、行数）
+ *
+ * 色度 plane 按像素格式的子采样缩小（如 NV12 的 UV plane 行数和列偏移减半），
+ * 因此 x / y 会向下对齐到色度采样边界（4:2:0 为偶数）。
+ *
+ * 像素格式未知的裸帧（plane_count=0）按 bits_per_pixel 视为单个 packed plane，
+ * 要求 bits_per_pixel 是 8 的倍数；裁剪后的布局同样没有像素格式。
+ *
+ * 使用方式：
+ * ```cpp
+ * FrameCrop crop;
+ * if (crop.configure(source_info, 640, 360, 1280, 720)) {
+ *     crop.copy(mapped_frame, buffer_data);                 // 按行拷贝 ROI
+ *     const RawFrameFileInfo& out = crop.getLayout();      // 1280x720 的 plane 布局
+ * }
+ * ```
+ */
+class FrameCrop {
+public:
+    /**
+     * @brief 单个 plane 的 ROI 行区间
+     */
+    struct Plane {
+        size_t src_offset = 0;     // ROI 首行相对源帧起始的偏移（plane 偏移 + 行偏移 + 列偏移）
+        size_t src_stride = 0;     // 源行跨度
+        size_t x_bytes = 0;        // 列偏移（字节）
+        int y = 0;                 // 首行行号（plane 内）
+        size_t dst_offset = 0;     // 目标 plane 偏移
+        size_t row_bytes = 0;      // 每行字节数（= 目标 linesize）
+        int rows = 0;
+    };
+
+    FrameCrop();
+
+    /**
+     * @brief 计算裁剪布局
+     * @param source 源帧布局（width / height / pixel_format / plane 布局；plane_count=0 时使用 bits_per_pixel）
+     * @param x, y ROI 左上角（向下对齐到色度采样边界）
+     * @param width, height ROI 尺寸（超出图像时截断到图像边缘）
+     * @return false 如果 ROI 为空、完全在图像外或像素格式不支持按行裁剪
+     */
+    bool configure(const RawFrameFileInfo& source, int x, int y, int width, int height);
+
+    void reset();
+
+    bool isEnabled() const { return enabled_; }
+
+    /**
+     * @brief 裁剪后的布局（width / height / pixel_format / plane 布局 / frame_size）
+     */
+    const RawFrameFileInfo& getLayout() const { return layout_; }
+
+    int getPlaneCount() const { return plane_count_; }
+    const Plane& getPlane(int index) const { return planes_[index]; }
+
+    /**
+     * @brief 从源布局的整帧（如映射区）拷贝 ROI 到紧凑的目标缓冲区
+     */
+    void copy(const uint8_t* frame, uint8_t* dst) const;
+
+    /**
+     * @brief 从分离的 plane（如解码后的 AVFrame）拷贝 ROI
+     * @param src_planes 各 plane 起始地址
+     * @param src_linesize 各 plane 行跨度
+     */
+    void copy(const uint8_t* const src_planes[4], const int src_linesize[4], uint8_t* dst) const;
+
+private:
+    bool enabled_;
+    RawFrameFileInfo layout_;
+    Plane planes_[4];
+    int plane_count_;
+};
+
+} // namespace io
+} // namespace productionline
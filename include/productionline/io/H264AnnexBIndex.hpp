@@ -0,0 +1,63 @@
+#pragma once
+
+#include "productionline/io/CompressedSample.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace productionline {
+namespace io {
+
+/**
+ * @brief H264AnnexBIndex - H.264 Annex-B 裸流的访问单元索引
+ *
+ * 在 open() 时扫描一次整个映射区（起始码查找使用 SSE2 / NEON），
+ * 按 H.264 7.4.1.2.3 的规则把 NAL 单元分组为访问单元（一帧），记录每帧的文件偏移、
+ * 长度和是否为 IDR。之后：
+ * - 送解码器的 AVPacket 直接引用映射区，不经过 libavformat
+ * - 随机访问是一次表查找（最近的 IDR 之前的帧无需读取）
+ *
+ * 使用方式：
+ * ```cpp
+ * H264AnnexBIndex index;
+ * if (index.build(mapped, file_size)) {
+ *     const auto& samples = index.getSamples();   // samples[i] = 第 i 帧（解码顺序），keyframe = IDR
+ * }
+ * ```
+ *
+ * @note 只处理逐帧编码的码流（场编码的两场会各自成为一个访问单元）
+ */
+class H264AnnexBIndex {
+public:
+    H264AnnexBIndex();
+
+    /**
+     * @brief 扫描 Annex-B 码流并建立访问单元索引
+     * @param data 码流起始地址（通常为 mmap 区域）
+     * @param size 码流字节数
+     * @return true 如果至少找到一个包含图像数据（VCL NAL）的访问单元
+     */
+    bool build(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 访问单元列表（解码顺序）
+     */
+    const std::vector<CompressedSample>& getSamples() const { return samples_; }
+
+    int getNalCount() const { return nal_count_; }
+    int getKeyframeCount() const { return keyframe_count_; }
+
+    /**
+     * @brief 查找下一个起始码（00 00 01）
+     * @return 起始码第一个字节的地址，找不到时返回 end
+     */
+    static const uint8_t* findStartCode(const uint8_t* p, const uint8_t* end);
+
+private:
+    std::vector<CompressedSample> samples_;
+    int nal_count_;
+    int keyframe_count_;
+};
+
+} // namespace io
+} // namespace productionline
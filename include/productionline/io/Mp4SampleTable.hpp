@@ -0,0 +1,80 @@
+#pragma once
+
+#include "productionline/io/CompressedSample.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace productionline {
+namespace io {
+
+/**
+ * @brief Mp4SampleTable - 从映射的 MP4 文件中解析第一条视频轨的 sample 表
+ *
+ * 只解析定位 sample 所需的 box（moov/trak/mdia/minf/stbl：stsd、stsz、stsc、stco/co64、stss、stts），
+ * 不做 avformat_find_stream_info 式的探测解码。结果：
+ * - 每个 sample 的文件偏移、长度和是否为同步 sample（关键帧）
+ * - 解码器 extradata（avcC / hvcC）
+ * - 帧率（stts 总时长 / mdhd timescale）
+ *
+ * sample 数据（长度前缀的 NAL）可直接从映射区送入解码器，关键帧 seek 是一次表查找。
+ *
+ * 使用方式：
+ * ```cpp
+ * Mp4SampleTable table;
+ * if (table.parse(mapped, file_size)) {
+ *     const auto& samples = table.getSamples();       // 解码顺序
+ *     const auto& extradata = table.getExtradata();   // 送 AVCodecContext::extradata
+ * }
+ * ```
+ *
+ * @note 不支持分片 MP4（moof）和多个 sample description；忽略 edit list
+ */
+class Mp4SampleTable {
+public:
+    enum class Codec {
+        UNKNOWN,
+        H264,       // avc1 / avc3
+        HEVC        // hvc1 / hev1
+    };
+
+    Mp4SampleTable();
+
+    /**
+     * @brief 解析 MP4 box 结构并建立 sample 表
+     * @param data 文件起始地址（通常为 mmap 区域）
+     * @param size 文件字节数
+     * @return true 如果找到可解码的视频轨且所有 sample 位于文件内
+     */
+    bool parse(const uint8_t* data, size_t size);
+
+    const std::vector<CompressedSample>& getSamples() const { return samples_; }
+    const std::vector<uint8_t>& getExtradata() const { return extradata_; }
+    Codec getCodec() const { return codec_; }
+    const std::string& getCodecTag() const { return codec_tag_; }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int getKeyframeCount() const { return keyframe_count_; }
+    double getFrameRate() const { return frame_rate_; }
+
+private:
+    struct Track;
+
+    bool parseTrak(const uint8_t* p, const uint8_t* end, Track* track);
+    bool parseStbl(const uint8_t* p, const uint8_t* end, Track* track);
+    bool parseStsd(const uint8_t* p, const uint8_t* end, Track* track);
+    bool buildSamples(const Track& track, size_t file_size);
+
+    std::vector<CompressedSample> samples_;
+    std::vector<uint8_t> extradata_;
+    Codec codec_;
+    std::string codec_tag_;
+    int width_;
+    int height_;
+    int keyframe_count_;
+    double frame_rate_;
+};
+
+} // namespace io
+} // namespace productionline
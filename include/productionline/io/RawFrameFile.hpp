@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace productionline {
+namespace io {
+
+/**
+ * @brief RawFrameFile - 自描述带索引的 raw 帧文件（容器格式）
+ *
+ * 用途：
+ * - 解码一次的 raw 缓存文件（WorkerConfig::cache.spill_path）：FFmpeg Worker 第一遍解码时写入，
+ *   之后的运行由 MmapRawVideoFileWorker 直接映射，不再探测和解码
+ * - raw 录制 / 素材文件（BufferWriter::openIndexed）：raw Worker 用 open(path) 打开，
+ *   不需要额外传入 width / height / bpp
+ *
+ * 文件布局（小端）：
+ * @code
+ * [0, 256)              Header（magic "RAWVIDX1"、几何、像素格式、plane 布局、帧数、源文件校验信息）
+ * [data_offset, ...)    帧数据（每帧内 plane 紧凑排列；frame_alignment=4096 时每帧从页边界开始）
+ * [index_offset, ...)   帧索引（frame_count 个 uint64_t 文件偏移）
+ * @endcode
+ *
+ * 特点：
+ * - 帧数据从页对齐偏移开始，读者可直接 mmap
+ * - 帧按页对齐时，读者可用 O_DIRECT 直接读入页对齐的 Buffer（绕过页缓存）
+ * - 索引位于文件末尾：写入时不需要预知帧数
+ * - Header 最后写入，写入中断的文件没有有效 magic（且写入时使用临时文件名，完成后 rename）
+ */
+struct RawFrameFileInfo {
+    int width = 0;
+    int height = 0;
+    int pixel_format = -1;                 // AVPixelFormat
+    int bits_per_pixel = 0;                // 平均每像素位数（frame_size * 8 / (width * height)）
+    int frame_count = 0;
+    size_t frame_size = 0;                 // 单帧字节数（不含对齐填充）
+    double frame_rate = 0.0;               // 源帧率（0=未知）
+    std::vector<uint64_t> frame_offsets;   // 每帧文件偏移
+
+    // plane 布局（帧内偏移，与 Buffer::setImageMetadata 对应；plane_count=0 表示未知布局）
+    int plane_count = 0;
+    int linesize[4] = {0, 0, 0, 0};
+    size_t plane_offset[4] = {0, 0, 0, 0};
+    size_t frame_alignment = 1;            // 帧起始偏移对齐（1=紧凑，4096=页对齐，可用 O_DIRECT 读取）
+
+    // 源文件校验信息（判断缓存是否过期）
+    uint64_t source_size = 0;
+    int64_t source_mtime_ns = 0;
+    uint64_t source_fingerprint = 0;       // 影响输出的配置指纹（解码器、输出格式等）
+};
+
+class RawFrameFile {
+public:
+    static constexpr char kMagic[8] = {'R', 'A', 'W', 'V', 'I', 'D', 'X', '1'};
+    static constexpr uint32_t kVersion = 2;
+    static constexpr size_t kHeaderSize = 256;
+    static constexpr size_t kDataAlignment = 4096;
+
+    /**
+     * @brief 检查文件头是否为 RawFrameFile magic
+     * @param header 文件开头的字节
+     * @param size header 长度
+     */
+    static bool hasMagic(const unsigned char* header, size_t size);
+
+    /**
+     * @brief 检查文件是否为 RawFrameFile（只读取 magic，不校验索引）
+     */
+    static bool isRawFrameFile(const char* path);
+
+    /**
+     * @brief 按 width / height / pixel_format 计算紧凑 plane 布局
+     *
+     * 填充 plane_count、linesize、plane_offset、frame_size 和 bits_per_pixel，
+     * 布局与 av_image_copy_to_buffer(align=1) 的输出一致。
+     *
+     * @return false 如果像素格式未知或不是 CPU 可访问的格式
+     */
+    static bool setImageLayout(RawFrameFileInfo* info);
+
+    /**
+     * @brief 把分离的 plane（如解码后的 AVFrame）拷贝为 setImageLayout() 的紧凑布局
+     *
+     * 逐 plane 用 FrameCopy 按行拷贝（去掉 linesize 对齐填充，大帧使用流式存储）。
+     *
+     * @param layout setImageLayout() 计算的布局
+     * @param src_planes 各 plane 起始地址
+     * @param src_linesize 各 plane 行跨度（不小于 layout 中的 linesize）
+     * @param dst 目标缓冲区（至少 layout.frame_size 字节）
+     * @return false 如果布局未知、源 plane 缺失或行跨度不足
+     */
+    static bool copyPlanes(const RawFrameFileInfo& layout, const uint8_t* const src_planes[4],
+                           const int src_linesize[4], uint8_t* dst);
+
+    /**
+     * @brief 读取并校验 Header 和帧索引
+     * @param fd 已打开的文件描述符（使用 pread，不改变文件位置）
+     * @param info 输出：文件信息
+     * @return true 如果文件完整有效
+     */
+    static bool readInfo(int fd, RawFrameFileInfo* info);
+
+    /**
+     * @brief 读取并校验 Header 和帧索引
+     * @param path 文件路径
+     * @param info 输出：文件信息
+     */
+    static bool readInfo(const char* path, RawFrameFileInfo* info);
+
+    /**
+     * @brief 获取源文件大小和修改时间（写入 / 校验缓存使用）
+     */
+    static bool statSource(const char* path, uint64_t* size, int64_t* mtime_ns);
+
+    /**
+     * @brief 计算配置指纹（FNV-1a 64，跨进程稳定）
+     */
+    static uint64_t fingerprint(const std::string& key);
+};
+
+/**
+ * @brief RawFrameFileWriter - 顺序写入 RawFrameFile
+ *
+ * 使用方式：
+ * ```cpp
+ * RawFrameFileInfo info;      // width / height / pixel_format / 源校验信息
+ * RawFrameFile::setImageLayout(&info);     // plane 布局和 frame_size
+ * info.frame_alignment = RawFrameFile::kDataAlignment;   // 可选：帧按页对齐
+ * RawFrameFileWriter writer;
+ * writer.open("clip.rawvid", info);
+ * writer.writeFrame(data);     // 每帧一次
+ * writer.finish();             // 写入索引和 Header，原子 rename 到最终路径
+ * ```
+ *
+ * @note 非线程安全，由调用方串行调用
+ * @note 未 finish() 就销毁时自动 abort()（删除临时文件）
+ */
+class RawFrameFileWriter {
+public:
+    RawFrameFileWriter();
+    ~RawFrameFileWriter();
+
+    RawFrameFileWriter(const RawFrameFileWriter&) = delete;
+    RawFrameFileWriter& operator=(const RawFrameFileWriter&) = delete;
+
+    /**
+     * @brief 创建临时文件并预留 Header
+     * @param path 最终文件路径（写入期间使用唯一的临时文件 path.tmp.XXXXXX）
+     * @param source 几何、像素格式、plane 布局、帧大小、帧对齐和源校验信息（frame_count / frame_offsets 忽略）
+     * @note frame_alignment 必须是 2 的幂且不超过 kDataAlignment
+     */
+    bool open(const char* path, const RawFrameFileInfo& source);
+
+    /**
+     * @brief 追加一帧（frame_size 字节，按 frame_alignment 在帧前补零）
+     */
+    bool writeFrame(const uint8_t* data);
+
+    /**
+     * @brief 写入索引和 Header，落盘后 rename 到最终路径
+     * @return true 如果文件已完整写入
+     */
+    bool finish();
+
+    /**
+     * @brief 放弃写入并删除临时文件
+     */
+    void abort();
+
+    bool isOpen() const { return fd_ >= 0; }
+    int getFrameCount() const { return static_cast<int>(info_.frame_offsets.size()); }
+    const std::string& getPath() const { return path_; }
+
+private:
+    bool writeAll(const void* data, size_t size, uint64_t offset);
+
+    int fd_;
+    std::string path_;
+    std::string tmp_path_;
+    RawFrameFileInfo info_;
+    uint64_t write_offset_;
+};
+
+} // namespace io
+} // namespace productionline
@@ -52,6 +52,7 @@ private:
     // ============ 门面模式：持有具体实现 ============
     std::unique_ptr<WorkerBase> worker_base_uptr_;  // 实际的Worker实现（统一基类）
     WorkerConfig config_;  // Worker配置（包含 worker_type 和所有配置参数）
+    uint64_t adopted_pool_id_;  // 外部输出 Pool（0=Worker 在 open() 时自建）
 
 public:
     // ============ 构造/析构 ============
@@ -87,12 +88,31 @@ public:
      */
     bool fillBuffer(int frame_index, Buffer* buffer);
     
+    /**
+     * 批量填充Buffer（转发到 WorkerBase::fillBuffers，Worker 未重写时逐个调用 fillBuffer）
+     * @param requests 请求数组（结果写入每项的 filled）
+     * @param count 请求数
+     * @return 填充成功的请求数
+     */
+    int fillBuffers(WorkerBase::FillRequest* requests, int count);
+    
     /**
      * 获取输出 BufferPool ID
      * @return pool_id（成功），0（失败或未创建）
      */
     uint64_t getOutputBufferPoolId();
     
+    /**
+     * 使用外部 BufferPool 作为输出 Pool（转发到 WorkerBase::adoptOutputBufferPool）
+     * @param pool_id 外部 Pool ID（open() 之前调用时 open() 不再创建 Pool；之后调用时替换自建 Pool）
+     */
+    void adoptOutputBufferPool(uint64_t pool_id);
+    
+    /**
+     * Worker 填充的 Buffer 是否需要绑定 AVFrame（解码 Worker）
+     */
+    bool usesAVFrameBuffers() const;
+    
     // ============ 文件导航方法（原IVideoFileNavigator的方法）============
     
     /**
@@ -185,6 +205,16 @@ public:
      * 检查是否到达文件末尾
      */
     bool isAtEnd() const;
+    
+    /**
+     * 获取源帧率（未知返回 0）
+     */
+    double getFrameRate() const;
+    
+    /**
+     * 获取解码帧缓存统计（Worker 未启用缓存返回 false）
+     */
+    bool getFrameCacheStats(DecodedFrameCache::Stats* stats) const;
 };
 
 #endif // BUFFER_FILLING_WORKER_FACADE_HPP
@@ -22,6 +22,9 @@
  * - MmapRawVideoFileWorker: Mmap方式打开raw视频文件Worker
  * - FfmpegDecodeRtspWorker: FFmpeg解码RTSP流Worker
  * - IoUringRawVideoFileWorker: IoUring方式打开raw视频文件Worker
+ * - ImageSequenceWorker: 逐帧文件目录Worker（io_uring 预取）
+ * - RawVideoStreamWorker: 管道 / FIFO / Unix 套接字 raw 帧流Worker
+ * - TestPatternWorker: 合成测试图案Worker（不读文件）
  * 
  * 优势：
  * - 用户无需了解具体实现类
@@ -0,0 +1,162 @@
+#ifndef DECODED_FRAME_CACHE_HPP
+#define DECODED_FRAME_CACHE_HPP
+
+#include "productionline/io/RawFrameFile.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// FFmpeg 前向声明
+struct AVFrame;
+struct AVBufferRef;
+struct AVBufferPool;
+
+/**
+ * @brief DecodedFrameCache - 解码帧缓存（短片段循环播放）
+ *
+ * 架构角色：Worker 内部组件 - 位于解码器之前的帧缓存
+ *
+ * 使用场景：
+ * - 循环播放的短片段（如 10 秒片段在多块屏幕上循环）：第一遍解码时按顺序记录每一帧，
+ *   之后的播放直接从缓存取帧，不再占用解码器
+ *
+ * 工作流程：
+ * 1. RECORDING：Worker 从第 0 帧开始解码，每解码一帧调用 record() 紧凑拷贝到缓存
+ * 2. 到达 EOF 时调用 finish()，全部帧都在预算内则进入 COMPLETE
+ * 3. COMPLETE：fetch() 按帧序号取帧（未压缩时引用计数共享缓存内存，零拷贝）
+ * 4. 超出内存预算、几何变化或帧不可由 CPU 访问时进入 DISABLED 并释放内存（只缓存完整片段）
+ *
+ * 特点：
+ * - 可选按帧 LZ4 压缩（编译时检测到 liblz4 才生效），取帧时解压到复用的 AVBufferPool
+ * - 统计命中率和内存占用（getStats()）
+ *
+ * @note 缓存帧位于普通内存，命中的帧没有物理地址（Buffer::getPhysicalAddress() == 0）
+ * @note 非线程安全：record / finish / fetch 由 Worker 在自身锁内调用；getStats() 可在任意线程调用
+ */
+class DecodedFrameCache {
+public:
+    /**
+     * @brief 缓存状态
+     */
+    enum class State {
+        RECORDING,   // 第一遍解码中，记录帧
+        COMPLETE,    // 片段已完整缓存，从缓存取帧
+        DISABLED     // 已放弃（超出预算等），透传给解码器
+    };
+
+    /**
+     * @brief 缓存统计（getStats() 快照）
+     */
+    struct Stats {
+        State state = State::DISABLED;
+        int frames = 0;                    // 已缓存帧数
+        uint64_t hits = 0;                 // 从缓存取帧次数
+        uint64_t misses = 0;               // 由解码器解码的帧数（缓存启用期间）
+        size_t memory_bytes = 0;           // 实际占用内存（压缩后）
+        size_t raw_bytes = 0;              // 未压缩时的大小
+        size_t budget_bytes = 0;           // 内存预算
+        bool compressed = false;           // 是否按帧 LZ4 压缩
+
+        double hitRate() const {
+            return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+        }
+    };
+
+    /**
+     * @brief 构造函数
+     * @param budget_bytes 内存预算（字节）
+     * @param compress 是否按帧 LZ4 压缩（未编译 LZ4 支持时忽略并告警）
+     */
+    DecodedFrameCache(size_t budget_bytes, bool compress);
+
+    ~DecodedFrameCache();
+
+    DecodedFrameCache(const DecodedFrameCache&) = delete;
+    DecodedFrameCache& operator=(const DecodedFrameCache&) = delete;
+
+    /**
+     * @brief 记录下一帧（按解码顺序，仅 RECORDING 状态有效）
+     * @param frame 解码后的帧（CPU 可访问的像素格式）
+     * @return true 如果已记录；false 表示缓存已放弃
+     */
+    bool record(const AVFrame* frame);
+
+    /**
+     * @brief 第一遍解码结束（到达 EOF），RECORDING 进入 COMPLETE
+     */
+    void finish();
+
+    /**
+     * @brief 放弃缓存并释放内存
+     * @param reason 原因（日志）
+     */
+    void disable(const std::string& reason);
+
+    /**
+     * @brief 从缓存取帧到 frame（frame 原有引用被释放）
+     * @param index 帧序号（0 ~ getFrameCount()-1）
+     * @param frame 输出帧（如 Buffer::getAVFrame()）
+     * @return true 如果命中
+     */
+    bool fetch(int index, AVFrame* frame);
+
+    /**
+     * @brief 记录一次未命中（帧由解码器解码）
+     */
+    void recordMiss() { misses_.fetch_add(1, std::memory_order_relaxed); }
+
+    State getState() const { return state_.load(std::memory_order_acquire); }
+    bool isComplete() const { return getState() == State::COMPLETE; }
+    int getFrameCount() const { return frame_count_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 获取统计快照
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief 状态名称（日志）
+     */
+    static const char* stateName(State state);
+
+private:
+    /**
+     * @brief 单帧缓存项
+     */
+    struct Entry {
+        AVBufferRef* data = nullptr;       // 紧凑排列的像素数据（压缩时为 LZ4 数据）
+        int compressed_size = 0;           // LZ4 压缩后大小（0=未压缩）
+    };
+
+    void releaseEntries();
+
+    std::vector<Entry> entries_;
+    std::atomic<State> state_;
+    std::atomic<int> frame_count_;
+
+    // 片段几何（第一帧确定，之后的帧必须一致）
+    int width_;
+    int height_;
+    int format_;
+    int frame_bytes_;                      // 紧凑排列（align=1）的单帧大小
+    productionline::io::RawFrameFileInfo layout_;   // 紧凑 plane 布局（record 按此拷贝，与 fetch 的 av_image_fill_arrays 一致）
+
+    // 配置
+    size_t budget_bytes_;
+    bool compress_;
+
+    // 压缩 / 解压缓冲区
+    std::vector<uint8_t> scratch_raw_;     // 压缩前的紧凑拷贝
+    std::vector<uint8_t> scratch_lz4_;     // 压缩输出
+    AVBufferPool* decode_pool_;            // 解压输出（压缩时创建，引用计数回收）
+
+    // 统计
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<size_t> memory_bytes_;
+    std::atomic<size_t> raw_bytes_;
+};
+
+#endif // DECODED_FRAME_CACHE_HPP
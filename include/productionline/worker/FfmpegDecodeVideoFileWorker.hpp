@@ -2,6 +2,8 @@
 #define FFMPEG_DECODE_VIDEO_FILE_WORKER_HPP
 
 #include "productionline/worker/WorkerBase.hpp"
+#include "productionline/worker/DecodedFrameCache.hpp"
+#include "productionline/io/RawFrameFile.hpp"
 #include "buffer/bufferpool/Buffer.hpp"
 #include "buffer/bufferpool/BufferPool.hpp"
 #include <string>
@@ -9,6 +11,7 @@
 #include <atomic>
 #include <mutex>
 #include <map>
+#include <vector>
 
 // FFmpeg 前向声明
 struct AVFormatContext;
@@ -19,6 +22,12 @@ struct AVFrame;
 struct SwsContext;
 struct AVDictionary;
 
+namespace productionline {
+namespace io {
+class FileAVIOContext;
+}
+}
+
 
 /**
  * @brief FfmpegDecodeVideoFileWorker - FFmpeg解码视频文件Worker
@@ -42,6 +51,12 @@ struct AVDictionary;
  * - 支持格式转换（YUV → ARGB888）
  * - 零拷贝优化（当硬件支持时）
  * - 线程安全的帧访问
+ * - 可选解码帧缓存（WorkerConfig::cache）：短片段第一遍解码后循环播放直接从内存取帧
+ * - 可选自定义 AVIOContext（WorkerConfig::file.io_mode）：解复用读取改由 mmap 或 io_uring 预读提供
+ * - 可选 raw 缓存文件（WorkerConfig::cache.spill_path）：第一遍解码写入 RawFrameFile，
+ *   之后的运行由 BufferFillingWorkerFacade 改用 MmapRawVideoFileWorker 直接映射
+ * - 逐帧填充（fillBuffer）与批量填充（fillBuffers，整批只加一次锁）共用 decodeNextFrame()：
+ *   一个 packet 解出多帧时依次填入后续 buffer，非视频流 packet 和解码器延迟不再让单次填充失败
  * 
  * 使用方式：
  * ```cpp
@@ -80,6 +95,7 @@ public:
     
     // Buffer填充功能（原IBufferFillingWorker的方法）
     bool fillBuffer(int frame_index, Buffer* buffer) override;
+    int fillBuffers(FillRequest* requests, int count) override;
     const char* getWorkerType() const override {
         return "FfmpegDecodeVideoFileWorker";
     }
@@ -104,6 +120,8 @@ public:
     const char* getPath() const override;
     bool hasMoreFrames() const override;
     bool isAtEnd() const override;
+    double getFrameRate() const override;
+    bool getFrameCacheStats(DecodedFrameCache::Stats* stats) const override;
     
     // ============ 信息查询 ============
     
@@ -121,6 +139,14 @@ public:
      * @brief 打印统计信息
      */
     void printStats() const;
+    
+    /**
+     * @brief 检查 raw 缓存文件是否可替代解码（文件完整，源文件和解码配置未变）
+     * @param config Worker 配置（file.file_path 和 cache.spill_path）
+     * @param info 输出：缓存文件信息（可为 nullptr）
+     * @return true 如果可以直接播放缓存文件
+     */
+    static bool isSpillFileValid(const WorkerConfig& config, productionline::io::RawFrameFileInfo* info = nullptr);
 
 private:
     // ============ FFmpeg 资源 ============
@@ -130,6 +156,7 @@ private:
     std::map<int, std::pair<AVFrame*, AVPacket*>> frame_packet_map_;    // 用于存储解码后的帧和对应的packet
     SwsContext* sws_ctx_ptr_;              // 图像格式转换
     int video_stream_index_;
+    std::unique_ptr<productionline::io::FileAVIOContext> custom_io_uptr_;  // file.io_mode != DEFAULT 时的 pb
     
     // ============ 文件信息 ============
     std::string file_path_;            // 文件路径（使用 std::string 更安全）
@@ -155,6 +182,14 @@ private:
     std::string decoder_name_;         // 指定解码器名称（如 "h264_taco"），空字符串表示自动选择
     AVDictionary* codec_options_ptr_;      // 解码器选项（用于 h264_taco 配置）
     
+    // ============ 解码帧缓存 ============
+    std::unique_ptr<DecodedFrameCache> frame_cache_uptr_;  // worker_config_.cache 启用时在 open() 创建
+    
+    // ============ raw 缓存文件（第一遍解码时写入）============
+    bool spill_pending_;                                   // 需要写入（open() 时缓存文件缺失或过期）
+    std::unique_ptr<productionline::io::RawFrameFileWriter> spill_writer_uptr_;  // 第一帧解码后创建
+    std::vector<uint8_t> spill_scratch_;                   // 紧凑拷贝缓冲区
+    
     // ============ 线程安全 ============
     // 使用递归锁避免同一线程重入时死锁（例如 fillBuffer -> seek）
     mutable std::recursive_mutex mutex_;
@@ -199,6 +234,43 @@ private:
      */
     int estimateTotalFrames();
     
+    /**
+     * @brief 第一遍解码：追加一帧到 raw 缓存文件（几何变化或写入失败时放弃）
+     */
+    void spillFrame(const AVFrame* frame);
+    
+    /**
+     * @brief 放弃写入 raw 缓存文件（删除临时文件）
+     */
+    void abortSpill(const char* reason);
+    
+    /**
+     * @brief 计算影响解码输出的配置指纹（源路径、解码器、输出格式）
+     */
+    static uint64_t spillFingerprint(const WorkerConfig& config);
+    
+    /**
+     * @brief 读取下一个 packet 到 packet_ptr_（跳过有限次数的损坏 packet）
+     * @return 1=成功，0=EOF（已设置 eof_reached_ 并结束缓存写入），-1=错误
+     */
+    int readPacket();
+    
+    /**
+     * @brief 从解码器取一帧到 frame_ptr，并设置 buffer 的地址和图像元数据
+     * @return 1=成功，0=需要更多数据，-1=帧无效（没有物理地址）
+     */
+    int receiveFrame(Buffer* buffer, AVFrame* frame_ptr);
+    
+    /**
+     * @brief fillBuffer / fillBuffers 的单帧步骤：先取解码器中已解出的帧，没有时再送入 packet（调用方持有 mutex_）
+     */
+    bool decodeNextFrame(Buffer* buffer);
+    
+    /**
+     * @brief 从完整的解码帧缓存填充下一帧（不经过解码器）
+     */
+    bool fillFromCache(Buffer* buffer);
+    
     /**
      * @brief 设置错误信息
      */
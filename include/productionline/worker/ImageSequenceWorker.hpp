@@ -0,0 +1,198 @@
+#ifndef IMAGE_SEQUENCE_WORKER_HPP
+#define IMAGE_SEQUENCE_WORKER_HPP
+
+#include "productionline/worker/WorkerBase.hpp"
+#include "buffer/bufferpool/Buffer.hpp"
+#include <liburing.h>
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief ImageSequenceWorker - 逐帧文件目录（图像序列）Worker
+ *
+ * 架构角色：Worker（工人）- 图像序列类型
+ *
+ * 功能：每个文件是一帧 raw 图像（如 frame_000001.nv12），按文件顺序作为视频播放
+ * 目的：填充Buffer，得到填充后的buffer
+ *
+ * 文件列表（open 时解析一次）：
+ * - 目录：目录下所有普通文件（忽略隐藏文件），按文件名自然排序（frame_2 在 frame_10 之前）
+ * - printf 模式（如 "/data/seq/frame_%06d.raw"）：从 0（不存在时从 1）开始连续编号，遇到缺失的编号结束
+ *
+ * 帧格式：open(path, width, height, bits_per_pixel)，与 raw Worker 相同；
+ * WorkerConfig::OutputConfig 设置了 pixel_format 时按紧凑 plane 布局计算帧大小并设置 Buffer 图像元数据。
+ * 文件大于一帧时只读取开头的一帧
+ *
+ * 预取（隐藏逐文件 open 延迟）：
+ * - fillBuffer(N) 之后为 N+1 .. N+depth（depth = FileConfig::readahead_depth）提交 io_uring 链：
+ *   openat（直接描述符）→ read → close，一个文件一次提交、无额外系统调用
+ * - 预取的数据在暂存区（depth 个帧槽），fillBuffer 命中时拷贝到 Buffer；未命中时当场提交并等待
+ * - 序列不超过 depth 帧时，所有帧常驻暂存区，循环播放不再读文件
+ * - 内核不支持 IORING_OP_OPENAT / 直接描述符时退化为同步 open + pread + close
+ *
+ * 线程安全：fillBuffer 可被多个生产者线程并发调用（帧槽状态由 mutex 保护，拷贝在锁外进行）
+ */
+class ImageSequenceWorker : public WorkerBase {
+public:
+    // ============ 构造/析构 ============
+    
+    ImageSequenceWorker();
+    ImageSequenceWorker(const WorkerConfig& config);
+    virtual ~ImageSequenceWorker();
+    
+    // 禁止拷贝（RAII资源管理）
+    ImageSequenceWorker(const ImageSequenceWorker&) = delete;
+    ImageSequenceWorker& operator=(const ImageSequenceWorker&) = delete;
+    
+    // ============ WorkerBase 接口实现 ============
+    
+    bool fillBuffer(int frame_index, Buffer* buffer) override;
+    const char* getWorkerType() const override {
+        return "ImageSequenceWorker";
+    }
+    
+    // 文件导航功能（继承自IVideoFileNavigator）
+    bool open(const char* path) override;
+    bool open(const char* path, int width, int height, int bits_per_pixel) override;
+    void close() override;
+    bool isOpen() const override;
+    bool seek(int frame_index) override;
+    bool seekToBegin() override;
+    bool seekToEnd() override;
+    bool skip(int frame_count) override;
+    int getTotalFrames() const override;
+    int getCurrentFrameIndex() const override;
+    size_t getFrameSize() const override;
+    long getFileSize() const override;
+    int getWidth() const override;
+    int getHeight() const override;
+    int getBytesPerPixel() const override;
+    const char* getPath() const override;
+    bool hasMoreFrames() const override;
+    bool isAtEnd() const override;
+    double getFrameRate() const override;
+    
+    // ============ 统计 ============
+    
+    uint64_t getPrefetchHits() const { return prefetch_hits_; }
+    uint64_t getPrefetchMisses() const { return prefetch_misses_; }
+    
+private:
+    /**
+     * 预取帧槽（暂存区中的一帧）
+     */
+    struct Slot {
+        uint8_t* data = nullptr;
+        int frame_index = -1;      // -1=空
+        int pending_ops = 0;       // 在途的 openat / read / close 完成事件数
+        int pins = 0;              // 正在从该槽拷贝的 fillBuffer 数
+        bool ready = false;        // 已完整读入 frame_index
+        int error = 0;             // errno（0=成功）
+    };
+    
+    enum ChainOp {
+        OP_OPEN = 0,
+        OP_READ = 1,
+        OP_CLOSE = 2
+    };
+    
+    static constexpr int kMaxPrefetchDepth = 64;
+    
+    // ============ 文件列表 ============
+    std::string path_;                 // 目录或 printf 模式
+    std::vector<std::string> files_;   // 每帧一个文件
+    
+    // ============ 视频属性 ============
+    int width_;
+    int height_;
+    int bits_per_pixel_;
+    size_t frame_size_;
+    int pixel_format_;                 // AVPixelFormat（-1=未知，不设置 Buffer 图像元数据）
+    int plane_count_;
+    int linesize_[4];
+    size_t plane_offset_[4];
+    
+    int total_frames_;
+    int current_frame_index_;
+    bool is_open_;
+    
+    // ============ 预取（io_uring 链）============
+    struct io_uring ring_;
+    bool ring_ready_;                  // false=同步读取
+    int prefetch_depth_;
+    std::vector<uint8_t> staging_;     // prefetch_depth_ 个帧槽（页对齐）
+    std::vector<Slot> slots_;          // 槽号同时是直接描述符号
+    std::mutex mutex_;                 // 保护 ring_ / slots_
+    
+    uint64_t prefetch_hits_;
+    uint64_t prefetch_misses_;
+    
+    // ============ 内部辅助方法 ============
+    
+    /**
+     * 解析目录或 printf 模式，建立 files_
+     */
+    bool resolveFiles(const char* path);
+    
+    /**
+     * 按 worker_config_.output 和几何参数计算帧大小和 plane 布局
+     */
+    bool configureFormat(int width, int height, int bits_per_pixel);
+    
+    /**
+     * 初始化 io_uring 和直接描述符表（失败时使用同步读取）
+     */
+    bool initPrefetch();
+    void cleanupPrefetch();
+    
+    /**
+     * 试打开第一个文件到直接描述符槽 0 再关闭，确认内核支持 openat_direct（5.15+）
+     */
+    bool probeDirectOpen();
+    
+    /**
+     * 查找保存 / 正在读取 frame_index 的槽（调用方持有 mutex_）
+     */
+    Slot* findSlot(int frame_index);
+    
+    /**
+     * 为 frame_index 分配槽并准备 openat → read → close 链（不提交；调用方持有 mutex_）
+     * @param base 当前播放位置，预取窗口 [base, base + depth] 内的槽不会被替换
+     * @return 分配的槽，没有可替换的槽时返回 nullptr
+     */
+    Slot* queueChain(int frame_index, int base);
+    
+    /**
+     * 等待并处理一个完成事件（调用方持有 mutex_）
+     */
+    bool reapOne();
+    
+    /**
+     * 为 base 之后的 depth 帧准备预取链并提交（调用方持有 mutex_）
+     */
+    void prefetchAfter(int base);
+    
+    /**
+     * frame_index 是否在 base 起的预取窗口内（循环播放时窗口越过末尾回到 0）
+     */
+    bool inWindow(int frame_index, int base) const;
+    
+    /**
+     * 同步读取一帧（open + pread + close）
+     */
+    bool readFileSync(int frame_index, uint8_t* dst) const;
+    
+    /**
+     * 设置 Buffer 图像元数据（已知像素格式时）
+     */
+    void setMetadata(Buffer* buffer) const;
+    
+    /**
+     * 创建输出 BufferPool（open() 成功后调用）
+     */
+    bool createBufferPool();
+};
+
+#endif // IMAGE_SEQUENCE_WORKER_HPP
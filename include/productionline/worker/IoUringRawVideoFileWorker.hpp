@@ -4,10 +4,13 @@
 #include "productionline/worker/WorkerBase.hpp"
 #include "buffer/bufferpool/Buffer.hpp"
 #include "buffer/bufferpool/BufferPool.hpp"
+#include "productionline/io/FrameCrop.hpp"
 #include <liburing.h>
+#include <sys/uio.h>
 #include <string>
 #include <vector>
 #include <atomic>
+#include <mutex>
 
 /**
  * @brief IoUringRawVideoFileWorker - IoUring方式打开raw视频文件Worker
@@ -23,6 +26,20 @@
  * - 显著降低CPU使用率
  * - 提高I/O吞吐量
  * 
+ * 文件格式：
+ * - 裸帧：open(path, width, height, bits_per_pixel)，帧紧密排列；WorkerConfig::OutputConfig 设置了
+ *   pixel_format（NV12、YUV420P、P010、ARGB 等）时按紧凑 plane 布局计算帧大小并设置 Buffer 图像元数据
+ * - RawFrameFile（magic "RAWVIDX1"）：open(path) 从文件头读取几何、plane 布局和帧索引，
+ *   填充时设置 Buffer 图像元数据；帧按页对齐时使用 O_DIRECT 读取（Buffer 由 PAGE_ALIGNED
+ *   分配器按页对齐分配），文件系统不支持时回退到普通读取
+ * 
+ * 感兴趣区域（WorkerConfig::OutputConfig 的 roi_*）：每个 plane 的 ROI 行段用 readv 直接读入 Buffer
+ * 的紧凑布局，行间不需要的字节读入丢弃区（间隔很大时改为逐行读取）；ROI 外的行不读取。
+ * 裁剪时不使用 O_DIRECT（行段不按页对齐）
+ * 
+ * 批量填充（fillBuffers）：一批帧各准备一个 SQE，每 queue_depth_ 个只调用一次 io_uring_submit，
+ * 再按 user_data 收割完成事件；多个生产者线程共用一个 ring，提交和收割在 ring_mutex_ 内进行
+ * 
  * 使用场景：
  * - 多线程并发读取视频帧
  * - 随机访问模式
@@ -57,6 +74,7 @@ public:
     
     // Buffer填充功能（原IBufferFillingWorker的方法）
     bool fillBuffer(int frame_index, Buffer* buffer) override;
+    int fillBuffers(FillRequest* requests, int count) override;
     const char* getWorkerType() const override {
         return "IoUringRawVideoFileWorker";
     }
@@ -80,6 +98,7 @@ public:
     const char* getPath() const override;
     bool hasMoreFrames() const override;
     bool isAtEnd() const override;
+    double getFrameRate() const override;
     
     // ============ IoUring 专有接口（保留原有功能） ============
     
@@ -112,9 +131,11 @@ private:
     struct io_uring ring_;
     int queue_depth_;
     bool initialized_;
+    std::mutex ring_mutex_;                // ring 不是线程安全的：提交到收割完成期间持有，避免收割到其他线程的 CQE
     
     // ============ 文件资源 ============
     int video_fd_;
+    int direct_fd_;                        // O_DIRECT 描述符（RawFrameFile 帧按页对齐时打开，-1=不可用）
     std::string video_path_;
     
     // ============ 视频属性 ============
@@ -125,9 +146,49 @@ private:
     int width_;
     int height_;
     int bits_per_pixel_;
+    double frame_rate_;                    // RawFrameFile 文件头提供，裸帧为 0
+    std::vector<uint64_t> frame_offsets_;  // RawFrameFile 帧索引（空=按 frame_index * frame_size_ 计算）
+    
+    // ============ 图像布局（RawFrameFile 文件头提供，裸帧 plane_count_=0）============
+    int pixel_format_;                     // AVPixelFormat
+    int plane_count_;
+    int linesize_[4];
+    size_t plane_offset_[4];
+    
+    // ============ 感兴趣区域（未配置 ROI 时 crop_.isEnabled()=false）============
+    
+    /**
+     * 一次 readv：从帧内偏移 offset 起读 length 字节，散布到 crop_iovecs_[first_iov, first_iov + iov_count)
+     */
+    struct CropRead {
+        uint64_t offset = 0;
+        int first_iov = 0;
+        int iov_count = 0;
+        size_t length = 0;
+    };
+    
+    static constexpr int kMaxRowsPerRead = 512;            // 每个 readv 最多行数（iovec 数 < IOV_MAX）
+    static constexpr size_t kMaxSkipBytes = 64 * 1024;     // 行间隔超过该字节数时逐行读取，不读入丢弃区
+    
+    productionline::io::FrameCrop crop_;
+    std::vector<CropRead> crop_reads_;
+    std::vector<size_t> crop_iov_dst_;     // iovec 在 Buffer 中的偏移（SIZE_MAX=丢弃区）
+    std::vector<struct iovec> crop_iovecs_;
+    std::vector<uint8_t> crop_sink_;       // 行间隔的丢弃区（所有间隔共用）
+    
+    /**
+     * 一个读取请求的完成结果（user_data 和 cqe->res）
+     */
+    struct Completion {
+        void* user_data = nullptr;
+        int res = 0;
+    };
+    
+    std::vector<Completion> completions_;  // submitAndReap 收割的完成结果（ring_mutex_ 保护）
     
     // ============ 状态 ============
     bool is_open_;
+    int last_read_error_;                  // 最近一次读取失败的 errno（0=无）
     
     // ============ 内部辅助方法 ============
     
@@ -142,14 +203,73 @@ private:
     void cleanupIoUring();
     
     /**
-     * 提交单个读取请求
+     * 打开文件后的公共初始化：初始化 io_uring 并创建输出 BufferPool
+     */
+    bool finishOpen();
+    
+    /**
+     * 按 worker_config_.output 的 ROI 计算裁剪布局和 readv 计划
+     */
+    bool configureRoi();
+    
+    void addCropIovec(size_t dst_offset, size_t length);
+    
+    /**
+     * 输出到 Buffer 的单帧字节数（裁剪后）
+     */
+    size_t getOutputFrameSize() const;
+    
+    /**
+     * 用 readv 把第 frame_index 帧的 ROI 读入 buffer（按 queue_depth_ 分批提交）
+     */
+    bool readCropped(int frame_index, Buffer* buffer);
+    
+    /**
+     * O_DIRECT 读取长度（帧大小向上取整到页）
+     */
+    size_t directReadSize() const;
+    
+    /**
+     * 检查填充参数（Worker 已打开、帧索引有效、Buffer 足够大）
+     */
+    bool checkFillRequest(int frame_index, Buffer* buffer) const;
+    
+    /**
+     * 本 Worker 是否对该 buffer 使用 O_DIRECT 读取（地址和容量按页对齐）
+     */
+    bool canReadDirect(const Buffer* buffer) const;
+    
+    /**
+     * 读取成功后设置 Buffer 图像元数据（RawFrameFile 或 ROI）
+     */
+    void applyImageMetadata(Buffer* buffer) const;
+    
+    /**
+     * 准备单个读取 SQE（不提交）
+     * @param direct true 时通过 direct_fd_ 读取 directReadSize() 字节
+     * @param user_data 完成事件中返回的用户数据
+     */
+    bool prepareRead(int frame_index, void* buffer, size_t buffer_size, bool direct, void* user_data);
+    
+    /**
+     * 同步读取单帧：准备一个 SQE，提交并等待完成
+     * @param direct true 时通过 direct_fd_ 读取 directReadSize() 字节
+     */
+    bool readSync(int frame_index, void* buffer, size_t buffer_size, bool direct);
+    
+    /**
+     * 提交已准备的 count 个 SQE，收割完成事件到 completions_
+     * 
+     * io_uring_submit / io_uring_wait_cqe 遇到 EINTR 时重试，只等待内核实际接收的数量；
+     * 返回前不留下飞行中的请求（user_data 可能指向调用方栈上的数据），无法继续时重建 ring
+     * @return 全部请求都已收割返回 true；false 时 completions_ 只含已收割的部分
      */
-    bool submitReadRequest(int frame_index, void* buffer, size_t buffer_size);
+    bool submitAndReap(int count);
     
     /**
-     * 等待并完成读取请求
+     * 重建 ring，丢弃残留的 SQE 和未收割的请求（重建失败时 initialized_=false）
      */
-    bool waitForCompletion();
+    void resetRing();
 };
 
 #endif // IOURING_RAW_VIDEO_FILE_WORKER_HPP
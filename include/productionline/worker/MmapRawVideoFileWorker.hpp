@@ -2,9 +2,20 @@
 #define MMAP_RAW_VIDEO_FILE_WORKER_HPP
 
 #include "productionline/worker/WorkerBase.hpp"
+#include "productionline/io/CompressedSample.hpp"
+#include "productionline/io/FrameCrop.hpp"
 #include "buffer/bufferpool/Buffer.hpp"
 #include <stddef.h>  // For size_t
 #include <sys/types.h>  // For ssize_t
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// FFmpeg 前向声明（H.264 裸流解码）
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
 
 #define MAX_PATH_LENGTH 512  // Maximum path length
 
@@ -30,6 +41,29 @@
  * - 文件大小 < 1GB
  * - 随机访问模式
  * - 单线程或少量线程
+ * 
+ * 文件格式：
+ * - 裸帧：open(path, width, height, bits_per_pixel)，帧紧密排列；WorkerConfig::OutputConfig 设置了
+ *   pixel_format（NV12、YUV420P、P010、ARGB 等）时按紧凑 plane 布局计算帧大小并设置 Buffer 图像元数据
+ * - RawFrameFile（magic "RAWVIDX1"，如解码一次的 raw 缓存文件）：open(path) 从文件头读取几何和帧索引，
+ *   填充时按文件头的像素格式和 plane 布局设置 Buffer 图像元数据
+ * - H.264 Annex-B 裸流（.h264 / .264 摄像头录像）：open(path) 扫描映射区建立访问单元索引，
+ *   AVPacket 直接引用映射区送 libavcodec 解码（不经过 libavformat），seek 跳到最近的 IDR；
+ *   第 N 帧指从最近 IDR 起按输出顺序计数的第 N 帧
+ * - MP4（H.264 / H.265 视频轨）：open(path) 解析 moov 中的 sample 表，sample 同样直接从映射区送解码器，
+ *   不调用 avformat_open_input / avformat_find_stream_info
+ * 
+ * 感兴趣区域（WorkerConfig::OutputConfig 的 roi_*）：只按行拷贝 ROI 到 Buffer，
+ * getWidth() / getHeight() / getFrameSize() 和 Buffer 图像元数据都是裁剪后的值
+ * 
+ * 批量填充（fillBuffers）：
+ * - 裸帧先用一次 madvise(MADV_POPULATE_READ) 建立整批帧的页表映射，拷贝时不再逐页缺页
+ *   （旧内核回退到 MADV_WILLNEED 只触发预读；ROI 只读部分行，不预取）
+ * - 压缩流整批只加一次解码锁，按顺序解码
+ * 
+ * 多生产者解码压缩流：解码器状态是顺序的，帧 N 在帧 N-1 之前进入会让解码器从关键帧重新解码。
+ * 其他生产者还有请求在排队时，fillBuffer(N) 先等待前面的帧解码完成（按帧序进入解码器）；
+ * 前序帧在 kDecodeOrderWaitMs 内没有进展（seek、填充失败）时不再等待，直接跳到 N
  */
 class MmapRawVideoFileWorker : public WorkerBase {
 public:
@@ -47,6 +81,7 @@ public:
     
     // Buffer填充功能（原IBufferFillingWorker的方法）
     bool fillBuffer(int frame_index, Buffer* buffer) override;
+    int fillBuffers(FillRequest* requests, int count) override;
     const char* getWorkerType() const override {
         return "MmapRawVideoFileWorker";
     }
@@ -70,6 +105,7 @@ public:
     const char* getPath() const override;
     bool hasMoreFrames() const override;
     bool isAtEnd() const override;
+    double getFrameRate() const override;
 
 private:
     // ============ 文件资源 ============
@@ -83,12 +119,41 @@ private:
     int height_;                      // 视频高度（像素）
     int bits_per_pixel_;              // 每像素位数
     size_t frame_size_;               // 单帧大小（字节）
+    double frame_rate_;               // 帧率（RawFrameFile 文件头提供，裸帧为 0）
+    
+    // ============ 图像布局（RawFrameFile 文件头提供，裸帧 plane_count_=0）============
+    int pixel_format_;                // AVPixelFormat
+    int plane_count_;
+    int linesize_[4];
+    size_t plane_offset_[4];
+    
+    // ============ 感兴趣区域（未配置 ROI 时 isEnabled()=false）============
+    productionline::io::FrameCrop crop_;
     
     // ============ 文件信息 ============
+    std::vector<uint64_t> frame_offsets_;  // RawFrameFile 帧索引（空=按 frame_index * frame_size_ 计算）
     long file_size_;                  // 文件大小（字节）
     int total_frames_;                // 总帧数
     int current_frame_index_;         // 当前帧索引
     
+    // ============ 压缩裸流（H.264 Annex-B）============
+    std::vector<productionline::io::CompressedSample> samples_;  // 每帧在映射区中的位置（解码顺序）
+    std::vector<int> keyframes_;      // 关键帧在 samples_ 中的索引（升序）
+    AVCodecContext* codec_ctx_ptr_;   // 非空表示 fillBuffer 需要解码
+    AVPacket* packet_ptr_;
+    AVFrame* frame_ptr_;
+    int next_sample_;                 // 下一个送入解码器的 sample
+    int next_output_index_;           // 解码器下一个输出帧的帧索引
+    bool draining_;                   // 已送入 flush 包（码流结束）
+    std::vector<uint8_t> tail_packet_;  // 文件末尾的 sample 需要复制一份补齐 padding
+    std::mutex decode_mutex_;         // 解码状态是顺序的：fillBuffer 串行化
+    std::condition_variable decode_cv_;   // 解码器输出一帧（next_output_index_ 前进）时通知等待帧序的请求
+    std::atomic<int> pending_decodes_;    // 正在排队 / 解码的 fillBuffer(s) 调用数
+    static constexpr int kDecodeOrderWaitMs = 100;  // 等待前序帧的最长无进展时间
+    
+    // ============ 批量预取 ============
+    std::atomic<bool> populate_supported_;  // 内核支持 MADV_POPULATE_READ（不支持时回退到 MADV_WILLNEED）
+    
     // ============ 状态标志 ============
     bool is_open_;
     
@@ -99,7 +164,8 @@ private:
         MP4,          // MP4容器
         H264,         // H.264裸流
         H265,         // H.265裸流
-        AVI           // AVI容器
+        AVI,          // AVI容器
+        INDEXED       // RawFrameFile（带文件头和帧索引的 raw 帧）
     };
     
     FileFormat detected_format_;
@@ -122,7 +188,7 @@ private:
     ssize_t readFileHeader(unsigned char* header, size_t size);
     
     /**
-     * 从MP4头部解析格式信息
+     * 从MP4 sample 表解析格式信息（映射区）
      */
     bool parseMP4Header();
     
@@ -131,6 +197,78 @@ private:
      */
     bool parseH264Header();
     
+    /**
+     * 从 RawFrameFile 文件头和索引读取格式信息
+     */
+    bool parseIndexedHeader();
+    
+    /**
+     * 创建解码器并解码第一帧，确定输出几何和 plane 布局（samples_ 已建立）
+     * @param codec_id AVCodecID
+     * @param extradata 解码器配置（MP4 的 avcC / hvcC；Annex-B 裸流为空）
+     */
+    bool openDecoder(int codec_id, const std::vector<uint8_t>& extradata = std::vector<uint8_t>());
+    
+    /**
+     * 释放解码器和压缩流索引
+     */
+    void closeDecoder();
+    
+    /**
+     * 检查填充参数（Worker 已打开、帧索引有效、Buffer 足够大）
+     */
+    bool checkFillRequest(int frame_index, Buffer* buffer) const;
+    
+    /**
+     * 从映射区拷贝第 frame_index 帧到 buffer（裸帧 / RawFrameFile）
+     */
+    bool copyFrame(int frame_index, Buffer* buffer);
+    
+    /**
+     * 预取一批帧所在的映射区页（相邻帧合并为一次 madvise）
+     */
+    void prefetchFrames(const FillRequest* requests, int count);
+    
+    /**
+     * 解码第 frame_index 帧到 buffer（必要时从最近的关键帧重新开始）
+     */
+    bool decodeToBuffer(int frame_index, Buffer* buffer);
+    
+    /**
+     * decodeToBuffer 的实现（调用方持有 decode_mutex_）
+     */
+    bool decodeFrameLocked(int frame_index, Buffer* buffer);
+    
+    /**
+     * 等待前序帧先进入解码器（只在其他请求排队时等待，调用方持有 decode_mutex_）
+     */
+    void waitForDecodeTurn(std::unique_lock<std::mutex>& lock, int frame_index);
+    
+    /**
+     * 从解码器取下一帧到 frame_ptr_（按需送入后续 sample）
+     */
+    bool receiveNextFrame();
+    
+    /**
+     * 把 samples_[index] 包装为引用映射区的 AVPacket 送入解码器
+     */
+    bool sendSample(int index);
+    
+    /**
+     * 按 worker_config_.output 的 ROI 计算裁剪布局（几何和 plane 布局已确定后调用）
+     */
+    bool configureRoi();
+    
+    /**
+     * 输出到 Buffer 的单帧字节数（裁剪后）
+     */
+    size_t getOutputFrameSize() const;
+    
+    /**
+     * 创建输出 BufferPool（open() 成功后调用）
+     */
+    bool createBufferPool();
+    
     /**
      * 映射文件到内存
      */
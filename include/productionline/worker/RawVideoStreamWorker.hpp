@@ -0,0 +1,143 @@
+#ifndef RAW_VIDEO_STREAM_WORKER_HPP
+#define RAW_VIDEO_STREAM_WORKER_HPP
+
+#include "productionline/worker/WorkerBase.hpp"
+#include "buffer/bufferpool/Buffer.hpp"
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief RawVideoStreamWorker - 流式 raw 帧输入 Worker（管道 / FIFO / Unix 流套接字）
+ *
+ * 架构角色：Worker（工人）- raw 流类型
+ *
+ * 功能：从另一个进程（如 `ffmpeg -f rawvideo -` 或采集守护进程）按固定帧大小读取 raw 帧，不经过磁盘
+ * 目的：填充Buffer，得到填充后的buffer
+ *
+ * 路径：
+ * - "-" 或 "stdin"：标准输入（dup 后读取，close 不关闭进程的 stdin）
+ * - "unix:/path/to.sock"，或路径本身是套接字文件：连接 Unix 流套接字（SOCK_STREAM）
+ * - 其他（FIFO、字符设备、普通文件）：open(O_RDONLY)；FIFO 在写端打开前阻塞
+ *
+ * 帧格式：open(path, width, height, bits_per_pixel)，与 raw Worker 相同；
+ * WorkerConfig::OutputConfig 设置了 pixel_format 时按紧凑 plane 布局计算帧大小并设置 Buffer 图像元数据。
+ * 不支持 ROI（流不能跳过字节而不读取，裁剪需要额外拷贝）
+ *
+ * 读取：
+ * - 数据直接读入 Buffer（内核 → 池内存一次拷贝，没有用户态暂存区）；
+ *   splice / vmsplice 的一端必须是管道，读入用户内存时内核同样执行拷贝，因此不使用
+ * - 管道容量扩大到一帧（F_SETPIPE_SZ，受 /proc/sys/fs/pipe-max-size 限制），套接字接收缓冲区同样扩大，
+ *   写端可以一次写入整帧，读端每帧只唤醒一两次
+ * - 流结束（read 返回 0）即 EOF：isAtEnd() 变为 true；结尾不足一帧的数据丢弃
+ * - 空闲时 fillBuffer 最多等待 kIdleWaitMs 后返回 false（生产者检查停止标志后重试）；
+ *   一帧读到一半时会等到该帧读完，保证帧边界不错位
+ *
+ * 特点：
+ * - 不可定位：seek / seekToBegin 返回 false，getTotalFrames() 返回 INT_MAX（与 RTSP Worker 一致）
+ * - 帧按到达顺序读取（mutex 串行化）；多个生产者线程时提交顺序可能交错，需要严格顺序时使用 1 个生产者线程
+ */
+class RawVideoStreamWorker : public WorkerBase {
+public:
+    // ============ 构造/析构 ============
+    
+    RawVideoStreamWorker();
+    RawVideoStreamWorker(const WorkerConfig& config);
+    virtual ~RawVideoStreamWorker();
+    
+    // 禁止拷贝（RAII资源管理）
+    RawVideoStreamWorker(const RawVideoStreamWorker&) = delete;
+    RawVideoStreamWorker& operator=(const RawVideoStreamWorker&) = delete;
+    
+    // ============ WorkerBase 接口实现 ============
+    
+    bool fillBuffer(int frame_index, Buffer* buffer) override;
+    const char* getWorkerType() const override {
+        return "RawVideoStreamWorker";
+    }
+    
+    // 文件导航功能（继承自IVideoFileNavigator）
+    bool open(const char* path) override;
+    bool open(const char* path, int width, int height, int bits_per_pixel) override;
+    void close() override;
+    bool isOpen() const override;
+    bool seek(int frame_index) override;
+    bool seekToBegin() override;
+    bool seekToEnd() override;
+    bool skip(int frame_count) override;
+    int getTotalFrames() const override;
+    int getCurrentFrameIndex() const override;
+    size_t getFrameSize() const override;
+    long getFileSize() const override;
+    int getWidth() const override;
+    int getHeight() const override;
+    int getBytesPerPixel() const override;
+    const char* getPath() const override;
+    bool hasMoreFrames() const override;
+    bool isAtEnd() const override;
+    
+    // ============ 统计 ============
+    
+    uint64_t getFramesRead() const { return frames_read_.load(); }
+    uint64_t getBytesRead() const { return bytes_read_.load(); }
+    
+private:
+    static constexpr int kIdleWaitMs = 100;
+    
+    // ============ 流 ============
+    std::string path_;
+    int fd_;
+    bool is_socket_;
+    
+    // ============ 视频属性 ============
+    int width_;
+    int height_;
+    int bits_per_pixel_;
+    size_t frame_size_;
+    int pixel_format_;                 // AVPixelFormat（-1=未知，不设置 Buffer 图像元数据）
+    int plane_count_;
+    int linesize_[4];
+    size_t plane_offset_[4];
+    
+    bool is_open_;
+    std::atomic<bool> eof_;
+    std::atomic<uint64_t> frames_read_;
+    std::atomic<uint64_t> bytes_read_;
+    std::mutex read_mutex_;            // 一次读完整帧，保证帧边界
+    
+    // ============ 内部辅助方法 ============
+    
+    /**
+     * 按 worker_config_.output 和几何参数计算帧大小和 plane 布局
+     */
+    bool configureFormat(int width, int height, int bits_per_pixel);
+    
+    /**
+     * 按路径打开 stdin / Unix 套接字 / FIFO，返回 fd（-1=失败）
+     */
+    int openStream(const char* path);
+    
+    /**
+     * 扩大管道容量 / 套接字接收缓冲区到约一帧
+     */
+    void tuneStreamBuffer();
+    
+    /**
+     * 读取一整帧到 dst（调用方持有 read_mutex_）
+     * @return 1=成功，0=空闲超时（未读到任何字节），-1=EOF 或错误
+     */
+    int readFrame(uint8_t* dst);
+    
+    /**
+     * 设置 Buffer 图像元数据（已知像素格式时）
+     */
+    void setMetadata(Buffer* buffer) const;
+    
+    /**
+     * 创建输出 BufferPool（open() 成功后调用）
+     */
+    bool createBufferPool();
+};
+
+#endif // RAW_VIDEO_STREAM_WORKER_HPP
@@ -0,0 +1,167 @@
+#ifndef TEST_PATTERN_WORKER_HPP
+#define TEST_PATTERN_WORKER_HPP
+
+#include "productionline/worker/WorkerBase.hpp"
+#include "buffer/bufferpool/Buffer.hpp"
+#include "productionline/io/RawFrameFile.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief TestPatternWorker - 合成测试图案 Worker
+ *
+ * 架构角色：Worker（工人）- 测试图案类型
+ *
+ * 功能：不读取任何文件，按帧号生成测试图案，用于测量 Pool / 显示 / 消费者的吞吐上限和 CI 中的可重复基准
+ * 目的：填充Buffer，得到填充后的buffer
+ *
+ * 图案（WorkerConfig::PatternConfig::name）：
+ * - bars：8 条 75% 彩条
+ * - gradient：水平渐变，每帧左移 4 像素（按色度采样对齐）
+ * - noise：xorshift 随机字节（种子 + 帧号决定，同一帧可重现）
+ * - counter：深灰背景 + 帧号
+ * stamp_frame_number=true 时在任意图案左上角叠加十进制帧号（8 像素方块字体）
+ *
+ * 帧格式：open(path, width, height, bits_per_pixel)，path 只作为名称显示。
+ * WorkerConfig::OutputConfig::pixel_format 可以是任意非硬件、非调色板、非 Bayer 的整数格式（RGB / YUV / 灰度，
+ * packed 或 planar，8~16 位）；未设置时按 bits_per_pixel 选择：32=BGRA，24=BGR24，16=RGB565，12=NV12，8=GRAY8。
+ * Buffer 总是带图像元数据
+ *
+ * 生成方式（每帧只做整行拷贝和 64 位整数运算）：
+ * - open 时用 av_write_image_line 把图案按目标格式渲染到小模板（一个色度采样周期的行数，渐变为两倍宽度），
+ *   帧号字体渲染为 0~9 的字模表
+ * - fillBuffer 用 FrameCopy::copyRows（源行跨度为 0）把模板行复制到整帧，渐变只改变模板的起始列；
+ *   帧号逐位从字模表按矩形拷贝
+ * - noise 用 4 路独立的 xorshift64 状态填充，编译器可以向量化
+ *
+ * 帧率：getFrameRate() 返回 PatternConfig::frame_rate，配合 VideoProductionLine::setPacingFromSource() 限速
+ *
+ * 线程安全：fillBuffer 只读取 open 时生成的模板，可被多个生产者线程并发调用
+ */
+class TestPatternWorker : public WorkerBase {
+public:
+    // ============ 构造/析构 ============
+    
+    TestPatternWorker();
+    TestPatternWorker(const WorkerConfig& config);
+    virtual ~TestPatternWorker();
+    
+    // 禁止拷贝（RAII资源管理）
+    TestPatternWorker(const TestPatternWorker&) = delete;
+    TestPatternWorker& operator=(const TestPatternWorker&) = delete;
+    
+    // ============ WorkerBase 接口实现 ============
+    
+    bool fillBuffer(int frame_index, Buffer* buffer) override;
+    const char* getWorkerType() const override {
+        return "TestPatternWorker";
+    }
+    
+    // 文件导航功能（继承自IVideoFileNavigator）
+    bool open(const char* path) override;
+    bool open(const char* path, int width, int height, int bits_per_pixel) override;
+    void close() override;
+    bool isOpen() const override;
+    bool seek(int frame_index) override;
+    bool seekToBegin() override;
+    bool seekToEnd() override;
+    bool skip(int frame_count) override;
+    int getTotalFrames() const override;
+    int getCurrentFrameIndex() const override;
+    size_t getFrameSize() const override;
+    long getFileSize() const override;
+    int getWidth() const override;
+    int getHeight() const override;
+    int getBytesPerPixel() const override;
+    const char* getPath() const override;
+    bool hasMoreFrames() const override;
+    bool isAtEnd() const override;
+    double getFrameRate() const override;
+    
+private:
+    enum class Pattern {
+        BARS,
+        GRADIENT,
+        NOISE,
+        COUNTER
+    };
+    
+    /**
+     * 按目标格式渲染的小图像（图案模板 / 字模表）
+     */
+    struct Image {
+        productionline::io::RawFrameFileInfo layout;
+        std::vector<uint8_t> data;
+    };
+    
+    static constexpr int kGradientStep = 4;       // 每帧左移像素数
+    static constexpr int kGlyphScale = 8;         // 字体每个点的像素数
+    static constexpr int kGlyphWidth = 4 * kGlyphScale;   // 3 列点 + 1 列间隔
+    static constexpr int kGlyphHeight = 6 * kGlyphScale;  // 5 行点 + 1 行间隔
+    static constexpr int kStampMargin = 16;
+    
+    // ============ 视频属性 ============
+    std::string path_;
+    int width_;
+    int height_;
+    int bits_per_pixel_;
+    size_t frame_size_;
+    int pixel_format_;
+    productionline::io::RawFrameFileInfo layout_;
+    
+    Pattern pattern_;
+    bool stamp_;
+    int total_frames_;
+    int current_frame_index_;
+    bool is_open_;
+    
+    // ============ 模板 ============
+    Image band_;                       // bars / gradient / counter 的模板（一个色度采样周期的行）
+    Image glyphs_;                     // 帧号字模表（0~9 横向排列）
+    int x_align_;                      // 列偏移对齐（色度采样 / 位流格式的字节边界）
+    
+    // ============ 内部辅助方法 ============
+    
+    /**
+     * 解析 PatternConfig::name
+     */
+    bool parsePattern();
+    
+    /**
+     * 按 pixel_format / bits_per_pixel 确定格式并计算帧布局
+     */
+    bool configureFormat(int width, int height, int bits_per_pixel);
+    
+    /**
+     * 渲染图案模板和字模表
+     */
+    bool buildTemplates();
+    
+    /**
+     * 从模板第 x 列起，把模板行复制到整帧
+     */
+    void fillFromBand(uint8_t* dst, int x) const;
+    
+    /**
+     * 按帧号生成随机字节
+     */
+    void fillNoise(uint8_t* dst, int frame_index) const;
+    
+    /**
+     * 在左上角绘制帧号
+     */
+    void drawFrameNumber(uint8_t* dst, int frame_index) const;
+    
+    /**
+     * 矩形拷贝（所有 plane；x / y / width / height 已按色度采样对齐）
+     */
+    void copyRect(uint8_t* dst, int dst_x, int dst_y, const Image& src, int src_x, int width, int height) const;
+    
+    /**
+     * 创建输出 BufferPool（open() 成功后调用）
+     */
+    bool createBufferPool();
+};
+
+#endif // TEST_PATTERN_WORKER_HPP
@@ -3,6 +3,7 @@
 
 #include "productionline/worker/IVideoFileNavigator.hpp"
 #include "productionline/worker/WorkerConfig.hpp"
+#include "productionline/worker/DecodedFrameCache.hpp"
 #include "buffer/bufferpool/Buffer.hpp"
 #include "buffer/BufferAllocatorFacade.hpp"
 #include "buffer/BufferAllocatorFactory.hpp"
@@ -62,6 +63,9 @@ public:
      * - FRAMEBUFFER: Framebuffer设备Worker（需要包装外部内存）
      * - AUTO: 默认使用NORMAL（不推荐，子类应明确指定）
      * 
+     * 配置了放置（config.placement）时 NORMAL 改为 PAGE_ALIGNED：
+     * 每个 Buffer 从页边界开始，绑定 NUMA 节点时整页迁移，不牵连相邻分配
+     * 
      * 构造顺序：
      * 1. 父类 WorkerBase 构造（创建 allocator_facade_）
      * 2. 子类成员变量初始化
@@ -73,8 +77,9 @@ public:
     explicit WorkerBase(
         BufferAllocatorFactory::AllocatorType allocator_type,
         const WorkerConfig& config = WorkerConfig()
-    ) : allocator_facade_(allocator_type)  // 🎯 父类直接创建Allocator门面
+    ) : allocator_facade_(placementAllocatorType(allocator_type, config))  // 🎯 父类直接创建Allocator门面
       , buffer_pool_id_(0)  // v2.0: 记录 pool_id 而不是指针
+      , adopted_pool_id_(0)
       , worker_config_(config)  // 🎯 v2.2: 存储配置
     {
     }
@@ -94,6 +99,47 @@ public:
      */
     virtual bool fillBuffer(int frame_index, Buffer* buffer) = 0;
     
+    /**
+     * @brief 批量填充请求（fillBuffers 的一项）
+     */
+    struct FillRequest {
+        int frame_index = 0;       // 帧索引
+        Buffer* buffer = nullptr;  // 输出 Buffer（从 BufferPool 获取）
+        bool filled = false;       // 输出：是否填充成功
+    };
+    
+    /**
+     * @brief 批量填充Buffer
+     * 
+     * 默认实现：按顺序逐个调用 fillBuffer()，到达 EOF（isAtEnd()）后剩余请求不再填充
+     * 子类可以重写此方法，把一批帧合并为一次预读 / 一次提交 / 一次加锁
+     * 
+     * 重写要求：
+     * - 每个请求的结果写入 filled，与逐个调用 fillBuffer() 的结果一致
+     * - 到达 EOF 后剩余请求保持 filled=false（调用方按 isAtEnd() 处理循环或结束）
+     * 
+     * @param requests 请求数组（调用方按帧索引顺序排列）
+     * @param count 请求数
+     * @return 填充成功的请求数
+     */
+    virtual int fillBuffers(FillRequest* requests, int count) {
+        int filled = 0;
+        int i = 0;
+        for (; i < count; i++) {
+            requests[i].filled = fillBuffer(requests[i].frame_index, requests[i].buffer);
+            if (requests[i].filled) {
+                filled++;
+            } else if (isAtEnd()) {
+                i++;
+                break;
+            }
+        }
+        for (; i < count; i++) {
+            requests[i].filled = false;
+        }
+        return filled;
+    }
+    
     /**
      * @brief 获取Worker类型名称（用于调试和日志）
      * 
@@ -118,6 +164,36 @@ public:
         return buffer_pool_id_;
     }
     
+    /**
+     * @brief 使用外部 BufferPool 作为输出 Pool
+     * 
+     * open() 之前调用：open() 不再通过 Allocator 创建 Pool，getOutputBufferPoolId() 返回 pool_id。
+     * 生产线切换源（播放列表 / 热重启）时新 Worker 直接填充已有的工作 Pool，
+     * 不再分配用不到的 Buffer（raw Worker 的帧大小 Buffer、解码 Worker 的 AVFrame）
+     * 
+     * open() 之后调用：销毁 open() 时自建的 Pool，改为填充外部 Pool
+     * （生产线输出到共享内存 Pool 时使用：帧大小在 open() 之后才确定）
+     * 
+     * @param pool_id 外部 Pool ID（Pool 由调用方的 Allocator 持有，须比 Worker 活得久）
+     * 
+     * @note 外部 Pool 的 Buffer 类型须与 usesAVFrameBuffers() 一致
+     * @note open() 之后调用时自建 Pool 的 Buffer 必须都已归还（尚未开始填充）
+     */
+    void adoptOutputBufferPool(uint64_t pool_id) {
+        adopted_pool_id_ = pool_id;
+        if (pool_id != 0 && buffer_pool_id_ != 0 && buffer_pool_id_ != pool_id) {
+            allocator_facade_.destroyPool();
+            buffer_pool_id_ = pool_id;
+        }
+    }
+    
+    /**
+     * @brief Worker 填充的 Buffer 是否需要绑定 AVFrame（解码 Worker）
+     */
+    bool usesAVFrameBuffers() const {
+        return allocator_facade_.getAllocatorType() == BufferAllocatorFactory::AllocatorType::AVFRAME;
+    }
+    
     // ==================== 解码器配置功能（v2.2新增）====================
     
     /**
@@ -152,6 +228,34 @@ public:
         (void)enable;
     }
     
+    /**
+     * @brief 获取源帧率（用于生产线按源速率放行帧）
+     * 
+     * 默认实现：返回 0（Raw 文件没有时间信息）
+     * 子类可以重写此方法
+     * 
+     * @return 帧率（fps），未知返回 0
+     * 
+     * @note 必须在 open() 之后调用
+     */
+    virtual double getFrameRate() const {
+        return 0.0;
+    }
+    
+    /**
+     * @brief 获取解码帧缓存统计（用于 printStats 和监控）
+     * 
+     * 默认实现：返回 false（Worker 没有解码帧缓存）
+     * 子类可以重写此方法
+     * 
+     * @param stats 输出：缓存统计快照
+     * @return true 如果 Worker 启用了解码帧缓存
+     */
+    virtual bool getFrameCacheStats(DecodedFrameCache::Stats* stats) const {
+        (void)stats;
+        return false;
+    }
+    
     // ==================== 文件导航功能（继承自IVideoFileNavigator）====================
     // 以下方法继承自 IVideoFileNavigator，子类必须实现
     virtual bool open(const char* path) override = 0;
@@ -174,6 +278,32 @@ public:
     virtual bool isAtEnd() const override = 0;
     
 protected:
+    /**
+     * @brief 配置了放置时把 NORMAL 换成页对齐分配（见构造函数说明）
+     */
+    static BufferAllocatorFactory::AllocatorType placementAllocatorType(
+        BufferAllocatorFactory::AllocatorType allocator_type, const WorkerConfig& config) {
+        if (allocator_type == BufferAllocatorFactory::AllocatorType::NORMAL && config.placement.isEnabled()) {
+            return BufferAllocatorFactory::AllocatorType::PAGE_ALIGNED;
+        }
+        return allocator_type;
+    }
+    
+    /**
+     * @brief 创建输出 BufferPool（子类在 open() 中调用）
+     * 
+     * 已通过 adoptOutputBufferPool() 指定外部 Pool 时直接返回该 Pool，不分配 Buffer
+     * 
+     * @return pool_id（成功），0（失败）
+     */
+    uint64_t allocateOutputPool(int count, size_t size, const std::string& name,
+                                const std::string& category = "") {
+        if (adopted_pool_id_ != 0) {
+            return adopted_pool_id_;
+        }
+        return allocator_facade_.allocatePoolWithBuffers(count, size, name, category);
+    }
+    
     /**
      * @brief Allocator门面（所有Worker子类自动继承）
      */
@@ -190,6 +320,11 @@ protected:
      */
     uint64_t buffer_pool_id_;
     
+    /**
+     * @brief 外部输出 Pool ID（adoptOutputBufferPool() 设置，0=open() 时自建）
+     */
+    uint64_t adopted_pool_id_;
+    
     /**
      * @brief Worker配置（v2.2 所有Worker子类自动继承）
      * 
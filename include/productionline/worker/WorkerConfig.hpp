@@ -1,9 +1,11 @@
 #ifndef WORKER_CONFIG_HPP
 #define WORKER_CONFIG_HPP
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <optional>
+#include <vector>
 
 /**
  * @brief Worker 类型枚举
@@ -15,7 +17,19 @@ enum class WorkerType {
     MMAP_RAW,          // Mmap Raw 视频文件
     IOURING_RAW,       // IoUring Raw 视频文件
     FFMPEG_RTSP,       // FFmpeg RTSP 流
-    FFMPEG_VIDEO_FILE  // FFmpeg 视频文件
+    FFMPEG_VIDEO_FILE, // FFmpeg 视频文件
+    IMAGE_SEQUENCE,    // 逐帧文件目录（每个文件一帧 raw 图像）
+    RAW_STREAM,        // 管道 / FIFO / Unix 流套接字上的 raw 帧流
+    TEST_PATTERN       // 合成测试图案（不读文件，用于压测和 CI）
+};
+
+/**
+ * @brief 文件读取方式（FfmpegDecodeVideoFileWorker 的解复用 I/O）
+ */
+enum class FileIoMode {
+    DEFAULT,           // FFmpeg 默认 file 协议（同步小块 read）
+    MMAP,              // 自定义 AVIOContext：映射整个文件，按预读窗口 madvise
+    IO_URING           // 自定义 AVIOContext：io_uring 预读块环，读取与解码重叠
 };
 
 /**
@@ -31,6 +45,9 @@ enum class WorkerType {
  * - FileConfig: 文件路径和导航参数
  * - OutputConfig: 输出分辨率和格式
  * - DecoderConfig: 解码器类型和参数
+ * - PlacementConfig: 生产者线程 CPU 亲和性和 BufferPool 内存 NUMA 放置
+ * - CacheConfig: 解码帧缓存（短片段循环播放）和解码一次的 raw 缓存文件
+ * - PatternConfig: 合成测试图案（TEST_PATTERN Worker）
  * - worker_type: Worker 实现类型
  */
 struct WorkerConfig {
@@ -41,6 +58,9 @@ struct WorkerConfig {
         std::string file_path;                // 文件路径（使用 std::string 保证生命周期安全）
         int start_frame = 0;                   // 起始帧
         int end_frame = -1;                    // 结束帧（-1=全部）
+        FileIoMode io_mode = FileIoMode::DEFAULT;        // 解复用读取方式（打开失败时回退 DEFAULT）
+        size_t readahead_bytes = 4 * 1024 * 1024;       // 预读窗口字节数（MMAP：madvise 范围；IO_URING：在途总量）
+        int readahead_depth = 4;                         // IO_URING 在途块数（窗口按块均分）；IMAGE_SEQUENCE 预取的文件数
         
         FileConfig() = default;
         FileConfig(const FileConfig&) = default;
@@ -56,8 +76,15 @@ struct WorkerConfig {
         int width = 0;                         // 输出宽度
         int height = 0;                        // 输出高度
         int bits_per_pixel = 0;                // 每像素位数
+        int pixel_format = -1;                 // raw 裸帧的 AVPixelFormat（-1=未知，按 bits_per_pixel 视为 packed）
+        int roi_x = 0;                         // 感兴趣区域左上角（raw Worker 只输出该区域）
+        int roi_y = 0;
+        int roi_width = 0;                     // 感兴趣区域尺寸（0=不裁剪，输出整帧）
+        int roi_height = 0;
         
         OutputConfig() = default;
+        
+        bool hasRoi() const { return roi_width > 0 && roi_height > 0; }
     } output;
     
     // ========================================
@@ -101,6 +128,58 @@ struct WorkerConfig {
         DecoderConfig& operator=(DecoderConfig&&) = default;
     } decoder;
     
+    // ========================================
+    // 放置配置（CPU 亲和性 / NUMA）
+    // ========================================
+    struct PlacementConfig {
+        int numa_node = -1;                    // BufferPool 内存和生产者线程所在节点（-1=不限制）
+        std::vector<int> cpu_affinity;         // 生产者线程 CPU 列表（空=使用 numa_node 的全部 CPU）
+        bool pin_per_thread = false;           // true=每个线程独占一个 CPU（按线程号轮转），false=共享整个 CPU 集合
+        
+        PlacementConfig() = default;
+        PlacementConfig(const PlacementConfig&) = default;
+        PlacementConfig& operator=(const PlacementConfig&) = default;
+        PlacementConfig(PlacementConfig&&) = default;
+        PlacementConfig& operator=(PlacementConfig&&) = default;
+        
+        bool isEnabled() const { return numa_node >= 0 || !cpu_affinity.empty(); }
+    } placement;
+    
+    // ========================================
+    // 缓存配置（解码帧缓存）
+    // ========================================
+    struct CacheConfig {
+        size_t frame_cache_bytes = 0;          // 解码帧缓存内存预算（0=禁用；片段超出预算时不缓存）
+        bool frame_cache_compress = false;     // 按帧 LZ4 压缩（需编译时检测到 liblz4）
+        std::string spill_path;                // 解码一次的 raw 缓存文件（空=禁用；有效时直接 mmap 播放）
+        
+        CacheConfig() = default;
+        CacheConfig(const CacheConfig&) = default;
+        CacheConfig& operator=(const CacheConfig&) = default;
+        CacheConfig(CacheConfig&&) = default;
+        CacheConfig& operator=(CacheConfig&&) = default;
+        
+        bool isFrameCacheEnabled() const { return frame_cache_bytes > 0; }
+        bool isSpillEnabled() const { return !spill_path.empty(); }
+    } cache;
+    
+    // ========================================
+    // 测试图案配置（TEST_PATTERN）
+    // ========================================
+    struct PatternConfig {
+        std::string name = "bars";             // bars / gradient / noise / counter
+        bool stamp_frame_number = false;       // 在左上角叠加帧号（counter 图案总是叠加）
+        double frame_rate = 0.0;               // getFrameRate() 报告的帧率（配合 setPacingFromSource()；0=不限速）
+        int total_frames = 0;                  // 总帧数（0=无限，与 RTSP 流一致）
+        uint32_t seed = 1;                     // noise 的随机种子（同一种子和帧号得到相同的帧）
+        
+        PatternConfig() = default;
+        PatternConfig(const PatternConfig&) = default;
+        PatternConfig& operator=(const PatternConfig&) = default;
+        PatternConfig(PatternConfig&&) = default;
+        PatternConfig& operator=(PatternConfig&&) = default;
+    } pattern;
+    
     // ========================================
     // Worker 类型
     // ========================================
@@ -162,6 +241,25 @@ public:
         return *this;
     }
     
+    /**
+     * @brief 设置解复用读取方式（仅 FfmpegDecodeVideoFileWorker 使用）
+     */
+    FileConfigBuilder& setIoMode(FileIoMode mode) {
+        config_.io_mode = mode;
+        return *this;
+    }
+    
+    /**
+     * @brief 设置预读窗口（MMAP / IO_URING 模式）
+     * @param window_bytes 窗口字节数
+     * @param depth IO_URING 在途块数（IMAGE_SEQUENCE：预取的文件数，window_bytes 不使用）
+     */
+    FileConfigBuilder& setReadahead(size_t window_bytes, int depth = 4) {
+        config_.readahead_bytes = window_bytes;
+        config_.readahead_depth = depth;
+        return *this;
+    }
+    
     WorkerConfig::FileConfig build() const {
         return config_;
     }
@@ -198,6 +296,27 @@ public:
         return *this;
     }
     
+    /**
+     * @brief 设置 raw 裸帧的像素格式（AVPixelFormat，如 AV_PIX_FMT_NV12）
+     * 
+     * raw Worker 据此计算 plane 布局并设置 Buffer 图像元数据；bits_per_pixel 可以不设置
+     */
+    OutputConfigBuilder& setPixelFormat(int pixel_format) {
+        config_.pixel_format = pixel_format;
+        return *this;
+    }
+    
+    /**
+     * @brief 设置感兴趣区域（width / height 为 0 表示不裁剪）
+     */
+    OutputConfigBuilder& setRoi(int x, int y, int width, int height) {
+        config_.roi_x = x;
+        config_.roi_y = y;
+        config_.roi_width = width;
+        config_.roi_height = height;
+        return *this;
+    }
+    
     WorkerConfig::OutputConfig build() const {
         return config_;
     }
@@ -419,6 +538,146 @@ private:
     WorkerConfig::DecoderConfig config_;
 };
 
+/**
+ * @brief 放置配置构建器
+ * 
+ * 示例：
+ * @code
+ * // 生产者线程和 BufferPool 内存都放在节点 1，每个线程绑定一个 CPU
+ * auto placement = PlacementConfigBuilder()
+ *     .setNumaNode(1)
+ *     .setPinPerThread(true)
+ *     .build();
+ * @endcode
+ */
+class PlacementConfigBuilder {
+public:
+    PlacementConfigBuilder() = default;
+    
+    PlacementConfigBuilder& setNumaNode(int node) {
+        config_.numa_node = node;
+        return *this;
+    }
+    
+    PlacementConfigBuilder& setCpuAffinity(const std::vector<int>& cpus) {
+        config_.cpu_affinity = cpus;
+        return *this;
+    }
+    
+    PlacementConfigBuilder& setPinPerThread(bool enable = true) {
+        config_.pin_per_thread = enable;
+        return *this;
+    }
+    
+    WorkerConfig::PlacementConfig build() const {
+        return config_;
+    }
+    
+private:
+    WorkerConfig::PlacementConfig config_;
+};
+
+/**
+ * @brief 缓存配置构建器
+ * 
+ * 示例：
+ * @code
+ * // 10 秒 1080p 循环片段：第一遍解码后从内存播放
+ * auto cache = CacheConfigBuilder()
+ *     .setFrameCacheBytes(512UL * 1024 * 1024)
+ *     .build();
+ * 
+ * // 较长片段：解码一次写入 raw 缓存文件，之后的运行直接 mmap 播放
+ * auto spill = CacheConfigBuilder()
+ *     .setSpillPath("/data/cache/clip.rawvid")
+ *     .build();
+ * @endcode
+ * 
+ * @note 缓存命中的帧没有物理地址，依赖物理地址（DMA）的消费者不应启用
+ */
+class CacheConfigBuilder {
+public:
+    CacheConfigBuilder() = default;
+    
+    CacheConfigBuilder& setFrameCacheBytes(size_t bytes) {
+        config_.frame_cache_bytes = bytes;
+        return *this;
+    }
+    
+    CacheConfigBuilder& setFrameCacheCompress(bool enable = true) {
+        config_.frame_cache_compress = enable;
+        return *this;
+    }
+    
+    /**
+     * @brief 设置 raw 缓存文件路径
+     * 
+     * 第一次运行时 FFmpeg Worker 把解码后的帧写入该文件（完整解码到 EOF 后生效）；
+     * 之后的运行若源文件和解码配置未变，改由 MmapRawVideoFileWorker 直接映射播放
+     */
+    CacheConfigBuilder& setSpillPath(std::string_view path) {
+        config_.spill_path = std::string(path);
+        return *this;
+    }
+    
+    WorkerConfig::CacheConfig build() const {
+        return config_;
+    }
+    
+private:
+    WorkerConfig::CacheConfig config_;
+};
+
+/**
+ * @brief 测试图案配置构建器
+ * 
+ * 示例：
+ * @code
+ * // 1080p NV12 彩条 + 帧号，按 60 fps 放行（VideoProductionLine::setPacingFromSource()）
+ * auto pattern = PatternConfigBuilder()
+ *     .setName("bars")
+ *     .setStampFrameNumber(true)
+ *     .setFrameRate(60.0)
+ *     .build();
+ * @endcode
+ */
+class PatternConfigBuilder {
+public:
+    PatternConfigBuilder() = default;
+    
+    PatternConfigBuilder& setName(std::string_view name) {
+        config_.name = std::string(name);
+        return *this;
+    }
+    
+    PatternConfigBuilder& setStampFrameNumber(bool enable = true) {
+        config_.stamp_frame_number = enable;
+        return *this;
+    }
+    
+    PatternConfigBuilder& setFrameRate(double fps) {
+        config_.frame_rate = fps;
+        return *this;
+    }
+    
+    PatternConfigBuilder& setTotalFrames(int frames) {
+        config_.total_frames = frames;
+        return *this;
+    }
+    
+    PatternConfigBuilder& setSeed(uint32_t seed) {
+        config_.seed = seed;
+        return *this;
+    }
+    
+    WorkerConfig::PatternConfig build() const {
+        return config_;
+    }
+    
+private:
+    WorkerConfig::PatternConfig config_;
+};
+
 /**
  * @brief Worker 配置构建器（顶层）
  * 
@@ -452,6 +711,30 @@ public:
         return *this;
     }
     
+    /**
+     * @brief 设置放置配置（CPU 亲和性 / NUMA）
+     */
+    WorkerConfigBuilder& setPlacementConfig(const WorkerConfig::PlacementConfig& placement_config) {
+        config_.placement = placement_config;
+        return *this;
+    }
+    
+    /**
+     * @brief 设置缓存配置（解码帧缓存）
+     */
+    WorkerConfigBuilder& setCacheConfig(const WorkerConfig::CacheConfig& cache_config) {
+        config_.cache = cache_config;
+        return *this;
+    }
+    
+    /**
+     * @brief 设置测试图案配置（TEST_PATTERN）
+     */
+    WorkerConfigBuilder& setPatternConfig(const WorkerConfig::PatternConfig& pattern_config) {
+        config_.pattern = pattern_config;
+        return *this;
+    }
+    
     /**
      * @brief 设置 Worker 类型
      */
@@ -32,6 +32,13 @@ std::unique_ptr<BufferAllocatorBase> BufferAllocatorFactory::create(
                 64
             );
             
+        case AllocatorType::PAGE_ALIGNED:
+            LOG_DEBUG_FMT("[BufferAllocatorFactory] 创建NormalAllocator (MALLOC, 4096-byte aligned)");
+            return std::make_unique<NormalAllocator>(
+                BufferMemoryAllocatorType::NORMAL_MALLOC,
+                4096
+            );
+            
         case AllocatorType::AVFRAME:
             LOG_DEBUG("[BufferAllocatorFactory] 创建AVFrameAllocator");
             return std::make_unique<AVFrameAllocator>();
@@ -77,6 +84,8 @@ std::unique_ptr<BufferAllocatorBase> BufferAllocatorFactory::createByName(
     
     if (strcmp(name, "normal") == 0) {
         return createByType(AllocatorType::NORMAL, mem_type, alignment);
+    } else if (strcmp(name, "page_aligned") == 0) {
+        return createByType(AllocatorType::PAGE_ALIGNED, mem_type, alignment);
     } else if (strcmp(name, "avframe") == 0) {
         return createByType(AllocatorType::AVFRAME, mem_type, alignment);
     } else if (strcmp(name, "framebuffer") == 0) {
@@ -93,6 +102,7 @@ const char* BufferAllocatorFactory::typeToString(AllocatorType type) {
     switch (type) {
         case AllocatorType::AUTO:        return "AUTO";
         case AllocatorType::NORMAL:     return "NORMAL";
+        case AllocatorType::PAGE_ALIGNED: return "PAGE_ALIGNED";
         case AllocatorType::AVFRAME:    return "AVFRAME";
         case AllocatorType::FRAMEBUFFER: return "FRAMEBUFFER";
         default:                         return "UNKNOWN";
@@ -113,6 +123,10 @@ std::unique_ptr<BufferAllocatorBase> BufferAllocatorFactory::createByType(
             LOG_DEBUG("🏭 [BufferAllocatorFactory] Creating NormalAllocator");
             return std::make_unique<NormalAllocator>(mem_type, alignment);
             
+        case AllocatorType::PAGE_ALIGNED:
+            LOG_DEBUG("🏭 [BufferAllocatorFactory] Creating page-aligned NormalAllocator");
+            return std::make_unique<NormalAllocator>(mem_type, alignment > 4096 ? alignment : 4096);
+            
         case AllocatorType::AVFRAME:
             LOG_DEBUG("🏭 [BufferAllocatorFactory] Creating AVFrameAllocator");
             return std::make_unique<AVFrameAllocator>();
@@ -22,6 +22,7 @@ Buffer::Buffer(uint32_t id,
     , linesize_{0, 0, 0, 0}
     , plane_offset_{0, 0, 0, 0}
     , nb_planes_(0)
+    , source_id_(-1)
     , validation_magic_(MAGIC_NUMBER)
 {
 }
@@ -43,6 +44,7 @@ Buffer::Buffer(Buffer&& other) noexcept
     , linesize_{other.linesize_[0], other.linesize_[1], other.linesize_[2], other.linesize_[3]}
     , plane_offset_{other.plane_offset_[0], other.plane_offset_[1], other.plane_offset_[2], other.plane_offset_[3]}
     , nb_planes_(other.nb_planes_)
+    , source_id_(other.source_id_)
     , validation_magic_(other.validation_magic_)
 {
     // 清空源对象
@@ -71,6 +73,7 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept {
         memcpy(linesize_, other.linesize_, sizeof(linesize_));
         memcpy(plane_offset_, other.plane_offset_, sizeof(plane_offset_));
         nb_planes_ = other.nb_planes_;
+        source_id_ = other.source_id_;
         validation_magic_ = other.validation_magic_;
         
         // 清空源对象
@@ -126,3 +129,13 @@ void Buffer::setImageMetadataFromAVFrame(const AVFrame* frame) {
     has_image_metadata_ = true;
 }
 
+void Buffer::setImageMetadata(int width, int height, AVPixelFormat format,
+                              const int linesize[4], const size_t plane_offset[4], int nb_planes) {
+    width_ = width;
+    height_ = height;
+    format_ = format;
+    memcpy(linesize_, linesize, sizeof(linesize_));
+    memcpy(plane_offset_, plane_offset, sizeof(plane_offset_));
+    nb_planes_ = nb_planes;
+    has_image_metadata_ = true;
+}
@@ -1,8 +1,12 @@
 #include "buffer/bufferpool/BufferPool.hpp"
 #include "buffer/bufferpool/BufferPoolRegistry.hpp"
 #include "common/Logger.hpp"
+#include "common/NumaPlacement.hpp"
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <stdexcept>
 #include <chrono>
+#include <map>
 
 // ============================================================
 // 构造函数实现
@@ -17,6 +21,9 @@ BufferPool::BufferPool(
     , category_(category)
     , registry_id_(0)
     , running_(true)
+    , numa_node_(-1)
+    , filled_event_fd_(-1)
+    , free_event_fd_(-1)
     , log_prefix_("[BufferPool::" + name + "]")
 {
     (void)token;  // 标记 token 已使用
@@ -42,6 +49,14 @@ BufferPool::~BufferPool() {
     // 停止等待线程
     shutdown();
     
+    // 关闭事件通知 fd
+    if (filled_event_fd_.load() >= 0) {
+        close(filled_event_fd_.load());
+    }
+    if (free_event_fd_.load() >= 0) {
+        close(free_event_fd_.load());
+    }
+    
     // ⚠️ 注意：不再在这里调用 unregisterPool()
     // 原因：
     // 1. unregisterPool() 现在是私有方法，只能由 Allocator 的 destroyPool() 调用
@@ -59,6 +74,10 @@ void BufferPool::shutdown() {
     // 唤醒所有等待的线程
     free_cv_.notify_all();
     filled_cv_.notify_all();
+    
+    // 唤醒事件循环（消费者检测到 acquire 返回 nullptr 后退出）
+    signalEventFd(filled_event_fd_.load());
+    signalEventFd(free_event_fd_.load());
 }
 
 // ============================================================
@@ -66,6 +85,15 @@ void BufferPool::shutdown() {
 // ============================================================
 
 Buffer* BufferPool::acquireFree(bool blocking, int timeout_ms) {
+    Buffer* buffer = nullptr;
+    return acquireFreeBatch(&buffer, 1, blocking, timeout_ms) == 1 ? buffer : nullptr;
+}
+
+int BufferPool::acquireFreeBatch(Buffer** out, int max_count, bool blocking, int timeout_ms) {
+    if (!out || max_count <= 0) {
+        return 0;
+    }
+    
     std::unique_lock<std::mutex> lock(mutex_);
     
     if (blocking) {
@@ -81,7 +109,7 @@ Buffer* BufferPool::acquireFree(bool blocking, int timeout_ms) {
             
             while (free_queue_.empty() && running_) {
                 if (free_cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
-                    return nullptr;  // 超时
+                    return 0;  // 超时
                 }
             }
         }
@@ -89,22 +117,21 @@ Buffer* BufferPool::acquireFree(bool blocking, int timeout_ms) {
     
     // 检查是否因为 shutdown 而退出
     if (!running_) {
-        return nullptr;
+        return 0;
     }
     
-    // 检查队列是否为空
-    if (free_queue_.empty()) {
-        return nullptr;
+    // 获取 buffer（队列为空时返回 0）
+    int count = 0;
+    while (count < max_count && !free_queue_.empty()) {
+        Buffer* buffer = free_queue_.front();
+        free_queue_.pop();
+        
+        // 更新状态
+        buffer->setState(Buffer::State::LOCKED_BY_PRODUCER);
+        out[count++] = buffer;
     }
     
-    // 获取 buffer
-    Buffer* buffer = free_queue_.front();
-    free_queue_.pop();
-    
-    // 更新状态
-    buffer->setState(Buffer::State::LOCKED_BY_PRODUCER);
-    
-    return buffer;
+    return count;
 }
 
 void BufferPool::submitFilled(Buffer* buffer_ptr) {
@@ -112,6 +139,7 @@ void BufferPool::submitFilled(Buffer* buffer_ptr) {
         return;
     }
     
+    bool became_non_empty = false;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         
@@ -131,12 +159,16 @@ void BufferPool::submitFilled(Buffer* buffer_ptr) {
         }
         
         // 添加到 filled 队列
+        became_non_empty = filled_queue_.empty();
         filled_queue_.push(buffer_ptr);
         buffer_ptr->setState(Buffer::State::READY_FOR_CONSUME);
     }
     
     // 通知消费者（锁外通知）
     filled_cv_.notify_one();
+    if (became_non_empty) {
+        signalEventFd(filled_event_fd_.load());
+    }
 }
 
 void BufferPool::releaseFree(Buffer* buffer_ptr) {
@@ -144,6 +176,7 @@ void BufferPool::releaseFree(Buffer* buffer_ptr) {
         return;
     }
     
+    bool became_non_empty = false;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         
@@ -163,12 +196,16 @@ void BufferPool::releaseFree(Buffer* buffer_ptr) {
         }
         
         // 归还到 free 队列
+        became_non_empty = free_queue_.empty();
         free_queue_.push(buffer_ptr);
         buffer_ptr->setState(Buffer::State::IDLE);
     }
     
     // 通知生产者（锁外通知）
     free_cv_.notify_one();
+    if (became_non_empty) {
+        signalEventFd(free_event_fd_.load());
+    }
 }
 
 // ============================================================
@@ -222,6 +259,7 @@ void BufferPool::releaseFilled(Buffer* buffer) {
         return;
     }
     
+    bool became_non_empty = false;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         
@@ -241,12 +279,16 @@ void BufferPool::releaseFilled(Buffer* buffer) {
         }
         
         // 归还到 free 队列
+        became_non_empty = free_queue_.empty();
         free_queue_.push(buffer);
         buffer->setState(Buffer::State::IDLE);
     }
     
     // 通知生产者（锁外通知）
     free_cv_.notify_one();
+    if (became_non_empty) {
+        signalEventFd(free_event_fd_.load());
+    }
 }
 
 // ============================================================
@@ -304,6 +346,7 @@ bool BufferPool::addBufferToQueue(Buffer* buffer, QueueType queue) {
         return false;
     }
     
+    bool became_non_empty = false;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         
@@ -319,9 +362,11 @@ bool BufferPool::addBufferToQueue(Buffer* buffer, QueueType queue) {
         
         // 添加到指定队列
         if (queue == QueueType::FREE) {
+            became_non_empty = free_queue_.empty();
             free_queue_.push(buffer);
             buffer->setState(Buffer::State::IDLE);
         } else {
+            became_non_empty = filled_queue_.empty();
             filled_queue_.push(buffer);
             buffer->setState(Buffer::State::READY_FOR_CONSUME);
         }
@@ -330,8 +375,14 @@ bool BufferPool::addBufferToQueue(Buffer* buffer, QueueType queue) {
     // 在锁外通知（避免惊群效应）
     if (queue == QueueType::FREE) {
         free_cv_.notify_one();
+        if (became_non_empty) {
+            signalEventFd(free_event_fd_.load());
+        }
     } else {
         filled_cv_.notify_one();
+        if (became_non_empty) {
+            signalEventFd(filled_event_fd_.load());
+        }
     }
     
     return true;
@@ -400,6 +451,100 @@ bool BufferPool::removeFromQueue(std::queue<Buffer*>& queue, Buffer* target) {
     return found;
 }
 
+// ============================================================
+// 事件通知（eventfd）
+// ============================================================
+
+int BufferPool::getFilledEventFd() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (filled_event_fd_.load() < 0) {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) {
+            LOG_ERROR_FMT("%s eventfd() failed for filled queue", log_prefix_.c_str());
+            return -1;
+        }
+        filled_event_fd_.store(fd);
+        
+        // 已有就绪 Buffer 时立即置位，避免事件循环错过初始状态
+        if (!filled_queue_.empty() || !running_) {
+            signalEventFd(fd);
+        }
+    }
+    return filled_event_fd_.load();
+}
+
+int BufferPool::getFreeEventFd() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (free_event_fd_.load() < 0) {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) {
+            LOG_ERROR_FMT("%s eventfd() failed for free queue", log_prefix_.c_str());
+            return -1;
+        }
+        free_event_fd_.store(fd);
+        
+        if (!free_queue_.empty() || !running_) {
+            signalEventFd(fd);
+        }
+    }
+    return free_event_fd_.load();
+}
+
+void BufferPool::clearFilledEvent() {
+    drainEventFd(filled_event_fd_.load());
+}
+
+void BufferPool::clearFreeEvent() {
+    drainEventFd(free_event_fd_.load());
+}
+
+void BufferPool::signalEventFd(int fd) {
+    if (fd < 0) {
+        return;
+    }
+    uint64_t one = 1;
+    // EFD_NONBLOCK：计数器溢出时返回 EAGAIN，此时 fd 已处于可读状态，忽略即可
+    ssize_t ret = write(fd, &one, sizeof(one));
+    (void)ret;
+}
+
+void BufferPool::drainEventFd(int fd) {
+    if (fd < 0) {
+        return;
+    }
+    uint64_t value = 0;
+    ssize_t ret = read(fd, &value, sizeof(value));
+    (void)ret;
+}
+
+// ============================================================
+// NUMA 放置
+// ============================================================
+
+int BufferPool::bindToNumaNode(int node) {
+    if (node < 0) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    int bound = 0;
+    for (Buffer* buf : managed_buffers_) {
+        if (NumaPlacement::bindMemoryToNode(buf->getVirtualAddress(), buf->size(), node)) {
+            bound++;
+        }
+    }
+    numa_node_.store(node);
+    
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+    LOG4CPLUS_INFO(logger, log_prefix_ << " 绑定到 NUMA 节点 " << node 
+                   << ": " << bound << "/" << managed_buffers_.size() << " buffers");
+    
+    return bound;
+}
+
 // ============================================================
 // 调试接口实现
 // ============================================================
@@ -418,6 +563,23 @@ void BufferPool::printStats() const {
     LOG4CPLUS_INFO(logger, "[BufferPool]   Free buffers: " << free_queue_.size());
     LOG4CPLUS_INFO(logger, "[BufferPool]   Filled buffers: " << filled_queue_.size());
     LOG4CPLUS_INFO(logger, "[BufferPool]   Running: " << (running_ ? "Yes" : "No"));
+    
+    // NUMA 放置：按每个 Buffer 首页所在节点统计
+    std::map<int, int> node_distribution;
+    for (Buffer* buf : managed_buffers_) {
+        node_distribution[NumaPlacement::getNodeOfAddress(buf->getVirtualAddress())]++;
+    }
+    std::string distribution;
+    for (const auto& entry : node_distribution) {
+        if (!distribution.empty()) {
+            distribution += ", ";
+        }
+        distribution += (entry.first < 0 ? std::string("unknown") : "node" + std::to_string(entry.first))
+                        + "=" + std::to_string(entry.second);
+    }
+    LOG4CPLUS_INFO(logger, "[BufferPool]   NUMA node: " 
+                   << (numa_node_.load() < 0 ? std::string("(unbound)") : std::to_string(numa_node_.load()))
+                   << ", actual: " << (distribution.empty() ? "(none)" : distribution));
     LOG4CPLUS_INFO(logger, "[BufferPool] ========================================");
 }
 
@@ -1,6 +1,7 @@
 #include "buffer/bufferpool/BufferPoolRegistry.hpp"
 #include "common/Logger.hpp"
 #include "buffer/bufferpool/BufferPool.hpp"
+#include "buffer/bufferpool/SharedMemoryBufferPool.hpp"
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
@@ -98,6 +99,109 @@ size_t BufferPoolRegistry::getPoolCount() const {
     return pools_.size();
 }
 
+// ========== 跨进程共享内存 Pool 接口实现 ==========
+
+uint64_t BufferPoolRegistry::createSharedPool(const std::string& name, int buffer_count, 
+                                              size_t buffer_size, const std::string& category) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shared_name_to_id_.find(name) != shared_name_to_id_.end()) {
+            LOG_WARN_FMT("[Registry]  Error: Shared BufferPool '%s' already exists in this process", name.c_str());
+            return 0;
+        }
+    }
+    
+    // 创建共享内存段（不持锁，涉及系统调用）
+    auto pool = SharedMemoryBufferPool::create(name, buffer_count, buffer_size, category);
+    if (!pool) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    uint64_t id = next_id_++;
+    pool->setRegistryId(id);
+    
+    SharedPoolInfo info;
+    info.pool = pool;
+    info.id = id;
+    info.name = name;
+    info.created_time = std::chrono::system_clock::now();
+    
+    shared_pools_[id] = info;
+    shared_name_to_id_[name] = id;
+    
+    LOG_DEBUG_FMT("[Registry] Shared pool created: '%s' (ID: %lu, Category: %s)",
+           name.c_str(), id, category.empty() ? "None" : category.c_str());
+    
+    return id;
+}
+
+uint64_t BufferPoolRegistry::attachSharedPool(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = shared_name_to_id_.find(name);
+        if (it != shared_name_to_id_.end()) {
+            return it->second;
+        }
+    }
+    
+    auto pool = SharedMemoryBufferPool::attach(name);
+    if (!pool) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    uint64_t id = next_id_++;
+    pool->setRegistryId(id);
+    
+    SharedPoolInfo info;
+    info.pool = pool;
+    info.id = id;
+    info.name = name;
+    info.created_time = std::chrono::system_clock::now();
+    
+    shared_pools_[id] = info;
+    shared_name_to_id_[name] = id;
+    
+    LOG_DEBUG_FMT("[Registry] Shared pool attached: '%s' (ID: %lu)", name.c_str(), id);
+    
+    return id;
+}
+
+std::weak_ptr<SharedMemoryBufferPool> BufferPoolRegistry::getSharedPool(uint64_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto it = shared_pools_.find(id);
+    if (it == shared_pools_.end()) {
+        return std::weak_ptr<SharedMemoryBufferPool>();
+    }
+    
+    return it->second.pool;
+}
+
+void BufferPoolRegistry::releaseSharedPool(uint64_t id) {
+    std::shared_ptr<SharedMemoryBufferPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        auto it = shared_pools_.find(id);
+        if (it == shared_pools_.end()) {
+            LOG_WARN_FMT("[Registry]  Warning: Trying to release non-existent shared BufferPool (ID: %lu)", id);
+            return;
+        }
+        
+        pool = it->second.pool;
+        shared_name_to_id_.erase(it->second.name);
+        shared_pools_.erase(it);
+    }
+    
+    // 在锁外析构（munmap / shm_unlink）
+    LOG_DEBUG_FMT("[Registry] Shared pool released: '%s' (ID: %lu)", pool->getName().c_str(), id);
+    pool.reset();
+}
+
 // ========== v2.0 新增：Allocator 友元方法 ==========
 
 std::shared_ptr<BufferPool> BufferPoolRegistry::getPoolSpecialForAllocator(uint64_t id) {
@@ -143,9 +247,9 @@ void BufferPoolRegistry::printAllStats() const {
     LOG_INFO("========================================");
     LOG_INFO("📊 Global BufferPool Statistics");
     LOG_INFO("========================================");
-    LOG_INFO_FMT("Total Pools: %zu", pools_.size());
+    LOG_INFO_FMT("Total Pools: %zu (shared: %zu)", pools_.size() + shared_pools_.size(), shared_pools_.size());
     
-    if (pools_.empty()) {
+    if (pools_.empty() && shared_pools_.empty()) {
         LOG_INFO("   (No BufferPools registered)");
         LOG_INFO("========================================");
         return;
@@ -189,6 +293,27 @@ void BufferPoolRegistry::printAllStats() const {
         LOG_INFO_FMT("   Created: %s", time_buf);
     }
     
+    for (const auto& pair : shared_pools_) {
+        const SharedPoolInfo& info = pair.second;
+        std::shared_ptr<SharedMemoryBufferPool> pool = info.pool;
+        
+        LOG_INFO_FMT("[%s] %s (ID: %lu, shared, %s)",
+               pool->getCategory().empty() ? "Uncategorized" : pool->getCategory().c_str(),
+               info.name.c_str(),
+               info.id,
+               pool->isCreator() ? "creator" : "attached");
+        
+        LOG_INFO_FMT("   Buffers: %d total, %d free, %d filled",
+               pool->getTotalCount(),
+               pool->getFreeCount(),
+               pool->getFilledCount());
+        
+        size_t pool_memory = pool->getTotalCount() * pool->getBufferSize();
+        total_memory += pool_memory;
+        
+        LOG_INFO_FMT("   Memory: %.2f MB", pool_memory / (1024.0 * 1024.0));
+    }
+    
     LOG_INFO("========================================");
     LOG_INFO_FMT("TOTAL MEMORY: %.2f MB", total_memory / (1024.0 * 1024.0));
     LOG_INFO("========================================");
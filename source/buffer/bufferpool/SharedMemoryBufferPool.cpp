@@ -0,0 +1,707 @@
+#include "buffer/bufferpool/SharedMemoryBufferPool.hpp"
+#include "common/Logger.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+// ============================================================
+// 共享内存结构定义
+// ============================================================
+
+namespace {
+
+constexpr uint32_t kShmMagic = 0x53484D50;     // "SHMP"
+constexpr uint32_t kShmVersion = 1;
+constexpr size_t kCacheLine = 64;
+constexpr size_t kDataAlignment = 4096;
+constexpr int kWaitSliceMs = 100;              // 单次 futex 等待上限（用于检查存活）
+constexpr int32_t kNoOwner = 0;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t nextPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+long futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+long futexWake(std::atomic<uint32_t>* word, int count) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+bool isProcessAlive(int32_t pid) {
+    if (pid <= 0) {
+        return false;
+    }
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32-bit");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+}  // namespace
+
+/**
+ * @brief 共享内存头部（所有进程共享）
+ */
+struct SharedMemoryBufferPool::ShmHeader {
+    std::atomic<uint32_t> magic;            // 初始化完成后写入（附加进程据此判断可用）
+    uint32_t version;
+    uint32_t buffer_count;
+    uint32_t ring_capacity;                 // 环形队列容量（2 的幂）
+    uint64_t buffer_size;                   // 用户请求的 Buffer 大小
+    uint64_t buffer_stride;                 // 对齐后的 Buffer 间距
+    uint64_t meta_offset;
+    uint64_t free_ring_offset;
+    uint64_t filled_ring_offset;
+    uint64_t data_offset;
+    uint64_t total_size;
+    int32_t creator_pid;
+    std::atomic<uint32_t> running;
+    std::atomic<uint32_t> attach_count;
+    char category[64];
+
+    alignas(kCacheLine) std::atomic<uint32_t> free_futex;     // free 队列变化序号
+    std::atomic<uint32_t> free_waiters;
+    alignas(kCacheLine) std::atomic<uint32_t> filled_futex;   // filled 队列变化序号
+    std::atomic<uint32_t> filled_waiters;
+};
+
+/**
+ * @brief 有界 MPMC 环形队列（每个槽位带序号，无锁）
+ */
+struct SharedMemoryBufferPool::ShmRing {
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        uint32_t index;
+        uint32_t reserved;
+    };
+
+    alignas(kCacheLine) std::atomic<uint64_t> enqueue_pos;
+    alignas(kCacheLine) std::atomic<uint64_t> dequeue_pos;
+    alignas(kCacheLine) uint32_t mask;
+    Slot slots[1];                          // 实际长度为 ring_capacity
+
+    static size_t bytesFor(uint32_t capacity) {
+        return alignUp(sizeof(ShmRing) + sizeof(Slot) * (capacity - 1), kCacheLine);
+    }
+};
+
+/**
+ * @brief 每个 Buffer 的共享元数据
+ */
+struct SharedMemoryBufferPool::ShmBufferMeta {
+    std::atomic<uint32_t> state;            // Buffer::State
+    std::atomic<int32_t> owner_pid;         // 当前持有者进程（0=在队列中）
+    int32_t has_image_metadata;
+    int32_t width;
+    int32_t height;
+    int32_t format;
+    int32_t nb_planes;
+    int32_t linesize[4];
+    uint64_t plane_offset[4];
+};
+
+// ============================================================
+// 构造函数和析构函数
+// ============================================================
+
+SharedMemoryBufferPool::SharedMemoryBufferPool(const std::string& name, bool is_creator)
+    : name_(name)
+    , category_()
+    , registry_id_(0)
+    , is_creator_(is_creator)
+    , fd_(-1)
+    , base_(nullptr)
+    , mapped_size_(0)
+    , header_(nullptr)
+    , metas_(nullptr)
+    , free_ring_(nullptr)
+    , filled_ring_(nullptr)
+    , buffer_size_(0)
+    , buffers_()
+    , log_prefix_("[SharedMemoryBufferPool::" + name + "]")
+{
+}
+
+SharedMemoryBufferPool::~SharedMemoryBufferPool() {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+
+    if (header_) {
+        if (is_creator_) {
+            shutdown();
+        } else {
+            header_->attach_count.fetch_sub(1);
+        }
+        LOG4CPLUS_INFO(logger, log_prefix_ << " 析构: " << (is_creator_ ? "creator" : "attached")
+                       << ", free=" << getFreeCount() << ", filled=" << getFilledCount());
+    }
+
+    buffers_.clear();
+
+    if (base_) {
+        munmap(base_, mapped_size_);
+        base_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    if (is_creator_) {
+        shm_unlink(toShmPath(name_).c_str());
+    }
+}
+
+// ============================================================
+// 工厂方法
+// ============================================================
+
+std::shared_ptr<SharedMemoryBufferPool> SharedMemoryBufferPool::create(
+    const std::string& name,
+    int buffer_count,
+    size_t buffer_size,
+    const std::string& category)
+{
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+
+    if (name.empty() || buffer_count <= 0 || buffer_size == 0) {
+        LOG4CPLUS_ERROR(logger, "[SharedMemoryBufferPool] Invalid parameters: name='" << name
+                        << "', count=" << buffer_count << ", size=" << buffer_size);
+        return nullptr;
+    }
+
+    // 计算布局
+    uint32_t capacity = nextPowerOfTwo(static_cast<uint32_t>(buffer_count));
+    size_t stride = alignUp(buffer_size, kDataAlignment);
+    size_t meta_offset = alignUp(sizeof(ShmHeader), kCacheLine);
+    size_t free_ring_offset = alignUp(meta_offset + sizeof(ShmBufferMeta) * buffer_count, kCacheLine);
+    size_t filled_ring_offset = free_ring_offset + ShmRing::bytesFor(capacity);
+    size_t data_offset = alignUp(filled_ring_offset + ShmRing::bytesFor(capacity), kDataAlignment);
+    size_t total_size = data_offset + stride * buffer_count;
+
+    std::string path = toShmPath(name);
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        LOG4CPLUS_ERROR(logger, "[SharedMemoryBufferPool] shm_open('" << path << "') failed: " << strerror(errno));
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(total_size)) != 0) {
+        LOG4CPLUS_ERROR(logger, "[SharedMemoryBufferPool] ftruncate failed: " << strerror(errno));
+        close(fd);
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+
+    std::shared_ptr<SharedMemoryBufferPool> pool(new SharedMemoryBufferPool(name, true));
+    pool->category_ = category;
+
+    // 先写入布局信息和队列序号（ftruncate 后内容全部为 0），再由 mapSegment() 按布局建立视图
+    void* base = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        LOG4CPLUS_ERROR(logger, "[SharedMemoryBufferPool] mmap failed: " << strerror(errno));
+        close(fd);
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+
+    ShmHeader* header = static_cast<ShmHeader*>(base);
+    header->version = kShmVersion;
+    header->buffer_count = static_cast<uint32_t>(buffer_count);
+    header->ring_capacity = capacity;
+    header->buffer_size = buffer_size;
+    header->buffer_stride = stride;
+    header->meta_offset = meta_offset;
+    header->free_ring_offset = free_ring_offset;
+    header->filled_ring_offset = filled_ring_offset;
+    header->data_offset = data_offset;
+    header->total_size = total_size;
+    header->creator_pid = getpid();
+    header->running.store(1);
+    header->attach_count.store(0);
+    strncpy(header->category, category.c_str(), sizeof(header->category) - 1);
+    header->free_futex.store(0);
+    header->free_waiters.store(0);
+    header->filled_futex.store(0);
+    header->filled_waiters.store(0);
+
+    // 初始化环形队列序号
+    auto* rings_base = static_cast<uint8_t*>(base);
+    for (size_t offset : {free_ring_offset, filled_ring_offset}) {
+        ShmRing* ring = reinterpret_cast<ShmRing*>(rings_base + offset);
+        ring->enqueue_pos.store(0);
+        ring->dequeue_pos.store(0);
+        ring->mask = capacity - 1;
+        for (uint32_t i = 0; i < capacity; i++) {
+            ring->slots[i].sequence.store(i);
+            ring->slots[i].index = 0;
+        }
+    }
+    munmap(base, total_size);
+
+    if (!pool->mapSegment(fd, total_size)) {
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+
+    // 所有 Buffer 放入 free 队列
+    for (int i = 0; i < buffer_count; i++) {
+        pool->metas_[i].state.store(static_cast<uint32_t>(Buffer::State::IDLE));
+        pool->metas_[i].owner_pid.store(kNoOwner);
+        pool->pushRing(pool->free_ring_, static_cast<uint32_t>(i));
+    }
+
+    // 最后写入魔数，附加进程以此判断初始化完成
+    pool->header_->magic.store(kShmMagic, std::memory_order_release);
+
+    LOG4CPLUS_INFO(logger, pool->log_prefix_ << " 创建: " << buffer_count << " buffers x "
+                   << buffer_size << " bytes, shm=" << path
+                   << ", total=" << (total_size / (1024.0 * 1024.0)) << " MB");
+
+    return pool;
+}
+
+std::shared_ptr<SharedMemoryBufferPool> SharedMemoryBufferPool::attach(const std::string& name) {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+
+    std::string path = toShmPath(name);
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        LOG4CPLUS_ERROR(logger, "[SharedMemoryBufferPool] shm_open('" << path << "') failed: " << strerror(errno));
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmHeader)) {
+        LOG4CPLUS_ERROR(logger, "[SharedMemoryBufferPool] Invalid shared memory segment: " << path);
+        close(fd);
+        return nullptr;
+    }
+
+    std::shared_ptr<SharedMemoryBufferPool> pool(new SharedMemoryBufferPool(name, false));
+    if (!pool->mapSegment(fd, static_cast<size_t>(st.st_size))) {
+        return nullptr;
+    }
+
+    pool->category_ = pool->header_->category;
+    pool->header_->attach_count.fetch_add(1);
+
+    LOG4CPLUS_INFO(logger, pool->log_prefix_ << " 附加: " << pool->getTotalCount() << " buffers x "
+                   << pool->buffer_size_ << " bytes, creator pid=" << pool->header_->creator_pid);
+
+    return pool;
+}
+
+bool SharedMemoryBufferPool::mapSegment(int fd, size_t total_size) {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+
+    fd_ = fd;
+    base_ = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base_ == MAP_FAILED) {
+        LOG4CPLUS_ERROR(logger, log_prefix_ << " mmap failed: " << strerror(errno));
+        base_ = nullptr;
+        return false;
+    }
+    mapped_size_ = total_size;
+    header_ = static_cast<ShmHeader*>(base_);
+
+    // 附加进程：校验头部（创建者此时尚未写入魔数，跳过）
+    if (!is_creator_) {
+        if (header_->magic.load(std::memory_order_acquire) != kShmMagic ||
+            header_->version != kShmVersion ||
+            header_->total_size > total_size) {
+            LOG4CPLUS_ERROR(logger, log_prefix_ << " Shared memory header mismatch (not initialized or incompatible)");
+            header_ = nullptr;
+            return false;
+        }
+    }
+
+    auto* bytes = static_cast<uint8_t*>(base_);
+    metas_ = reinterpret_cast<ShmBufferMeta*>(bytes + header_->meta_offset);
+    free_ring_ = reinterpret_cast<ShmRing*>(bytes + header_->free_ring_offset);
+    filled_ring_ = reinterpret_cast<ShmRing*>(bytes + header_->filled_ring_offset);
+    buffer_size_ = header_->buffer_size;
+
+    // 建立本进程的 Buffer 视图（EXTERNAL：内存由共享内存段管理）
+    buffers_.reserve(header_->buffer_count);
+    for (uint32_t i = 0; i < header_->buffer_count; i++) {
+        void* addr = bytes + header_->data_offset + header_->buffer_stride * i;
+        buffers_.push_back(std::make_unique<Buffer>(i, addr, 0, buffer_size_, Buffer::Ownership::EXTERNAL));
+    }
+
+    return true;
+}
+
+std::string SharedMemoryBufferPool::toShmPath(const std::string& name) {
+    std::string path = "/components_pool_";
+    for (char c : name) {
+        path += (c == '/') ? '_' : c;
+    }
+    return path;
+}
+
+// ============================================================
+// 无锁环形队列
+// ============================================================
+
+bool SharedMemoryBufferPool::pushRing(ShmRing* ring, uint32_t index) {
+    uint64_t pos = ring->enqueue_pos.load(std::memory_order_relaxed);
+    ShmRing::Slot* slot = nullptr;
+
+    while (true) {
+        slot = &ring->slots[pos & ring->mask];
+        uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (ring->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Buffer 总数不超过容量，队列不会真正满：槽位序号落后说明出队方已推进出队位置、
+            // 尚未释放槽位，让出 CPU 后重试
+            std::this_thread::yield();
+            pos = ring->enqueue_pos.load(std::memory_order_relaxed);
+        } else {
+            pos = ring->enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // 发布槽位之前清除持有者：出队方据此登记新的持有者
+    slot->index = index;
+    metas_[index].owner_pid.store(kNoOwner);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool SharedMemoryBufferPool::popRing(ShmRing* ring, uint32_t* index) {
+    const int32_t self = getpid();
+    uint64_t pos = ring->dequeue_pos.load(std::memory_order_relaxed);
+
+    while (true) {
+        ShmRing::Slot* slot = &ring->slots[pos & ring->mask];
+        uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+        if (diff < 0) {
+            return false;  // 队列为空
+        }
+        if (diff > 0) {
+            pos = ring->dequeue_pos.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        // 先登记持有者再推进出队位置：任何时刻 Buffer 要么在队列中（owner=0），
+        // 要么记录了持有者，进程在出队途中崩溃时 reclaimOrphanedBuffers() 仍能找回
+        uint32_t candidate = slot->index;
+        int32_t owner = kNoOwner;
+        if (!metas_[candidate].owner_pid.compare_exchange_strong(owner, self)) {
+            if (!isProcessAlive(owner)) {
+                return false;  // 登记者已退出：等待回收
+            }
+            // 其他出队者正在取同一槽位
+            pos = ring->dequeue_pos.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (ring->dequeue_pos.compare_exchange_strong(pos, pos + 1, std::memory_order_relaxed)) {
+            *index = candidate;
+            slot->sequence.store(pos + ring->mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 槽位已被其他出队者取走（读到的是过期索引）：撤销登记后重试
+        metas_[candidate].owner_pid.store(kNoOwner);
+    }
+}
+
+bool SharedMemoryBufferPool::isQueued(const ShmRing* ring, uint32_t index) const {
+    uint64_t tail = ring->enqueue_pos.load();
+    for (uint64_t pos = ring->dequeue_pos.load(); pos < tail; pos++) {
+        const ShmRing::Slot& slot = ring->slots[pos & ring->mask];
+        if (slot.sequence.load(std::memory_order_acquire) == pos + 1 && slot.index == index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Buffer* SharedMemoryBufferPool::acquireFromRing(ShmRing* ring, std::atomic<uint32_t>* futex_word,
+                                                std::atomic<uint32_t>* waiters, bool blocking, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (true) {
+        // 先读取序号再尝试出队，避免错过出队失败与等待之间的唤醒
+        uint32_t observed = futex_word->load(std::memory_order_acquire);
+
+        uint32_t index = 0;
+        if (popRing(ring, &index)) {
+            return buffers_[index].get();
+        }
+
+        if (!blocking || !isRunning()) {
+            return nullptr;
+        }
+
+        int wait_ms = kWaitSliceMs;
+        if (timeout_ms >= 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                return nullptr;
+            }
+            wait_ms = std::min<int>(wait_ms, static_cast<int>(remaining));
+        }
+
+        waiters->fetch_add(1);
+        futexWait(futex_word, observed, wait_ms);
+        waiters->fetch_sub(1);
+    }
+}
+
+void SharedMemoryBufferPool::postToRing(ShmRing* ring, std::atomic<uint32_t>* futex_word,
+                                        std::atomic<uint32_t>* waiters, uint32_t index) {
+    if (!pushRing(ring, index)) {
+        LOG_ERROR_FMT("%s Ring overflow for buffer #%u", log_prefix_.c_str(), index);
+        return;
+    }
+
+    futex_word->fetch_add(1, std::memory_order_release);
+    if (waiters->load() > 0) {
+        futexWake(futex_word, 1);
+    }
+}
+
+bool SharedMemoryBufferPool::ownsBuffer(const Buffer* buffer_ptr) const {
+    if (!buffer_ptr || !header_) {
+        return false;
+    }
+    uint32_t id = buffer_ptr->id();
+    return id < buffers_.size() && buffers_[id].get() == buffer_ptr;
+}
+
+// ============================================================
+// 生产者接口
+// ============================================================
+
+Buffer* SharedMemoryBufferPool::acquireFree(bool blocking, int timeout_ms) {
+    if (!header_) {
+        return nullptr;
+    }
+
+    Buffer* buffer = acquireFromRing(free_ring_, &header_->free_futex, &header_->free_waiters,
+                                     blocking, timeout_ms);
+    if (buffer) {
+        metas_[buffer->id()].state.store(static_cast<uint32_t>(Buffer::State::LOCKED_BY_PRODUCER));
+        buffer->setState(Buffer::State::LOCKED_BY_PRODUCER);
+    }
+    return buffer;
+}
+
+void SharedMemoryBufferPool::submitFilled(Buffer* buffer_ptr) {
+    if (!ownsBuffer(buffer_ptr)) {
+        LOG_ERROR_FMT("%s submitFilled: buffer does not belong to this pool", log_prefix_.c_str());
+        return;
+    }
+
+    // 同步图像元数据到共享内存（消费者进程读取）
+    ShmBufferMeta& meta = metas_[buffer_ptr->id()];
+    meta.has_image_metadata = buffer_ptr->hasImageMetadata() ? 1 : 0;
+    if (meta.has_image_metadata) {
+        meta.width = buffer_ptr->getImageWidth();
+        meta.height = buffer_ptr->getImageHeight();
+        meta.format = static_cast<int32_t>(buffer_ptr->getImageFormat());
+        meta.nb_planes = buffer_ptr->getImagePlaneCount();
+        for (int i = 0; i < 4; i++) {
+            meta.linesize[i] = buffer_ptr->getImageLinesize()[i];
+            meta.plane_offset[i] = buffer_ptr->getImagePlaneOffset()[i];
+        }
+    }
+
+    meta.state.store(static_cast<uint32_t>(Buffer::State::READY_FOR_CONSUME));
+    buffer_ptr->setState(Buffer::State::READY_FOR_CONSUME);
+    postToRing(filled_ring_, &header_->filled_futex, &header_->filled_waiters, buffer_ptr->id());
+}
+
+void SharedMemoryBufferPool::releaseFree(Buffer* buffer_ptr) {
+    if (!ownsBuffer(buffer_ptr)) {
+        LOG_ERROR_FMT("%s releaseFree: buffer does not belong to this pool", log_prefix_.c_str());
+        return;
+    }
+
+    metas_[buffer_ptr->id()].state.store(static_cast<uint32_t>(Buffer::State::IDLE));
+    buffer_ptr->setState(Buffer::State::IDLE);
+    postToRing(free_ring_, &header_->free_futex, &header_->free_waiters, buffer_ptr->id());
+}
+
+// ============================================================
+// 消费者接口
+// ============================================================
+
+Buffer* SharedMemoryBufferPool::acquireFilled(bool blocking, int timeout_ms) {
+    if (!header_) {
+        return nullptr;
+    }
+
+    Buffer* buffer = acquireFromRing(filled_ring_, &header_->filled_futex, &header_->filled_waiters,
+                                     blocking, timeout_ms);
+    if (!buffer) {
+        return nullptr;
+    }
+
+    // 从共享内存同步图像元数据
+    const ShmBufferMeta& meta = metas_[buffer->id()];
+    if (meta.has_image_metadata) {
+        size_t plane_offset[4];
+        for (int i = 0; i < 4; i++) {
+            plane_offset[i] = static_cast<size_t>(meta.plane_offset[i]);
+        }
+        buffer->setImageMetadata(meta.width, meta.height, static_cast<AVPixelFormat>(meta.format),
+                                 meta.linesize, plane_offset, meta.nb_planes);
+    } else {
+        buffer->clearImageMetadata();
+    }
+
+    metas_[buffer->id()].state.store(static_cast<uint32_t>(Buffer::State::LOCKED_BY_CONSUMER));
+    buffer->setState(Buffer::State::LOCKED_BY_CONSUMER);
+    return buffer;
+}
+
+void SharedMemoryBufferPool::releaseFilled(Buffer* buffer_ptr) {
+    if (!ownsBuffer(buffer_ptr)) {
+        LOG_ERROR_FMT("%s releaseFilled: buffer does not belong to this pool", log_prefix_.c_str());
+        return;
+    }
+
+    metas_[buffer_ptr->id()].state.store(static_cast<uint32_t>(Buffer::State::IDLE));
+    buffer_ptr->setState(Buffer::State::IDLE);
+    postToRing(free_ring_, &header_->free_futex, &header_->free_waiters, buffer_ptr->id());
+}
+
+// ============================================================
+// 健壮性
+// ============================================================
+
+int SharedMemoryBufferPool::reclaimOrphanedBuffers() {
+    if (!header_) {
+        return 0;
+    }
+
+    int reclaimed = 0;
+    for (uint32_t i = 0; i < header_->buffer_count; i++) {
+        int32_t owner = metas_[i].owner_pid.load();
+        if (owner == kNoOwner || isProcessAlive(owner)) {
+            continue;
+        }
+        // 持有者在出队途中退出（已登记、未推进出队位置）：Buffer 仍在队列中，只清除登记
+        if (isQueued(free_ring_, i) || isQueued(filled_ring_, i)) {
+            if (metas_[i].owner_pid.compare_exchange_strong(owner, kNoOwner)) {
+                LOG_WARN_FMT("%s Cleared stale owner %d of queued buffer #%u", log_prefix_.c_str(), owner, i);
+            }
+            continue;
+        }
+        // CAS 确保只有一个进程回收（归还 free 队列时清除登记）
+        if (!metas_[i].owner_pid.compare_exchange_strong(owner, static_cast<int32_t>(getpid()))) {
+            continue;
+        }
+        LOG_WARN_FMT("%s Reclaiming buffer #%u held by dead process %d", log_prefix_.c_str(), i, owner);
+        metas_[i].state.store(static_cast<uint32_t>(Buffer::State::IDLE));
+        postToRing(free_ring_, &header_->free_futex, &header_->free_waiters, i);
+        reclaimed++;
+    }
+    return reclaimed;
+}
+
+// ============================================================
+// 查询接口
+// ============================================================
+
+int SharedMemoryBufferPool::getFreeCount() const {
+    if (!free_ring_) {
+        return 0;
+    }
+    return static_cast<int>(free_ring_->enqueue_pos.load() - free_ring_->dequeue_pos.load());
+}
+
+int SharedMemoryBufferPool::getFilledCount() const {
+    if (!filled_ring_) {
+        return 0;
+    }
+    return static_cast<int>(filled_ring_->enqueue_pos.load() - filled_ring_->dequeue_pos.load());
+}
+
+bool SharedMemoryBufferPool::isRunning() const {
+    if (!header_ || header_->running.load() == 0) {
+        return false;
+    }
+    return is_creator_ || isProcessAlive(header_->creator_pid);
+}
+
+Buffer* SharedMemoryBufferPool::getBufferById(uint32_t id) const {
+    if (id >= buffers_.size()) {
+        return nullptr;
+    }
+    return buffers_[id].get();
+}
+
+// ============================================================
+// 生命周期管理
+// ============================================================
+
+void SharedMemoryBufferPool::shutdown() {
+    if (!header_) {
+        return;
+    }
+
+    header_->running.store(0);
+
+    // 唤醒所有进程中的等待者
+    header_->free_futex.fetch_add(1);
+    header_->filled_futex.fetch_add(1);
+    futexWake(&header_->free_futex, INT32_MAX);
+    futexWake(&header_->filled_futex, INT32_MAX);
+}
+
+// ============================================================
+// 调试接口
+// ============================================================
+
+void SharedMemoryBufferPool::printStats() const {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool] ========================================");
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool] 📊 SharedMemoryBufferPool '" << name_ << "' Statistics");
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool] ========================================");
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Category: " << (category_.empty() ? "(none)" : category_));
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Registry ID: " << registry_id_);
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Role: " << (is_creator_ ? "creator" : "attached"));
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Shm: " << toShmPath(name_)
+                   << " (" << (mapped_size_ / (1024.0 * 1024.0)) << " MB)");
+    if (header_) {
+        LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Creator PID: " << header_->creator_pid
+                       << ", attached processes: " << header_->attach_count.load());
+    }
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Total buffers: " << getTotalCount());
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Free buffers: " << getFreeCount());
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Filled buffers: " << getFilledCount());
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool]   Running: " << (isRunning() ? "Yes" : "No"));
+    LOG4CPLUS_INFO(logger, "[SharedMemoryBufferPool] ========================================");
+}
@@ -0,0 +1,363 @@
+#include "common/FrameCopy.hpp"
+#include "common/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using CopyKernel = void (*)(uint8_t* dst, const uint8_t* src, size_t size);
+
+void copyScalar(uint8_t* dst, const uint8_t* src, size_t size) {
+    memcpy(dst, src, size);
+}
+
+/**
+ * 用 memcpy 拷贝到 dst 对齐到 alignment 为止，返回剩余字节数
+ */
+inline size_t alignHead(uint8_t** dst, const uint8_t** src, size_t size, size_t alignment) {
+    size_t head = (alignment - (reinterpret_cast<uintptr_t>(*dst) & (alignment - 1))) & (alignment - 1);
+    head = std::min(head, size);
+    memcpy(*dst, *src, head);
+    *dst += head;
+    *src += head;
+    return size - head;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2")))
+void copySse2(uint8_t* dst, const uint8_t* src, size_t size) {
+    size = alignHead(&dst, &src, size, 16);
+    while (size >= 64) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+        src += 64;
+        dst += 64;
+        size -= 64;
+    }
+    memcpy(dst, src, size);
+}
+
+__attribute__((target("avx2")))
+void copyAvx2(uint8_t* dst, const uint8_t* src, size_t size) {
+    size = alignHead(&dst, &src, size, 32);
+    while (size >= 128) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), d);
+        src += 128;
+        dst += 128;
+        size -= 128;
+    }
+    memcpy(dst, src, size);
+}
+
+#elif defined(__aarch64__)
+
+void copyNeon(uint8_t* dst, const uint8_t* src, size_t size) {
+    size = alignHead(&dst, &src, size, 16);
+    while (size >= 64) {
+        // stnp：non-temporal 存储提示，写入不分配缓存行
+        __asm__ __volatile__(
+            "ldp q0, q1, [%[s]]\n\t"
+            "ldp q2, q3, [%[s], #32]\n\t"
+            "stnp q0, q1, [%[d]]\n\t"
+            "stnp q2, q3, [%[d], #32]\n\t"
+            :
+            : [s] "r"(src), [d] "r"(dst)
+            : "v0", "v1", "v2", "v3", "memory");
+        src += 64;
+        dst += 64;
+        size -= 64;
+    }
+    memcpy(dst, src, size);
+}
+
+#endif
+
+/**
+ * 流式存储不遵守普通的存储顺序：拷贝结束后需要屏障，其他线程才能按序看到数据
+ */
+inline void storeFence() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_sfence();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("dmb ishst" ::: "memory");
+#endif
+}
+
+struct Dispatch {
+    FrameCopy::Isa isa;
+    CopyKernel kernel;
+};
+
+Dispatch selectKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {FrameCopy::Isa::AVX2, copyAvx2};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {FrameCopy::Isa::SSE2, copySse2};
+    }
+#elif defined(__aarch64__)
+    return {FrameCopy::Isa::NEON, copyNeon};
+#endif
+    return {FrameCopy::Isa::SCALAR, copyScalar};
+}
+
+const Dispatch& dispatch() {
+    static const Dispatch selected = selectKernel();
+    return selected;
+}
+
+} // namespace
+
+// ============================================================================
+// 构造 / 析构
+// ============================================================================
+
+FrameCopy& FrameCopy::getInstance() {
+    static FrameCopy instance;
+    return instance;
+}
+
+FrameCopy::FrameCopy()
+    : streaming_(true)
+    , job_()
+    , generation_(0)
+    , remaining_(0)
+    , stop_(false)
+    , helper_count_(0)
+{
+}
+
+FrameCopy::~FrameCopy() {
+    std::lock_guard<std::mutex> job_lock(job_mutex_);
+    stopHelpers();
+}
+
+// ============================================================================
+// 配置
+// ============================================================================
+
+void FrameCopy::setHelperThreads(int count) {
+    count = std::max(0, std::min(count, kMaxHelperThreads));
+
+    // 等待正在进行的条带任务结束后再替换线程
+    std::lock_guard<std::mutex> job_lock(job_mutex_);
+    if (count == static_cast<int>(helpers_.size())) {
+        return;
+    }
+    stopHelpers();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = false;
+        generation_ = 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        helpers_.emplace_back(&FrameCopy::helperLoop, this, i);
+    }
+    helper_count_.store(count, std::memory_order_release);
+    LOG_DEBUG_FMT("[FrameCopy] %d helper threads, ISA %s", count, getIsaName());
+}
+
+int FrameCopy::getHelperThreads() const {
+    return helper_count_.load(std::memory_order_acquire);
+}
+
+void FrameCopy::setStreaming(bool enable) {
+    streaming_.store(enable, std::memory_order_relaxed);
+}
+
+bool FrameCopy::isStreaming() const {
+    return streaming_.load(std::memory_order_relaxed);
+}
+
+FrameCopy::Isa FrameCopy::getIsa() {
+    return dispatch().isa;
+}
+
+const char* FrameCopy::getIsaName() {
+    switch (getIsa()) {
+        case Isa::AVX2: return "AVX2";
+        case Isa::SSE2: return "SSE2";
+        case Isa::NEON: return "NEON";
+        default:        return "scalar";
+    }
+}
+
+void FrameCopy::streamCopy(void* dst, const void* src, size_t size) {
+    dispatch().kernel(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), size);
+    storeFence();
+}
+
+// ============================================================================
+// 拷贝
+// ============================================================================
+
+void FrameCopy::copy(void* dst, const void* src, size_t size) {
+    if (size < kStreamingThreshold || !isStreaming()) {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    Job job;
+    job.dst = static_cast<uint8_t*>(dst);
+    job.src = static_cast<const uint8_t*>(src);
+    job.row_bytes = size;
+    job.rows = 1;
+    job.contiguous = true;
+    job.stripes = stripeCount(size, INT32_MAX);
+    run(job);
+}
+
+void FrameCopy::copyRows(void* dst, size_t dst_stride, const void* src, size_t src_stride,
+                         size_t row_bytes, int rows) {
+    if (rows <= 0 || row_bytes == 0) {
+        return;
+    }
+    // 两边都没有行间填充：等价于一次连续拷贝
+    if (dst_stride == row_bytes && src_stride == row_bytes) {
+        copy(dst, src, row_bytes * static_cast<size_t>(rows));
+        return;
+    }
+
+    Job job;
+    job.dst = static_cast<uint8_t*>(dst);
+    job.src = static_cast<const uint8_t*>(src);
+    job.dst_stride = dst_stride;
+    job.src_stride = src_stride;
+    job.row_bytes = row_bytes;
+    job.rows = rows;
+    job.contiguous = false;
+    job.stripes = stripeCount(row_bytes * static_cast<size_t>(rows), rows);
+    run(job);
+}
+
+int FrameCopy::stripeCount(size_t total_bytes, int max_units) const {
+    size_t by_size = total_bytes / kMinStripeBytes;
+    int stripes = getHelperThreads() + 1;
+    stripes = static_cast<int>(std::min<size_t>(static_cast<size_t>(stripes), std::max<size_t>(by_size, 1)));
+    return std::max(1, std::min(stripes, max_units));
+}
+
+void FrameCopy::run(const Job& job) {
+    if (job.stripes <= 1) {
+        runStripe(job, 0);
+        return;
+    }
+
+    // 辅助线程正被其他拷贝点占用：不等待，直接在调用线程完成
+    std::unique_lock<std::mutex> job_lock(job_mutex_, std::try_to_lock);
+    if (!job_lock.owns_lock() || helpers_.empty()) {
+        Job single = job;
+        single.stripes = 1;
+        runStripe(single, 0);
+        return;
+    }
+
+    Job striped = job;
+    striped.stripes = std::min(job.stripes, static_cast<int>(helpers_.size()) + 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = striped;
+        remaining_ = static_cast<int>(helpers_.size());
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    runStripe(striped, 0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return remaining_ == 0; });
+}
+
+void FrameCopy::runStripe(const Job& job, int stripe) const {
+    CopyKernel kernel = isStreaming() ? dispatch().kernel : copyScalar;
+
+    if (job.contiguous) {
+        size_t size = job.row_bytes;
+        // 条带边界对齐到 64 字节（缓存行），各线程不写同一行
+        size_t chunk = ((size + job.stripes - 1) / job.stripes + 63) & ~static_cast<size_t>(63);
+        size_t begin = std::min(size, chunk * static_cast<size_t>(stripe));
+        size_t end = std::min(size, begin + chunk);
+        if (end > begin) {
+            kernel(job.dst + begin, job.src + begin, end - begin);
+        }
+    } else {
+        int rows_per_stripe = (job.rows + job.stripes - 1) / job.stripes;
+        int begin = std::min(job.rows, rows_per_stripe * stripe);
+        int end = std::min(job.rows, begin + rows_per_stripe);
+        // 行太短时流式存储不划算（每行的首尾 memcpy 占比过高）
+        if (job.row_bytes < 256) {
+            kernel = copyScalar;
+        }
+        for (int row = begin; row < end; ++row) {
+            kernel(job.dst + static_cast<size_t>(row) * job.dst_stride,
+                   job.src + static_cast<size_t>(row) * job.src_stride, job.row_bytes);
+        }
+    }
+    storeFence();
+}
+
+// ============================================================================
+// 辅助线程
+// ============================================================================
+
+void FrameCopy::helperLoop(int helper_index) {
+    uint64_t seen = 0;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            job = job_;
+        }
+
+        // 条带 0 由调用线程拷贝，辅助线程 i 负责条带 i+1
+        if (helper_index + 1 < job.stripes) {
+            runStripe(job, helper_index + 1);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--remaining_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void FrameCopy::stopHelpers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& helper : helpers_) {
+        if (helper.joinable()) {
+            helper.join();
+        }
+    }
+    helpers_.clear();
+    helper_count_.store(0, std::memory_order_release);
+}
@@ -0,0 +1,207 @@
+#include "common/FramePacer.hpp"
+#include "common/Logger.hpp"
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace {
+
+constexpr int64_t kNsPerMs = 1000 * 1000;
+constexpr int64_t kNsPerSec = 1000 * kNsPerMs;
+
+// 单次休眠最长时间（纳秒），到点后检查运行标志，保证 stop() 及时返回
+constexpr int64_t kMaxSleepChunkNs = 100 * kNsPerMs;
+
+// 延迟超过该值计为迟到帧（纳秒）
+constexpr int64_t kLateThresholdNs = 1 * kNsPerMs;
+
+inline int64_t periodFromFps(double fps) {
+    return fps > 0.0 ? static_cast<int64_t>(std::llround(kNsPerSec / fps)) : 0;
+}
+
+} // namespace
+
+// ============================================================
+// 构造函数
+// ============================================================
+
+FramePacer::FramePacer(double target_fps)
+    : mutex_()
+    , period_ns_(periodFromFps(target_fps))
+    , next_deadline_ns_(0)
+    , frames_(0)
+    , late_frames_(0)
+    , resyncs_(0)
+    , total_lateness_ns_(0)
+    , max_lateness_ns_(0)
+    , first_release_ns_(0)
+    , last_release_ns_(0)
+    , histogram_()
+{
+}
+
+// ============================================================
+// 配置
+// ============================================================
+
+void FramePacer::setRate(double target_fps) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    period_ns_ = periodFromFps(target_fps);
+    // 以上一帧放行时间为锚点按新周期继续（尚未放行过则下一帧立即放行）
+    next_deadline_ns_ = (period_ns_ > 0 && last_release_ns_ > 0) ? last_release_ns_ + period_ns_ : 0;
+}
+
+double FramePacer::getRate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return period_ns_ > 0 ? static_cast<double>(kNsPerSec) / period_ns_ : 0.0;
+}
+
+void FramePacer::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    next_deadline_ns_ = 0;
+    frames_ = 0;
+    late_frames_ = 0;
+    resyncs_ = 0;
+    total_lateness_ns_ = 0;
+    max_lateness_ns_ = 0;
+    first_release_ns_ = 0;
+    last_release_ns_ = 0;
+    histogram_.fill(0);
+}
+
+// ============================================================
+// 调度
+// ============================================================
+
+bool FramePacer::waitNextSlot(const std::atomic<bool>* running) {
+    int64_t deadline = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int64_t now = nowNs();
+        if (period_ns_ <= 0) {
+            // 不限速：只统计放行帧率
+            recordLateness(0, now);
+            return true;
+        }
+        if (next_deadline_ns_ == 0) {
+            next_deadline_ns_ = now;  // 首帧作为锚点立即放行
+        }
+        deadline = next_deadline_ns_;
+        if (now - deadline > kResyncPeriods * period_ns_) {
+            // 落后太多（下游阻塞或填充过慢）：本帧立即放行，从当前时间重新锚定，
+            // 避免为追赶进度连续突发放行
+            next_deadline_ns_ = now + period_ns_;
+            resyncs_++;
+        } else {
+            // 按绝对时间推进：单帧唤醒延迟不影响后续截止时间
+            next_deadline_ns_ += period_ns_;
+        }
+    }
+
+    while (true) {
+        if (running && !running->load()) {
+            return false;
+        }
+        int64_t now = nowNs();
+        if (now >= deadline) {
+            break;
+        }
+        int64_t wake = std::min(deadline, now + kMaxSleepChunkNs);
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(wake / kNsPerSec);
+        ts.tv_nsec = static_cast<long>(wake % kNsPerSec);
+        // TIMER_ABSTIME：被信号中断（EINTR）后重新进入循环，不会累积误差
+        int ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+        if (ret != 0 && ret != EINTR) {
+            LOG_WARN_FMT("[FramePacer] clock_nanosleep failed: %s", strerror(ret));
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now = nowNs();
+    recordLateness(now - deadline, now);
+    return true;
+}
+
+int64_t FramePacer::nanosUntilNextSlot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (period_ns_ <= 0 || next_deadline_ns_ == 0) {
+        return 0;
+    }
+    return std::max<int64_t>(0, next_deadline_ns_ - nowNs());
+}
+
+int64_t FramePacer::nowNs() {
+    // 与 clock_nanosleep 使用同一时钟
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * kNsPerSec + ts.tv_nsec;
+}
+
+void FramePacer::recordLateness(int64_t lateness_ns, int64_t release_ns) {
+    lateness_ns = std::max<int64_t>(0, lateness_ns);
+    frames_++;
+    total_lateness_ns_ += lateness_ns;
+    max_lateness_ns_ = std::max(max_lateness_ns_, lateness_ns);
+    if (lateness_ns > kLateThresholdNs) {
+        late_frames_++;
+    }
+    if (first_release_ns_ == 0) {
+        first_release_ns_ = release_ns;
+    }
+    last_release_ns_ = release_ns;
+
+    double lateness_ms = static_cast<double>(lateness_ns) / kNsPerMs;
+    int bucket = 0;
+    while (bucket < kHistogramBuckets - 1 && lateness_ms >= kBucketUpperMs[bucket]) {
+        bucket++;
+    }
+    histogram_[bucket]++;
+}
+
+// ============================================================
+// 统计
+// ============================================================
+
+FramePacer::Stats FramePacer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.target_fps = period_ns_ > 0 ? static_cast<double>(kNsPerSec) / period_ns_ : 0.0;
+    stats.frames = frames_;
+    stats.late_frames = late_frames_;
+    stats.resyncs = resyncs_;
+    stats.histogram = histogram_;
+    if (frames_ > 0) {
+        stats.avg_lateness_ms = static_cast<double>(total_lateness_ns_) / kNsPerMs / frames_;
+        stats.max_lateness_ms = static_cast<double>(max_lateness_ns_) / kNsPerMs;
+    }
+    if (frames_ > 1 && last_release_ns_ > first_release_ns_) {
+        stats.actual_fps = static_cast<double>(frames_ - 1) * kNsPerSec / (last_release_ns_ - first_release_ns_);
+    }
+    return stats;
+}
+
+void FramePacer::printStats() const {
+    Stats stats = getStats();
+    LOG_INFO_FMT("[FramePacer] Target: %.2f fps, Actual: %.2f fps, Frames: %lu, Late(>1ms): %lu, Resyncs: %lu, "
+                 "Lateness avg: %.3f ms, max: %.3f ms",
+                 stats.target_fps, stats.actual_fps, (unsigned long)stats.frames, (unsigned long)stats.late_frames,
+                 (unsigned long)stats.resyncs, stats.avg_lateness_ms, stats.max_lateness_ms);
+
+    std::string histogram;
+    char item[48];
+    for (int i = 0; i < kHistogramBuckets; i++) {
+        if (i < kHistogramBuckets - 1) {
+            snprintf(item, sizeof(item), " <%gms=%lu", kBucketUpperMs[i], (unsigned long)stats.histogram[i]);
+        } else {
+            snprintf(item, sizeof(item), " >=%gms=%lu", kBucketUpperMs[i - 1], (unsigned long)stats.histogram[i]);
+        }
+        histogram += item;
+    }
+    LOG_INFO_FMT("[FramePacer] Lateness histogram:%s", histogram.c_str());
+}
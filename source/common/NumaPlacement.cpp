@@ -0,0 +1,280 @@
+#include "common/NumaPlacement.hpp"
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// ============================================================
+// 内部辅助（直接调用系统调用，避免依赖 libnuma）
+// ============================================================
+
+namespace {
+
+constexpr int kMaxNodes = 1024;
+constexpr int kBitsPerLong = static_cast<int>(sizeof(unsigned long) * 8);
+constexpr int kMaskLongs = kMaxNodes / kBitsPerLong;
+
+struct NodeMask {
+    unsigned long bits[kMaskLongs];
+
+    NodeMask() { memset(bits, 0, sizeof(bits)); }
+
+    bool set(int node) {
+        if (node < 0 || node >= kMaxNodes) {
+            return false;
+        }
+        bits[node / kBitsPerLong] |= (1UL << (node % kBitsPerLong));
+        return true;
+    }
+};
+
+// 注意：内核使用 maxnode - 1 位，因此需要 +1（与 libnuma 行为一致）
+constexpr unsigned long kMaxNodeArg = kMaxNodes + 1;
+
+long sysGetMempolicy(int* mode, unsigned long* nodemask, unsigned long maxnode,
+                     const void* addr, unsigned long flags) {
+    return syscall(SYS_get_mempolicy, mode, nodemask, maxnode, addr, flags);
+}
+
+long sysSetMempolicy(int mode, const unsigned long* nodemask, unsigned long maxnode) {
+    return syscall(SYS_set_mempolicy, mode, nodemask, maxnode);
+}
+
+long sysMbind(void* addr, unsigned long len, int mode, const unsigned long* nodemask,
+              unsigned long maxnode, unsigned flags) {
+    return syscall(SYS_mbind, addr, len, mode, nodemask, maxnode, flags);
+}
+
+/**
+ * @brief 解析内核 list 格式（cpulist / node online，如 "0-3,8,10-11"）
+ */
+std::vector<int> parseIdList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") {
+            continue;
+        }
+        size_t dash = item.find('-');
+        char* end = nullptr;
+        if (dash == std::string::npos) {
+            long cpu = strtol(item.c_str(), &end, 10);
+            if (end != item.c_str()) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        } else {
+            long first = strtol(item.substr(0, dash).c_str(), nullptr, 10);
+            long last = strtol(item.substr(dash + 1).c_str(), nullptr, 10);
+            for (long cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+    }
+    return cpus;
+}
+
+}  // namespace
+
+// ============================================================
+// 查询接口
+// ============================================================
+
+bool NumaPlacement::isAvailable() {
+    static const bool available = []() {
+        int mode = 0;
+        return sysGetMempolicy(&mode, nullptr, 0, nullptr, 0) == 0;
+    }();
+    return available;
+}
+
+int NumaPlacement::getNodeCount() {
+    // 节点编号可能不连续（如 "0,2"，离线或无内存节点），按最大编号 + 1 返回，
+    // 调用方按编号遍历 / 校验时不会漏掉高编号节点
+    std::ifstream file("/sys/devices/system/node/online");
+    if (file.is_open()) {
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> nodes = parseIdList(line);
+        if (!nodes.empty()) {
+            return *std::max_element(nodes.begin(), nodes.end()) + 1;
+        }
+    }
+
+    // 旧内核没有 online 文件：取 nodeN 目录的最大编号
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (!dir) {
+        return 1;
+    }
+
+    int max_node = -1;
+    struct dirent* entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strncmp(entry->d_name, "node", 4) == 0 &&
+            entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            max_node = std::max(max_node, atoi(entry->d_name + 4));
+        }
+    }
+    closedir(dir);
+
+    return max_node >= 0 ? max_node + 1 : 1;
+}
+
+std::vector<int> NumaPlacement::getCpusOfNode(int node) {
+    if (node < 0) {
+        return {};
+    }
+
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!file.is_open()) {
+        return {};
+    }
+
+    std::string line;
+    std::getline(file, line);
+    return parseIdList(line);
+}
+
+int NumaPlacement::getNodeOfCpu(int cpu) {
+    if (cpu < 0) {
+        return -1;
+    }
+
+    int node_count = getNodeCount();
+    for (int node = 0; node < node_count; node++) {
+        for (int c : getCpusOfNode(node)) {
+            if (c == cpu) {
+                return node;
+            }
+        }
+    }
+    return -1;
+}
+
+int NumaPlacement::getCurrentCpu() {
+    return sched_getcpu();
+}
+
+int NumaPlacement::getNodeOfAddress(const void* addr) {
+    if (!addr || !isAvailable()) {
+        return -1;
+    }
+
+    int node = -1;
+    if (sysGetMempolicy(&node, nullptr, 0, addr, MPOL_F_NODE | MPOL_F_ADDR) != 0) {
+        return -1;
+    }
+    return node;
+}
+
+std::string NumaPlacement::formatCpuList(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return "(any)";
+    }
+
+    std::string result;
+    size_t i = 0;
+    while (i < cpus.size()) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            j++;
+        }
+        if (!result.empty()) {
+            result += ",";
+        }
+        result += std::to_string(cpus[i]);
+        if (j > i) {
+            result += "-" + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return result;
+}
+
+// ============================================================
+// 放置接口
+// ============================================================
+
+bool NumaPlacement::bindCurrentThreadToCpus(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuset);
+        }
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+}
+
+bool NumaPlacement::setCurrentThreadPreferredNode(int node) {
+    if (!isAvailable()) {
+        return false;
+    }
+
+    NodeMask mask;
+    if (!mask.set(node)) {
+        return false;
+    }
+    return sysSetMempolicy(MPOL_PREFERRED, mask.bits, kMaxNodeArg) == 0;
+}
+
+bool NumaPlacement::resetCurrentThreadPolicy() {
+    if (!isAvailable()) {
+        return false;
+    }
+    return sysSetMempolicy(MPOL_DEFAULT, nullptr, 0) == 0;
+}
+
+bool NumaPlacement::bindMemoryToNode(void* addr, size_t size, int node) {
+    if (!addr || size == 0 || !isAvailable()) {
+        return false;
+    }
+
+    NodeMask mask;
+    if (!mask.set(node)) {
+        return false;
+    }
+
+    // mbind 要求地址按页对齐：只绑定完全落在区域内的页。
+    // 首尾不完整的页与相邻分配共享，MPOL_MF_MOVE 会把别人的数据一起迁移，因此跳过
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t start = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page_size - 1);
+    if (end <= start) {
+        return false;
+    }
+
+    return sysMbind(reinterpret_cast<void*>(start), end - start, MPOL_PREFERRED,
+                    mask.bits, kMaxNodeArg, MPOL_MF_MOVE) == 0;
+}
+
+// ============================================================
+// ScopedPreferredNode 实现
+// ============================================================
+
+NumaPlacement::ScopedPreferredNode::ScopedPreferredNode(int node)
+    : active_(false)
+{
+    if (node >= 0) {
+        active_ = NumaPlacement::setCurrentThreadPreferredNode(node);
+    }
+}
+
+NumaPlacement::ScopedPreferredNode::~ScopedPreferredNode() {
+    if (active_) {
+        NumaPlacement::resetCurrentThreadPolicy();
+    }
+}
@@ -0,0 +1,450 @@
+#include "common/WorkStealingExecutor.hpp"
+#include "common/Logger.hpp"
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+// ============================================================
+// 内部常量和线程局部状态
+// ============================================================
+
+namespace {
+
+// 分组领先最小 vruntime 超过该值时让出（纳秒）
+constexpr uint64_t kFairSliceNs = 2 * 1000 * 1000;
+
+// 连续让出次数上限（避免所有任务都在让出时空转）
+constexpr int kMaxDeferrals = 16;
+
+// 空闲线程最长休眠时间（毫秒），作为唤醒丢失的兜底
+constexpr int kIdleWaitMs = 10;
+
+// 挂起任务超时检查周期（毫秒）
+constexpr int kWakerTickMs = 2;
+
+thread_local const WorkStealingExecutor* t_executor = nullptr;
+thread_local int t_worker_index = -1;
+
+inline uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+struct WorkStealingExecutor::Group {
+    uint64_t id = 0;
+    std::string name;
+    std::atomic<int> weight{1};
+    std::atomic<uint64_t> vruntime_ns{0};
+    std::atomic<int64_t> pending{0};
+    std::atomic<int64_t> parked{0};
+    std::atomic<uint64_t> executed{0};
+    std::atomic<uint64_t> run_ns{0};
+};
+
+// ============================================================
+// 构造函数和析构函数
+// ============================================================
+
+WorkStealingExecutor& WorkStealingExecutor::getInstance() {
+    static WorkStealingExecutor instance;
+    return instance;
+}
+
+WorkStealingExecutor::WorkStealingExecutor(int thread_count)
+    : queues_()
+    , workers_()
+    , stopping_(false)
+    , global_mutex_()
+    , global_tasks_()
+    , wake_mutex_()
+    , wake_cv_()
+    , queued_total_(0)
+    , sleeping_workers_(0)
+    , groups_mutex_()
+    , groups_()
+    , next_group_id_(1)
+    , epoll_fd_(-1)
+    , waker_()
+    , parked_mutex_()
+    , parked_()
+{
+    if (thread_count <= 0) {
+        thread_count = static_cast<int>(std::thread::hardware_concurrency());
+        if (thread_count <= 0) {
+            thread_count = 1;
+        }
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        LOG_WARN_FMT("[WorkStealingExecutor] epoll_create1 failed: %s, parked tasks resume on timeout only",
+                     strerror(errno));
+    }
+
+    queues_.reserve(thread_count);
+    for (int i = 0; i < thread_count; i++) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(thread_count);
+    for (int i = 0; i < thread_count; i++) {
+        workers_.emplace_back(&WorkStealingExecutor::workerLoop, this, i);
+    }
+    waker_ = std::thread(&WorkStealingExecutor::wakerLoop, this);
+
+    LOG_INFO_FMT("[WorkStealingExecutor] 创建: %d worker threads", thread_count);
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    stopping_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    if (waker_.joinable()) {
+        waker_.join();
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+}
+
+// ============================================================
+// 分组管理
+// ============================================================
+
+uint64_t WorkStealingExecutor::registerGroup(const std::string& name, int weight) {
+    auto group = std::make_shared<Group>();
+    group->id = next_group_id_.fetch_add(1);
+    group->name = name;
+    group->weight.store(weight < 1 ? 1 : weight);
+
+    std::unique_lock<std::shared_mutex> lock(groups_mutex_);
+    // 新分组从当前最小 vruntime 开始（与 CFS 新任务处理一致）
+    uint64_t min_vruntime = 0;
+    bool first = true;
+    for (const auto& entry : groups_) {
+        uint64_t v = entry.second->vruntime_ns.load();
+        if (first || v < min_vruntime) {
+            min_vruntime = v;
+            first = false;
+        }
+    }
+    group->vruntime_ns.store(min_vruntime);
+    groups_[group->id] = group;
+    return group->id;
+}
+
+void WorkStealingExecutor::unregisterGroup(uint64_t group_id) {
+    std::unique_lock<std::shared_mutex> lock(groups_mutex_);
+    groups_.erase(group_id);
+}
+
+bool WorkStealingExecutor::setGroupWeight(uint64_t group_id, int weight) {
+    auto group = findGroup(group_id);
+    if (!group) {
+        return false;
+    }
+    group->weight.store(weight < 1 ? 1 : weight);
+    return true;
+}
+
+std::shared_ptr<WorkStealingExecutor::Group> WorkStealingExecutor::findGroup(uint64_t group_id) const {
+    std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+    auto it = groups_.find(group_id);
+    return it != groups_.end() ? it->second : nullptr;
+}
+
+// ============================================================
+// 任务提交
+// ============================================================
+
+bool WorkStealingExecutor::submit(uint64_t group_id, Task task) {
+    if (stopping_.load() || !task) {
+        return false;
+    }
+    auto group = findGroup(group_id);
+    if (!group) {
+        LOG_ERROR_FMT("[WorkStealingExecutor] submit: group %lu not found", (unsigned long)group_id);
+        return false;
+    }
+    enqueue(TaskItem{std::move(group), std::move(task)});
+    return true;
+}
+
+bool WorkStealingExecutor::submitWhenReadable(uint64_t group_id, int fd, Task task, int timeout_ms) {
+    if (stopping_.load() || !task) {
+        return false;
+    }
+    auto group = findGroup(group_id);
+    if (!group) {
+        LOG_ERROR_FMT("[WorkStealingExecutor] submitWhenReadable: group %lu not found", (unsigned long)group_id);
+        return false;
+    }
+
+    ParkedTask parked;
+    parked.item = TaskItem{group, std::move(task)};
+    parked.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+
+    std::lock_guard<std::mutex> lock(parked_mutex_);
+    auto& waiting = parked_[fd];
+    if (waiting.empty() && fd >= 0 && epoll_fd_ >= 0) {
+        // 水平触发：注册时已可读会立即唤醒，避免"检查后、挂起前"的信号丢失
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0 && errno == EEXIST) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+        }
+        // 注册失败时仅依赖超时唤醒
+    }
+    waiting.push_back(std::move(parked));
+    group->parked.fetch_add(1);
+    return true;
+}
+
+void WorkStealingExecutor::enqueue(TaskItem item) {
+    item.group->pending.fetch_add(1);
+
+    if (t_executor == this && t_worker_index >= 0) {
+        // 工作线程提交：压入本地队尾（LIFO，数据仍在本核缓存中）
+        auto& queue = *queues_[t_worker_index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(item));
+    } else {
+        std::lock_guard<std::mutex> lock(global_mutex_);
+        global_tasks_.push_back(std::move(item));
+    }
+    queued_total_.fetch_add(1);
+
+    if (sleeping_workers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+}
+
+// ============================================================
+// 工作线程
+// ============================================================
+
+bool WorkStealingExecutor::isWorkerThread() const {
+    return t_executor == this && t_worker_index >= 0;
+}
+
+bool WorkStealingExecutor::popTask(int index, TaskItem* item) {
+    // 1. 本地队尾
+    {
+        auto& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            *item = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // 2. 全局注入队列
+    {
+        std::lock_guard<std::mutex> lock(global_mutex_);
+        if (!global_tasks_.empty()) {
+            *item = std::move(global_tasks_.front());
+            global_tasks_.pop_front();
+            return true;
+        }
+    }
+
+    // 3. 从其他线程队首窃取
+    size_t count = queues_.size();
+    for (size_t i = 1; i < count; i++) {
+        auto& victim = *queues_[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            *item = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingExecutor::shouldDefer(const Group& group) const {
+    uint64_t mine = group.vruntime_ns.load();
+    std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+    for (const auto& entry : groups_) {
+        const Group& other = *entry.second;
+        if (&other != &group && other.pending.load() > 0 &&
+            other.vruntime_ns.load() + kFairSliceNs < mine) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t WorkStealingExecutor::minVruntime(bool runnable_only) const {
+    std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+    uint64_t result = 0;
+    bool first = true;
+    for (const auto& entry : groups_) {
+        if (runnable_only && entry.second->pending.load() <= 0) {
+            continue;
+        }
+        uint64_t v = entry.second->vruntime_ns.load();
+        if (first || v < result) {
+            result = v;
+            first = false;
+        }
+    }
+    return result;
+}
+
+void WorkStealingExecutor::workerLoop(int index) {
+    t_executor = this;
+    t_worker_index = index;
+    int deferrals = 0;
+
+    while (!stopping_.load()) {
+        TaskItem item;
+        if (!popTask(index, &item)) {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            sleeping_workers_.fetch_add(1);
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(kIdleWaitMs), [this] {
+                return stopping_.load() || queued_total_.load() > 0;
+            });
+            sleeping_workers_.fetch_sub(1);
+            continue;
+        }
+        queued_total_.fetch_sub(1);
+        item.group->pending.fetch_sub(1);
+
+        // 公平调度：本分组领先落后分组太多时，放回全局队尾让出
+        if (deferrals < kMaxDeferrals && shouldDefer(*item.group)) {
+            deferrals++;
+            item.group->pending.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(global_mutex_);
+                global_tasks_.push_back(std::move(item));
+            }
+            queued_total_.fetch_add(1);
+            continue;
+        }
+        deferrals = 0;
+
+        uint64_t begin = nowNs();
+        try {
+            item.fn();
+        } catch (...) {
+            LOG_WARN_FMT("[WorkStealingExecutor] Exception in task of group '%s'", item.group->name.c_str());
+        }
+        uint64_t elapsed = nowNs() - begin;
+
+        item.group->executed.fetch_add(1);
+        item.group->run_ns.fetch_add(elapsed);
+        item.group->vruntime_ns.fetch_add(elapsed / static_cast<uint64_t>(item.group->weight.load()));
+    }
+
+    t_executor = nullptr;
+    t_worker_index = -1;
+}
+
+void WorkStealingExecutor::wakerLoop() {
+    epoll_event events[64];
+
+    while (!stopping_.load()) {
+        int n = 0;
+        if (epoll_fd_ >= 0) {
+            n = epoll_wait(epoll_fd_, events, 64, kWakerTickMs);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kWakerTickMs));
+        }
+
+        std::vector<TaskItem> ready;
+        {
+            std::lock_guard<std::mutex> lock(parked_mutex_);
+
+            // fd 可读：唤醒挂起在该 fd 上的全部任务
+            for (int i = 0; i < n; i++) {
+                int fd = events[i].data.fd;
+                auto it = parked_.find(fd);
+                if (it != parked_.end()) {
+                    for (auto& parked : it->second) {
+                        ready.push_back(std::move(parked.item));
+                    }
+                    parked_.erase(it);
+                }
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            }
+
+            // 超时：唤醒到期任务
+            auto now = std::chrono::steady_clock::now();
+            for (auto it = parked_.begin(); it != parked_.end();) {
+                auto& waiting = it->second;
+                for (auto task_it = waiting.begin(); task_it != waiting.end();) {
+                    if (task_it->deadline <= now) {
+                        ready.push_back(std::move(task_it->item));
+                        task_it = waiting.erase(task_it);
+                    } else {
+                        ++task_it;
+                    }
+                }
+                if (waiting.empty()) {
+                    if (it->first >= 0 && epoll_fd_ >= 0) {
+                        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->first, nullptr);
+                    }
+                    it = parked_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        for (auto& item : ready) {
+            item.group->parked.fetch_sub(1);
+            enqueue(std::move(item));
+        }
+    }
+}
+
+// ============================================================
+// 查询接口
+// ============================================================
+
+bool WorkStealingExecutor::getGroupStats(uint64_t group_id, GroupStats* stats) const {
+    auto group = findGroup(group_id);
+    if (!group || !stats) {
+        return false;
+    }
+    stats->name = group->name;
+    stats->weight = group->weight.load();
+    stats->executed = group->executed.load();
+    int64_t pending = group->pending.load();
+    int64_t parked = group->parked.load();
+    stats->pending = pending > 0 ? static_cast<uint64_t>(pending) : 0;
+    stats->parked = parked > 0 ? static_cast<uint64_t>(parked) : 0;
+    stats->run_time_ms = group->run_ns.load() / 1e6;
+    stats->vruntime_ms = group->vruntime_ns.load() / 1e6;
+    return true;
+}
+
+void WorkStealingExecutor::printStats() const {
+    LOG_INFO_FMT("[WorkStealingExecutor] Threads: %d, Queued: %d, Sleeping: %d, Min vruntime: %.2f ms",
+                 getThreadCount(), queued_total_.load(), sleeping_workers_.load(), minVruntime(false) / 1e6);
+
+    std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+    for (const auto& entry : groups_) {
+        const Group& group = *entry.second;
+        LOG_INFO_FMT("[WorkStealingExecutor]   Group %lu '%s': weight=%d, executed=%lu, pending=%ld, parked=%ld, "
+                     "run=%.2f ms, vruntime=%.2f ms",
+                     (unsigned long)group.id, group.name.c_str(), group.weight.load(),
+                     (unsigned long)group.executed.load(), (long)group.pending.load(), (long)group.parked.load(),
+                     group.run_ns.load() / 1e6, group.vruntime_ns.load() / 1e6);
+    }
+}
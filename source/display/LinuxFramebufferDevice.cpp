@@ -1,5 +1,6 @@
 #include "display/LinuxFramebufferDevice.hpp"
 #include "common/Logger.hpp"
+#include "common/FrameCopy.hpp"
 #include "buffer/BufferAllocatorFacade.hpp"
 #include "buffer/BufferAllocatorFactory.hpp"
 #include "buffer/FramebufferAllocator.hpp"
@@ -682,10 +683,10 @@ bool LinuxFramebufferDevice::displayBufferByMemcpyToFramebuffer(Buffer* buffer)
     
     size_t copy_size = (buffer->size() < fb_buffer->size()) ? buffer->size() : fb_buffer->size();
     
-    // 执行 memcpy
-    memcpy(fb_buffer->getVirtualAddress(), 
-           buffer->getVirtualAddress(), 
-           copy_size);
+    // 执行拷贝（流式存储，framebuffer 通常是写合并内存）
+    FrameCopy::getInstance().copy(fb_buffer->getVirtualAddress(),
+                                  buffer->getVirtualAddress(),
+                                  copy_size);
     
     // 显示这个 framebuffer buffer
     uint32_t fb_buffer_id = fb_buffer->id();
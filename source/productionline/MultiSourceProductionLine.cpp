@@ -0,0 +1,540 @@
+#include "productionline/MultiSourceProductionLine.hpp"
+#include "buffer/bufferpool/BufferPoolRegistry.hpp"
+#include "common/Logger.hpp"
+#include "productionline/io/RawFrameFile.hpp"
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/pixdesc.h>
+}
+
+namespace {
+// 生产者阻塞等待空闲 buffer / 可运行源的超时（毫秒），超时后检查停止标志
+constexpr int kProducerWaitMs = 100;
+
+// 共享 Pool 默认容量：每个源 2 个 buffer，至少 4 个
+constexpr int kBuffersPerSource = 2;
+constexpr int kMinBufferCount = 4;
+
+inline uint64_t elapsedUs(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+}
+
+// ============================================================
+// 构造函数和析构函数
+// ============================================================
+
+MultiSourceProductionLine::MultiSourceProductionLine(int thread_count, int buffer_count)
+    : sources_()
+    , schedule_mutex_()
+    , schedule_cv_()
+    , global_pass_(0.0)
+    , allocator_facade_uptr_(nullptr)
+    , output_pool_id_(0)
+    , output_pool_weak_()
+    , buffer_count_(buffer_count)
+    , threads_()
+    , running_(false)
+    , active_threads_(0)
+    , threads_mutex_()
+    , thread_count_(thread_count)
+    , produced_frames_(0)
+    , skipped_frames_(0)
+    , start_time_()
+    , elapsed_us_(0)
+    , error_callback_(nullptr)
+    , error_mutex_()
+    , last_error_()
+    , log_prefix_("[MultiSourceProductionLine]")
+{
+    if (thread_count_ < 1) {
+        LOG_WARN_FMT("%s Invalid thread_count, using 1", log_prefix_.c_str());
+        thread_count_ = 1;
+    }
+    if (buffer_count_ < 0) {
+        LOG_WARN_FMT("%s Invalid buffer_count, using default", log_prefix_.c_str());
+        buffer_count_ = 0;
+    }
+}
+
+MultiSourceProductionLine::~MultiSourceProductionLine() {
+    stop();
+    releaseResources();
+}
+
+// ============================================================
+// 核心接口实现
+// ============================================================
+
+int MultiSourceProductionLine::addSource(const SourceConfig& config) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty()) {
+        LOG_WARN_FMT("%s addSource: cannot add source while running", log_prefix_.c_str());
+        return -1;
+    }
+    if (!config.isValid()) {
+        LOG_WARN_FMT("%s addSource: invalid config (empty path or weight < 1)", log_prefix_.c_str());
+        return -1;
+    }
+    auto source = std::make_unique<Source>();
+    source->id = static_cast<int>(sources_.size());
+    source->config = config;
+    if (source->config.name.empty()) {
+        source->config.name = config.worker.file.file_path.empty() ? config.worker.pattern.name
+                                                                    : config.worker.file.file_path;
+    }
+    sources_.push_back(std::move(source));
+    return sources_.back()->id;
+}
+
+void MultiSourceProductionLine::clearSources() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty()) {
+        LOG_WARN_FMT("%s clearSources: cannot clear sources while running", log_prefix_.c_str());
+        return;
+    }
+    releaseResources();
+    sources_.clear();
+}
+
+bool MultiSourceProductionLine::start() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+
+    if (running_.load()) {
+        LOG_WARN_FMT("%s Already running", log_prefix_.c_str());
+        return false;
+    }
+
+    // 上一轮自然结束后线程尚未回收时，先回收再启动
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+    releaseResources();
+
+    if (sources_.empty()) {
+        setError("No source added");
+        return false;
+    }
+
+    // 1. 打开所有源
+    if (!openSources()) {
+        releaseResources();
+        return false;
+    }
+
+    // 2. 创建共享输出 Pool（Buffer 大小取所有源的最大帧）
+    size_t buffer_size = 0;
+    for (const auto& source : sources_) {
+        buffer_size = std::max(buffer_size, source->frame_size);
+    }
+    int buffer_count = buffer_count_ > 0
+        ? buffer_count_
+        : std::max(kMinBufferCount, static_cast<int>(sources_.size()) * kBuffersPerSource);
+
+    allocator_facade_uptr_ = std::make_unique<BufferAllocatorFacade>(BufferAllocatorFactory::AllocatorType::NORMAL);
+    output_pool_id_ = allocator_facade_uptr_->allocatePoolWithBuffers(
+        buffer_count,
+        buffer_size,
+        "MultiSourceProductionLine",
+        "Video"
+    );
+    if (output_pool_id_ == 0) {
+        setError("Failed to create shared output BufferPool");
+        releaseResources();
+        return false;
+    }
+    output_pool_weak_ = BufferPoolRegistry::getInstance().getPool(output_pool_id_);
+
+    // 3. 重置调度状态和统计
+    global_pass_ = 0.0;
+    for (auto& source : sources_) {
+        source->pass = 0.0;
+        source->next_frame = 0;
+        source->inflight = 0;
+        source->ended = false;
+        source->produced.store(0);
+        source->skipped.store(0);
+        source->fill_time_us.store(0);
+    }
+    produced_frames_.store(0);
+    skipped_frames_.store(0);
+    elapsed_us_.store(0);
+    start_time_ = std::chrono::steady_clock::now();
+    running_.store(true);
+
+    LOG_INFO_FMT("%s Starting: %zu sources, %d threads, shared pool %lu (%d x %zu bytes)",
+                 log_prefix_.c_str(), sources_.size(), thread_count_,
+                 (unsigned long)output_pool_id_, buffer_count, buffer_size);
+
+    // 4. 启动生产者线程
+    active_threads_.store(thread_count_);
+    threads_.reserve(thread_count_);
+    for (int i = 0; i < thread_count_; i++) {
+        try {
+            threads_.emplace_back(&MultiSourceProductionLine::producerThreadFunc, this, i);
+        } catch (const std::exception& e) {
+            LOG_ERROR_FMT("%s Failed to start thread #%d: %s", log_prefix_.c_str(), i, e.what());
+            // 未启动的线程不参与计数；至少一个线程启动成功即可继续
+            active_threads_.fetch_sub(thread_count_ - i);
+            if (i == 0) {
+                running_.store(false);
+                releaseResources();
+                setError(std::string("Failed to start producer thread: ") + e.what());
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+void MultiSourceProductionLine::stop() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+
+    // 自然结束时 running_ 已为 false，但线程仍需 join
+    if (threads_.empty()) {
+        return;
+    }
+
+    running_.store(false);
+    schedule_cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+    active_threads_.store(0);
+
+    releaseResources();
+
+    LOG_INFO_FMT("%s Stopped: produced=%d, skipped=%d, fps=%.2f", log_prefix_.c_str(),
+                 produced_frames_.load(), skipped_frames_.load(), getAverageFPS());
+}
+
+// ============================================================
+// 查询接口实现
+// ============================================================
+
+double MultiSourceProductionLine::getAverageFPS() const {
+    int64_t elapsed = elapsed_us_.load();
+    if (elapsed == 0 && start_time_ != std::chrono::steady_clock::time_point()) {
+        elapsed = static_cast<int64_t>(elapsedUs(start_time_));
+    }
+    return elapsed > 0 ? produced_frames_.load() * 1e6 / elapsed : 0.0;
+}
+
+std::vector<MultiSourceProductionLine::SourceStats> MultiSourceProductionLine::getSourceStats() const {
+    std::vector<SourceStats> result;
+    result.reserve(sources_.size());
+
+    uint64_t total = static_cast<uint64_t>(produced_frames_.load());
+    for (const auto& source : sources_) {
+        SourceStats stats;
+        stats.source_id = source->id;
+        stats.name = source->config.name;
+        stats.worker_type = source->worker ? source->worker->getWorkerType() : "";
+        stats.weight = source->config.weight;
+        stats.staged = source->staged;
+        {
+            std::lock_guard<std::mutex> lock(schedule_mutex_);
+            stats.ended = source->ended;
+        }
+        stats.produced = source->produced.load();
+        stats.skipped = source->skipped.load();
+        stats.share = total > 0 ? static_cast<double>(stats.produced) / total : 0.0;
+        uint64_t fills = stats.produced + stats.skipped;
+        if (fills > 0) {
+            stats.avg_fill_ms = source->fill_time_us.load() / 1000.0 / fills;
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+std::string MultiSourceProductionLine::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void MultiSourceProductionLine::printStats() const {
+    LOG_DEBUG_FMT("MultiSourceProductionLine Statistics: Running: %s, Sources: %zu, Produced: %d, Skipped: %d, FPS: %.2f, Threads: %d",
+                  running_.load() ? "Yes" : "No", sources_.size(), produced_frames_.load(),
+                  skipped_frames_.load(), getAverageFPS(), thread_count_);
+    for (const auto& st : getSourceStats()) {
+        LOG_DEBUG_FMT("MultiSourceProductionLine Source #%d '%s': Worker: %s%s, Weight: %d, Produced: %lu (%.1f%%), "
+                      "Skipped: %lu, Fill: %.2f ms%s",
+                      st.source_id, st.name.c_str(), st.worker_type.c_str(), st.staged ? " (staged)" : "",
+                      st.weight, (unsigned long)st.produced, st.share * 100.0, (unsigned long)st.skipped,
+                      st.avg_fill_ms, st.ended ? ", ended" : "");
+    }
+}
+
+// ============================================================
+// 内部方法实现
+// ============================================================
+
+bool MultiSourceProductionLine::openSources() {
+    for (auto& source : sources_) {
+        source->worker = std::make_shared<BufferFillingWorkerFacade>(source->config.worker);
+        if (!source->worker->open()) {
+            setError("Failed to open source #" + std::to_string(source->id) + ": " + source->config.name);
+            return false;
+        }
+
+        source->total_frames = source->worker->getTotalFrames();
+        source->frame_size = source->worker->getFrameSize();
+
+        // Worker 自己的 Pool 中 buffer 绑定了 AVFrame（解码 Worker）时，不能直接填充共享 buffer
+        source->staged = false;
+        source->staging_pool_weak.reset();
+        auto worker_pool = BufferPoolRegistry::getInstance().getPool(source->worker->getOutputBufferPoolId()).lock();
+        if (worker_pool) {
+            for (Buffer* buffer : worker_pool->getAllManagedBuffers()) {
+                if (buffer && buffer->getAVFrame()) {
+                    source->staged = true;
+                    break;
+                }
+            }
+        }
+        if (source->staged) {
+            source->staging_pool_weak = worker_pool;
+        }
+
+        // 解码 Worker 按顺序解码，同一时刻只允许一个线程填充
+        source->max_inflight = source->staged ? 1 : 0;
+
+        if (!source->staged && source->total_frames <= 0) {
+            setError("Source #" + std::to_string(source->id) + " has no frames: " + source->config.name);
+            return false;
+        }
+
+        LOG_INFO_FMT("%s Source #%d '%s': %s, %dx%d, %d frames, weight=%d%s%s", log_prefix_.c_str(),
+                     source->id, source->config.name.c_str(), source->worker->getWorkerType(),
+                     source->worker->getWidth(), source->worker->getHeight(), source->total_frames,
+                     source->config.weight, source->config.loop ? ", loop" : "",
+                     source->staged ? ", staged" : "");
+    }
+    return true;
+}
+
+void MultiSourceProductionLine::releaseResources() {
+    // 先销毁共享 Pool，再关闭 Worker（Worker 析构时销毁自己的 Pool）
+    allocator_facade_uptr_.reset();
+    output_pool_id_ = 0;
+    output_pool_weak_.reset();
+    for (auto& source : sources_) {
+        source->staging_pool_weak.reset();
+        source->worker.reset();
+    }
+}
+
+MultiSourceProductionLine::Source* MultiSourceProductionLine::pickSource(int* frame_index, bool* all_ended) {
+    std::lock_guard<std::mutex> lock(schedule_mutex_);
+
+    *all_ended = true;
+    Source* best = nullptr;
+    for (auto& source_uptr : sources_) {
+        Source* source = source_uptr.get();
+        if (source->ended) {
+            continue;
+        }
+        // 非循环模式的 Raw 源按帧索引判断结束（解码源以 EOF 为准）
+        if (!source->staged && !source->config.loop && source->next_frame >= source->total_frames) {
+            if (source->inflight == 0) {
+                source->ended = true;
+                LOG_INFO_FMT("%s Source #%d '%s' finished", log_prefix_.c_str(),
+                             source->id, source->config.name.c_str());
+            } else {
+                *all_ended = false;
+            }
+            continue;
+        }
+        *all_ended = false;
+        if (source->max_inflight > 0 && source->inflight >= source->max_inflight) {
+            continue;
+        }
+        if (!best || source->pass < best->pass) {
+            best = source;
+        }
+    }
+    if (!best) {
+        return nullptr;
+    }
+
+    // 恢复可运行的源不早于全局虚拟时间，避免长时间等待后突发占用
+    best->pass = std::max(best->pass, global_pass_);
+    global_pass_ = best->pass;
+    best->pass += 1.0 / best->config.weight;
+    best->inflight++;
+
+    *frame_index = best->next_frame;
+    if (!best->staged) {
+        best->next_frame = best->config.loop ? (best->next_frame + 1) % best->total_frames
+                                             : best->next_frame + 1;
+    } else {
+        best->next_frame++;
+    }
+    return best;
+}
+
+void MultiSourceProductionLine::finishFill(Source* source, bool ended) {
+    {
+        std::lock_guard<std::mutex> lock(schedule_mutex_);
+        source->inflight--;
+        if (ended && !source->ended) {
+            source->ended = true;
+            LOG_INFO_FMT("%s Source #%d '%s' reached EOF", log_prefix_.c_str(),
+                         source->id, source->config.name.c_str());
+        }
+    }
+    schedule_cv_.notify_all();
+}
+
+bool MultiSourceProductionLine::fillFromSource(Source* source, int frame_index, Buffer* buffer) {
+    if (source->staged) {
+        return fillStaged(source, frame_index, buffer);
+    }
+    // 上一次可能由解码源填充：清除残留的图像元数据
+    buffer->clearImageMetadata();
+    return source->worker->fillBuffer(frame_index, buffer);
+}
+
+bool MultiSourceProductionLine::fillStaged(Source* source, int frame_index, Buffer* buffer) {
+    auto staging_pool = source->staging_pool_weak.lock();
+    if (!staging_pool) {
+        LOG_ERROR_FMT("%s Source #%d: staging BufferPool not found or destroyed", log_prefix_.c_str(), source->id);
+        return false;
+    }
+
+    Buffer* staging = nullptr;
+    while (running_.load() && staging == nullptr) {
+        staging = staging_pool->acquireFree(true, kProducerWaitMs);
+    }
+    if (staging == nullptr) {
+        return false;
+    }
+
+    bool ok = source->worker->fillBuffer(frame_index, staging);
+    AVFrame* frame = staging->getAVFrame();
+    if (ok && frame) {
+        // 按像素格式紧凑拷贝（去掉 linesize 对齐填充，FrameCopy 按行拷贝），并写入共享 buffer 的图像元数据
+        AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+        productionline::io::RawFrameFileInfo layout;
+        layout.width = frame->width;
+        layout.height = frame->height;
+        layout.pixel_format = frame->format;
+        if (!productionline::io::RawFrameFile::setImageLayout(&layout) || layout.frame_size > buffer->size()) {
+            LOG_ERROR_FMT("%s Source #%d: decoded frame (%dx%d, %s) does not fit shared buffer (%zu bytes)",
+                          log_prefix_.c_str(), source->id, frame->width, frame->height,
+                          av_get_pix_fmt_name(format) ? av_get_pix_fmt_name(format) : "unknown", buffer->size());
+            ok = false;
+        } else if (!productionline::io::RawFrameFile::copyPlanes(layout, frame->data, frame->linesize,
+                                                                 static_cast<uint8_t*>(buffer->data()))) {
+            LOG_ERROR_FMT("%s Source #%d: failed to copy decoded frame %d", log_prefix_.c_str(), source->id, frame_index);
+            ok = false;
+        } else {
+            buffer->setImageMetadata(layout.width, layout.height, format, layout.linesize, layout.plane_offset,
+                                     layout.plane_count);
+        }
+    }
+
+    // 中转 buffer 不提交：数据已拷贝，直接归还 Worker 的 free 队列
+    staging_pool->releaseFree(staging);
+    return ok;
+}
+
+void MultiSourceProductionLine::producerThreadFunc(int thread_id) {
+    auto pool_sptr = output_pool_weak_.lock();
+    if (!pool_sptr) {
+        LOG_ERROR_FMT("%s Thread #%d: shared BufferPool not found or destroyed", log_prefix_.c_str(), thread_id);
+    } else {
+        int thread_produced = 0;
+        Buffer* buffer = nullptr;
+
+        while (running_.load()) {
+            // 1. 先取空闲 buffer，再选择源（等待 buffer 期间不占用源的并发名额）
+            if (buffer == nullptr) {
+                buffer = pool_sptr->acquireFree(true, kProducerWaitMs);
+                if (buffer == nullptr) {
+                    continue;
+                }
+            }
+
+            // 2. 加权公平选择源
+            int frame_index = 0;
+            bool all_ended = false;
+            Source* source = pickSource(&frame_index, &all_ended);
+            if (source == nullptr) {
+                if (all_ended) {
+                    break;
+                }
+                // 所有未结束的源都在被其他线程填充：等待名额释放
+                std::unique_lock<std::mutex> lock(schedule_mutex_);
+                schedule_cv_.wait_for(lock, std::chrono::milliseconds(kProducerWaitMs));
+                continue;
+            }
+
+            // 3. 填充
+            auto fill_start = std::chrono::steady_clock::now();
+            bool ok = fillFromSource(source, frame_index, buffer);
+            source->fill_time_us.fetch_add(elapsedUs(fill_start));
+
+            bool source_ended = false;
+            if (ok) {
+                buffer->setSourceId(source->id);
+                pool_sptr->submitFilled(buffer);
+                buffer = nullptr;
+                source->produced.fetch_add(1);
+                produced_frames_.fetch_add(1);
+                thread_produced++;
+            } else if (source->worker->isAtEnd()) {
+                // 到达 EOF：循环模式重置源，否则标记结束
+                if (!source->config.loop) {
+                    source_ended = true;
+                } else if (!source->worker->seekToBegin()) {
+                    LOG_ERROR_FMT("%s Source #%d: failed to reset to begin", log_prefix_.c_str(), source->id);
+                    source_ended = true;
+                }
+            } else if (running_.load()) {
+                source->skipped.fetch_add(1);
+                skipped_frames_.fetch_add(1);
+            }
+            finishFill(source, source_ended);
+        }
+
+        if (buffer) {
+            pool_sptr->releaseFree(buffer);
+        }
+        LOG_INFO_FMT("%s Thread #%d finished: produced=%d", log_prefix_.c_str(), thread_id, thread_produced);
+    }
+
+    int remaining = active_threads_.fetch_sub(1) - 1;
+    if (remaining == 0) {
+        elapsed_us_.store(static_cast<int64_t>(elapsedUs(start_time_)));
+        running_.store(false);
+        LOG_INFO_FMT("%s All producer threads finished", log_prefix_.c_str());
+    }
+}
+
+void MultiSourceProductionLine::setError(const std::string& error_msg) {
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = error_msg;
+    }
+
+    if (error_callback_) {
+        try {
+            error_callback_(error_msg);
+        } catch (...) {
+            LOG_WARN("Exception in error callback");
+        }
+    }
+
+    LOG_ERROR_FMT("MultiSourceProductionLine Error: %s", error_msg.c_str());
+}
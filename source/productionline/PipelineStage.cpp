@@ -0,0 +1,292 @@
+#include "productionline/PipelineStage.hpp"
+#include "buffer/bufferpool/BufferPoolRegistry.hpp"
+#include "common/Logger.hpp"
+#include "common/NumaPlacement.hpp"
+
+namespace {
+// 阶段阻塞等待上游帧 / 下游空闲 buffer 的超时（毫秒）
+constexpr int kStageWaitMs = 100;
+
+inline uint64_t elapsedUs(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+}
+
+// ============================================================
+// 构造函数和析构函数
+// ============================================================
+
+PipelineStage::PipelineStage(const StageConfig& config)
+    : config_(config)
+    , allocator_facade_uptr_(nullptr)
+    , output_pool_id_(0)
+    , input_pool_weak_()
+    , output_pool_weak_()
+    , numa_node_(-1)
+    , threads_()
+    , active_threads_(0)
+    , upstream_done_(false)
+    , stopping_(false)
+    , on_finished_(nullptr)
+    , threads_mutex_()
+    , frames_in_(0)
+    , frames_out_(0)
+    , frames_dropped_(0)
+    , process_time_us_(0)
+    , input_wait_us_(0)
+    , output_wait_us_(0)
+    , start_time_()
+    , elapsed_us_(0)
+    , log_prefix_("[PipelineStage:" + config.name + "]")
+{
+    if (config_.thread_count < 1) {
+        LOG_WARN_FMT("%s Invalid thread_count, using 1", log_prefix_.c_str());
+        config_.thread_count = 1;
+    }
+}
+
+PipelineStage::~PipelineStage() {
+    stop();
+    releaseOutputPool();
+}
+
+// ============================================================
+// 生命周期
+// ============================================================
+
+bool PipelineStage::start(uint64_t input_pool_id, int numa_node, std::function<void()> on_finished) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+
+    if (!threads_.empty()) {
+        LOG_WARN_FMT("%s Already running", log_prefix_.c_str());
+        return false;
+    }
+    if (!config_.isValid()) {
+        LOG_ERROR_FMT("%s Invalid stage config (process function missing?)", log_prefix_.c_str());
+        return false;
+    }
+
+    input_pool_weak_ = BufferPoolRegistry::getInstance().getPool(input_pool_id);
+    auto input_pool = input_pool_weak_.lock();
+    if (!input_pool) {
+        LOG_ERROR_FMT("%s Input BufferPool %lu not found", log_prefix_.c_str(), (unsigned long)input_pool_id);
+        return false;
+    }
+
+    size_t buffer_size = config_.output_buffer_size > 0 ? config_.output_buffer_size
+                                                        : input_pool->getBufferSize();
+    numa_node_ = numa_node;
+
+    // 热重启：上一轮保留的输出 Pool 规格一致时直接复用（Pool ID 不变，下游无需重新绑定）
+    auto kept_pool = output_pool_weak_.lock();
+    bool reuse_pool = kept_pool && allocator_facade_uptr_ &&
+                      kept_pool->getBufferSize() == buffer_size &&
+                      kept_pool->getTotalCount() == config_.output_buffer_count;
+    kept_pool.reset();
+    if (!reuse_pool) {
+        releaseOutputPool();
+        
+        // 创建输出 Pool（分配期间优先落在指定节点）
+        allocator_facade_uptr_ = std::make_unique<BufferAllocatorFacade>(BufferAllocatorFactory::AllocatorType::NORMAL);
+        {
+            NumaPlacement::ScopedPreferredNode numa_guard(numa_node_);
+            output_pool_id_ = allocator_facade_uptr_->allocatePoolWithBuffers(
+                config_.output_buffer_count,
+                buffer_size,
+                std::string("PipelineStage_") + config_.name,
+                "Pipeline"
+            );
+        }
+        if (output_pool_id_ == 0) {
+            LOG_ERROR_FMT("%s Failed to create output BufferPool", log_prefix_.c_str());
+            allocator_facade_uptr_.reset();
+            return false;
+        }
+        output_pool_weak_ = BufferPoolRegistry::getInstance().getPool(output_pool_id_);
+    }
+    if (numa_node_ >= 0) {
+        if (auto output_pool = output_pool_weak_.lock()) {
+            output_pool->bindToNumaNode(numa_node_);
+        }
+    }
+
+    // 重置状态和统计
+    upstream_done_.store(false);
+    stopping_.store(false);
+    on_finished_ = std::move(on_finished);
+    frames_in_.store(0);
+    frames_out_.store(0);
+    frames_dropped_.store(0);
+    process_time_us_.store(0);
+    input_wait_us_.store(0);
+    output_wait_us_.store(0);
+    elapsed_us_.store(0);
+    start_time_ = std::chrono::steady_clock::now();
+
+    active_threads_.store(config_.thread_count);
+    threads_.reserve(config_.thread_count);
+    for (int i = 0; i < config_.thread_count; i++) {
+        try {
+            threads_.emplace_back(&PipelineStage::threadFunc, this, i);
+        } catch (const std::exception& e) {
+            LOG_ERROR_FMT("%s Failed to start thread #%d: %s", log_prefix_.c_str(), i, e.what());
+            // 未启动的线程不参与计数；至少一个线程启动成功即可继续
+            active_threads_.fetch_sub(config_.thread_count - i);
+            if (i == 0) {
+                releaseOutputPool();
+                return false;
+            }
+            break;
+        }
+    }
+
+    LOG_INFO_FMT("%s Started: %zu threads, output pool %lu (%d x %zu bytes%s)",
+                 log_prefix_.c_str(), threads_.size(), (unsigned long)output_pool_id_,
+                 config_.output_buffer_count, buffer_size, reuse_pool ? ", reused" : "");
+    return true;
+}
+
+void PipelineStage::stop() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+
+    if (threads_.empty()) {
+        return;
+    }
+
+    // 上游已停止：处理完剩余帧后退出
+    upstream_done_.store(true);
+    stopping_.store(true);
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+    active_threads_.store(0);
+}
+
+void PipelineStage::releaseOutputPool() {
+    // Allocator 析构时销毁其创建的 Pool（从 Registry 注销）
+    allocator_facade_uptr_.reset();
+    output_pool_id_ = 0;
+    output_pool_weak_.reset();
+}
+
+// ============================================================
+// 阶段线程
+// ============================================================
+
+Buffer* PipelineStage::acquireOutput(BufferPool* output_pool) {
+    auto wait_start = std::chrono::steady_clock::now();
+    Buffer* output = nullptr;
+    while (output == nullptr) {
+        output = output_pool->acquireFree(true, kStageWaitMs);
+        if (output == nullptr && stopping_.load()) {
+            // 停止期间下游不再消费：放弃本帧，避免阻塞 stop()
+            break;
+        }
+    }
+    output_wait_us_.fetch_add(elapsedUs(wait_start));
+    return output;
+}
+
+void PipelineStage::threadFunc(int thread_id) {
+    auto input_pool = input_pool_weak_.lock();
+    auto output_pool = output_pool_weak_.lock();
+
+    if (!input_pool || !output_pool) {
+        LOG_ERROR_FMT("%s Thread #%d: BufferPool not found or destroyed", log_prefix_.c_str(), thread_id);
+    } else {
+        if (numa_node_ >= 0) {
+            NumaPlacement::setCurrentThreadPreferredNode(numa_node_);
+        }
+
+        while (true) {
+            // 1. 从上游取帧
+            auto wait_start = std::chrono::steady_clock::now();
+            Buffer* input = input_pool->acquireFilled(true, kStageWaitMs);
+            if (input == nullptr && upstream_done_.load()) {
+                // 上游已结束：再非阻塞取一次，覆盖超时与最后一次 submit 之间的竞争
+                input = input_pool->acquireFilled(false, 0);
+                if (input == nullptr) {
+                    break;
+                }
+            }
+            input_wait_us_.fetch_add(elapsedUs(wait_start));
+            if (input == nullptr) {
+                continue;
+            }
+            frames_in_.fetch_add(1);
+
+            // 2. 获取下游空闲 buffer
+            Buffer* output = acquireOutput(output_pool.get());
+            if (output == nullptr) {
+                input_pool->releaseFilled(input);
+                frames_dropped_.fetch_add(1);
+                continue;
+            }
+
+            // 3. 处理
+            auto process_start = std::chrono::steady_clock::now();
+            bool ok = false;
+            try {
+                ok = config_.process(input, output);
+            } catch (...) {
+                LOG_WARN_FMT("%s Exception in process function", log_prefix_.c_str());
+            }
+            process_time_us_.fetch_add(elapsedUs(process_start));
+
+            // 4. 归还上游，提交或丢弃下游
+            input_pool->releaseFilled(input);
+            if (ok) {
+                output_pool->submitFilled(output);
+                frames_out_.fetch_add(1);
+            } else {
+                output_pool->releaseFree(output);
+                frames_dropped_.fetch_add(1);
+            }
+        }
+    }
+
+    int remaining = active_threads_.fetch_sub(1) - 1;
+    if (remaining == 0) {
+        elapsed_us_.store(static_cast<int64_t>(elapsedUs(start_time_)));
+        LOG_INFO_FMT("%s All threads finished: in=%lu, out=%lu, dropped=%lu", log_prefix_.c_str(),
+                     (unsigned long)frames_in_.load(), (unsigned long)frames_out_.load(),
+                     (unsigned long)frames_dropped_.load());
+        if (on_finished_) {
+            on_finished_();
+        }
+    }
+}
+
+// ============================================================
+// 统计
+// ============================================================
+
+PipelineStage::Stats PipelineStage::getStats() const {
+    Stats stats;
+    stats.name = config_.name;
+    stats.thread_count = config_.thread_count;
+    stats.frames_in = frames_in_.load();
+    stats.frames_out = frames_out_.load();
+    stats.frames_dropped = frames_dropped_.load();
+
+    if (stats.frames_in > 0) {
+        stats.avg_process_ms = process_time_us_.load() / 1000.0 / stats.frames_in;
+        stats.avg_input_wait_ms = input_wait_us_.load() / 1000.0 / stats.frames_in;
+        stats.avg_output_wait_ms = output_wait_us_.load() / 1000.0 / stats.frames_in;
+    }
+
+    int64_t elapsed = elapsed_us_.load();
+    if (elapsed == 0 && start_time_ != std::chrono::steady_clock::time_point()) {
+        elapsed = static_cast<int64_t>(elapsedUs(start_time_));
+    }
+    if (elapsed > 0) {
+        stats.busy_ratio = static_cast<double>(process_time_us_.load())
+                         / (static_cast<double>(elapsed) * stats.thread_count);
+    }
+    return stats;
+}
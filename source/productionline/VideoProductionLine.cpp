@@ -1,10 +1,98 @@
 #include "productionline/VideoProductionLine.hpp"
 #include "buffer/bufferpool/BufferPoolRegistry.hpp"
+#include "buffer/bufferpool/SharedMemoryBufferPool.hpp"
 #include "common/Logger.hpp"
+#include "common/NumaPlacement.hpp"
 #include <stdio.h>
+#include <algorithm>
 #include <chrono>
 #include <string>
 
+namespace {
+// 当前线程是否为本模块的消费者线程（用于拦截回调中调用 stop() 导致的自我 join）
+thread_local bool t_in_consumer_thread = false;
+
+// 消费者阻塞等待 filled buffer 的超时（毫秒），超时后检查生产者状态
+constexpr int kConsumerWaitMs = 100;
+
+// 执行器模式下生产任务挂起等待空闲 buffer 的最长时间（毫秒），超时后重新检查
+constexpr int kTaskParkTimeoutMs = 10;
+
+// 自动伸缩阈值：filled 队列占用率高于此值缩容，低于此值扩容
+constexpr double kAutoscaleHighOccupancy = 0.75;
+constexpr double kAutoscaleLowOccupancy = 0.25;
+
+// 扩容后帧率提升低于此比例视为无效（锁竞争），回退并冷却若干周期
+constexpr double kAutoscaleMinGain = 1.05;
+constexpr int kAutoscaleCooldownIntervals = 5;
+
+// 帧率控制：执行器任务距离下一个时间槽超过该值时先挂起（毫秒），
+// 挂起唤醒精度约为执行器唤醒周期，剩余部分在任务内精确等待
+constexpr int kPacingParkThresholdMs = 3;
+constexpr int kPacingParkMarginMs = 2;
+
+// CHUNKED 帧索引分配：自适应块大小上限（帧）
+constexpr int kMaxClaimChunk = 64;
+
+// 批量填充：每次获取 / 填充的帧数上限
+constexpr int kMaxFillBatch = 64;
+
+// 播放列表：预加载时预填充的帧数（占用工作 Pool 的 buffer，不宜过多），
+// 以及解码 Worker 读到非视频包等失败时的最大尝试次数
+constexpr int kPlaylistPrerollFrames = 2;
+constexpr int kPlaylistPrerollAttempts = 16;
+
+// 播放列表切换期间让路的生产者等待切换完成的超时（毫秒），超时后检查停止标志
+constexpr int kPlaylistSwitchWaitMs = 10;
+
+inline int64_t elapsedUsSince(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count();
+}
+
+// 两个配置是否描述同一个源（文件、输出、解码器、Worker 类型均一致，放置除外）
+bool sameSourceConfig(const WorkerConfig& a, const WorkerConfig& b) {
+    const auto& ta = a.decoder.taco;
+    const auto& tb = b.decoder.taco;
+    return a.worker_type == b.worker_type &&
+           a.file.file_path == b.file.file_path &&
+           a.file.start_frame == b.file.start_frame &&
+           a.file.end_frame == b.file.end_frame &&
+           a.output.width == b.output.width &&
+           a.output.height == b.output.height &&
+           a.output.bits_per_pixel == b.output.bits_per_pixel &&
+           a.output.pixel_format == b.output.pixel_format &&
+           a.output.roi_x == b.output.roi_x &&
+           a.output.roi_y == b.output.roi_y &&
+           a.output.roi_width == b.output.roi_width &&
+           a.output.roi_height == b.output.roi_height &&
+           a.pattern.name == b.pattern.name &&
+           a.pattern.stamp_frame_number == b.pattern.stamp_frame_number &&
+           a.pattern.frame_rate == b.pattern.frame_rate &&
+           a.pattern.total_frames == b.pattern.total_frames &&
+           a.pattern.seed == b.pattern.seed &&
+           a.decoder.name == b.decoder.name &&
+           a.decoder.enable_hardware == b.decoder.enable_hardware &&
+           a.decoder.hwaccel_device == b.decoder.hwaccel_device &&
+           a.decoder.decode_threads == b.decoder.decode_threads &&
+           ta.reorder_disable == tb.reorder_disable &&
+           ta.ch0_enable == tb.ch0_enable &&
+           ta.ch1_enable == tb.ch1_enable &&
+           ta.ch1_rgb == tb.ch1_rgb &&
+           ta.ch1_rgb_format == tb.ch1_rgb_format &&
+           ta.ch1_rgb_std == tb.ch1_rgb_std &&
+           ta.ch1_crop_x == tb.ch1_crop_x &&
+           ta.ch1_crop_y == tb.ch1_crop_y &&
+           ta.ch1_crop_width == tb.ch1_crop_width &&
+           ta.ch1_crop_height == tb.ch1_crop_height &&
+           ta.ch1_scale_width == tb.ch1_scale_width &&
+           ta.ch1_scale_height == tb.ch1_scale_height &&
+           a.cache.frame_cache_bytes == b.cache.frame_cache_bytes &&
+           a.cache.frame_cache_compress == b.cache.frame_cache_compress &&
+           a.cache.spill_path == b.cache.spill_path;
+}
+}
+
 // ============================================================
 // 构造函数和析构函数
 // ============================================================
@@ -12,18 +100,106 @@
 VideoProductionLine::VideoProductionLine(bool loop, int thread_count, bool enable_monitor)
     : working_buffer_pool_id_(0)
     , working_buffer_pool_weak_()
+    , output_buffer_pool_weak_()
+    , stages_()
     , worker_facade_sptr_(nullptr)
+    , playlist_mode_(false)
+    , playlist_()
+    , playlist_index_(0)
+    , playlist_mutex_()
+    , playlist_cv_()
+    , source_switch_mutex_()
+    , source_switching_(false)
+    , playlist_generation_(0)
+    , preload_thread_()
+    , preloaded_(nullptr)
+    , pool_owner_facade_sptr_(nullptr)
+    , source_width_(0)
+    , source_height_(0)
+    , source_frame_size_(0)
+    , source_uses_avframe_(false)
+    , playlist_switches_(0)
+    , playlist_max_switch_us_(0)
+    , worker_config_()
+    , paused_(false)
+    , fills_in_flight_(0)
+    , pause_mutex_()
+    , pause_cv_()
+    , pause_started_us_(0)
+    , paused_us_(0)
+    , warm_restarts_(0)
     , threads_()
     , running_(false)
     , active_threads_(0)
     , threads_mutex_()
+    , execution_mode_(ExecutionMode::DEDICATED_THREADS)
+    , executor_weight_(1)
+    , executor_(nullptr)
+    , executor_group_id_(0)
+    , producer_exit_mutex_()
+    , producer_exit_cv_()
+    , producers_exited_(false)
+    , autoscale_enabled_(false)
+    , autoscale_min_(1)
+    , autoscale_max_(1)
+    , autoscale_initial_(1)
+    , autoscale_interval_ms_(500)
+    , target_threads_(0)
+    , production_ended_(false)
+    , next_autoscale_us_(0)
+    , autoscale_mutex_()
+    , autoscale_cv_()
+    , autoscale_stats_mutex_()
+    , autoscale_stats_()
+    , autoscale_window_start_us_(0)
+    , autoscale_last_frames_(0)
+    , autoscale_last_fill_us_(0)
+    , autoscale_last_wait_us_(0)
+    , autoscale_last_up_fps_(-1.0)
+    , autoscale_up_blocked_until_us_(0)
+    , pacing_fps_(0.0)
+    , pacing_from_source_(false)
+    , pacer_(nullptr)
+    , claim_mode_(FrameClaimMode::PER_FRAME)
+    , claim_chunk_size_(0)
+    , reorder_window_(0)
+    , claim_cursors_()
+    , frame_claims_(0)
+    , fill_batch_size_(1)
+    , fill_batches_(0)
+    , frame_sinks_()
+    , consumer_threads_()
+    , consumer_thread_count_(1)
+    , consumer_batch_size_(1)
+    , auto_release_(true)
+    , active_consumers_(0)
+    , producers_done_(false)
+    , output_done_(false)
+    , consumed_frames_(0)
+    , shared_output_name_()
+    , shared_output_count_(0)
+    , shared_output_pool_id_(0)
+    , shared_output_pool_weak_()
+    , shared_view_facade_(nullptr)
+    , shared_view_buffers_()
+    , shared_return_thread_()
+    , shared_return_running_(false)
     , produced_frames_(0)
     , skipped_frames_(0)
     , next_frame_index_(0)
+    , fill_time_us_(0)
+    , free_wait_us_(0)
+    , producer_elapsed_us_(0)
     , loop_(loop)
     , thread_count_(thread_count)
+    , configured_thread_count_(thread_count)
     , total_frames_(0)
     , enable_monitor_(enable_monitor)
+    , numa_node_(-1)
+    , producer_cpus_()
+    , pin_per_thread_(false)
+    , thread_cpus_()
+    , placement_mutex_()
     , error_callback_(nullptr)
     , error_mutex_()
     , last_error_()
@@ -41,6 +217,7 @@ VideoProductionLine::VideoProductionLine(bool loop, int thread_count, bool enabl
     if (thread_count < 1) {
         LOG4CPLUS_WARN(logger, log_prefix_ << " Invalid thread_count, using 1");
         thread_count_ = 1;
+        configured_thread_count_ = 1;
     }
 }
 
@@ -54,9 +231,8 @@ VideoProductionLine::~VideoProductionLine() {
     LOG4CPLUS_INFO(logger, log_prefix_ << " 析构: 已生产 " << produced_frames_.load() << " 帧, 跳过 " << skipped_frames_.load() << " 帧");
     LOG4CPLUS_INFO(logger, log_prefix_ << " " << std::string(69, '='));
     
-    if (running_.load()) {
-        stop();
-    }
+    // 自然结束时线程仍需 join，因此无论 running_ 状态都调用 stop()（可重入）
+    stop();
 }
 
 // ============================================================
@@ -64,6 +240,27 @@ VideoProductionLine::~VideoProductionLine() {
 // ============================================================
 
 bool VideoProductionLine::start(const WorkerConfig& worker_config) {
+    return startInternal(worker_config, false);
+}
+
+bool VideoProductionLine::startPlaylist(const std::vector<WorkerConfig>& items) {
+    if (items.empty()) {
+        LOG_WARN("[VideoProductionLine] startPlaylist: empty playlist");
+        return false;
+    }
+    if (running_.load()) {
+        LOG_WARN("[VideoProductionLine] startPlaylist: already running");
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(playlist_mutex_);
+        playlist_ = items;
+        playlist_index_ = 0;
+    }
+    return startInternal(items.front(), true);
+}
+
+bool VideoProductionLine::startInternal(const WorkerConfig& worker_config, bool playlist) {
     auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
     
     // 检查是否已经在运行
@@ -72,14 +269,38 @@ bool VideoProductionLine::start(const WorkerConfig& worker_config) {
         return false;
     }
     
+    // 上一轮自然结束后线程尚未回收时，先回收再启动
+    stop();
+    playlist_mode_ = playlist;
+    warm_restarts_ = 0;
+    
+    if (!openSource(worker_config)) {
+        return false;
+    }
+    return launch(worker_config);
+}
+
+bool VideoProductionLine::openSource(const WorkerConfig& worker_config) {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+    
     LOG4CPLUS_INFO(logger, log_prefix_ << " BufferFillingWorkerFacade: " << worker_config.file.file_path);
     
     // 创建共享的 BufferFillingWorkerFacade 对象（v2.2：只传入完整配置）
     worker_facade_sptr_ = std::make_shared<BufferFillingWorkerFacade>(worker_config);
     LOG4CPLUS_INFO(logger, log_prefix_ << " 启动Worker...");
     
+    // 解析放置配置（CPU 亲和性 / NUMA）
+    resolvePlacement(worker_config.placement);
+    
     // v2.2：简化的 open 接口（所有参数从 config 获取）
-    if (!worker_facade_sptr_->open()) {
+    // Worker 在 open() 中通过 Allocator 分配 BufferPool 内存，
+    // 期间将当前线程内存策略设为生产者节点，使首次访问的页面落在该节点
+    bool opened = false;
+    {
+        NumaPlacement::ScopedPreferredNode numa_guard(numa_node_);
+        opened = worker_facade_sptr_->open();
+    }
+    if (!opened) {
         setError(std::string("Failed to open video file: ") + worker_config.file.file_path);
         worker_facade_sptr_.reset();
         return false;
@@ -106,6 +327,44 @@ bool VideoProductionLine::start(const WorkerConfig& worker_config) {
         return false;
     }
     
+    // 共享内存输出：工作 Pool 换成包装共享内存 Buffer 的视图 Pool（Worker 自建的 Pool 随即销毁）
+    if (!shared_output_name_.empty()) {
+        int buffer_count = shared_output_count_ > 0 ? shared_output_count_
+                                                    : static_cast<int>(pool_sptr->getTotalCount());
+        pool_sptr.reset();
+        if (!openSharedOutput(buffer_count)) {
+            worker_facade_sptr_.reset();
+            releaseSharedOutput();
+            return false;
+        }
+        pool_sptr = working_buffer_pool_weak_.lock();
+    }
+    
+    // 迁移已分配的 Pool 内存到生产者节点（分配发生在其他节点时生效）
+    if (numa_node_ >= 0) {
+        pool_sptr->bindToNumaNode(numa_node_);
+    }
+    
+    // 工作 Pool 由第一个 Worker 的 Allocator 创建：播放列表切换后仍需保持到 stop()
+    pool_owner_facade_sptr_ = worker_facade_sptr_;
+    source_width_ = worker_facade_sptr_->getWidth();
+    source_height_ = worker_facade_sptr_->getHeight();
+    source_frame_size_ = worker_facade_sptr_->getFrameSize();
+    source_uses_avframe_ = worker_facade_sptr_->usesAVFrameBuffers();
+    worker_config_ = worker_config;
+    return true;
+}
+
+bool VideoProductionLine::launch(const WorkerConfig& worker_config) {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+    
+    auto pool_sptr = working_buffer_pool_weak_.lock();
+    if (!pool_sptr) {
+        setError("Working BufferPool destroyed");
+        worker_facade_sptr_.reset();
+        return false;
+    }
+    
     total_frames_ = worker_facade_sptr_->getTotalFrames();
     size_t frame_size = worker_facade_sptr_->getFrameSize();
     
@@ -113,14 +372,70 @@ bool VideoProductionLine::start(const WorkerConfig& worker_config) {
     LOG4CPLUS_INFO(logger, log_prefix_ << "   - 分辨率: " << worker_facade_sptr_->getWidth() << "x" << worker_facade_sptr_->getHeight());
     LOG4CPLUS_INFO(logger, log_prefix_ << "   - 总帧数: " << total_frames_);
     LOG4CPLUS_INFO(logger, log_prefix_ << "   - 帧大小: " << (frame_size / (1024.0 * 1024.0)) << " MB");
+    if (claim_mode_ == FrameClaimMode::CHUNKED) {
+        LOG4CPLUS_INFO(logger, log_prefix_ << "   - 帧索引分配: chunked, "
+                       << (claim_chunk_size_ > 0 ? std::to_string(claim_chunk_size_) : std::string("adaptive")));
+    }
+    if (fill_batch_size_ > 1) {
+        LOG4CPLUS_INFO(logger, log_prefix_ << "   - 批量填充: " << fill_batch_size_ << " 帧");
+    }
     
     // 重置状态
     running_.store(true);
     produced_frames_.store(0);
     skipped_frames_.store(0);
+    consumed_frames_.store(0);
+    producers_done_.store(false);
+    output_done_.store(false);
+    fill_time_us_.store(0);
+    free_wait_us_.store(0);
+    producer_elapsed_us_.store(0);
+    production_ended_.store(false);
+    target_threads_.store(autoscale_enabled_ ? autoscale_initial_ : thread_count_);
+    next_autoscale_us_.store(static_cast<int64_t>(autoscale_interval_ms_) * 1000);
+    {
+        std::lock_guard<std::mutex> lock(autoscale_stats_mutex_);
+        autoscale_stats_ = AutoscaleStats();
+        autoscale_stats_.enabled = autoscale_enabled_;
+        autoscale_stats_.min_threads = autoscale_enabled_ ? autoscale_min_ : thread_count_;
+        autoscale_stats_.max_threads = thread_count_;
+        autoscale_window_start_us_ = 0;
+        autoscale_last_frames_ = 0;
+        autoscale_last_fill_us_ = 0;
+        autoscale_last_wait_us_ = 0;
+        autoscale_last_up_fps_ = -1.0;
+        autoscale_up_blocked_until_us_ = 0;
+    }
     next_frame_index_.store(0);
+    playlist_generation_.store(0);
+    playlist_switches_.store(0);
+    playlist_max_switch_us_.store(0);
+    source_switching_.store(false);
+    paused_.store(false);
+    fills_in_flight_.store(0);
+    pause_started_us_.store(0);
+    paused_us_.store(0);
+    frame_claims_.store(0);
+    fill_batches_.store(0);
+    claim_cursors_.assign(thread_count_, ClaimCursor());
+    reorder_window_ = static_cast<int>(pool_sptr->getTotalCount());
     start_time_ = std::chrono::steady_clock::now();
     
+    // 帧率控制：按源帧率时从 Worker 获取
+    double pacing_fps = pacing_fps_;
+    if (pacing_from_source_) {
+        pacing_fps = worker_facade_sptr_->getFrameRate();
+        if (pacing_fps <= 0.0) {
+            LOG4CPLUS_WARN(logger, log_prefix_ << " Source frame rate unknown, pacing disabled (use setPacing())");
+        }
+    }
+    pacer_.reset();
+    if (pacing_fps > 0.0) {
+        pacer_ = std::make_unique<FramePacer>(pacing_fps);
+        LOG4CPLUS_INFO(logger, log_prefix_ << "   - 帧率控制: " << pacing_fps << " fps"
+                       << (pacing_from_source_ ? " (source)" : ""));
+    }
+    
     // 初始化性能监控（仅在启用时）
     if (enable_monitor_) {
         monitor_ = std::make_unique<PerformanceMonitor>();
@@ -131,10 +446,75 @@ bool VideoProductionLine::start(const WorkerConfig& worker_config) {
     // 启动生产者线程
     threads_.reserve(thread_count_);
     active_threads_.store(thread_count_);
+    {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        thread_cpus_.assign(thread_count_, -1);
+    }
+    
+    // 启动处理阶段（必须在生产者之前，保证生产者结束时阶段已在等待上游）
+    output_buffer_pool_weak_ = working_buffer_pool_weak_;
+    uint64_t upstream_pool_id = working_buffer_pool_id_;
+    for (size_t i = 0; i < stages_.size(); i++) {
+        PipelineStage* next_stage = (i + 1 < stages_.size()) ? stages_[i + 1].get() : nullptr;
+        auto on_finished = [this, next_stage]() {
+            if (next_stage) {
+                next_stage->markUpstreamDone();
+            } else {
+                onOutputFinished();
+            }
+        };
+        if (!stages_[i]->start(upstream_pool_id, numa_node_, on_finished)) {
+            // 回收已启动的阶段
+            for (size_t j = 0; j < i; j++) {
+                stages_[j]->stop();
+                stages_[j]->releaseOutputPool();
+            }
+            running_.store(false);
+            worker_facade_sptr_.reset();
+            setError("Failed to start pipeline stage: " + stages_[i]->getName());
+            return false;
+        }
+        upstream_pool_id = stages_[i]->getOutputPoolId();
+        output_buffer_pool_weak_ = BufferPoolRegistry::getInstance().getPool(upstream_pool_id);
+        LOG4CPLUS_INFO(logger, log_prefix_ << "   - Stage #" << i << " '" << stages_[i]->getName()
+                       << "' started, output pool " << upstream_pool_id);
+    }
+    
+    // 消费者计数必须在生产者启动前设置，否则生产者提前结束时会误判流水线已停止
+    // 共享内存输出由消费者线程提交到共享 filled 队列，未注册回调时也需要消费者
+    int consumer_count = (frame_sinks_.empty() && shared_output_pool_id_ == 0) ? 0 : consumer_thread_count_;
+    active_consumers_.store(consumer_count);
+    
+    LOG4CPLUS_INFO(logger, log_prefix_ << " 启动生产线: " << thread_count_
+                   << (execution_mode_ == ExecutionMode::SHARED_EXECUTOR ? " executor tasks" : " threads")
+                   << (consumer_count > 0 ? ", " + std::to_string(consumer_count) + " consumer threads" : ""));
+    
+    {
+        std::lock_guard<std::mutex> lock(producer_exit_mutex_);
+        producers_exited_ = false;
+    }
     
-    LOG4CPLUS_INFO(logger, log_prefix_ << " 启动生产线: " << thread_count_ << " threads");
+    if (execution_mode_ == ExecutionMode::SHARED_EXECUTOR) {
+        // 共享执行器：注册分组并提交 thread_count_ 个并发填充任务
+        executor_group_id_ = executor_->registerGroup(worker_config.file.file_path, executor_weight_);
+        if (!producer_cpus_.empty()) {
+            LOG4CPLUS_WARN(logger, log_prefix_ << " CPU affinity is not applied in shared executor mode");
+        }
+        if (monitor_) {
+            monitor_->start();
+        }
+        LOG4CPLUS_INFO(logger, log_prefix_ << "   - 共享执行器: group=" << executor_group_id_
+                       << ", weight=" << executor_weight_ << ", executor threads=" << executor_->getThreadCount());
+        for (int i = 0; i < thread_count_; i++) {
+            if (!executor_->submit(executor_group_id_, [this, i]() {
+                    producerTask(i, std::chrono::steady_clock::time_point());
+                })) {
+                onProducerExit();
+            }
+        }
+    }
     
-    for (int i = 0; i < thread_count_; i++) {
+    for (int i = 0; execution_mode_ == ExecutionMode::DEDICATED_THREADS && i < thread_count_; i++) {
         try {
             threads_.emplace_back(&VideoProductionLine::producerThreadFunc, this, i);
             LOG4CPLUS_INFO(logger, log_prefix_ << "   - Thread #" << i << " started");
@@ -143,35 +523,87 @@ bool VideoProductionLine::start(const WorkerConfig& worker_config) {
             // 停止已启动的线程
             running_.store(false);
             active_threads_.store(0);  // 重置活跃线程计数
+            active_consumers_.store(0);
             for (auto& thread : threads_) {
                 if (thread.joinable()) {
                     thread.join();
                 }
             }
             threads_.clear();
+            for (auto& stage : stages_) {
+                stage->stop();
+                stage->releaseOutputPool();
+            }
             worker_facade_sptr_.reset();
             setError(std::string("Failed to start producer thread: ") + e.what());
             return false;
         }
     }
     
+    // 启动消费者线程（仅注册了帧回调时）
+    consumer_threads_.reserve(consumer_count);
+    for (int i = 0; i < consumer_count; i++) {
+        try {
+            consumer_threads_.emplace_back(&VideoProductionLine::consumerThreadFunc, this, i);
+            LOG4CPLUS_INFO(logger, log_prefix_ << "   - Consumer #" << i << " started");
+        } catch (const std::exception& e) {
+            LOG4CPLUS_ERROR(logger, log_prefix_ << " Failed to start consumer #" << i << ": " << e.what());
+            // 未启动的消费者不参与计数；至少有一个消费者时流水线继续运行
+            active_consumers_.fetch_sub(consumer_count - i);
+            if (i == 0) {
+                stop();
+                setError(std::string("Failed to start consumer thread: ") + e.what());
+                return false;
+            }
+            break;
+        }
+    }
+    
+    // 播放列表：当前项开始播放的同时预加载下一项
+    if (playlist_mode_) {
+        std::lock_guard<std::mutex> lock(playlist_mutex_);
+        LOG4CPLUS_INFO(logger, log_prefix_ << "   - 播放列表: " << playlist_.size() << " 项"
+                       << (loop_ ? " (loop)" : ""));
+        startPreloadLocked(playlist_index_);
+    }
+    
     return true;
 }
 
 void VideoProductionLine::stop() {
+    stopInternal(true);
+}
+
+void VideoProductionLine::stopInternal(bool release_source) {
     // 加锁保护线程相关操作
+    if (t_in_consumer_thread) {
+        // 帧回调中不能 join 自身：只发出停止信号，由外部线程或析构完成回收
+        LOG_WARN("VideoProductionLine::stop() called from frame sink, only signalling producers");
+        running_.store(false);
+        return;
+    }
+    
     std::lock_guard<std::mutex> lock(threads_mutex_);
     
-    if (!running_.load()) {
+    // 自然结束时 running_ 已为 false，但线程仍需 join
+    // 热重启保留的 Worker 和 Pool 也在这里释放
+    if (threads_.empty() && consumer_threads_.empty() && executor_group_id_ == 0) {
+        if (release_source) {
+            releaseSource();
+        }
         return;
     }
     
-    LOG_INFO("Stopping VideoProductionLine...");
+    LOG_INFO_FMT("Stopping VideoProductionLine%s...", release_source ? "" : " (keeping worker and pools)");
     
-    // 设置停止标志
+    // 设置停止标志（唤醒暂停中的生产者）
     running_.store(false);
+    {
+        std::lock_guard<std::mutex> pause_lock(pause_mutex_);
+    }
+    pause_cv_.notify_all();
     
-    // 等待所有线程退出
+    // 等待所有生产者线程退出
     for (auto& thread : threads_) {
         if (thread.joinable()) {
             thread.join();
@@ -179,12 +611,36 @@ void VideoProductionLine::stop() {
     }
     threads_.clear();
     
+    // 执行器模式：等待所有填充任务退出（挂起的任务最迟 kTaskParkTimeoutMs 后被唤醒）
+    if (executor_group_id_ != 0) {
+        {
+            std::unique_lock<std::mutex> exit_lock(producer_exit_mutex_);
+            producer_exit_cv_.wait(exit_lock, [this]() { return producers_exited_; });
+        }
+        executor_->unregisterGroup(executor_group_id_);
+        executor_group_id_ = 0;
+    }
+    
     // 重置活跃线程计数
     active_threads_.store(0);
+    producers_done_.store(true);
     
-    // 关闭视频文件
-    if (worker_facade_sptr_) {
-        worker_facade_sptr_.reset();
+    // 按顺序排空各阶段（上游已全部退出）
+    for (auto& stage : stages_) {
+        stage->stop();
+    }
+    
+    // 等待消费者把已填充的 buffer 分发完（排空语义）
+    for (auto& thread : consumer_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    consumer_threads_.clear();
+    active_consumers_.store(0);
+    
+    if (release_source) {
+        releaseSource();
     }
     
     // 停止性能监控
@@ -196,9 +652,32 @@ void VideoProductionLine::stop() {
     LOG_INFO("VideoProductionLine stopped");
     LOG_INFO_FMT("Total produced: %d frames", produced_frames_.load());
     LOG_INFO_FMT("Total skipped: %d frames", skipped_frames_.load());
+    if (!frame_sinks_.empty()) {
+        LOG_INFO_FMT("Total consumed: %d frames", consumed_frames_.load());
+    }
     LOG_INFO_FMT("Average FPS: %.2f", getAverageFPS());
 }
 
+void VideoProductionLine::releaseSource() {
+    // 销毁阶段输出 Pool（下游已全部退出）
+    for (auto& stage : stages_) {
+        stage->releaseOutputPool();
+    }
+    output_buffer_pool_weak_.reset();
+    
+    // 回收预加载（预填充的 buffer 归还工作 Pool，必须在 Pool 销毁之前）
+    cancelPreload();
+    
+    // 关闭视频文件（工作 Pool 随其创建者一起销毁）
+    if (worker_facade_sptr_) {
+        worker_facade_sptr_.reset();
+    }
+    pool_owner_facade_sptr_.reset();
+    
+    // 共享内存输出：视图 Pool 和共享内存段（Worker 已销毁）
+    releaseSharedOutput();
+}
+
 // ============================================================
 // 查询接口实现
 // ============================================================
@@ -207,14 +686,14 @@ double VideoProductionLine::getAverageFPS() const {
     if (!running_.load() && threads_.empty()) {
         // 已停止，计算总体平均
         auto duration = std::chrono::steady_clock::now() - start_time_;
-        double seconds = std::chrono::duration<double>(duration).count();
+        double seconds = std::chrono::duration<double>(duration).count() - pausedUs() / 1e6;
         if (seconds > 0) {
             return produced_frames_.load() / seconds;
         }
     } else if (running_.load()) {
         // 正在运行，计算当前平均
         auto duration = std::chrono::steady_clock::now() - start_time_;
-        double seconds = std::chrono::duration<double>(duration).count();
+        double seconds = std::chrono::duration<double>(duration).count() - pausedUs() / 1e6;
         if (seconds > 0) {
             return produced_frames_.load() / seconds;
         }
@@ -227,189 +706,1736 @@ std::string VideoProductionLine::getLastError() const {
     return last_error_;
 }
 
-void VideoProductionLine::printStats() const {
-    LOG_DEBUG_FMT("VideoProductionLine Statistics: Running: %s, Produced: %d, Skipped: %d, Total: %d, FPS: %.2f, Threads: %zu",
-                  running_.load() ? "Yes" : "No", produced_frames_.load(), skipped_frames_.load(), 
-                  total_frames_, getAverageFPS(), threads_.size());
+uint64_t VideoProductionLine::getOutputBufferPoolId() const {
+    if (!stages_.empty() && stages_.back()->getOutputPoolId() != 0) {
+        return stages_.back()->getOutputPoolId();
+    }
+    return working_buffer_pool_id_;
 }
 
 // ============================================================
-// 内部方法实现
+// 自动伸缩接口实现
 // ============================================================
 
-std::optional<int> VideoProductionLine::getNextFrameIndex() {
-    // 1. 原子地获取下一个原始索引
-    int raw_index = next_frame_index_.fetch_add(1);
-    
-    // 2. 使用已缓存的总帧数（在 start() 时从 Worker 获取）
-    if (total_frames_ <= 0) {
-        return std::nullopt;
+bool VideoProductionLine::setAutoscale(int min_threads, int max_threads, int interval_ms) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty() || executor_group_id_ != 0) {
+        LOG_WARN("[VideoProductionLine] setAutoscale: cannot change autoscale while running");
+        return false;
     }
-    
-    // 3. 处理循环模式和文件边界
-    if (raw_index >= total_frames_) {
-        if (loop_) {
-            // 循环模式：归一化到有效范围
-            int normalized = raw_index % total_frames_;
-            
-            // 4. 溢出保护：定期重置计数器（避免整数溢出）
-            if (raw_index > 0 && raw_index % (total_frames_ * 2) == 0) {
-                next_frame_index_.store(normalized + 1);
-            }
-            
-            return normalized;
-        } else {
-            // 非循环模式：无更多帧
-            return std::nullopt;
-        }
+    if (min_threads < 1 || max_threads < min_threads || interval_ms <= 0) {
+        LOG_WARN_FMT("[VideoProductionLine] setAutoscale: invalid range [%d, %d] / interval %d ms",
+                     min_threads, max_threads, interval_ms);
+        return false;
     }
     
-    // 有效索引，直接返回
-    return raw_index;
+    autoscale_enabled_ = true;
+    autoscale_min_ = min_threads;
+    autoscale_max_ = max_threads;
+    autoscale_initial_ = std::min(std::max(configured_thread_count_, min_threads), max_threads);
+    autoscale_interval_ms_ = interval_ms;
+    
+    // 按最大值创建生产者，活跃数由 target_threads_ 控制
+    thread_count_ = max_threads;
+    return true;
 }
 
-void VideoProductionLine::producerThreadFunc(int thread_id) {
-    // 从缓存的 weak_ptr 获取临时 shared_ptr（符合架构设计）
-    auto pool_sptr = working_buffer_pool_weak_.lock();
-    if (!pool_sptr) {
-        LOG_ERROR_FMT("Thread #%d: BufferPool not found or destroyed", thread_id);
-        return;
-    }
-    
-    LOG_INFO_FMT("[VideoProductionLine] Thread #%d: Starting unified producer loop", thread_id);
-    LOG_INFO_FMT("[VideoProductionLine] Working BufferPool: '%s'", pool_sptr->getName().c_str());
-    
-    int thread_produced = 0;
-    int thread_skipped = 0;
-    int consecutive_failures = 0;
-    if (monitor_) {
-        monitor_->start();  // 启动后Timer会自动触发周期性报告
-    }
-    
-    while (running_.load()) {
-        // 获取下一个有效的帧索引（封装后的清晰接口）
-        auto frame_index_opt = getNextFrameIndex();
-        if (!frame_index_opt.has_value()) {
-            break;  // 无更多帧，退出循环
-        }
-        int frame_index = frame_index_opt.value();
-        
-        // 🎯 统一的流程：从工作 BufferPool 获取 buffer（使用临时 shared_ptr）
-        Buffer* buffer = nullptr;
-        while (running_.load() && buffer == nullptr) {
-            buffer = pool_sptr->acquireFree(true, 100);  // 100ms 超时
-            if (buffer == nullptr && running_.load()) {
-                // 超时但仍在运行，继续等待
-                LOG_DEBUG_FMT("[Thread #%d] Waiting for free buffer...", thread_id);
-            }
-        }
-        
-        // 检查是否因为停止信号退出循环
-        if (!running_.load()) {
-            break;
-        }
-        
-        // 4. 🎯 统一的接口：调用 Worker 填充 buffer（使用fillBuffer）
-        // 使用 PerformanceMonitor 测量填充buffer的耗时
-        if (monitor_) {
-            monitor_->beginTiming("fill_buffer");
-        }
-        bool fill_success = worker_facade_sptr_->fillBuffer(frame_index, buffer);
-      
-        
-        // 5. 🎯 统一的处理：提交或归还
-        if (fill_success) {
-            // ✅ 填充成功：提交到 filled 队列（供消费者使用）
-            pool_sptr->submitFilled(buffer);
-            produced_frames_.fetch_add(1);
-            thread_produced++;
-            consecutive_failures = 0;  // 重置失败计数
-            if (monitor_) {
-                monitor_->endTiming("fill_buffer");
-            }
-        } else {
-            // ⚠️ 填充失败：检查 Worker 是否到达 EOF
-            if (worker_facade_sptr_->isAtEnd()) {
-                // Worker 到达 EOF
-                if (loop_) {
-                    // 🔧 修复：循环模式下，当 Worker 到达 EOF 时，重置 Worker
-                    // 这确保循环播放时 Worker 能够从文件开头重新开始读取
-                    LOG_DEBUG_FMT("[Thread #%d] Worker reached EOF in loop mode, resetting to begin (frame_index=%d)", 
-                                  thread_id, frame_index);
-                    if (worker_facade_sptr_->seekToBegin()) {
-                        // 重置成功：归还 buffer，重置失败计数，继续下一次循环
-                        // 注意：不增加 skipped_frames，因为这是正常的循环重置操作
-                        pool_sptr->releaseFree(buffer);
-                        consecutive_failures = 0;
-                    } else {
-                        LOG_ERROR_FMT("[Thread #%d] Failed to reset Worker to begin", thread_id);
-                        // 重置失败，按正常失败处理
-                        pool_sptr->releaseFree(buffer);
-                        skipped_frames_.fetch_add(1);
-                        thread_skipped++;
-                        consecutive_failures++;
-                    }
-                } else {
-                    // 🔧 修复：非循环模式下，Worker 到达 EOF 时应该停止循环
-                    LOG_DEBUG_FMT("[Thread #%d] Worker reached EOF in non-loop mode, stopping producer thread", 
-                                  thread_id);
-                    pool_sptr->releaseFree(buffer);
-                    // 停止循环，退出生产者线程
-                    break;
-                }
-            } else {
-                // 非 EOF 情况：正常处理失败（可能是损坏帧等其他错误）
-                pool_sptr->releaseFree(buffer);
-                skipped_frames_.fetch_add(1);
-                thread_skipped++;
-                // 🎯 累加连续失败次数（PerformanceMonitor的Timer会每2秒自动打印统计）
-                consecutive_failures++;
-            }
-            if (monitor_) {
-                monitor_->endTiming("fill_buffer");
-            }
-        }
-    }
-    
-    // 🔧 修复：线程退出前停止 PerformanceMonitor
-    // 注意：monitor_ 是共享的，所有线程都使用同一个 monitor
-    // stop() 方法是线程安全的，可以多次调用（内部会检查是否已停止）
-    // 虽然多个线程退出时都会调用 stop()，但这是安全的，因为 stop() 内部有锁保护
-    // 实际上，只要有一个线程调用了 stop()，定时器就会停止，其他线程的调用会被忽略
-    if (monitor_) {
-        monitor_->stop();
+bool VideoProductionLine::disableAutoscale() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty() || executor_group_id_ != 0) {
+        LOG_WARN("[VideoProductionLine] disableAutoscale: cannot change autoscale while running");
+        return false;
     }
     
-    // 线程结束
-    LOG_INFO_FMT("Thread #%d finished: produced=%d, skipped=%d, final_consecutive_failures=%d",
-                 thread_id, thread_produced, thread_skipped, consecutive_failures);
-    
-    // 减少活跃线程计数
-    int remaining = active_threads_.fetch_sub(1) - 1;
-    if (remaining == 0) {
-        // 最后一个线程退出，设置 running_ 为 false
-        running_.store(false);
-        LOG_INFO("All producer threads finished naturally, production line stopped");
-    }
+    autoscale_enabled_ = false;
+    thread_count_ = configured_thread_count_;
+    return true;
 }
 
-void VideoProductionLine::setError(const std::string& error_msg) {
-    // 保存错误消息
-    {
-        std::lock_guard<std::mutex> lock(error_mutex_);
-        last_error_ = error_msg;
+VideoProductionLine::AutoscaleStats VideoProductionLine::getAutoscaleStats() const {
+    std::lock_guard<std::mutex> lock(autoscale_stats_mutex_);
+    AutoscaleStats stats = autoscale_stats_;
+    stats.active_threads = target_threads_.load();
+    return stats;
+}
+
+// ============================================================
+// 帧率控制接口实现
+// ============================================================
+
+bool VideoProductionLine::setPacing(double target_fps) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty() || executor_group_id_ != 0) {
+        LOG_WARN("[VideoProductionLine] setPacing: cannot change pacing while running");
+        return false;
     }
-    
-    // 调用用户回调
-    if (error_callback_) {
-        try {
-            error_callback_(error_msg);
-        } catch (...) {
-            LOG_WARN("Exception in error callback");
-        }
+    if (target_fps < 0.0) {
+        LOG_WARN_FMT("[VideoProductionLine] setPacing: invalid target fps %.2f", target_fps);
+        return false;
     }
-    
-    // 打印到控制台
-    LOG_ERROR_FMT("VideoProductionLine Error: %s", error_msg.c_str());
+    pacing_fps_ = target_fps;
+    pacing_from_source_ = false;
+    return true;
 }
 
+bool VideoProductionLine::setPacingFromSource() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty() || executor_group_id_ != 0) {
+        LOG_WARN("[VideoProductionLine] setPacingFromSource: cannot change pacing while running");
+        return false;
+    }
+    pacing_fps_ = 0.0;
+    pacing_from_source_ = true;
+    return true;
+}
+
+FramePacer::Stats VideoProductionLine::getPacingStats() const {
+    return pacer_ ? pacer_->getStats() : FramePacer::Stats();
+}
+
+// ============================================================
+// 执行模式接口实现
+// ============================================================
+
+bool VideoProductionLine::setExecutionMode(ExecutionMode mode, int weight, WorkStealingExecutor* executor) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty() || executor_group_id_ != 0) {
+        LOG_WARN("[VideoProductionLine] setExecutionMode: cannot change execution mode while running");
+        return false;
+    }
+    if (weight < 1) {
+        LOG_WARN("[VideoProductionLine] Invalid executor weight, using 1");
+        weight = 1;
+    }
+    execution_mode_ = mode;
+    executor_weight_ = weight;
+    executor_ = nullptr;
+    if (mode == ExecutionMode::SHARED_EXECUTOR) {
+        executor_ = executor ? executor : &WorkStealingExecutor::getInstance();
+    }
+    return true;
+}
+
+// ============================================================
+// 帧索引分配接口实现
+// ============================================================
+
+bool VideoProductionLine::setFrameClaimMode(FrameClaimMode mode, int chunk_size) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty() || executor_group_id_ != 0) {
+        LOG_WARN("[VideoProductionLine] setFrameClaimMode: cannot change claim mode while running");
+        return false;
+    }
+    if (chunk_size < 0) {
+        LOG_WARN_FMT("[VideoProductionLine] setFrameClaimMode: invalid chunk size %d", chunk_size);
+        return false;
+    }
+    claim_mode_ = mode;
+    claim_chunk_size_ = chunk_size;
+    return true;
+}
+
+bool VideoProductionLine::setFillBatchSize(int batch_size) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty() || executor_group_id_ != 0) {
+        LOG_WARN("[VideoProductionLine] setFillBatchSize: cannot change fill batch size while running");
+        return false;
+    }
+    if (batch_size < 1 || batch_size > kMaxFillBatch) {
+        LOG_WARN_FMT("[VideoProductionLine] setFillBatchSize: invalid batch size %d (valid: 1-%d)",
+                     batch_size, kMaxFillBatch);
+        return false;
+    }
+    fill_batch_size_ = batch_size;
+    return true;
+}
+
+// ============================================================
+// 多阶段流水线接口实现
+// ============================================================
+
+bool VideoProductionLine::addStage(const StageConfig& config) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (!config.isValid()) {
+        LOG_WARN_FMT("[VideoProductionLine] addStage: invalid config for stage '%s'", config.name.c_str());
+        return false;
+    }
+    if (running_.load() || !threads_.empty()) {
+        LOG_WARN("[VideoProductionLine] addStage: cannot add stage while running");
+        return false;
+    }
+    StageConfig stage_config = config;
+    if (stage_config.name.empty()) {
+        stage_config.name = "stage" + std::to_string(stages_.size() + 1);
+    }
+    stages_.push_back(std::make_unique<PipelineStage>(stage_config));
+    return true;
+}
+
+void VideoProductionLine::clearStages() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !threads_.empty()) {
+        LOG_WARN("[VideoProductionLine] clearStages: cannot clear stages while running");
+        return;
+    }
+    stages_.clear();
+}
+
+std::vector<PipelineStage::Stats> VideoProductionLine::getStageStats() const {
+    std::vector<PipelineStage::Stats> result;
+    result.reserve(stages_.size() + 1);
+    
+    // 生产者作为第一个阶段（填充 = 处理，等待空闲 buffer = 等待下游）
+    PipelineStage::Stats source;
+    source.name = "source";
+    source.thread_count = thread_count_;
+    source.frames_out = static_cast<uint64_t>(produced_frames_.load());
+    source.frames_dropped = static_cast<uint64_t>(skipped_frames_.load());
+    source.frames_in = source.frames_out + source.frames_dropped;
+    if (source.frames_in > 0) {
+        source.avg_process_ms = fill_time_us_.load() / 1000.0 / source.frames_in;
+        source.avg_output_wait_ms = free_wait_us_.load() / 1000.0 / source.frames_in;
+    }
+    int64_t elapsed = producer_elapsed_us_.load();
+    if (elapsed == 0) {
+        elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_time_).count();
+    }
+    if (elapsed > 0) {
+        source.busy_ratio = static_cast<double>(fill_time_us_.load())
+                          / (static_cast<double>(elapsed) * thread_count_);
+    }
+    result.push_back(source);
+    
+    for (const auto& stage : stages_) {
+        result.push_back(stage->getStats());
+    }
+    return result;
+}
+
+// ============================================================
+// 回调式消费接口实现
+// ============================================================
+
+bool VideoProductionLine::addFrameSink(FrameCallback sink) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (!sink) {
+        LOG_WARN("[VideoProductionLine] addFrameSink: empty sink ignored");
+        return false;
+    }
+    if (running_.load() || !consumer_threads_.empty()) {
+        LOG_WARN("[VideoProductionLine] addFrameSink: cannot add sink while running");
+        return false;
+    }
+    frame_sinks_.push_back(std::move(sink));
+    return true;
+}
+
+void VideoProductionLine::clearFrameSinks() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !consumer_threads_.empty()) {
+        LOG_WARN("[VideoProductionLine] clearFrameSinks: cannot clear sinks while running");
+        return;
+    }
+    frame_sinks_.clear();
+}
+
+bool VideoProductionLine::setConsumerConfig(int thread_count, int batch_size, bool auto_release) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !consumer_threads_.empty()) {
+        LOG_WARN("[VideoProductionLine] setConsumerConfig: cannot change consumers while running");
+        return false;
+    }
+    if (thread_count < 1) {
+        LOG_WARN("[VideoProductionLine] Invalid consumer thread_count, using 1");
+        thread_count = 1;
+    }
+    if (batch_size < 1) {
+        LOG_WARN("[VideoProductionLine] Invalid consumer batch_size, using 1");
+        batch_size = 1;
+    }
+    consumer_thread_count_ = thread_count;
+    consumer_batch_size_ = batch_size;
+    auto_release_ = auto_release;
+    return true;
+}
+
+bool VideoProductionLine::releaseFrame(Buffer* buffer) {
+    if (!buffer) {
+        return false;
+    }
+    auto pool_sptr = output_buffer_pool_weak_.lock();
+    if (!pool_sptr) {
+        LOG_ERROR("[VideoProductionLine] releaseFrame: BufferPool not found or destroyed");
+        return false;
+    }
+    if (shared_output_pool_id_ != 0) {
+        publishSharedFrame(buffer);
+        return true;
+    }
+    pool_sptr->releaseFilled(buffer);
+    return true;
+}
+
+// ============================================================
+// 共享内存输出（跨进程零拷贝）
+// ============================================================
+
+bool VideoProductionLine::setSharedOutput(const std::string& name, int buffer_count) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (running_.load() || !consumer_threads_.empty()) {
+        LOG_WARN("[VideoProductionLine] setSharedOutput: cannot change output while running");
+        return false;
+    }
+    if (buffer_count < 0) {
+        LOG_WARN("[VideoProductionLine] Invalid shared output buffer_count, using worker default");
+        buffer_count = 0;
+    }
+    shared_output_name_ = name;
+    shared_output_count_ = buffer_count;
+    return true;
+}
+
+bool VideoProductionLine::openSharedOutput(int buffer_count) {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+    
+    if (worker_facade_sptr_->usesAVFrameBuffers()) {
+        setError("Shared output requires a raw source (decoded frames are bound to AVFrames)");
+        return false;
+    }
+    if (!stages_.empty()) {
+        setError("Shared output cannot be combined with pipeline stages");
+        return false;
+    }
+    
+    auto& registry = BufferPoolRegistry::getInstance();
+    size_t frame_size = worker_facade_sptr_->getFrameSize();
+    shared_output_pool_id_ = registry.createSharedPool(shared_output_name_, buffer_count, frame_size, "Video");
+    shared_output_pool_weak_ = registry.getSharedPool(shared_output_pool_id_);
+    auto shm_sptr = shared_output_pool_weak_.lock();
+    if (!shm_sptr) {
+        setError("Failed to create shared output pool: " + shared_output_name_);
+        return false;
+    }
+    
+    // 本进程取走全部共享 Buffer：空闲的在视图 Pool 的 free 队列，已发布的在共享 filled 队列
+    for (int i = 0; i < buffer_count; i++) {
+        if (!shm_sptr->acquireFree(false, 0)) {
+            setError("Shared output pool has fewer free buffers than expected");
+            return false;
+        }
+    }
+    
+    // 视图 Pool：按 ID 顺序包装共享内存 Buffer（注入时 ID 依次递增，与共享内存 Buffer ID 一致）
+    shared_view_facade_ = std::make_unique<BufferAllocatorFacade>(BufferAllocatorFactory::AllocatorType::FRAMEBUFFER);
+    uint64_t view_pool_id = shared_view_facade_->allocatePoolWithBuffers(0, 0, shared_output_name_ + "_view", "Video");
+    if (view_pool_id == 0) {
+        setError("Failed to create shared output view pool");
+        return false;
+    }
+    shared_view_buffers_.assign(buffer_count, nullptr);
+    for (int i = 0; i < buffer_count; i++) {
+        Buffer* shm_buffer = shm_sptr->getBufferById(i);
+        Buffer* view_buffer = shared_view_facade_->injectExternalBufferToPool(
+            view_pool_id, shm_buffer->getVirtualAddress(), 0, shm_buffer->size(), QueueType::FREE);
+        if (!view_buffer || view_buffer->id() != static_cast<uint32_t>(i)) {
+            setError("Failed to wrap shared output buffer #" + std::to_string(i));
+            return false;
+        }
+        shared_view_buffers_[i] = view_buffer;
+    }
+    
+    // Worker 改为填充视图 Pool（自建 Pool 尚未开始填充，直接销毁）
+    worker_facade_sptr_->adoptOutputBufferPool(view_pool_id);
+    if (worker_facade_sptr_->getOutputBufferPoolId() != view_pool_id) {
+        setError("Worker failed to adopt the shared output pool");
+        return false;
+    }
+    working_buffer_pool_id_ = view_pool_id;
+    working_buffer_pool_weak_ = registry.getPool(view_pool_id);
+    
+    shared_return_running_.store(true);
+    try {
+        shared_return_thread_ = std::thread(&VideoProductionLine::sharedReturnThreadFunc, this);
+    } catch (const std::exception& e) {
+        shared_return_running_.store(false);
+        setError(std::string("Failed to start shared output return thread: ") + e.what());
+        return false;
+    }
+    
+    LOG4CPLUS_INFO(logger, log_prefix_ << " 共享内存输出: '" << shared_output_name_ << "', "
+                   << buffer_count << " buffers x " << frame_size << " bytes");
+    return true;
+}
+
+void VideoProductionLine::publishSharedFrame(Buffer* buffer) {
+    auto shm_sptr = shared_output_pool_weak_.lock();
+    Buffer* shm_buffer = shm_sptr ? shm_sptr->getBufferById(buffer->id()) : nullptr;
+    if (!shm_buffer) {
+        LOG_ERROR_FMT("[VideoProductionLine] publishSharedFrame: shared buffer #%u not found", buffer->id());
+        return;
+    }
+    
+    // 视图 Buffer 与共享 Buffer 指向同一块内存：plane 偏移可直接沿用
+    if (buffer->hasImageMetadata()) {
+        shm_buffer->setImageMetadata(buffer->getImageWidth(), buffer->getImageHeight(), buffer->getImageFormat(),
+                                     buffer->getImageLinesize(), buffer->getImagePlaneOffset(),
+                                     buffer->getImagePlaneCount());
+    } else {
+        shm_buffer->clearImageMetadata();
+    }
+    shm_sptr->submitFilled(shm_buffer);
+}
+
+void VideoProductionLine::sharedReturnThreadFunc() {
+    auto shm_sptr = shared_output_pool_weak_.lock();
+    auto pool_sptr = working_buffer_pool_weak_.lock();
+    if (!shm_sptr || !pool_sptr) {
+        LOG_ERROR("[VideoProductionLine] Shared output return thread: pool not found or destroyed");
+        return;
+    }
+    
+    int returned = 0;
+    while (shared_return_running_.load()) {
+        Buffer* shm_buffer = shm_sptr->acquireFree(true, kConsumerWaitMs);
+        if (shm_buffer == nullptr) {
+            // 空闲时回收已退出的分析进程持有的 Buffer（回到共享 free 队列，下一轮取回）
+            int reclaimed = shm_sptr->reclaimOrphanedBuffers();
+            if (reclaimed > 0) {
+                LOG_WARN_FMT("[VideoProductionLine] Reclaimed %d shared buffers from exited consumers", reclaimed);
+            }
+            continue;
+        }
+        pool_sptr->releaseFilled(shared_view_buffers_[shm_buffer->id()]);
+        returned++;
+    }
+    LOG_INFO_FMT("[VideoProductionLine] Shared output return thread finished: returned=%d", returned);
+}
+
+void VideoProductionLine::releaseSharedOutput() {
+    shared_return_running_.store(false);
+    if (shared_return_thread_.joinable()) {
+        shared_return_thread_.join();
+    }
+    
+    // 视图 Pool 只包装共享内存，必须先于共享内存段销毁
+    shared_view_buffers_.clear();
+    shared_view_facade_.reset();
+    shared_output_pool_weak_.reset();
+    if (shared_output_pool_id_ != 0) {
+        BufferPoolRegistry::getInstance().releaseSharedPool(shared_output_pool_id_);
+        shared_output_pool_id_ = 0;
+    }
+}
+
+void VideoProductionLine::printStats() const {
+    LOG_DEBUG_FMT("VideoProductionLine Statistics: Running: %s, Produced: %d, Skipped: %d, Total: %d, FPS: %.2f, Threads: %zu",
+                  running_.load() ? "Yes" : "No", produced_frames_.load(), skipped_frames_.load(), 
+                  total_frames_, getAverageFPS(), threads_.size());
+    if (autoscale_enabled_) {
+        AutoscaleStats as = getAutoscaleStats();
+        LOG_DEBUG_FMT("VideoProductionLine Autoscale: Active: %d [%d, %d], Ups: %d, Downs: %d, Occupancy: %.2f, "
+                      "Fill: %.2f ms, Free wait: %.2f ms, FPS: %.1f, Last: %s",
+                      as.active_threads, as.min_threads, as.max_threads, as.scale_ups, as.scale_downs,
+                      as.filled_occupancy, as.avg_fill_ms, as.avg_free_wait_ms, as.fps,
+                      as.last_decision.empty() ? "-" : as.last_decision.c_str());
+    }
+    if (execution_mode_ == ExecutionMode::SHARED_EXECUTOR && executor_group_id_ != 0) {
+        WorkStealingExecutor::GroupStats group_stats;
+        if (executor_->getGroupStats(executor_group_id_, &group_stats)) {
+            LOG_DEBUG_FMT("VideoProductionLine Executor: Group: %lu, Weight: %d, Tasks run: %lu, Pending: %lu, Parked: %lu, Run: %.2f ms",
+                          (unsigned long)executor_group_id_, group_stats.weight, (unsigned long)group_stats.executed,
+                          (unsigned long)group_stats.pending, (unsigned long)group_stats.parked, group_stats.run_time_ms);
+        }
+    }
+    if (playlist_mode_) {
+        std::lock_guard<std::mutex> lock(playlist_mutex_);
+        LOG_DEBUG_FMT("VideoProductionLine Playlist: Item: %zu/%zu, Switches: %d, Max switch: %.2f ms, Next: %s",
+                      playlist_index_ + 1, playlist_.size(), playlist_switches_.load(),
+                      playlist_max_switch_us_.load() / 1000.0,
+                      preloaded_ ? ("#" + std::to_string(preloaded_->index + 1)).c_str() : "none");
+    }
+    if (paused_.load() || warm_restarts_ > 0) {
+        LOG_DEBUG_FMT("VideoProductionLine Control: Paused: %s, Paused time: %.2f s, Warm restarts: %d",
+                      paused_.load() ? "Yes" : "No", pausedUs() / 1e6, warm_restarts_);
+    }
+    // 解码帧缓存（播放列表模式下 Worker 会被切换线程替换，不在此访问）
+    DecodedFrameCache::Stats cache_stats;
+    if (!playlist_mode_ && worker_facade_sptr_ && worker_facade_sptr_->getFrameCacheStats(&cache_stats)) {
+        LOG_DEBUG_FMT("VideoProductionLine Frame cache: State: %s, Frames: %d, Memory: %.1f/%.1f MB%s, Hits: %lu, Misses: %lu, Hit rate: %.1f%%",
+                      DecodedFrameCache::stateName(cache_stats.state), cache_stats.frames,
+                      cache_stats.memory_bytes / (1024.0 * 1024.0), cache_stats.budget_bytes / (1024.0 * 1024.0),
+                      cache_stats.compressed ? " (LZ4)" : "", (unsigned long)cache_stats.hits,
+                      (unsigned long)cache_stats.misses, cache_stats.hitRate() * 100.0);
+    }
+    if (claim_mode_ == FrameClaimMode::CHUNKED) {
+        uint64_t claims = frame_claims_.load();
+        int frames = produced_frames_.load() + skipped_frames_.load();
+        LOG_DEBUG_FMT("VideoProductionLine Claiming: Chunked, Chunk: %d (%s), Reorder window: %d, Claims: %lu, Frames/claim: %.1f",
+                      currentClaimChunkSize(), claim_chunk_size_ > 0 ? "fixed" : "adaptive", reorder_window_,
+                      (unsigned long)claims, claims > 0 ? static_cast<double>(frames) / claims : 0.0);
+    }
+    if (fill_batch_size_ > 1) {
+        uint64_t batches = fill_batches_.load();
+        int frames = produced_frames_.load() + skipped_frames_.load();
+        LOG_DEBUG_FMT("VideoProductionLine Fill batching: Batch: %d, Batches: %lu, Frames/batch: %.1f",
+                      fill_batch_size_, (unsigned long)batches,
+                      batches > 0 ? static_cast<double>(frames) / batches : 0.0);
+    }
+    if (pacer_) {
+        FramePacer::Stats ps = pacer_->getStats();
+        std::string histogram;
+        for (int i = 0; i < FramePacer::kHistogramBuckets; i++) {
+            histogram += (i == 0 ? "" : "/") + std::to_string(ps.histogram[i]);
+        }
+        LOG_DEBUG_FMT("VideoProductionLine Pacing: Target: %.2f fps, Actual: %.2f fps, Late: %lu, Resyncs: %lu, "
+                      "Lateness avg: %.3f ms, max: %.3f ms, Histogram(<0.1/0.5/1/2/5/10/20/>=20 ms): %s",
+                      ps.target_fps, ps.actual_fps, (unsigned long)ps.late_frames, (unsigned long)ps.resyncs,
+                      ps.avg_lateness_ms, ps.max_lateness_ms, histogram.c_str());
+    }
+    if (!frame_sinks_.empty()) {
+        LOG_DEBUG_FMT("VideoProductionLine Consumers: Sinks: %zu, Threads: %zu (active %d), Batch: %d, Auto release: %s, Consumed: %d",
+                      frame_sinks_.size(), consumer_threads_.size(), active_consumers_.load(),
+                      consumer_batch_size_, auto_release_ ? "Yes" : "No", consumed_frames_.load());
+    }
+    
+    // 阶段统计：busy_ratio 最高的阶段即为瓶颈
+    if (!stages_.empty()) {
+        auto stage_stats = getStageStats();
+        size_t bottleneck = 0;
+        for (size_t i = 1; i < stage_stats.size(); i++) {
+            if (stage_stats[i].busy_ratio > stage_stats[bottleneck].busy_ratio) {
+                bottleneck = i;
+            }
+        }
+        for (size_t i = 0; i < stage_stats.size(); i++) {
+            const auto& st = stage_stats[i];
+            LOG_DEBUG_FMT("VideoProductionLine Stage #%zu '%s': Threads: %d, In: %lu, Out: %lu, Dropped: %lu, "
+                          "Process: %.2f ms, Input wait: %.2f ms, Output wait: %.2f ms, Busy: %.0f%%%s",
+                          i, st.name.c_str(), st.thread_count, (unsigned long)st.frames_in,
+                          (unsigned long)st.frames_out, (unsigned long)st.frames_dropped,
+                          st.avg_process_ms, st.avg_input_wait_ms, st.avg_output_wait_ms,
+                          st.busy_ratio * 100.0, i == bottleneck ? " <- bottleneck" : "");
+        }
+    }
+    
+    // 放置信息：配置的节点/CPU，以及每个线程实际所在 CPU 和节点
+    std::string thread_placement;
+    {
+        std::lock_guard<std::mutex> lock(placement_mutex_);
+        for (size_t i = 0; i < thread_cpus_.size(); i++) {
+            int cpu = thread_cpus_[i];
+            thread_placement += " #" + std::to_string(i) + "=cpu" + std::to_string(cpu)
+                              + "/node" + std::to_string(NumaPlacement::getNodeOfCpu(cpu));
+        }
+    }
+    auto pool_sptr = working_buffer_pool_weak_.lock();
+    LOG_DEBUG_FMT("VideoProductionLine Placement: NUMA node: %d, CPUs: %s, Pool node: %d, Threads:%s",
+                  numa_node_, NumaPlacement::formatCpuList(producer_cpus_).c_str(),
+                  pool_sptr ? pool_sptr->getNumaNode() : -1,
+                  thread_placement.empty() ? " (none)" : thread_placement.c_str());
+}
+
+// ============================================================
+// 内部方法实现
+// ============================================================
+
+std::optional<int> VideoProductionLine::getNextFrameIndex(int producer_id) {
+    if (claim_mode_ == FrameClaimMode::CHUNKED) {
+        if (total_frames_ <= 0) {
+            return std::nullopt;
+        }
+        // 当前块已填完时领取下一块（同一生产者内索引连续）
+        ClaimCursor& cursor = claim_cursors_[producer_id];
+        if (cursor.next >= cursor.end && !claimFrameChunk(producer_id)) {
+            return std::nullopt;
+        }
+        int raw = cursor.next++;
+        return loopsSource() ? raw % total_frames_ : raw;
+    }
+    
+    // 1. 原子地获取下一个原始索引
+    frame_claims_.fetch_add(1, std::memory_order_relaxed);
+    int raw_index = next_frame_index_.fetch_add(1);
+    
+    // 2. 使用已缓存的总帧数（在 start() 时从 Worker 获取）
+    if (total_frames_ <= 0) {
+        return std::nullopt;
+    }
+    
+    // 3. 处理循环模式和文件边界
+    if (raw_index >= total_frames_) {
+        if (loopsSource()) {
+            // 循环模式：归一化到有效范围
+            int normalized = raw_index % total_frames_;
+            
+            // 4. 溢出保护：定期重置计数器（避免整数溢出）
+            if (raw_index > 0 && raw_index % (total_frames_ * 2) == 0) {
+                next_frame_index_.store(normalized + 1);
+            }
+            
+            return normalized;
+        } else {
+            // 非循环模式：无更多帧
+            return std::nullopt;
+        }
+    }
+    
+    // 有效索引，直接返回
+    return raw_index;
+}
+
+bool VideoProductionLine::claimFrameChunk(int producer_id) {
+    int chunk = currentClaimChunkSize();
+    int raw = next_frame_index_.fetch_add(chunk);
+    frame_claims_.fetch_add(1, std::memory_order_relaxed);
+    
+    ClaimCursor& cursor = claim_cursors_[producer_id];
+    if (!loopsSource()) {
+        // 非循环模式：块在文件末尾截断
+        if (raw >= total_frames_) {
+            return false;
+        }
+        cursor.next = raw;
+        cursor.end = std::min(raw + chunk, total_frames_);
+        return true;
+    }
+    
+    // 循环模式：索引在取帧时归一化；溢出保护，计数器超过两轮时回绕
+    // （CAS 失败说明其他生产者已领取后续块，由它们负责回绕）
+    int claimed_end = raw + chunk;
+    if (claimed_end >= total_frames_ * 2) {
+        int expected = claimed_end;
+        next_frame_index_.compare_exchange_strong(expected, claimed_end % total_frames_);
+        raw %= total_frames_;
+        claimed_end = raw + chunk;
+    }
+    cursor.next = raw;
+    cursor.end = claimed_end;
+    return true;
+}
+
+int VideoProductionLine::currentClaimChunkSize() const {
+    if (claim_chunk_size_ > 0) {
+        return claim_chunk_size_;
+    }
+    // 自适应：所有生产者已领取的帧合计不超过 Pool 容量（下游重排窗口）
+    int producers = std::max(1, target_threads_.load());
+    return std::min(std::max(reorder_window_ / producers, 1), kMaxClaimChunk);
+}
+
+bool VideoProductionLine::hasClaimedFrames(int producer_id) const {
+    if (claim_mode_ != FrameClaimMode::CHUNKED) {
+        return false;
+    }
+    const ClaimCursor& cursor = claim_cursors_[producer_id];
+    return cursor.next < cursor.end;
+}
+
+// ============================================================
+// 暂停 / 热重启
+// ============================================================
+
+bool VideoProductionLine::pause() {
+    if (!running_.load() || producers_done_.load()) {
+        LOG_WARN("[VideoProductionLine] pause: not running");
+        return false;
+    }
+    if (paused_.exchange(true)) {
+        return true;
+    }
+    pause_started_us_.store(elapsedUsSince(start_time_));
+    
+    // 等待在途填充完成（生产者先登记在途再检查 paused_，二者必有一方看到对方）
+    std::unique_lock<std::mutex> lock(pause_mutex_);
+    pause_cv_.wait(lock, [this]() { return fills_in_flight_.load() == 0; });
+    LOG_INFO_FMT("[VideoProductionLine] Paused after %d frames", produced_frames_.load());
+    return true;
+}
+
+bool VideoProductionLine::resume() {
+    if (!paused_.load()) {
+        return false;
+    }
+    int64_t now_us = elapsedUsSince(start_time_);
+    paused_us_.fetch_add(now_us - pause_started_us_.load());
+    
+    // 丢弃跨越暂停的伸缩评估窗口（帧率控制落后超过 kResyncPeriods 个周期时自行重新锚定，不会突发补帧）
+    {
+        std::lock_guard<std::mutex> lock(autoscale_stats_mutex_);
+        autoscale_window_start_us_ = now_us;
+        autoscale_last_frames_ = produced_frames_.load() + skipped_frames_.load();
+        autoscale_last_fill_us_ = fill_time_us_.load();
+        autoscale_last_wait_us_ = free_wait_us_.load();
+        autoscale_last_up_fps_ = -1.0;
+        next_autoscale_us_.store(now_us + static_cast<int64_t>(autoscale_interval_ms_) * 1000);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(pause_mutex_);
+        paused_.store(false);
+    }
+    pause_cv_.notify_all();
+    LOG_INFO("[VideoProductionLine] Resumed");
+    return true;
+}
+
+bool VideoProductionLine::restart(const WorkerConfig& worker_config) {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+    
+    if (t_in_consumer_thread) {
+        LOG4CPLUS_WARN(logger, log_prefix_ << " restart() cannot be called from a frame sink");
+        return false;
+    }
+    
+    // 未启动、已 stop() 或播放列表模式：冷启动
+    if (!worker_facade_sptr_ || playlist_mode_) {
+        stop();
+        return start(worker_config);
+    }
+    
+    auto restart_start = std::chrono::steady_clock::now();
+    bool same_source = sameSourceConfig(worker_config_, worker_config);
+    
+    // 源变化：在旧源继续生产的同时打开新 Worker（open / 探测流信息 / 解码器初始化）
+    // 新 Worker 直接填充工作 Pool，不自建 Pool（几何不符时回退冷启动，不会写入工作 Pool）
+    std::shared_ptr<BufferFillingWorkerFacade> next_worker;
+    if (!same_source) {
+        next_worker = std::make_shared<BufferFillingWorkerFacade>(worker_config);
+        next_worker->adoptOutputBufferPool(working_buffer_pool_id_);
+        bool opened = false;
+        {
+            NumaPlacement::ScopedPreferredNode numa_guard(numa_node_);
+            opened = next_worker->open();
+        }
+        std::string mismatch = opened ? checkSourceGeometry(next_worker.get()) : std::string();
+        if (!opened || !mismatch.empty()) {
+            LOG4CPLUS_INFO(logger, log_prefix_ << " Warm restart not possible ("
+                           << (opened ? mismatch : std::string("failed to open new source"))
+                           << "), falling back to stop() + start()");
+            next_worker.reset();
+            stop();
+            return start(worker_config);
+        }
+    }
+    
+    // 排空并回收生产者、阶段和消费者线程，保留 Worker、工作 Pool 和阶段输出 Pool
+    stopInternal(false);
+    
+    if (same_source) {
+        // 同一源：保留 demuxer / decoder，回到起始帧
+        if (!worker_facade_sptr_->seekToBegin()) {
+            LOG4CPLUS_WARN(logger, log_prefix_ << " Failed to rewind worker, falling back to stop() + start()");
+            stop();
+            return start(worker_config);
+        }
+    } else {
+        // 替换 Worker：非 Pool 创建者直接销毁，创建者只关闭文件（其 Allocator 持有工作 Pool）
+        if (worker_facade_sptr_ == pool_owner_facade_sptr_) {
+            worker_facade_sptr_->close();
+        }
+        worker_facade_sptr_ = next_worker;
+    }
+    worker_config_ = worker_config;
+    
+    // 放置变化：重新解析并迁移工作 Pool 内存（阶段输出 Pool 在阶段启动时迁移）
+    int previous_node = numa_node_;
+    resolvePlacement(worker_config.placement);
+    if (numa_node_ >= 0 && numa_node_ != previous_node) {
+        if (auto pool_sptr = working_buffer_pool_weak_.lock()) {
+            pool_sptr->bindToNumaNode(numa_node_);
+        }
+    }
+    
+    if (!launch(worker_config)) {
+        stop();
+        return false;
+    }
+    warm_restarts_++;
+    LOG4CPLUS_INFO(logger, log_prefix_ << " Warm restart #" << warm_restarts_ << " ("
+                   << (same_source ? "same source, worker kept" : "new source, pool kept") << "): "
+                   << elapsedUsSince(restart_start) / 1000.0 << " ms");
+    return true;
+}
+
+std::string VideoProductionLine::checkSourceGeometry(BufferFillingWorkerFacade* worker) const {
+    bool uses_avframe = worker->usesAVFrameBuffers();
+    if (worker->getWidth() == source_width_ && worker->getHeight() == source_height_ &&
+        worker->getFrameSize() == source_frame_size_ && uses_avframe == source_uses_avframe_) {
+        return std::string();
+    }
+    return "geometry differs from the working pool (" +
+           std::to_string(worker->getWidth()) + "x" + std::to_string(worker->getHeight()) +
+           " vs " + std::to_string(source_width_) + "x" + std::to_string(source_height_) + ")";
+}
+
+bool VideoProductionLine::enterFill() {
+    fills_in_flight_.fetch_add(1);
+    if (!paused_.load()) {
+        return true;
+    }
+    leaveFill();
+    return false;
+}
+
+void VideoProductionLine::leaveFill() {
+    if (fills_in_flight_.fetch_sub(1) == 1 && paused_.load()) {
+        std::lock_guard<std::mutex> lock(pause_mutex_);
+        pause_cv_.notify_all();
+    }
+}
+
+bool VideoProductionLine::waitWhilePaused() {
+    std::unique_lock<std::mutex> lock(pause_mutex_);
+    pause_cv_.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+        return !paused_.load() || !running_.load();
+    });
+    return running_.load();
+}
+
+int64_t VideoProductionLine::pausedUs() const {
+    int64_t paused_us = paused_us_.load();
+    if (paused_.load()) {
+        paused_us += elapsedUsSince(start_time_) - pause_started_us_.load();
+    }
+    return paused_us;
+}
+
+// ============================================================
+// 播放列表（无缝切换）
+// ============================================================
+
+bool VideoProductionLine::appendToPlaylist(const WorkerConfig& item) {
+    if (!playlist_mode_) {
+        LOG_WARN("[VideoProductionLine] appendToPlaylist: not in playlist mode (use startPlaylist())");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(playlist_mutex_);
+    playlist_.push_back(item);
+    // 当前项已是最后一项时没有预加载在进行：立即预加载新追加的项
+    if (running_.load() && !preloaded_) {
+        startPreloadLocked(playlist_index_);
+    }
+    return true;
+}
+
+int VideoProductionLine::getPlaylistIndex() const {
+    if (!playlist_mode_) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(playlist_mutex_);
+    return static_cast<int>(playlist_index_);
+}
+
+std::shared_lock<std::shared_mutex> VideoProductionLine::lockSourceForFill() {
+    if (!playlist_mode_) {
+        return std::shared_lock<std::shared_mutex>();
+    }
+    // 切换进行中：先让路，避免读优先的 rwlock 上切换方饥饿
+    if (source_switching_.load()) {
+        std::unique_lock<std::mutex> lock(playlist_mutex_);
+        playlist_cv_.wait_for(lock, std::chrono::milliseconds(kPlaylistSwitchWaitMs), [this]() {
+            return !source_switching_.load() || !running_.load();
+        });
+    }
+    return std::shared_lock<std::shared_mutex>(source_switch_mutex_);
+}
+
+bool VideoProductionLine::startPreloadLocked(size_t from) {
+    if (preloaded_ || playlist_.empty()) {
+        return preloaded_ != nullptr;
+    }
+    size_t next = from + 1;
+    if (next >= playlist_.size()) {
+        if (!loop_) {
+            return false;
+        }
+        next = 0;
+    }
+    if (preload_thread_.joinable()) {
+        preload_thread_.join();
+    }
+    preloaded_ = std::make_shared<PreloadedSource>();
+    preloaded_->index = next;
+    try {
+        preload_thread_ = std::thread(&VideoProductionLine::preloadThreadFunc, this, preloaded_, playlist_[next]);
+    } catch (const std::exception& e) {
+        preloaded_->error = std::string("Failed to start preload thread: ") + e.what();
+        preloaded_->done = true;
+    }
+    return true;
+}
+
+void VideoProductionLine::preloadThreadFunc(std::shared_ptr<PreloadedSource> result, WorkerConfig config) {
+    preloadSource(result.get(), config);
+    {
+        std::lock_guard<std::mutex> lock(playlist_mutex_);
+        result->done = true;
+    }
+    playlist_cv_.notify_all();
+}
+
+void VideoProductionLine::preloadSource(PreloadedSource* result, const WorkerConfig& config) {
+    auto pool_sptr = working_buffer_pool_weak_.lock();
+    if (!pool_sptr) {
+        result->error = "Working BufferPool destroyed";
+        return;
+    }
+    
+    // 1. 打开 Worker（open / 探测流信息 / 解码器初始化都在后台完成）
+    //    直接使用工作 Pool：Worker 不再分配自己的 Pool
+    auto worker = std::make_shared<BufferFillingWorkerFacade>(config);
+    worker->adoptOutputBufferPool(working_buffer_pool_id_);
+    bool opened = false;
+    {
+        NumaPlacement::ScopedPreferredNode numa_guard(numa_node_);
+        opened = worker->open();
+    }
+    if (!opened) {
+        result->error = "Failed to open playlist item: " + config.file.file_path;
+        return;
+    }
+    
+    // 2. 几何必须一致才能复用工作 Pool
+    std::string mismatch = checkSourceGeometry(worker.get());
+    if (!mismatch.empty()) {
+        result->error = "Playlist item " + mismatch + ": " + config.file.file_path;
+        return;
+    }
+    
+    // 3. 预填充首帧到工作 Pool（只取空闲 buffer，且至少留一半给当前项，避免当前项无 buffer 可用而无法结束）
+    int preroll_limit = std::min(kPlaylistPrerollFrames, pool_sptr->getTotalCount() / 2);
+    for (int attempt = 0; attempt < kPlaylistPrerollAttempts && running_.load() &&
+                          static_cast<int>(result->preroll.size()) < preroll_limit; attempt++) {
+        Buffer* buffer = pool_sptr->acquireFree(false, 0);
+        if (buffer == nullptr) {
+            break;
+        }
+        if (worker->fillBuffer(static_cast<int>(result->preroll.size()), buffer)) {
+            result->preroll.push_back(buffer);
+        } else {
+            pool_sptr->releaseFree(buffer);
+            if (worker->isAtEnd()) {
+                break;
+            }
+        }
+    }
+    
+    result->worker = worker;
+    result->ok = true;
+    LOG_INFO_FMT("[VideoProductionLine] Playlist item #%zu preloaded: %s (%zu frames prerolled)",
+                 result->index, config.file.file_path.c_str(), result->preroll.size());
+}
+
+bool VideoProductionLine::advancePlaylist(int generation) {
+    if (!playlist_mode_ || !running_.load()) {
+        return false;
+    }
+    
+    // 1. 不持切换锁等待下一项预加载完成：open() / 预填充期间其他生产者继续填充当前项的剩余帧
+    {
+        std::unique_lock<std::mutex> lock(playlist_mutex_);
+        size_t failed_items = 0;
+        while (true) {
+            if (playlist_generation_.load() != generation) {
+                return true;  // 其他生产者已完成切换
+            }
+            if (!running_.load()) {
+                return false;
+            }
+            if (!preloaded_ && (failed_items >= playlist_.size() || !startPreloadLocked(playlist_index_))) {
+                return false;  // 播放列表已结束（或一整轮都无法打开）
+            }
+            if (!preloaded_->done) {
+                playlist_cv_.wait_for(lock, std::chrono::milliseconds(kPlaylistSwitchWaitMs));
+                continue;
+            }
+            if (preloaded_->ok) {
+                break;
+            }
+            // 跳过打开失败或几何不一致的项
+            setError(preloaded_->error);
+            playlist_index_ = preloaded_->index;
+            preloaded_.reset();
+            failed_items++;
+        }
+    }
+    
+    // 2. 独占切换：替换 Worker 和帧索引状态，提交预填充的帧后才释放切换锁（不等待预加载）
+    std::vector<Buffer*> preroll;
+    bool switched = false;
+    source_switching_.store(true);
+    {
+        // 等待所有在途填充完成：此后没有生产者访问 worker_facade_sptr_ / 帧索引
+        std::unique_lock<std::shared_mutex> switch_lock(source_switch_mutex_);
+        auto switch_start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(playlist_mutex_);
+        
+        if (playlist_generation_.load() != generation) {
+            // 其他生产者已完成切换
+            switched = true;
+        } else if (preloaded_ && preloaded_->done && preloaded_->ok) {
+            std::shared_ptr<PreloadedSource> next = std::move(preloaded_);
+            preloaded_.reset();
+            playlist_index_ = next->index;
+            
+            // 替换 Worker：非 Pool 创建者直接销毁，创建者只关闭文件（其 Allocator 持有工作 Pool）
+            if (worker_facade_sptr_ == pool_owner_facade_sptr_) {
+                worker_facade_sptr_->close();
+            }
+            worker_facade_sptr_ = next->worker;
+            total_frames_ = worker_facade_sptr_->getTotalFrames();
+            claim_cursors_.assign(claim_cursors_.size(), ClaimCursor());
+            preroll = std::move(next->preroll);
+            next_frame_index_.store(static_cast<int>(preroll.size()));
+            
+            playlist_generation_.fetch_add(1);
+            playlist_switches_.fetch_add(1);
+            switched = true;
+            
+            int64_t switch_us = elapsedUsSince(switch_start);
+            if (switch_us > playlist_max_switch_us_.load()) {
+                playlist_max_switch_us_.store(switch_us);
+            }
+            LOG_INFO_FMT("[VideoProductionLine] Playlist switched to item #%zu: %s (%d frames, %.2f ms)",
+                         playlist_index_, worker_facade_sptr_->getPath(), total_frames_, switch_us / 1000.0);
+            
+            // 新项开始播放的同时预加载下一项
+            startPreloadLocked(playlist_index_);
+        }
+        lock.unlock();
+        
+        // 3. 仍持有切换锁时提交预填充的帧 0..n-1（不持 playlist_mutex_，限速等待不阻塞预加载）：
+        // 生产者只在共享锁下领取帧索引，新项的帧 n 及之后不会先于预填充帧提交或领取时间槽
+        auto pool_sptr = working_buffer_pool_weak_.lock();
+        for (Buffer* buffer : preroll) {
+            if (!pool_sptr) {
+                break;
+            }
+            if (pacer_ && !pacer_->waitNextSlot(&running_)) {
+                pool_sptr->releaseFree(buffer);
+                continue;
+            }
+            pool_sptr->submitFilled(buffer);
+            produced_frames_.fetch_add(1);
+        }
+    }
+    source_switching_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(playlist_mutex_);
+    }
+    playlist_cv_.notify_all();
+    
+    return switched;
+}
+
+void VideoProductionLine::cancelPreload() {
+    // 预加载线程结束时需要 playlist_mutex_：不持锁 join
+    std::thread preload_thread;
+    {
+        std::lock_guard<std::mutex> lock(playlist_mutex_);
+        preload_thread = std::move(preload_thread_);
+    }
+    if (preload_thread.joinable()) {
+        preload_thread.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(playlist_mutex_);
+    if (preloaded_) {
+        auto pool_sptr = working_buffer_pool_weak_.lock();
+        for (Buffer* buffer : preloaded_->preroll) {
+            if (pool_sptr) {
+                pool_sptr->releaseFree(buffer);
+            }
+        }
+        preloaded_.reset();
+    }
+}
+
+void VideoProductionLine::producerThreadFunc(int thread_id) {
+    // 从缓存的 weak_ptr 获取临时 shared_ptr（符合架构设计）
+    auto pool_sptr = working_buffer_pool_weak_.lock();
+    if (!pool_sptr) {
+        LOG_ERROR_FMT("Thread #%d: BufferPool not found or destroyed", thread_id);
+        onProducerExit();
+        return;
+    }
+    
+    // 应用 CPU 亲和性和 NUMA 内存策略
+    applyThreadPlacement(thread_id);
+    
+    LOG_INFO_FMT("[VideoProductionLine] Thread #%d: Starting unified producer loop", thread_id);
+    LOG_INFO_FMT("[VideoProductionLine] Working BufferPool: '%s'", pool_sptr->getName().c_str());
+    
+    int thread_produced = 0;
+    int thread_skipped = 0;
+    int consecutive_failures = 0;
+    Buffer* buffers[kMaxFillBatch];
+    WorkerBase::FillRequest requests[kMaxFillBatch];
+    if (monitor_) {
+        monitor_->start();  // 启动后Timer会自动触发周期性报告
+    }
+    
+    while (running_.load()) {
+        // 自动伸缩：不活跃的生产者填完已领取的帧后挂起，直到重新激活或生产结束
+        if (thread_id >= target_threads_.load() && !hasClaimedFrames(thread_id)) {
+            if (!waitUntilActive(thread_id)) {
+                break;
+            }
+            continue;
+        }
+        
+        // 暂停中：挂起直到 resume() 或 stop()
+        if (paused_.load()) {
+            if (!waitWhilePaused()) {
+                break;
+            }
+            continue;
+        }
+        
+        // 🎯 统一的流程：先从工作 BufferPool 获取 buffer（使用临时 shared_ptr），再领取帧索引
+        // （批量填充时一次取出最多 fill_batch_size_ 个，只等待第一个）
+        // 其他生产者已到达帧源结尾时，本线程仍要填完已领取的块（CHUNKED），否则块尾的帧丢失
+        int acquired = 0;
+        auto wait_start = std::chrono::steady_clock::now();
+        while (running_.load() && acquired == 0 &&
+               (!production_ended_.load() || hasClaimedFrames(thread_id))) {
+            acquired = pool_sptr->acquireFreeBatch(buffers, fill_batch_size_, true, 100);  // 100ms 超时
+            if (acquired == 0 && running_.load()) {
+                // 超时但仍在运行，继续等待
+                LOG_DEBUG_FMT("[Thread #%d] Waiting for free buffer...", thread_id);
+            }
+        }
+        
+        free_wait_us_.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - wait_start).count());
+        
+        // 检查是否因为停止信号退出循环
+        if (!running_.load()) {
+            for (int i = 0; i < acquired; i++) {
+                pool_sptr->releaseFree(buffers[i]);
+            }
+            break;
+        }
+        if (acquired == 0) {
+            break;  // 其他生产者已到达帧源结尾
+        }
+        
+        // 暂停闸门：等待 buffer 期间被暂停时归还 buffer，回到循环开头挂起
+        if (!enterFill()) {
+            for (int i = 0; i < acquired; i++) {
+                pool_sptr->releaseFree(buffers[i]);
+            }
+            continue;
+        }
+        
+        // 播放列表模式：领取帧索引到填充完成期间持有源共享锁（切换源时独占）
+        auto source_lock = lockSourceForFill();
+        int generation = playlist_generation_.load();
+        
+        // 获取下一个（批）有效的帧索引（封装后的清晰接口）
+        int count = claimFillRequests(pool_sptr.get(), buffers, acquired, thread_id, requests);
+        
+        // 4-5. 🎯 统一的接口：填充并提交或归还
+        FillOutcome outcome = FillOutcome::END;
+        int produced = 0;
+        int skipped = 0;
+        if (count > 0 && fill_batch_size_ > 1) {
+            outcome = fillBatchAndSubmit(pool_sptr.get(), requests, count, thread_id, &produced, &skipped);
+        } else if (count > 0) {
+            outcome = fillAndSubmit(pool_sptr.get(), requests[0].buffer, requests[0].frame_index, thread_id);
+            produced = outcome == FillOutcome::PRODUCED ? 1 : 0;
+            skipped = outcome == FillOutcome::SKIPPED ? 1 : 0;
+        }
+        if (source_lock.owns_lock()) {
+            source_lock.unlock();
+        }
+        bool switched = outcome == FillOutcome::END && advancePlaylist(generation);
+        leaveFill();
+        thread_produced += produced;
+        thread_skipped += skipped;
+        if (outcome == FillOutcome::END) {
+            if (switched) {
+                continue;  // 已切换到播放列表下一项
+            }
+            markProductionEnded();
+            break;  // 无更多帧或非循环模式到达 EOF，退出生产者线程
+        }
+        if (outcome == FillOutcome::PRODUCED) {
+            consecutive_failures = 0;  // 重置失败计数
+        } else if (outcome == FillOutcome::RESET) {
+            consecutive_failures = 0;
+        } else {
+            // 🎯 累加连续失败次数（PerformanceMonitor的Timer会每2秒自动打印统计）
+            consecutive_failures++;
+        }
+    }
+    
+    // 🔧 修复：线程退出前停止 PerformanceMonitor
+    // 注意：monitor_ 是共享的，所有线程都使用同一个 monitor
+    // stop() 方法是线程安全的，可以多次调用（内部会检查是否已停止）
+    // 虽然多个线程退出时都会调用 stop()，但这是安全的，因为 stop() 内部有锁保护
+    // 实际上，只要有一个线程调用了 stop()，定时器就会停止，其他线程的调用会被忽略
+    if (monitor_) {
+        monitor_->stop();
+    }
+    
+    // 线程结束
+    LOG_INFO_FMT("Thread #%d finished: produced=%d, skipped=%d, final_consecutive_failures=%d",
+                 thread_id, thread_produced, thread_skipped, consecutive_failures);
+    
+    onProducerExit();
+}
+
+void VideoProductionLine::producerTask(int task_id, std::chrono::steady_clock::time_point parked_since) {
+    auto pool_sptr = working_buffer_pool_weak_.lock();
+    if (!running_.load() || !pool_sptr) {
+        onProducerExit();
+        return;
+    }
+    
+    if (parked_since != std::chrono::steady_clock::time_point()) {
+        free_wait_us_.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - parked_since).count());
+    }
+    
+    // 暂停中：按固定周期挂起重试（不占用执行器线程）
+    if (paused_.load()) {
+        if (!executor_->submitWhenReadable(executor_group_id_, -1,
+                                           [this, task_id]() { producerTask(task_id, std::chrono::steady_clock::time_point()); },
+                                           kTaskParkTimeoutMs)) {
+            onProducerExit();
+        }
+        return;
+    }
+    
+    // 自动伸缩：不活跃的任务填完已领取的帧后按评估周期挂起（不占用执行器线程）
+    if (task_id >= target_threads_.load() && !hasClaimedFrames(task_id)) {
+        if (production_ended_.load() ||
+            !executor_->submitWhenReadable(executor_group_id_, -1,
+                                           [this, task_id]() { producerTask(task_id, std::chrono::steady_clock::time_point()); },
+                                           autoscale_interval_ms_)) {
+            onProducerExit();
+        }
+        return;
+    }
+    
+    // 帧率控制：距离下一个时间槽较远时先挂起，避免在执行器线程内长时间休眠
+    if (pacer_) {
+        int64_t wait_ms = pacer_->nanosUntilNextSlot() / 1000000;
+        if (wait_ms > kPacingParkThresholdMs) {
+            if (!executor_->submitWhenReadable(executor_group_id_, -1,
+                                               [this, task_id]() { producerTask(task_id, std::chrono::steady_clock::time_point()); },
+                                               static_cast<int>(wait_ms) - kPacingParkMarginMs)) {
+                onProducerExit();
+            }
+            return;
+        }
+    }
+    
+    // 先取 buffer 再取帧索引：挂起等待期间不占用帧索引
+    // 先清除事件再非阻塞获取，保证"获取失败后"的释放一定会再次触发事件
+    // （帧率控制时每个任务只填充一帧，不在执行器线程内等待多个时间槽）
+    Buffer* buffers[kMaxFillBatch];
+    WorkerBase::FillRequest requests[kMaxFillBatch];
+    pool_sptr->clearFreeEvent();
+    int acquired = pool_sptr->acquireFreeBatch(buffers, pacer_ ? 1 : fill_batch_size_, false, 0);
+    if (acquired == 0) {
+        // 无空闲 buffer：挂起到 free 事件上，不占用执行器线程
+        auto now = std::chrono::steady_clock::now();
+        if (!executor_->submitWhenReadable(executor_group_id_, pool_sptr->getFreeEventFd(),
+                                           [this, task_id, now]() { producerTask(task_id, now); },
+                                           kTaskParkTimeoutMs)) {
+            onProducerExit();
+        }
+        return;
+    }
+    
+    // 暂停闸门：取到 buffer 后才登记在途（pause() 只等待真正的填充）
+    if (!enterFill()) {
+        for (int i = 0; i < acquired; i++) {
+            pool_sptr->releaseFree(buffers[i]);
+        }
+        if (!executor_->submit(executor_group_id_, [this, task_id]() {
+                producerTask(task_id, std::chrono::steady_clock::time_point());
+            })) {
+            onProducerExit();
+        }
+        return;
+    }
+    
+    auto source_lock = lockSourceForFill();
+    int generation = playlist_generation_.load();
+    int count = claimFillRequests(pool_sptr.get(), buffers, acquired, task_id, requests);
+    bool source_ended = count == 0;
+    if (count > 0 && fill_batch_size_ > 1) {
+        int produced = 0;
+        int skipped = 0;
+        source_ended = fillBatchAndSubmit(pool_sptr.get(), requests, count, task_id,
+                                          &produced, &skipped) == FillOutcome::END;
+    } else if (count > 0) {
+        source_ended = fillAndSubmit(pool_sptr.get(), requests[0].buffer, requests[0].frame_index,
+                                     task_id) == FillOutcome::END;
+    }
+    if (source_lock.owns_lock()) {
+        source_lock.unlock();
+    }
+    bool ended = source_ended && !advancePlaylist(generation);
+    leaveFill();
+    if (ended) {
+        markProductionEnded();
+        onProducerExit();
+        return;
+    }
+    
+    // 每个任务只生产一帧（一批），然后重新提交（执行器在各生产线之间按权重调度）
+    if (!executor_->submit(executor_group_id_, [this, task_id]() {
+            producerTask(task_id, std::chrono::steady_clock::time_point());
+        })) {
+        onProducerExit();
+    }
+}
+
+VideoProductionLine::FillOutcome VideoProductionLine::fillAndSubmit(
+    BufferPool* pool, Buffer* buffer, int frame_index, int thread_id) {
+    // 使用 PerformanceMonitor 测量填充buffer的耗时
+    if (monitor_) {
+        monitor_->beginTiming("fill_buffer");
+    }
+    auto fill_start = std::chrono::steady_clock::now();
+    bool fill_success = worker_facade_sptr_->fillBuffer(frame_index, buffer);
+    fill_time_us_.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - fill_start).count());
+    
+    FillOutcome outcome = finishFill(pool, buffer, frame_index, fill_success, thread_id);
+    
+    if (monitor_) {
+        monitor_->endTiming("fill_buffer");
+    }
+    
+    maybeAutoscale();
+    return outcome;
+}
+
+VideoProductionLine::FillOutcome VideoProductionLine::fillBatchAndSubmit(
+    BufferPool* pool, WorkerBase::FillRequest* requests, int count, int thread_id, int* produced, int* skipped) {
+    if (monitor_) {
+        monitor_->beginTiming("fill_buffer");
+    }
+    auto fill_start = std::chrono::steady_clock::now();
+    worker_facade_sptr_->fillBuffers(requests, count);
+    fill_time_us_.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - fill_start).count());
+    fill_batches_.fetch_add(1, std::memory_order_relaxed);
+    
+    // 按帧索引顺序提交；到达 EOF 的帧决定重置或结束，之后的 buffer 未填充，直接归还
+    FillOutcome outcome = FillOutcome::SKIPPED;
+    *produced = 0;
+    *skipped = 0;
+    int i = 0;
+    for (; i < count; i++) {
+        FillOutcome frame_outcome = finishFill(pool, requests[i].buffer, requests[i].frame_index,
+                                               requests[i].filled, thread_id);
+        if (frame_outcome == FillOutcome::PRODUCED) {
+            (*produced)++;
+            outcome = FillOutcome::PRODUCED;
+        } else if (frame_outcome == FillOutcome::SKIPPED) {
+            (*skipped)++;
+        } else {
+            outcome = frame_outcome;
+            i++;
+            break;
+        }
+    }
+    for (; i < count; i++) {
+        pool->releaseFree(requests[i].buffer);
+    }
+    
+    if (monitor_) {
+        monitor_->endTiming("fill_buffer");
+    }
+    
+    maybeAutoscale();
+    return outcome;
+}
+
+VideoProductionLine::FillOutcome VideoProductionLine::finishFill(
+    BufferPool* pool, Buffer* buffer, int frame_index, bool fill_success, int thread_id) {
+    FillOutcome outcome = FillOutcome::SKIPPED;
+    if (fill_success && pacer_ && !pacer_->waitNextSlot(&running_)) {
+        // 等待时间槽期间停止：本帧不再放行
+        pool->releaseFree(buffer);
+    } else if (fill_success) {
+        // ✅ 填充成功：提交到 filled 队列（供消费者使用）
+        pool->submitFilled(buffer);
+        produced_frames_.fetch_add(1);
+        outcome = FillOutcome::PRODUCED;
+    } else if (worker_facade_sptr_->isAtEnd()) {
+        // ⚠️ Worker 到达 EOF
+        pool->releaseFree(buffer);
+        if (loopsSource()) {
+            // 🔧 修复：循环模式下，当 Worker 到达 EOF 时，重置 Worker
+            // 这确保循环播放时 Worker 能够从文件开头重新开始读取
+            LOG_DEBUG_FMT("[Thread #%d] Worker reached EOF in loop mode, resetting to begin (frame_index=%d)", 
+                          thread_id, frame_index);
+            if (worker_facade_sptr_->seekToBegin()) {
+                // 注意：不增加 skipped_frames，因为这是正常的循环重置操作
+                outcome = FillOutcome::RESET;
+            } else {
+                // 不可定位的源（管道 / 套接字流）无法回到开头：按非循环模式结束，避免在 EOF 上空转
+                LOG_ERROR_FMT("[Thread #%d] Failed to reset Worker to begin, ending production", thread_id);
+                outcome = FillOutcome::END;
+            }
+        } else {
+            // 🔧 修复：非循环模式下，Worker 到达 EOF 时应该停止循环
+            LOG_DEBUG_FMT("[Thread #%d] Worker reached EOF in non-loop mode, stopping producer thread", 
+                          thread_id);
+            outcome = FillOutcome::END;
+        }
+    } else {
+        // 非 EOF 情况：正常处理失败（可能是损坏帧等其他错误）
+        pool->releaseFree(buffer);
+        skipped_frames_.fetch_add(1);
+        outcome = FillOutcome::SKIPPED;
+    }
+    
+    return outcome;
+}
+
+int VideoProductionLine::claimFillRequests(BufferPool* pool, Buffer** buffers, int acquired, int producer_id,
+                                           WorkerBase::FillRequest* requests) {
+    int count = 0;
+    for (; count < acquired; count++) {
+        auto frame_index_opt = getNextFrameIndex(producer_id);
+        if (!frame_index_opt.has_value()) {
+            break;
+        }
+        requests[count].frame_index = frame_index_opt.value();
+        requests[count].buffer = buffers[count];
+        requests[count].filled = false;
+    }
+    
+    // 帧源已结束（非循环模式到达末尾）：归还没有领取到帧索引的 buffer
+    for (int i = count; i < acquired; i++) {
+        pool->releaseFree(buffers[i]);
+    }
+    return count;
+}
+
+void VideoProductionLine::onProducerExit() {
+    // 减少活跃线程（任务）计数
+    int remaining = active_threads_.fetch_sub(1) - 1;
+    if (remaining != 0) {
+        return;
+    }
+    
+    producer_elapsed_us_.store(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time_).count());
+    producers_done_.store(true);
+    if (execution_mode_ == ExecutionMode::SHARED_EXECUTOR && monitor_) {
+        monitor_->stop();
+    }
+    if (!stages_.empty()) {
+        // 有处理阶段时，由阶段依次排空后通知下游
+        LOG_INFO("All producer threads finished naturally, draining pipeline stages");
+        stages_.front()->markUpstreamDone();
+    } else {
+        onOutputFinished();
+    }
+    
+    // 唤醒等待执行器任务退出的 stop()（必须是最后一次访问 this）
+    std::lock_guard<std::mutex> lock(producer_exit_mutex_);
+    producers_exited_ = true;
+    producer_exit_cv_.notify_all();
+}
+
+void VideoProductionLine::markProductionEnded() {
+    production_ended_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(autoscale_mutex_);
+    }
+    autoscale_cv_.notify_all();
+}
+
+bool VideoProductionLine::waitUntilActive(int thread_id) {
+    std::unique_lock<std::mutex> lock(autoscale_mutex_);
+    autoscale_cv_.wait_for(lock, std::chrono::milliseconds(100), [this, thread_id]() {
+        return !running_.load() || production_ended_.load() || thread_id < target_threads_.load();
+    });
+    return running_.load() && !production_ended_.load();
+}
+
+void VideoProductionLine::maybeAutoscale() {
+    if (!autoscale_enabled_) {
+        return;
+    }
+    
+    // 到期且 CAS 成功的生产者执行本次评估
+    int64_t now_us = elapsedUsSince(start_time_);
+    int64_t due_us = next_autoscale_us_.load();
+    if (now_us < due_us ||
+        !next_autoscale_us_.compare_exchange_strong(due_us, now_us + static_cast<int64_t>(autoscale_interval_ms_) * 1000)) {
+        return;
+    }
+    
+    auto pool_sptr = working_buffer_pool_weak_.lock();
+    if (!pool_sptr) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(autoscale_stats_mutex_);
+    
+    // 1. 计算窗口指标
+    int frames = produced_frames_.load() + skipped_frames_.load();
+    uint64_t fill_us = fill_time_us_.load();
+    uint64_t wait_us = free_wait_us_.load();
+    int window_frames = frames - autoscale_last_frames_;
+    double window_s = (now_us - autoscale_window_start_us_) / 1e6;
+    
+    int total = pool_sptr->getTotalCount();
+    double occupancy = total > 0 ? static_cast<double>(pool_sptr->getFilledCount()) / total : 0.0;
+    double fill_ms = window_frames > 0 ? (fill_us - autoscale_last_fill_us_) / 1000.0 / window_frames : 0.0;
+    double wait_ms = window_frames > 0 ? (wait_us - autoscale_last_wait_us_) / 1000.0 / window_frames : 0.0;
+    double fps = window_s > 0 ? window_frames / window_s : 0.0;
+    
+    autoscale_window_start_us_ = now_us;
+    autoscale_last_frames_ = frames;
+    autoscale_last_fill_us_ = fill_us;
+    autoscale_last_wait_us_ = wait_us;
+    
+    // 2. 决策
+    int target = target_threads_.load();
+    int new_target = target;
+    const char* reason = "hold";
+    
+    if (occupancy >= kAutoscaleHighOccupancy) {
+        reason = "filled queue full, consumers are the bottleneck";
+        new_target = target - 1;
+    } else if (wait_ms > fill_ms && wait_ms > 1.0) {
+        reason = "producers waiting for free buffers";
+        new_target = target - 1;
+    } else if (occupancy <= kAutoscaleLowOccupancy) {
+        if (autoscale_last_up_fps_ >= 0 && fps < autoscale_last_up_fps_ * kAutoscaleMinGain) {
+            // 上次扩容没有带来帧率提升：多余线程只是在竞争 Pool / Worker 锁
+            reason = "no gain from last scale-up, contention";
+            new_target = target - 1;
+            autoscale_up_blocked_until_us_ = now_us
+                + static_cast<int64_t>(autoscale_interval_ms_) * 1000 * kAutoscaleCooldownIntervals;
+        } else if (now_us >= autoscale_up_blocked_until_us_) {
+            reason = "filled queue low, consumers starving";
+            new_target = target + 1;
+        } else {
+            reason = "scale-up cooling down";
+        }
+    }
+    
+    if (new_target < autoscale_min_) {
+        new_target = autoscale_min_;
+        reason = "at min_threads";
+    } else if (new_target > autoscale_max_) {
+        new_target = autoscale_max_;
+        reason = "at max_threads";
+    }
+    
+    autoscale_last_up_fps_ = new_target > target ? fps : -1.0;
+    
+    // 3. 应用并记录
+    autoscale_stats_.filled_occupancy = occupancy;
+    autoscale_stats_.avg_fill_ms = fill_ms;
+    autoscale_stats_.avg_free_wait_ms = wait_ms;
+    autoscale_stats_.fps = fps;
+    
+    if (new_target != target) {
+        target_threads_.store(new_target);
+        if (new_target > target) {
+            autoscale_stats_.scale_ups++;
+            {
+                std::lock_guard<std::mutex> cv_lock(autoscale_mutex_);
+            }
+            autoscale_cv_.notify_all();
+        } else {
+            autoscale_stats_.scale_downs++;
+        }
+        if (monitor_) {
+            monitor_->recordMetric(new_target > target ? "autoscale_up" : "autoscale_down");
+        }
+        autoscale_stats_.last_decision = std::string(new_target > target ? "up: " : "down: ") + reason;
+        LOG_INFO_FMT("[VideoProductionLine] Autoscale %d -> %d threads (%s; occupancy=%.2f, fill=%.2f ms, wait=%.2f ms, fps=%.1f)",
+                     target, new_target, reason, occupancy, fill_ms, wait_ms, fps);
+    } else {
+        autoscale_stats_.last_decision = std::string("hold: ") + reason;
+    }
+    autoscale_stats_.active_threads = new_target;
+}
+
+void VideoProductionLine::onOutputFinished() {
+    output_done_.store(true);
+    if (active_consumers_.load() == 0) {
+        // 没有消费者，设置 running_ 为 false
+        running_.store(false);
+        LOG_INFO("All producer threads finished naturally, production line stopped");
+    } else {
+        // 有消费者时，由最后一个消费者排空队列后设置 running_
+        LOG_INFO("Production finished, waiting for consumers to drain");
+    }
+}
+
+void VideoProductionLine::consumerThreadFunc(int thread_id) {
+    t_in_consumer_thread = true;
+    
+    auto pool_sptr = output_buffer_pool_weak_.lock();
+    if (!pool_sptr) {
+        LOG_ERROR_FMT("Consumer #%d: BufferPool not found or destroyed", thread_id);
+    } else {
+        // 与生产者使用同一放置策略（线程ID排在生产者之后，不记录到 thread_cpus_）
+        applyThreadPlacement(thread_count_ + thread_id);
+        
+        LOG_INFO_FMT("[VideoProductionLine] Consumer #%d: Starting (batch=%d)", thread_id, consumer_batch_size_);
+        
+        int thread_consumed = 0;
+        std::vector<Buffer*> batch;
+        batch.reserve(consumer_batch_size_);
+        
+        while (true) {
+            Buffer* first = pool_sptr->acquireFilled(true, kConsumerWaitMs);
+            if (first == nullptr) {
+                if (!output_done_.load()) {
+                    continue;
+                }
+                // 生产者和所有阶段已全部退出：再非阻塞取一次，覆盖超时与最后一次 submit 之间的竞争
+                // （队列为空或 Pool 已停止时返回 nullptr，排空完成）
+                first = pool_sptr->acquireFilled(false, 0);
+                if (first == nullptr) {
+                    break;
+                }
+            }
+            
+            // 非阻塞凑满一批，减少每帧一次的阻塞唤醒
+            batch.clear();
+            batch.push_back(first);
+            while (static_cast<int>(batch.size()) < consumer_batch_size_) {
+                Buffer* next = pool_sptr->acquireFilled(false, 0);
+                if (next == nullptr) {
+                    break;
+                }
+                batch.push_back(next);
+            }
+            
+            for (Buffer* buffer : batch) {
+                dispatchFrame(pool_sptr.get(), buffer);
+            }
+            thread_consumed += static_cast<int>(batch.size());
+        }
+        
+        LOG_INFO_FMT("Consumer #%d finished: consumed=%d", thread_id, thread_consumed);
+    }
+    
+    int remaining = active_consumers_.fetch_sub(1) - 1;
+    if (remaining == 0) {
+        running_.store(false);
+        LOG_INFO("All consumer threads drained, production line stopped");
+    }
+}
+
+void VideoProductionLine::dispatchFrame(BufferPool* pool, Buffer* buffer) {
+    if (monitor_) {
+        monitor_->beginTiming("consume_frame");
+    }
+    
+    for (auto& sink : frame_sinks_) {
+        try {
+            sink(buffer);
+        } catch (...) {
+            LOG_WARN("Exception in frame sink");
+        }
+    }
+    
+    consumed_frames_.fetch_add(1);
+    if (monitor_) {
+        monitor_->endTiming("consume_frame");
+    }
+    
+    // 共享内存输出：回调之后提交给分析进程（未注册回调时总是提交），由归还线程放回工作 Pool
+    if (shared_output_pool_id_ != 0 && (auto_release_ || frame_sinks_.empty())) {
+        publishSharedFrame(buffer);
+    } else if (auto_release_) {
+        pool->releaseFilled(buffer);
+    }
+}
+
+void VideoProductionLine::setError(const std::string& error_msg) {
+    // 保存错误消息
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = error_msg;
+    }
+    
+    // 调用用户回调
+    if (error_callback_) {
+        try {
+            error_callback_(error_msg);
+        } catch (...) {
+            LOG_WARN("Exception in error callback");
+        }
+    }
+    
+    // 打印到控制台
+    LOG_ERROR_FMT("VideoProductionLine Error: %s", error_msg.c_str());
+}
+
+void VideoProductionLine::resolvePlacement(const WorkerConfig::PlacementConfig& placement) {
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("components"));
+    
+    numa_node_ = placement.numa_node;
+    producer_cpus_ = placement.cpu_affinity;
+    pin_per_thread_ = placement.pin_per_thread;
+    
+    if (!placement.isEnabled()) {
+        return;
+    }
+    
+    if (numa_node_ >= NumaPlacement::getNodeCount()) {
+        LOG4CPLUS_WARN(logger, log_prefix_ << " NUMA node " << numa_node_ 
+                       << " does not exist, ignoring memory placement");
+        numa_node_ = -1;
+    }
+    
+    if (producer_cpus_.empty() && numa_node_ >= 0) {
+        producer_cpus_ = NumaPlacement::getCpusOfNode(numa_node_);
+    } else if (!producer_cpus_.empty() && numa_node_ < 0) {
+        numa_node_ = NumaPlacement::getNodeOfCpu(producer_cpus_.front());
+    }
+    
+    if (numa_node_ >= 0 && !NumaPlacement::isAvailable()) {
+        LOG4CPLUS_WARN(logger, log_prefix_ << " NUMA memory policy not supported, only CPU affinity will be applied");
+    }
+    
+    LOG4CPLUS_INFO(logger, log_prefix_ << "   - 放置: node=" << numa_node_ 
+                   << ", cpus=" << NumaPlacement::formatCpuList(producer_cpus_)
+                   << (pin_per_thread_ ? " (pin per thread)" : ""));
+}
+
+void VideoProductionLine::applyThreadPlacement(int thread_id) {
+    if (!producer_cpus_.empty()) {
+        bool bound = false;
+        if (pin_per_thread_) {
+            int cpu = producer_cpus_[thread_id % producer_cpus_.size()];
+            bound = NumaPlacement::bindCurrentThreadToCpus({cpu});
+        } else {
+            bound = NumaPlacement::bindCurrentThreadToCpus(producer_cpus_);
+        }
+        if (!bound) {
+            LOG_WARN_FMT("[VideoProductionLine] Thread #%d: Failed to set CPU affinity", thread_id);
+        }
+    }
+    
+    // 线程内后续分配（如解码器内部缓冲）优先落在本节点
+    if (numa_node_ >= 0) {
+        NumaPlacement::setCurrentThreadPreferredNode(numa_node_);
+    }
+    
+    std::lock_guard<std::mutex> lock(placement_mutex_);
+    if (thread_id >= 0 && thread_id < static_cast<int>(thread_cpus_.size())) {
+        thread_cpus_[thread_id] = NumaPlacement::getCurrentCpu();
+    }
+}
@@ -17,6 +17,8 @@ std::atomic<uint64_t> BufferWriter::next_id_{0};
 
 BufferWriter::BufferWriter()
     : file_(nullptr)
+    , indexed_writer_uptr_()
+    , frame_scratch_()
     , format_(AV_PIX_FMT_NONE)
     , width_(0)
     , height_(0)
@@ -53,35 +55,17 @@ bool BufferWriter::open(const char* path,
                         AVPixelFormat format,
                         int width, 
                         int height) {
-    // 1. 参数校验
-    if (!path) {
-        LOG_ERROR("[BufferWriter] Error: Invalid path (nullptr)");
-        return false;
-    }
-    
-    if (width <= 0 || height <= 0) {
-        LOG_ERROR_FMT("[BufferWriter] Error: Invalid dimensions (%dx%d)", 
-                width, height);
-        return false;
-    }
-    
-    // 2. 检查格式支持
-    if (!isSupportedFormat(format)) {
-        LOG_ERROR_FMT("[BufferWriter] Error: Unsupported format: %s (%d)",
-                av_get_pix_fmt_name(format), format);
-        LOG_ERROR("[BufferWriter] Supported formats (18): "
-                "GRAY8, GRAY10LE, NV12, P010LE, NV21, YUV420P10LE, "
-                "RGB24, BGR24, ARGB, ABGR, RGBA, BGRA, "
-                "RGB0, BGR0, 0RGB, 0BGR, RGB48LE, BGR48LE");
+    // 1. 参数校验（路径、尺寸、格式支持）
+    if (!checkOpenParams(path, format, width, height)) {
         return false;
     }
     
-    // 3. 如果已打开，先关闭
-    if (file_) {
+    // 2. 如果已打开，先关闭
+    if (isOpen()) {
         close();
     }
     
-    // 4. 打开文件（二进制写入模式）
+    // 3. 打开文件（二进制写入模式）
     file_ = fopen(path, "wb");
     if (!file_) {
         LOG_ERROR_FMT("[BufferWriter] Error: Failed to open file: %s "
@@ -89,13 +73,13 @@ bool BufferWriter::open(const char* path,
         return false;
     }
     
-    // 5. 保存配置
+    // 4. 保存配置
     format_ = format;
     width_ = width;
     height_ = height;
     write_count_.store(0);  // 重置计数器
     
-    // 6. 打印成功信息
+    // 5. 打印成功信息
     LOG_INFO_FMT("[BufferWriter] Opened: %s", path);
     LOG_INFO_FMT("  Format: %s", getFormatName(format_));
     LOG_INFO_FMT("  Resolution: %dx%d", width_, height_);
@@ -104,21 +88,84 @@ bool BufferWriter::open(const char* path,
     return true;
 }
 
+bool BufferWriter::openIndexed(const char* path,
+                               AVPixelFormat format,
+                               int width,
+                               int height,
+                               double frame_rate) {
+    if (!checkOpenParams(path, format, width, height)) {
+        return false;
+    }
+    
+    if (isOpen()) {
+        close();
+    }
+    
+    // 文件头记录与 writePlane 输出一致的紧凑 plane 布局
+    RawFrameFileInfo info;
+    info.width = width;
+    info.height = height;
+    info.pixel_format = format;
+    info.frame_rate = frame_rate;
+    info.frame_alignment = RawFrameFile::kDataAlignment;
+    if (!RawFrameFile::setImageLayout(&info) || info.frame_size != calculateFrameSize(format, width, height)) {
+        LOG_ERROR_FMT("[BufferWriter] Error: Cannot describe %s %dx%d as RawFrameFile (odd dimensions?)",
+                getFormatName(format), width, height);
+        return false;
+    }
+    
+    auto writer = std::make_unique<RawFrameFileWriter>();
+    if (!writer->open(path, info)) {
+        return false;
+    }
+    indexed_writer_uptr_ = std::move(writer);
+    frame_scratch_.reserve(info.frame_size);
+    
+    format_ = format;
+    width_ = width;
+    height_ = height;
+    write_count_.store(0);
+    
+    LOG_INFO_FMT("[BufferWriter] Opened (RawFrameFile): %s", path);
+    LOG_INFO_FMT("  Format: %s", getFormatName(format_));
+    LOG_INFO_FMT("  Resolution: %dx%d", width_, height_);
+    LOG_INFO_FMT("  Frame size: %zu bytes, %d planes", info.frame_size, info.plane_count);
+    
+    return true;
+}
+
 bool BufferWriter::write(const Buffer* buffer) {
     // 1. 参数校验
-    if (!buffer || !file_) {
+    if (!buffer || !isOpen()) {
         LOG_ERROR("[BufferWriter] Error: Invalid buffer or file not opened");
         return false;
     }
     
+    // RawFrameFile 模式：先拼出完整一帧，再整帧追加（帧对齐和索引由 RawFrameFileWriter 处理）
+    frame_scratch_.clear();
+    
     // 2. ⭐ 检查Buffer是否有图像元数据
-    if (buffer->hasImageMetadata()) {
-        // 使用元数据模式（v2.6新功能）
-        return writeWithMetadata(buffer);
-    } else {
-        // 回退到简单模式（兼容旧代码）
-        return writeSimple(buffer);
+    bool ok = buffer->hasImageMetadata()
+        ? writeWithMetadata(buffer)   // 使用元数据模式（v2.6新功能）
+        : writeSimple(buffer);        // 回退到简单模式（兼容旧代码）
+    if (!ok) {
+        return false;
     }
+    
+    if (indexed_writer_uptr_) {
+        if (frame_scratch_.size() != calculateFrameSize(format_, width_, height_)) {
+            LOG_ERROR_FMT("[BufferWriter] Error: Frame size mismatch (%zu bytes)", frame_scratch_.size());
+            return false;
+        }
+        if (!indexed_writer_uptr_->writeFrame(frame_scratch_.data())) {
+            indexed_writer_uptr_.reset();   // 临时文件已删除
+            return false;
+        }
+    }
+    
+    // 3. 累加计数器
+    write_count_.fetch_add(1);
+    return true;
 }
 
 bool BufferWriter::writeSimple(const Buffer* buffer) {
@@ -152,16 +199,13 @@ bool BufferWriter::writeSimple(const Buffer* buffer) {
         return false;
     }
     
-    size_t written = fwrite(data, 1, expected_size, file_);
-    if (written != expected_size) {
+    if (!emit(data, expected_size)) {
         LOG_ERROR("[BufferWriter] Error: Write failed");
         LOG_ERROR_FMT("  Expected to write: %zu bytes", expected_size);
-        LOG_ERROR_FMT("  Actually wrote: %zu bytes", written);
         LOG_ERROR_FMT("  errno=%d: %s", errno, strerror(errno));
         return false;
     }
     
-    write_count_.fetch_add(1);
     return true;
 }
 
@@ -307,8 +351,6 @@ bool BufferWriter::writeWithMetadata(const Buffer* buffer) {
             return false;
     }
     
-    // 5. 累加计数器
-    write_count_.fetch_add(1);
     return true;
 }
 
@@ -321,13 +363,11 @@ bool BufferWriter::writePlane(const uint8_t* data, int stride,
     
     if (stride == width) {
         // 无padding，直接写入
-        size_t written = fwrite(data, 1, width * height, file_);
-        return (written == (size_t)(width * height));
+        return emit(data, (size_t)width * height);
     } else {
         // 有padding，逐行写入（去除padding）
         for (int y = 0; y < height; y++) {
-            size_t written = fwrite(data + y * stride, 1, width, file_);
-            if (written != (size_t)width) {
+            if (!emit(data + y * stride, width)) {
                 LOG_ERROR_FMT("[BufferWriter] Error: Write plane failed at row %d", y);
                 return false;
             }
@@ -336,6 +376,15 @@ bool BufferWriter::writePlane(const uint8_t* data, int stride,
     }
 }
 
+bool BufferWriter::emit(const void* data, size_t size) {
+    if (indexed_writer_uptr_) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        frame_scratch_.insert(frame_scratch_.end(), bytes, bytes + size);
+        return true;
+    }
+    return fwrite(data, 1, size, file_) == size;
+}
+
 void BufferWriter::close() {
     if (file_) {
         fflush(file_);
@@ -345,10 +394,46 @@ void BufferWriter::close() {
         LOG_INFO_FMT("[BufferWriter] Closed (written %d frames)", 
                write_count_.load());
     }
+    
+    if (indexed_writer_uptr_) {
+        // 写入索引和文件头，rename 到最终路径（没有帧时删除临时文件）
+        indexed_writer_uptr_->finish();
+        indexed_writer_uptr_.reset();
+        frame_scratch_.clear();
+        frame_scratch_.shrink_to_fit();
+        
+        LOG_INFO_FMT("[BufferWriter] Closed RawFrameFile (written %d frames)", 
+               write_count_.load());
+    }
 }
 
 // ========== 内部辅助方法实现 ==========
 
+bool BufferWriter::checkOpenParams(const char* path, AVPixelFormat format, int width, int height) {
+    if (!path) {
+        LOG_ERROR("[BufferWriter] Error: Invalid path (nullptr)");
+        return false;
+    }
+    
+    if (width <= 0 || height <= 0) {
+        LOG_ERROR_FMT("[BufferWriter] Error: Invalid dimensions (%dx%d)", 
+                width, height);
+        return false;
+    }
+    
+    if (!isSupportedFormat(format)) {
+        LOG_ERROR_FMT("[BufferWriter] Error: Unsupported format: %s (%d)",
+                av_get_pix_fmt_name(format), format);
+        LOG_ERROR("[BufferWriter] Supported formats (18): "
+                "GRAY8, GRAY10LE, NV12, P010LE, NV21, YUV420P10LE, "
+                "RGB24, BGR24, ARGB, ABGR, RGBA, BGRA, "
+                "RGB0, BGR0, 0RGB, 0BGR, RGB48LE, BGR48LE");
+        return false;
+    }
+    
+    return true;
+}
+
 bool BufferWriter::isSupportedFormat(AVPixelFormat format) {
     switch (format) {
         // ========== YUV格式（6种）==========
@@ -0,0 +1,391 @@
+#include "productionline/io/FileAVIOContext.hpp"
+#include "common/Logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavutil/error.h>
+#include <libavutil/mem.h>
+}
+
+namespace productionline {
+namespace io {
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+constexpr int kMinDepth = 2;
+constexpr int kMaxDepth = 64;
+
+} // namespace
+
+FileAVIOContext::FileAVIOContext()
+    : fd_(-1)
+    , path_()
+    , mode_(Mode::MMAP)
+    , file_size_(0)
+    , pos_(0)
+    , avio_ctx_ptr_(nullptr)
+    , map_ptr_(nullptr)
+    , window_bytes_(0)
+    , advised_begin_(0)
+    , advised_end_(0)
+    , ring_()
+    , ring_ready_(false)
+    , block_size_(0)
+    , queued_(0)
+    , in_flight_(0)
+    , read_callbacks_(0)
+    , syscalls_(0)
+{
+}
+
+FileAVIOContext::~FileAVIOContext() {
+    close();
+}
+
+bool FileAVIOContext::open(const char* path, Mode mode, size_t window_bytes, int depth) {
+    close();
+    if (!path) {
+        return false;
+    }
+
+    fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        LOG_ERROR_FMT("[FileAVIOContext] Failed to open '%s': %s", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        LOG_ERROR_FMT("[FileAVIOContext] '%s' is not a non-empty regular file", path);
+        close();
+        return false;
+    }
+
+    path_ = path;
+    mode_ = mode;
+    file_size_ = static_cast<uint64_t>(st.st_size);
+    pos_ = 0;
+    read_callbacks_ = 0;
+    syscalls_ = 0;
+
+    bool backend_ok = mode == Mode::MMAP ? openMapped() : openRing(window_bytes, depth);
+    if (!backend_ok) {
+        close();
+        return false;
+    }
+    window_bytes_ = window_bytes;
+
+    // AVIO 缓冲区必须用 av_malloc 分配（FFmpeg 可能在内部重新分配）
+    unsigned char* avio_buffer = static_cast<unsigned char*>(av_malloc(kAvioBufferSize));
+    if (!avio_buffer) {
+        close();
+        return false;
+    }
+    avio_ctx_ptr_ = avio_alloc_context(avio_buffer, static_cast<int>(kAvioBufferSize), 0, this,
+                                       &FileAVIOContext::readPacket, nullptr,
+                                       &FileAVIOContext::seekPacket);
+    if (!avio_ctx_ptr_) {
+        av_free(avio_buffer);
+        close();
+        return false;
+    }
+
+    LOG_DEBUG_FMT("[FileAVIOContext] Opened '%s' (%llu bytes, %s, window %zu bytes)",
+                  path, static_cast<unsigned long long>(file_size_),
+                  mode == Mode::MMAP ? "mmap" : "io_uring",
+                  mode == Mode::MMAP ? window_bytes_ : block_size_ * blocks_.size());
+    return true;
+}
+
+bool FileAVIOContext::openMapped() {
+    void* addr = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR_FMT("[FileAVIOContext] mmap failed: %s", strerror(errno));
+        return false;
+    }
+    map_ptr_ = static_cast<const uint8_t*>(addr);
+    madvise(addr, file_size_, MADV_SEQUENTIAL);
+    advised_begin_ = 0;
+    advised_end_ = 0;
+    return true;
+}
+
+bool FileAVIOContext::openRing(size_t window_bytes, int depth) {
+    depth = std::max(kMinDepth, std::min(depth, kMaxDepth));
+    block_size_ = std::max(kMinBlockSize, window_bytes / static_cast<size_t>(depth));
+    block_size_ = (block_size_ + kPageSize - 1) / kPageSize * kPageSize;
+
+    int ret = io_uring_queue_init(static_cast<unsigned>(depth), &ring_, 0);
+    if (ret < 0) {
+        LOG_ERROR_FMT("[FileAVIOContext] io_uring_queue_init failed: %s", strerror(-ret));
+        return false;
+    }
+    ring_ready_ = true;
+
+    block_memory_.resize(block_size_ * static_cast<size_t>(depth));
+    blocks_.assign(static_cast<size_t>(depth), Block());
+    for (int i = 0; i < depth; ++i) {
+        blocks_[i].data = block_memory_.data() + block_size_ * static_cast<size_t>(i);
+    }
+    queued_ = 0;
+    in_flight_ = 0;
+    return true;
+}
+
+void FileAVIOContext::close() {
+    if (avio_ctx_ptr_) {
+        av_freep(&avio_ctx_ptr_->buffer);
+        avio_context_free(&avio_ctx_ptr_);
+        avio_ctx_ptr_ = nullptr;
+    }
+
+    if (ring_ready_) {
+        // 内核仍可能写入块缓冲区：先提交并等待所有在途读取
+        submitQueued();
+        while (in_flight_ > 0 && reapOne()) {
+        }
+        io_uring_queue_exit(&ring_);
+        ring_ready_ = false;
+    }
+    blocks_.clear();
+    block_memory_.clear();
+    block_memory_.shrink_to_fit();
+    queued_ = 0;
+    in_flight_ = 0;
+
+    if (map_ptr_) {
+        munmap(const_cast<uint8_t*>(map_ptr_), file_size_);
+        map_ptr_ = nullptr;
+    }
+
+    if (fd_ >= 0) {
+        LOG_DEBUG_FMT("[FileAVIOContext] Closed '%s': %llu read callbacks, %llu I/O syscalls",
+                      path_.c_str(), static_cast<unsigned long long>(read_callbacks_),
+                      static_cast<unsigned long long>(syscalls_));
+        ::close(fd_);
+        fd_ = -1;
+    }
+    file_size_ = 0;
+    pos_ = 0;
+}
+
+// ============================================================================
+// AVIO 回调
+// ============================================================================
+
+int FileAVIOContext::readPacket(void* opaque, uint8_t* buf, int size) {
+    FileAVIOContext* self = static_cast<FileAVIOContext*>(opaque);
+    ++self->read_callbacks_;
+    if (size <= 0) {
+        return 0;
+    }
+    if (self->pos_ >= self->file_size_) {
+        return AVERROR_EOF;
+    }
+    return self->mode_ == Mode::MMAP ? self->readMapped(buf, size) : self->readRing(buf, size);
+}
+
+int64_t FileAVIOContext::seekPacket(void* opaque, int64_t offset, int whence) {
+    return static_cast<FileAVIOContext*>(opaque)->seek(offset, whence);
+}
+
+int64_t FileAVIOContext::seek(int64_t offset, int whence) {
+    if (whence & AVSEEK_SIZE) {
+        return static_cast<int64_t>(file_size_);
+    }
+
+    int64_t target;
+    switch (whence & ~AVSEEK_FORCE) {
+        case SEEK_SET:
+            target = offset;
+            break;
+        case SEEK_CUR:
+            target = static_cast<int64_t>(pos_) + offset;
+            break;
+        case SEEK_END:
+            target = static_cast<int64_t>(file_size_) + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+    }
+    if (target < 0) {
+        return AVERROR(EINVAL);
+    }
+    // 只移动读位置：IO_URING 模式下窗口外的块在下一次 read 时按需提交
+    pos_ = static_cast<uint64_t>(target);
+    return target;
+}
+
+// ============================================================================
+// MMAP 后端
+// ============================================================================
+
+int FileAVIOContext::readMapped(uint8_t* buf, int size) {
+    size_t n = static_cast<size_t>(std::min<uint64_t>(static_cast<uint64_t>(size), file_size_ - pos_));
+
+    // 读位置越过窗口一半（或 seek 到窗口外）时预读下一个窗口
+    if (window_bytes_ > 0 &&
+        (pos_ < advised_begin_ ||
+         (advised_end_ < file_size_ && pos_ + n + window_bytes_ / 2 > advised_end_))) {
+        uint64_t begin = pos_ / kPageSize * kPageSize;
+        uint64_t length = std::min<uint64_t>(window_bytes_, file_size_ - begin);
+        madvise(const_cast<uint8_t*>(map_ptr_) + begin, length, MADV_WILLNEED);
+        ++syscalls_;
+        advised_begin_ = begin;
+        advised_end_ = begin + length;
+    }
+
+    memcpy(buf, map_ptr_ + pos_, n);
+    pos_ += n;
+    return static_cast<int>(n);
+}
+
+// ============================================================================
+// IO_URING 后端
+// ============================================================================
+
+int FileAVIOContext::readRing(uint8_t* buf, int size) {
+    uint64_t index = pos_ / block_size_;
+    Block& block = slotFor(index);
+
+    if (block.valid && block.index == index && !block.pending && block.error != 0) {
+        // 上次读取失败：作废该块，下一次 read 重新提交
+        int error = block.error;
+        block.valid = false;
+        return AVERROR(error);
+    }
+    if (!block.valid || block.index != index) {
+        // 首次读取或 seek 到窗口外：槽位上的旧读取完成后才能复用缓冲区
+        if (!waitBlock(&block)) {
+            return AVERROR(EIO);
+        }
+        if (!queueBlock(index)) {
+            return AVERROR(EIO);
+        }
+    }
+
+    // 保持后续 depth-1 个块在途（槽位仍有旧读取时跳过，下一次 read 再补）
+    uint64_t block_count = (file_size_ + block_size_ - 1) / block_size_;
+    for (size_t ahead = 1; ahead < blocks_.size() && index + ahead < block_count; ++ahead) {
+        Block& next = slotFor(index + ahead);
+        if (next.pending || (next.valid && next.index == index + ahead && next.error == 0)) {
+            continue;
+        }
+        queueBlock(index + ahead);
+    }
+    if (!submitQueued()) {
+        return AVERROR(EIO);
+    }
+
+    if (!waitBlock(&block)) {
+        return AVERROR(EIO);
+    }
+    if (block.error != 0) {
+        int error = block.error;
+        block.valid = false;
+        return AVERROR(error);
+    }
+
+    size_t in_block = static_cast<size_t>(pos_ - index * block_size_);
+    size_t n = std::min(static_cast<size_t>(size), block.length - in_block);
+    memcpy(buf, block.data + in_block, n);
+    pos_ += n;
+    return static_cast<int>(n);
+}
+
+bool FileAVIOContext::queueBlock(uint64_t index) {
+    Block& block = slotFor(index);
+    block.index = index;
+    block.length = static_cast<size_t>(std::min<uint64_t>(block_size_, file_size_ - index * block_size_));
+    block.filled = 0;
+    block.valid = true;
+    block.error = 0;
+    return queueRead(&block);
+}
+
+bool FileAVIOContext::queueRead(Block* block) {
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+    if (!sqe) {
+        // SQ 已满（不应发生：SQ 深度 = 块数）
+        block->valid = false;
+        return false;
+    }
+    io_uring_prep_read(sqe, fd_, block->data + block->filled,
+                       static_cast<unsigned>(block->length - block->filled),
+                       block->index * block_size_ + block->filled);
+    io_uring_sqe_set_data(sqe, block);
+    block->pending = true;
+    ++queued_;
+    return true;
+}
+
+bool FileAVIOContext::submitQueued() {
+    if (queued_ == 0) {
+        return true;
+    }
+    int ret = io_uring_submit(&ring_);
+    ++syscalls_;
+    if (ret < 0) {
+        LOG_ERROR_FMT("[FileAVIOContext] io_uring_submit failed: %s", strerror(-ret));
+        return false;
+    }
+    in_flight_ += queued_;
+    queued_ = 0;
+    return true;
+}
+
+bool FileAVIOContext::reapOne() {
+    if (!submitQueued()) {
+        return false;
+    }
+    struct io_uring_cqe* cqe = nullptr;
+    int ret = io_uring_wait_cqe(&ring_, &cqe);
+    ++syscalls_;
+    if (ret < 0) {
+        LOG_ERROR_FMT("[FileAVIOContext] io_uring_wait_cqe failed: %s", strerror(-ret));
+        return false;
+    }
+
+    Block* block = static_cast<Block*>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(&ring_, cqe);
+    --in_flight_;
+    block->pending = false;
+
+    if (res == -EINTR || res == -EAGAIN) {
+        return queueRead(block);
+    }
+    if (res < 0) {
+        block->error = -res;
+        return true;
+    }
+    if (res == 0) {
+        block->error = EIO;      // 文件在读取期间被截断
+        return true;
+    }
+    block->filled += static_cast<size_t>(res);
+    if (block->filled < block->length) {
+        return queueRead(block);  // 短读：继续读剩余部分
+    }
+    return true;
+}
+
+bool FileAVIOContext::waitBlock(Block* block) {
+    while (block->pending) {
+        if (!reapOne()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace io
+} // namespace productionline
@@ -0,0 +1,151 @@
+#include "productionline/io/FrameCrop.hpp"
+#include "common/FrameCopy.hpp"
+#include "common/Logger.hpp"
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace productionline {
+namespace io {
+
+FrameCrop::FrameCrop()
+    : enabled_(false)
+    , layout_()
+    , planes_()
+    , plane_count_(0)
+{
+}
+
+void FrameCrop::reset() {
+    enabled_ = false;
+    layout_ = RawFrameFileInfo();
+    for (auto& plane : planes_) {
+        plane = Plane();
+    }
+    plane_count_ = 0;
+}
+
+bool FrameCrop::configure(const RawFrameFileInfo& source, int x, int y, int width, int height) {
+    reset();
+    if (source.width <= 0 || source.height <= 0 || width <= 0 || height <= 0 ||
+        x < 0 || y < 0 || x >= source.width || y >= source.height) {
+        LOG_ERROR_FMT("[FrameCrop] ROI %d,%d %dx%d is outside the %dx%d frame",
+                      x, y, width, height, source.width, source.height);
+        return false;
+    }
+
+    // 像素格式未知：单个 packed plane
+    if (source.plane_count == 0) {
+        if (source.bits_per_pixel <= 0 || source.bits_per_pixel % 8 != 0) {
+            LOG_ERROR_FMT("[FrameCrop] Cannot crop %d-bit packed frames without a pixel format",
+                          source.bits_per_pixel);
+            return false;
+        }
+        size_t bytes_per_pixel = static_cast<size_t>(source.bits_per_pixel / 8);
+        width = std::min(width, source.width - x);
+        height = std::min(height, source.height - y);
+
+        Plane& plane = planes_[0];
+        plane.src_stride = bytes_per_pixel * source.width;
+        plane.x_bytes = bytes_per_pixel * x;
+        plane.y = y;
+        plane.src_offset = plane.src_stride * y + plane.x_bytes;
+        plane.dst_offset = 0;
+        plane.row_bytes = bytes_per_pixel * width;
+        plane.rows = height;
+        plane_count_ = 1;
+
+        layout_.width = width;
+        layout_.height = height;
+        layout_.bits_per_pixel = source.bits_per_pixel;
+        layout_.frame_size = plane.row_bytes * height;
+        enabled_ = true;
+        return true;
+    }
+
+    AVPixelFormat format = static_cast<AVPixelFormat>(source.pixel_format);
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+    if (!desc || (desc->flags & AV_PIX_FMT_FLAG_BITSTREAM)) {
+        LOG_ERROR_FMT("[FrameCrop] Pixel format %d cannot be cropped on byte boundaries", source.pixel_format);
+        return false;
+    }
+
+    // 左上角对齐到色度采样边界，否则色度 plane 的列 / 行偏移不是整数
+    int aligned_x = x & ~((1 << desc->log2_chroma_w) - 1);
+    int aligned_y = y & ~((1 << desc->log2_chroma_h) - 1);
+    if (aligned_x != x || aligned_y != y) {
+        LOG_WARN_FMT("[FrameCrop] ROI origin %d,%d aligned to %d,%d for %s chroma subsampling",
+                     x, y, aligned_x, aligned_y, desc->name);
+    }
+    x = aligned_x;
+    y = aligned_y;
+    width = std::min(width, source.width - x);
+    height = std::min(height, source.height - y);
+
+    layout_.width = width;
+    layout_.height = height;
+    layout_.pixel_format = source.pixel_format;
+    if (!RawFrameFile::setImageLayout(&layout_)) {
+        LOG_ERROR_FMT("[FrameCrop] Unsupported pixel format %d", source.pixel_format);
+        reset();
+        return false;
+    }
+    if (layout_.plane_count != source.plane_count) {
+        LOG_ERROR_FMT("[FrameCrop] Plane layout mismatch (%d vs %d planes)", layout_.plane_count, source.plane_count);
+        reset();
+        return false;
+    }
+
+    // 宽度为 x 的一行在各 plane 中的字节数 = ROI 在该 plane 中的列偏移
+    int x_linesize[4] = {0, 0, 0, 0};
+    if (x > 0 && av_image_fill_linesizes(x_linesize, format, x) < 0) {
+        reset();
+        return false;
+    }
+
+    for (int i = 0; i < layout_.plane_count; ++i) {
+        bool chroma = i == 1 || i == 2;
+        Plane& plane = planes_[i];
+        plane.src_stride = static_cast<size_t>(source.linesize[i]);
+        plane.x_bytes = static_cast<size_t>(x_linesize[i]);
+        plane.y = chroma ? (y >> desc->log2_chroma_h) : y;
+        plane.src_offset = source.plane_offset[i] + plane.src_stride * plane.y + plane.x_bytes;
+        plane.dst_offset = layout_.plane_offset[i];
+        plane.row_bytes = static_cast<size_t>(layout_.linesize[i]);
+        plane.rows = chroma ? AV_CEIL_RSHIFT(height, desc->log2_chroma_h) : height;
+        if (plane.x_bytes + plane.row_bytes > plane.src_stride) {
+            LOG_ERROR_FMT("[FrameCrop] ROI exceeds plane %d row (%zu + %zu > %zu)",
+                          i, plane.x_bytes, plane.row_bytes, plane.src_stride);
+            reset();
+            return false;
+        }
+    }
+    plane_count_ = layout_.plane_count;
+    enabled_ = true;
+    return true;
+}
+
+void FrameCrop::copy(const uint8_t* frame, uint8_t* dst) const {
+    for (int i = 0; i < plane_count_; ++i) {
+        const Plane& plane = planes_[i];
+        FrameCopy::getInstance().copyRows(dst + plane.dst_offset, plane.row_bytes,
+                                          frame + plane.src_offset, plane.src_stride,
+                                          plane.row_bytes, plane.rows);
+    }
+}
+
+void FrameCrop::copy(const uint8_t* const src_planes[4], const int src_linesize[4], uint8_t* dst) const {
+    for (int i = 0; i < plane_count_; ++i) {
+        const Plane& plane = planes_[i];
+        size_t stride = static_cast<size_t>(src_linesize[i]);
+        FrameCopy::getInstance().copyRows(dst + plane.dst_offset, plane.row_bytes,
+                                          src_planes[i] + stride * plane.y + plane.x_bytes, stride,
+                                          plane.row_bytes, plane.rows);
+    }
+}
+
+} // namespace io
+} // namespace productionline
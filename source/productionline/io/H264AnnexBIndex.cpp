@@ -0,0 +1,148 @@
+#include "productionline/io/H264AnnexBIndex.hpp"
+#include "common/Logger.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace productionline {
+namespace io {
+
+namespace {
+
+// H.264 NAL 单元类型（Table 7-1）
+constexpr int kNalSlice = 1;
+constexpr int kNalIdrSlice = 5;
+constexpr int kNalSei = 6;
+constexpr int kNalSps = 7;
+constexpr int kNalPps = 8;
+constexpr int kNalAud = 9;
+
+bool isVcl(int type) {
+    return type == kNalSlice || type == kNalIdrSlice;
+}
+
+/**
+ * @brief 该 NAL 是否开始一个新的访问单元（前一个访问单元已有 VCL NAL 时才判断）
+ *
+ * AUD / SPS / PPS / SEI / 类型 14-18 总在访问单元的第一个 VCL NAL 之前；
+ * first_mb_in_slice == 0 的 slice 是新图像的第一个 slice（ue(v) 的 0 编码为单个 '1' 比特）。
+ */
+bool startsAccessUnit(int type, const uint8_t* payload, const uint8_t* end) {
+    if (type == kNalAud || type == kNalSps || type == kNalPps || type == kNalSei ||
+        (type >= 14 && type <= 18)) {
+        return true;
+    }
+    return isVcl(type) && payload < end && (payload[0] & 0x80) != 0;
+}
+
+} // namespace
+
+H264AnnexBIndex::H264AnnexBIndex()
+    : samples_()
+    , nal_count_(0)
+    , keyframe_count_(0)
+{
+}
+
+const uint8_t* H264AnnexBIndex::findStartCode(const uint8_t* p, const uint8_t* end) {
+    // 一次比较 16 个候选位置：byte[i] == 0 && byte[i+1] == 0 && byte[i+2] == 1
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    while (end - p >= 18) {
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+        __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2));
+        __m128i hit = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                    _mm_cmpeq_epi8(b2, one));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    const uint8x16_t one = vdupq_n_u8(1);
+    while (end - p >= 18) {
+        uint8x16_t b0 = vld1q_u8(p);
+        uint8x16_t b1 = vld1q_u8(p + 1);
+        uint8x16_t b2 = vld1q_u8(p + 2);
+        uint8x16_t hit = vandq_u8(vandq_u8(vceqzq_u8(b0), vceqzq_u8(b1)), vceqq_u8(b2, one));
+        if (vmaxvq_u8(hit) != 0) {
+            for (int i = 0; i < 16; ++i) {
+                if (p[i] == 0 && p[i + 1] == 0 && p[i + 2] == 1) {
+                    return p + i;
+                }
+            }
+        }
+        p += 16;
+    }
+#endif
+    for (; end - p >= 3; ++p) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1) {
+            return p;
+        }
+    }
+    return end;
+}
+
+bool H264AnnexBIndex::build(const uint8_t* data, size_t size) {
+    samples_.clear();
+    nal_count_ = 0;
+    keyframe_count_ = 0;
+    if (!data || size < 4) {
+        return false;
+    }
+
+    const uint8_t* end = data + size;
+    const uint8_t* sc = findStartCode(data, end);
+    uint64_t au_start = 0;
+    bool au_has_vcl = false;
+    bool au_is_key = false;
+
+    auto pushSample = [&](uint64_t au_end) {
+        CompressedSample sample;
+        sample.offset = au_start;
+        sample.size = static_cast<uint32_t>(au_end - au_start);
+        sample.keyframe = au_is_key;
+        keyframe_count_ += au_is_key ? 1 : 0;
+        samples_.push_back(sample);
+    };
+
+    while (sc < end) {
+        const uint8_t* header = sc + 3;
+        const uint8_t* next = findStartCode(header, end);
+        if (header >= end) {
+            break;
+        }
+        // 4 字节起始码（00 00 00 01）的前导 0 属于本 NAL
+        uint64_t nal_start = static_cast<uint64_t>((sc > data && sc[-1] == 0 ? sc - 1 : sc) - data);
+        int type = header[0] & 0x1F;
+        ++nal_count_;
+
+        if (au_has_vcl && startsAccessUnit(type, header + 1, next)) {
+            pushSample(nal_start);
+            au_start = nal_start;
+            au_has_vcl = false;
+            au_is_key = false;
+        }
+        if (isVcl(type)) {
+            au_has_vcl = true;
+            au_is_key = au_is_key || type == kNalIdrSlice;
+        }
+        sc = next;
+    }
+    if (au_has_vcl) {
+        pushSample(size);
+    }
+
+    LOG_DEBUG_FMT("[H264AnnexBIndex] %d NAL units, %zu access units, %d IDR",
+                  nal_count_, samples_.size(), keyframe_count_);
+    return !samples_.empty();
+}
+
+} // namespace io
+} // namespace productionline
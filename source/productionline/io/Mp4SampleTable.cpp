@@ -0,0 +1,372 @@
+#include "productionline/io/Mp4SampleTable.hpp"
+#include "common/Logger.hpp"
+#include <cstring>
+
+namespace productionline {
+namespace io {
+
+namespace {
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint64_t readU64(const uint8_t* p) {
+    return (static_cast<uint64_t>(readU32(p)) << 32) | readU32(p + 4);
+}
+
+/**
+ * @brief 顺序遍历 [p, end) 内的同级 box
+ */
+class BoxIterator {
+public:
+    BoxIterator(const uint8_t* p, const uint8_t* end) : p_(p), end_(end), type_(), body_(nullptr), body_end_(nullptr) {}
+
+    /**
+     * @return false 如果没有更多 box 或 box 头损坏
+     */
+    bool next() {
+        if (end_ - p_ < 8) {
+            return false;
+        }
+        uint64_t size = readU32(p_);
+        memcpy(type_, p_ + 4, 4);
+        type_[4] = '\0';
+        const uint8_t* body = p_ + 8;
+        if (size == 1) {                       // 64 位 largesize
+            if (end_ - p_ < 16) {
+                return false;
+            }
+            size = readU64(p_ + 8);
+            body = p_ + 16;
+        } else if (size == 0) {                // 延伸到父 box 末尾
+            size = static_cast<uint64_t>(end_ - p_);
+        }
+        if (size < static_cast<uint64_t>(body - p_) || size > static_cast<uint64_t>(end_ - p_)) {
+            return false;
+        }
+        body_ = body;
+        body_end_ = p_ + size;
+        p_ = body_end_;
+        return true;
+    }
+
+    bool is(const char* type) const { return memcmp(type_, type, 4) == 0; }
+    const char* type() const { return type_; }
+    const uint8_t* body() const { return body_; }
+    const uint8_t* bodyEnd() const { return body_end_; }
+    size_t bodySize() const { return static_cast<size_t>(body_end_ - body_); }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+    char type_[5];
+    const uint8_t* body_;
+    const uint8_t* body_end_;
+};
+
+/**
+ * @brief FullBox 的条目表（version/flags + entry_count + entries）是否完整
+ */
+bool tableFits(const BoxIterator& box, size_t header, uint32_t count, size_t entry_size) {
+    return box.bodySize() >= header && (box.bodySize() - header) / entry_size >= count;
+}
+
+} // namespace
+
+/**
+ * @brief 解析过程中收集的轨道信息（stbl 原始表）
+ */
+struct Mp4SampleTable::Track {
+    bool is_video = false;
+    uint32_t timescale = 0;
+    Codec codec = Codec::UNKNOWN;
+    std::string codec_tag;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> extradata;
+    int sample_descriptions = 0;
+
+    uint32_t constant_size = 0;            // stsz sample_size（非 0 时所有 sample 同大小）
+    uint32_t sample_count = 0;
+    const uint8_t* sizes = nullptr;        // stsz 条目（大端 u32）
+    const uint8_t* stsc = nullptr;
+    uint32_t stsc_count = 0;
+    const uint8_t* chunk_offsets = nullptr;
+    uint32_t chunk_count = 0;
+    bool chunk_offsets_64 = false;
+    const uint8_t* stss = nullptr;
+    uint32_t stss_count = 0;
+    bool has_stss = false;
+    uint64_t duration = 0;                 // stts 总时长（timescale 单位）
+};
+
+Mp4SampleTable::Mp4SampleTable()
+    : samples_()
+    , extradata_()
+    , codec_(Codec::UNKNOWN)
+    , codec_tag_()
+    , width_(0)
+    , height_(0)
+    , keyframe_count_(0)
+    , frame_rate_(0.0)
+{
+}
+
+bool Mp4SampleTable::parse(const uint8_t* data, size_t size) {
+    samples_.clear();
+    extradata_.clear();
+    codec_ = Codec::UNKNOWN;
+    keyframe_count_ = 0;
+    frame_rate_ = 0.0;
+    if (!data || size < 8) {
+        return false;
+    }
+
+    const uint8_t* end = data + size;
+    const uint8_t* moov = nullptr;
+    const uint8_t* moov_end = nullptr;
+    bool fragmented = false;
+    BoxIterator top(data, end);
+    while (top.next()) {
+        if (top.is("moov")) {
+            moov = top.body();
+            moov_end = top.bodyEnd();
+        } else if (top.is("moof")) {
+            fragmented = true;
+        }
+    }
+    if (!moov) {
+        LOG_ERROR("[Mp4SampleTable] Error: No moov box (truncated file?)");
+        return false;
+    }
+
+    // 第一条视频轨
+    BoxIterator box(moov, moov_end);
+    while (box.next()) {
+        if (box.is("mvex")) {
+            fragmented = true;
+        }
+        if (!box.is("trak")) {
+            continue;
+        }
+        Track track;
+        if (!parseTrak(box.body(), box.bodyEnd(), &track) || !track.is_video) {
+            continue;
+        }
+        if (fragmented && track.sample_count == 0) {
+            LOG_ERROR("[Mp4SampleTable] Error: Fragmented MP4 (moof) is not supported");
+            return false;
+        }
+        if (track.codec == Codec::UNKNOWN) {
+            LOG_ERROR_FMT("[Mp4SampleTable] Error: Unsupported video sample entry '%s'", track.codec_tag.c_str());
+            return false;
+        }
+        if (track.sample_descriptions != 1) {
+            LOG_ERROR_FMT("[Mp4SampleTable] Error: %d sample descriptions (only 1 supported)",
+                          track.sample_descriptions);
+            return false;
+        }
+        if (!buildSamples(track, size)) {
+            samples_.clear();
+            return false;
+        }
+
+        codec_ = track.codec;
+        codec_tag_ = track.codec_tag;
+        width_ = track.width;
+        height_ = track.height;
+        extradata_ = std::move(track.extradata);
+        if (track.timescale > 0 && track.duration > 0) {
+            frame_rate_ = static_cast<double>(samples_.size()) * track.timescale / track.duration;
+        }
+        LOG_DEBUG_FMT("[Mp4SampleTable] %s %dx%d, %zu samples, %d sync, %.3f fps",
+                      codec_tag_.c_str(), width_, height_, samples_.size(), keyframe_count_, frame_rate_);
+        return true;
+    }
+
+    LOG_ERROR("[Mp4SampleTable] Error: No video track found");
+    return false;
+}
+
+bool Mp4SampleTable::parseTrak(const uint8_t* p, const uint8_t* end, Track* track) {
+    BoxIterator trak(p, end);
+    while (trak.next()) {
+        if (!trak.is("mdia")) {
+            continue;
+        }
+        BoxIterator mdia(trak.body(), trak.bodyEnd());
+        while (mdia.next()) {
+            if (mdia.is("mdhd") && mdia.bodySize() >= 4) {
+                // version 1: creation/modification 各 8 字节
+                size_t at = mdia.body()[0] == 1 ? 4 + 16 : 4 + 8;
+                if (mdia.bodySize() >= at + 4) {
+                    track->timescale = readU32(mdia.body() + at);
+                }
+            } else if (mdia.is("hdlr") && mdia.bodySize() >= 12) {
+                track->is_video = memcmp(mdia.body() + 8, "vide", 4) == 0;
+            } else if (mdia.is("minf")) {
+                BoxIterator minf(mdia.body(), mdia.bodyEnd());
+                while (minf.next()) {
+                    if (minf.is("stbl") && !parseStbl(minf.body(), minf.bodyEnd(), track)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool Mp4SampleTable::parseStbl(const uint8_t* p, const uint8_t* end, Track* track) {
+    BoxIterator box(p, end);
+    while (box.next()) {
+        const uint8_t* body = box.body();
+        size_t body_size = box.bodySize();
+        if (box.is("stsd")) {
+            if (!parseStsd(body, box.bodyEnd(), track)) {
+                return false;
+            }
+        } else if (box.is("stsz") && body_size >= 12) {
+            track->constant_size = readU32(body + 4);
+            track->sample_count = readU32(body + 8);
+            if (track->constant_size == 0) {
+                if (!tableFits(box, 12, track->sample_count, 4)) {
+                    return false;
+                }
+                track->sizes = body + 12;
+            }
+        } else if (box.is("stsc") && body_size >= 8) {
+            track->stsc_count = readU32(body + 4);
+            if (!tableFits(box, 8, track->stsc_count, 12)) {
+                return false;
+            }
+            track->stsc = body + 8;
+        } else if ((box.is("stco") || box.is("co64")) && body_size >= 8) {
+            track->chunk_offsets_64 = box.is("co64");
+            track->chunk_count = readU32(body + 4);
+            if (!tableFits(box, 8, track->chunk_count, track->chunk_offsets_64 ? 8 : 4)) {
+                return false;
+            }
+            track->chunk_offsets = body + 8;
+        } else if (box.is("stss") && body_size >= 8) {
+            track->stss_count = readU32(body + 4);
+            if (!tableFits(box, 8, track->stss_count, 4)) {
+                return false;
+            }
+            track->stss = body + 8;
+            track->has_stss = true;
+        } else if (box.is("stts") && body_size >= 8) {
+            uint32_t count = readU32(body + 4);
+            if (!tableFits(box, 8, count, 8)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint8_t* entry = body + 8 + i * 8;
+                track->duration += static_cast<uint64_t>(readU32(entry)) * readU32(entry + 4);
+            }
+        }
+    }
+    return true;
+}
+
+bool Mp4SampleTable::parseStsd(const uint8_t* p, const uint8_t* end, Track* track) {
+    if (end - p < 8) {
+        return false;
+    }
+    track->sample_descriptions = static_cast<int>(readU32(p + 4));
+
+    // 第一个 VisualSampleEntry：8 字节 box 头 + 78 字节固定字段，之后是 avcC / hvcC 等子 box
+    BoxIterator entry(p + 8, end);
+    if (!entry.next()) {
+        return false;
+    }
+    track->codec_tag = entry.type();
+    if (entry.is("avc1") || entry.is("avc3")) {
+        track->codec = Codec::H264;
+    } else if (entry.is("hvc1") || entry.is("hev1")) {
+        track->codec = Codec::HEVC;
+    }
+    if (entry.bodySize() < 78) {
+        return false;
+    }
+    track->width = readU16(entry.body() + 24);
+    track->height = readU16(entry.body() + 26);
+
+    BoxIterator child(entry.body() + 78, entry.bodyEnd());
+    while (child.next()) {
+        if (child.is("avcC") || child.is("hvcC")) {
+            track->extradata.assign(child.body(), child.bodyEnd());
+        }
+    }
+    return true;
+}
+
+bool Mp4SampleTable::buildSamples(const Track& track, size_t file_size) {
+    if (track.sample_count == 0 || track.chunk_count == 0 || track.stsc_count == 0 ||
+        (track.constant_size == 0 && !track.sizes)) {
+        LOG_ERROR("[Mp4SampleTable] Error: Incomplete sample table (stsz/stsc/stco missing)");
+        return false;
+    }
+
+    // 固定 sample 大小时 sample 数没有表长度约束：按文件大小拒绝不可能的 sample 数，再分配
+    // （逐个给出大小时 stsz 表本身已在文件内，每个 sample 至少按 1 字节计）
+    uint64_t min_sample_size = track.constant_size ? track.constant_size : 1;
+    if (track.sample_count > file_size / min_sample_size) {
+        LOG_ERROR_FMT("[Mp4SampleTable] Error: %u samples cannot fit in %zu bytes", track.sample_count, file_size);
+        return false;
+    }
+
+    samples_.resize(track.sample_count);
+    uint32_t sample = 0;
+    for (uint32_t run = 0; run < track.stsc_count && sample < track.sample_count; ++run) {
+        const uint8_t* entry = track.stsc + run * 12;
+        uint32_t first_chunk = readU32(entry);
+        uint32_t samples_per_chunk = readU32(entry + 4);
+        // 本条目覆盖到下一条目的 first_chunk 之前（最后一条覆盖到最后一个 chunk）
+        uint32_t last_chunk = run + 1 < track.stsc_count ? readU32(entry + 12) - 1 : track.chunk_count;
+        if (first_chunk == 0 || last_chunk > track.chunk_count) {
+            LOG_ERROR("[Mp4SampleTable] Error: Invalid stsc entry");
+            return false;
+        }
+        for (uint32_t chunk = first_chunk; chunk <= last_chunk && sample < track.sample_count; ++chunk) {
+            uint64_t offset = track.chunk_offsets_64 ? readU64(track.chunk_offsets + (chunk - 1) * 8)
+                                                     : readU32(track.chunk_offsets + (chunk - 1) * 4);
+            for (uint32_t i = 0; i < samples_per_chunk && sample < track.sample_count; ++i, ++sample) {
+                uint32_t size = track.constant_size ? track.constant_size : readU32(track.sizes + sample * 4);
+                if (size > file_size || offset > file_size - size) {   // 不写成 offset + size：co64 偏移可能溢出
+                    LOG_ERROR_FMT("[Mp4SampleTable] Error: Sample %u beyond end of file", sample);
+                    return false;
+                }
+                samples_[sample].offset = offset;
+                samples_[sample].size = size;
+                samples_[sample].keyframe = !track.has_stss;   // 没有 stss 时所有 sample 都是同步 sample
+                offset += size;
+            }
+        }
+    }
+    if (sample != track.sample_count) {
+        LOG_ERROR_FMT("[Mp4SampleTable] Error: Chunks cover %u of %u samples", sample, track.sample_count);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < track.stss_count; ++i) {
+        uint32_t number = readU32(track.stss + i * 4);   // 1-based
+        if (number >= 1 && number <= track.sample_count) {
+            samples_[number - 1].keyframe = true;
+        }
+    }
+    keyframe_count_ = 0;
+    for (const CompressedSample& s : samples_) {
+        keyframe_count_ += s.keyframe ? 1 : 0;
+    }
+    return true;
+}
+
+} // namespace io
+} // namespace productionline
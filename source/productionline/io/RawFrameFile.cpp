@@ -0,0 +1,412 @@
+#include "productionline/io/RawFrameFile.hpp"
+#include "common/Logger.hpp"
+#include "common/FrameCopy.hpp"
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace productionline {
+namespace io {
+
+namespace {
+
+/**
+ * @brief 磁盘 Header（固定 256 字节，小端主机直接读写）
+ */
+struct DiskHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    int32_t width;
+    int32_t height;
+    int32_t pixel_format;
+    int32_t bits_per_pixel;
+    uint32_t frame_count;
+    uint32_t flags;                    // 保留（0）
+    uint64_t frame_size;
+    uint64_t data_offset;
+    uint64_t index_offset;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+    uint64_t source_fingerprint;
+    double frame_rate;                 // 源帧率（0=未知）
+    uint32_t plane_count;              // 0=未知布局
+    uint32_t frame_alignment;          // 帧起始偏移对齐（1 或 2 的幂）
+    int32_t linesize[4];
+    uint64_t plane_offset[4];          // 帧内偏移
+    uint8_t reserved[104];
+};
+
+static_assert(sizeof(DiskHeader) == RawFrameFile::kHeaderSize, "RawFrameFile header must be 256 bytes");
+
+bool isPowerOfTwo(uint64_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+bool preadAll(int fd, void* data, size_t size, uint64_t offset) {
+    uint8_t* dst = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = pread(fd, dst, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        dst += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// RawFrameFile
+// ============================================================================
+
+bool RawFrameFile::hasMagic(const unsigned char* header, size_t size) {
+    return header && size >= sizeof(kMagic) && memcmp(header, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool RawFrameFile::readInfo(int fd, RawFrameFileInfo* info) {
+    if (fd < 0 || !info) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        return false;
+    }
+    uint64_t file_size = static_cast<uint64_t>(st.st_size);
+
+    DiskHeader header;
+    if (file_size < kHeaderSize || !preadAll(fd, &header, sizeof(header), 0)) {
+        return false;
+    }
+    if (!hasMagic(reinterpret_cast<const unsigned char*>(header.magic), sizeof(header.magic)) ||
+        header.version != kVersion || header.header_size != kHeaderSize) {
+        return false;
+    }
+    if (header.width <= 0 || header.height <= 0 || header.frame_size == 0 || header.frame_count == 0 ||
+        header.plane_count > 4 || !isPowerOfTwo(header.frame_alignment) ||
+        header.frame_alignment > kDataAlignment) {
+        LOG_WARN_FMT("[RawFrameFile] Invalid header (%dx%d, frame_size=%lu, frames=%u, planes=%u, align=%u)",
+                     header.width, header.height, (unsigned long)header.frame_size, header.frame_count,
+                     header.plane_count, header.frame_alignment);
+        return false;
+    }
+    for (uint32_t i = 0; i < header.plane_count; ++i) {
+        if (header.linesize[i] <= 0 || header.plane_offset[i] >= header.frame_size) {
+            LOG_WARN_FMT("[RawFrameFile] Invalid layout for plane %u", i);
+            return false;
+        }
+    }
+
+    // 索引必须完整位于文件内
+    uint64_t index_bytes = static_cast<uint64_t>(header.frame_count) * sizeof(uint64_t);
+    if (header.index_offset < header.data_offset || header.index_offset + index_bytes > file_size) {
+        LOG_WARN_FMT("[RawFrameFile] Truncated index (index_offset=%lu, file_size=%lu)",
+                     (unsigned long)header.index_offset, (unsigned long)file_size);
+        return false;
+    }
+
+    std::vector<uint64_t> offsets(header.frame_count);
+    if (!preadAll(fd, offsets.data(), index_bytes, header.index_offset)) {
+        return false;
+    }
+    for (uint64_t offset : offsets) {
+        if (offset < header.data_offset || offset + header.frame_size > header.index_offset ||
+            offset % header.frame_alignment != 0) {
+            LOG_WARN_FMT("[RawFrameFile] Frame offset %lu out of range or misaligned", (unsigned long)offset);
+            return false;
+        }
+    }
+
+    info->width = header.width;
+    info->height = header.height;
+    info->pixel_format = header.pixel_format;
+    info->bits_per_pixel = header.bits_per_pixel;
+    info->frame_count = static_cast<int>(header.frame_count);
+    info->frame_size = static_cast<size_t>(header.frame_size);
+    info->frame_offsets = std::move(offsets);
+    info->source_size = header.source_size;
+    info->source_mtime_ns = header.source_mtime_ns;
+    info->source_fingerprint = header.source_fingerprint;
+    info->frame_rate = header.frame_rate;
+    info->plane_count = static_cast<int>(header.plane_count);
+    info->frame_alignment = header.frame_alignment;
+    for (int i = 0; i < 4; ++i) {
+        bool used = i < info->plane_count;
+        info->linesize[i] = used ? header.linesize[i] : 0;
+        info->plane_offset[i] = used ? static_cast<size_t>(header.plane_offset[i]) : 0;
+    }
+    return true;
+}
+
+bool RawFrameFile::readInfo(const char* path, RawFrameFileInfo* info) {
+    if (!path) {
+        return false;
+    }
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = readInfo(fd, info);
+    ::close(fd);
+    return ok;
+}
+
+bool RawFrameFile::isRawFrameFile(const char* path) {
+    if (!path) {
+        return false;
+    }
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    unsigned char magic[sizeof(kMagic)];
+    bool ok = preadAll(fd, magic, sizeof(magic), 0) && hasMagic(magic, sizeof(magic));
+    ::close(fd);
+    return ok;
+}
+
+bool RawFrameFile::setImageLayout(RawFrameFileInfo* info) {
+    if (!info || info->width <= 0 || info->height <= 0) {
+        return false;
+    }
+    AVPixelFormat format = static_cast<AVPixelFormat>(info->pixel_format);
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+    if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL))) {
+        return false;
+    }
+
+    int linesize[4] = {0, 0, 0, 0};
+    if (av_image_fill_linesizes(linesize, format, info->width) < 0) {
+        return false;
+    }
+    int plane_count = av_pix_fmt_count_planes(format);
+    if (plane_count <= 0 || plane_count > 4) {
+        return false;
+    }
+
+    // plane 1/2 是色度平面（高度按 log2_chroma_h 缩小），plane 0/3 是亮度和 alpha
+    size_t offset = 0;
+    for (int i = 0; i < 4; ++i) {
+        info->linesize[i] = i < plane_count ? linesize[i] : 0;
+        info->plane_offset[i] = i < plane_count ? offset : 0;
+        if (i < plane_count) {
+            int rows = (i == 1 || i == 2) ? AV_CEIL_RSHIFT(info->height, desc->log2_chroma_h) : info->height;
+            offset += static_cast<size_t>(linesize[i]) * rows;
+        }
+    }
+    info->plane_count = plane_count;
+    info->frame_size = offset;
+    info->bits_per_pixel = static_cast<int>((static_cast<uint64_t>(offset) * 8) /
+                                            (static_cast<uint64_t>(info->width) * info->height));
+    return true;
+}
+
+bool RawFrameFile::copyPlanes(const RawFrameFileInfo& layout, const uint8_t* const src_planes[4],
+                              const int src_linesize[4], uint8_t* dst) {
+    if (layout.plane_count <= 0 || layout.plane_count > 4 || !dst) {
+        return false;
+    }
+    for (int i = 0; i < layout.plane_count; ++i) {
+        if (layout.linesize[i] <= 0 || !src_planes[i] || src_linesize[i] < layout.linesize[i]) {
+            return false;
+        }
+    }
+    for (int i = 0; i < layout.plane_count; ++i) {
+        size_t plane_end = i + 1 < layout.plane_count ? layout.plane_offset[i + 1] : layout.frame_size;
+        int rows = static_cast<int>((plane_end - layout.plane_offset[i]) / layout.linesize[i]);
+        FrameCopy::getInstance().copyRows(dst + layout.plane_offset[i], layout.linesize[i],
+                                          src_planes[i], src_linesize[i], layout.linesize[i], rows);
+    }
+    return true;
+}
+
+bool RawFrameFile::statSource(const char* path, uint64_t* size, int64_t* mtime_ns) {
+    struct stat st;
+    if (!path || stat(path, &st) < 0) {
+        return false;
+    }
+    if (size) {
+        *size = static_cast<uint64_t>(st.st_size);
+    }
+    if (mtime_ns) {
+        *mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    }
+    return true;
+}
+
+uint64_t RawFrameFile::fingerprint(const std::string& key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// ============================================================================
+// RawFrameFileWriter
+// ============================================================================
+
+RawFrameFileWriter::RawFrameFileWriter()
+    : fd_(-1)
+    , path_()
+    , tmp_path_()
+    , info_()
+    , write_offset_(0)
+{
+}
+
+RawFrameFileWriter::~RawFrameFileWriter() {
+    abort();
+}
+
+bool RawFrameFileWriter::open(const char* path, const RawFrameFileInfo& source) {
+    if (!path || source.width <= 0 || source.height <= 0 || source.frame_size == 0 ||
+        source.plane_count < 0 || source.plane_count > 4 ||
+        !isPowerOfTwo(source.frame_alignment) || source.frame_alignment > RawFrameFile::kDataAlignment) {
+        LOG_ERROR("[RawFrameFile] Error: Invalid writer parameters");
+        return false;
+    }
+    abort();
+
+    // 临时文件名唯一（mkostemp 以 O_EXCL 创建）：同一进程内多个 Worker 写同一路径时互不截断，
+    // 各自 finish() 时原子 rename，最后完成的文件生效
+    path_ = path;
+    std::vector<char> tmp_template(path_.begin(), path_.end());
+    const char kSuffix[] = ".tmp.XXXXXX";
+    tmp_template.insert(tmp_template.end(), kSuffix, kSuffix + sizeof(kSuffix));
+    fd_ = mkostemp(tmp_template.data(), O_CLOEXEC);
+    if (fd_ < 0) {
+        LOG_ERROR_FMT("[RawFrameFile] Error: Cannot create '%s.tmp.*': %s", path_.c_str(), strerror(errno));
+        return false;
+    }
+    tmp_path_ = tmp_template.data();
+    fchmod(fd_, 0644);   // mkostemp 创建的文件是 0600，缓存文件需要其他进程可读
+
+    info_ = source;
+    info_.frame_count = 0;
+    info_.frame_offsets.clear();
+    write_offset_ = RawFrameFile::kDataAlignment;   // Header 在 finish() 时写入
+    return true;
+}
+
+bool RawFrameFileWriter::writeFrame(const uint8_t* data) {
+    if (fd_ < 0 || !data) {
+        return false;
+    }
+    // 帧前的对齐填充不写数据（pwrite 越过的区域读出为 0）
+    uint64_t alignment = info_.frame_alignment;
+    write_offset_ = (write_offset_ + alignment - 1) & ~(alignment - 1);
+    if (!writeAll(data, info_.frame_size, write_offset_)) {
+        LOG_ERROR_FMT("[RawFrameFile] Error: Write failed for '%s': %s", tmp_path_.c_str(), strerror(errno));
+        abort();
+        return false;
+    }
+    info_.frame_offsets.push_back(write_offset_);
+    write_offset_ += info_.frame_size;
+    return true;
+}
+
+bool RawFrameFileWriter::finish() {
+    if (fd_ < 0) {
+        return false;
+    }
+    if (info_.frame_offsets.empty()) {
+        abort();
+        return false;
+    }
+
+    DiskHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RawFrameFile::kMagic, sizeof(header.magic));
+    header.version = RawFrameFile::kVersion;
+    header.header_size = RawFrameFile::kHeaderSize;
+    header.width = info_.width;
+    header.height = info_.height;
+    header.pixel_format = info_.pixel_format;
+    header.bits_per_pixel = info_.bits_per_pixel;
+    header.frame_count = static_cast<uint32_t>(info_.frame_offsets.size());
+    header.frame_size = info_.frame_size;
+    header.data_offset = RawFrameFile::kDataAlignment;
+    header.index_offset = write_offset_;
+    header.source_size = info_.source_size;
+    header.source_mtime_ns = info_.source_mtime_ns;
+    header.source_fingerprint = info_.source_fingerprint;
+    header.frame_rate = info_.frame_rate;
+    header.plane_count = static_cast<uint32_t>(info_.plane_count);
+    header.frame_alignment = static_cast<uint32_t>(info_.frame_alignment);
+    for (int i = 0; i < info_.plane_count; ++i) {
+        header.linesize[i] = info_.linesize[i];
+        header.plane_offset[i] = info_.plane_offset[i];
+    }
+
+    // 先落盘数据和索引，再写 Header：中途断电不会留下 magic 有效但内容不完整的文件
+    size_t index_bytes = info_.frame_offsets.size() * sizeof(uint64_t);
+    if (!writeAll(info_.frame_offsets.data(), index_bytes, write_offset_) ||
+        fdatasync(fd_) < 0 ||
+        !writeAll(&header, sizeof(header), 0) ||
+        fdatasync(fd_) < 0) {
+        LOG_ERROR_FMT("[RawFrameFile] Error: Finalize failed for '%s': %s", tmp_path_.c_str(), strerror(errno));
+        abort();
+        return false;
+    }
+
+    ::close(fd_);
+    fd_ = -1;
+    if (rename(tmp_path_.c_str(), path_.c_str()) < 0) {
+        LOG_ERROR_FMT("[RawFrameFile] Error: Cannot rename to '%s': %s", path_.c_str(), strerror(errno));
+        unlink(tmp_path_.c_str());
+        return false;
+    }
+
+    LOG_INFO_FMT("[RawFrameFile] Written '%s': %zu frames, %dx%d, %.1f MB",
+                 path_.c_str(), info_.frame_offsets.size(), info_.width, info_.height,
+                 (write_offset_ + index_bytes) / (1024.0 * 1024.0));
+    return true;
+}
+
+void RawFrameFileWriter::abort() {
+    if (fd_ < 0) {
+        return;
+    }
+    ::close(fd_);
+    fd_ = -1;
+    unlink(tmp_path_.c_str());
+    info_.frame_offsets.clear();
+}
+
+bool RawFrameFileWriter::writeAll(const void* data, size_t size, uint64_t offset) {
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = pwrite(fd_, src, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        src += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+} // namespace io
+} // namespace productionline
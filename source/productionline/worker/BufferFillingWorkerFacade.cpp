@@ -1,11 +1,15 @@
 #include "productionline/worker/BufferFillingWorkerFacade.hpp"
 #include "common/Logger.hpp"
+#include "productionline/worker/FfmpegDecodeVideoFileWorker.hpp"
+#include "productionline/worker/MmapRawVideoFileWorker.hpp"
+#include "productionline/io/RawFrameFile.hpp"
 #include <stdio.h>
 
 // ============ 构造/析构 ============
 
 BufferFillingWorkerFacade::BufferFillingWorkerFacade(const WorkerConfig& config)
     : config_(config)
+    , adopted_pool_id_(0)
 {
     if (!worker_base_uptr_) {
         worker_base_uptr_ = BufferFillingWorkerFactory::create(config_);
@@ -39,6 +43,7 @@ bool BufferFillingWorkerFacade::open() {
         LOG_ERROR("[Worker] ERROR: Failed to create worker");
         return false;
     }
+    worker_base_uptr_->adoptOutputBufferPool(adopted_pool_id_);
     
     // 从 config_ 获取所有参数
     const std::string& file_path = config_.file.file_path;
@@ -46,24 +51,61 @@ bool BufferFillingWorkerFacade::open() {
     int height = config_.output.height;
     int bits_per_pixel = config_.output.bits_per_pixel;
     
-    if (file_path.empty()) {
+    // 测试图案不读文件：未设置路径时用图案名称
+    bool is_pattern = config_.worker_type == BufferFillingWorkerFactory::WorkerType::TEST_PATTERN;
+    if (file_path.empty() && !is_pattern) {
         LOG_ERROR("[Worker] ERROR: File path not set in config");
         return false;
     }
     
-    const char* path = file_path.c_str();
+    const char* path = file_path.empty() ? config_.pattern.name.c_str() : file_path.c_str();
+    
+    // 🎯 解码一次的 raw 缓存文件已就绪（源文件和解码配置未变）：改由 mmap Worker 直接播放，
+    // 跳过探测和解码；缓存文件缺失或过期时由 FFmpeg Worker 在第一遍解码中写入
+    if (config_.worker_type == BufferFillingWorkerFactory::WorkerType::FFMPEG_VIDEO_FILE &&
+        FfmpegDecodeVideoFileWorker::isSpillFileValid(config_)) {
+        LOG_INFO_FMT("[Worker] BufferFillingWorkerFacade: Serving '%s' from spill file '%s'",
+                     path, config_.cache.spill_path.c_str());
+        worker_base_uptr_ = std::make_unique<MmapRawVideoFileWorker>(config_);
+        worker_base_uptr_->adoptOutputBufferPool(adopted_pool_id_);
+        if (worker_base_uptr_->open(config_.cache.spill_path.c_str())) {
+            return true;
+        }
+        LOG_WARN("[Worker]  Warning: Failed to open spill file, falling back to decoding");
+        worker_base_uptr_ = BufferFillingWorkerFactory::create(config_);
+        if (!worker_base_uptr_) {
+            LOG_ERROR("[Worker] ERROR: Failed to create worker");
+            return false;
+        }
+        worker_base_uptr_->adoptOutputBufferPool(adopted_pool_id_);
+    }
     
     // 🎯 智能判断：根据Worker类型选择合适的open方法
-    // - Raw视频Worker（MMAP_RAW, IOURING_RAW）：需要格式参数
+    // - Raw视频Worker（MMAP_RAW, IOURING_RAW, IMAGE_SEQUENCE, RAW_STREAM, TEST_PATTERN）：需要格式参数
+    //   （MMAP_RAW 未配置分辨率时按魔数打开 H.264 / MP4）
     // - 编码视频Worker（FFMPEG_VIDEO_FILE, FFMPEG_RTSP）：自动检测格式
     
     bool is_raw_worker = (config_.worker_type == BufferFillingWorkerFactory::WorkerType::MMAP_RAW ||
-                          config_.worker_type == BufferFillingWorkerFactory::WorkerType::IOURING_RAW);
+                          config_.worker_type == BufferFillingWorkerFactory::WorkerType::IOURING_RAW ||
+                          config_.worker_type == BufferFillingWorkerFactory::WorkerType::IMAGE_SEQUENCE ||
+                          config_.worker_type == BufferFillingWorkerFactory::WorkerType::RAW_STREAM ||
+                          is_pattern);
+    // 流不能预读文件头（会消耗管道中的数据，FIFO 还会阻塞）：只按配置的格式打开；测试图案没有文件
+    bool is_stream = config_.worker_type == BufferFillingWorkerFactory::WorkerType::RAW_STREAM;
     
-    if (is_raw_worker) {
-        // Raw视频Worker：需要格式参数
-        if (width == 0 || height == 0 || bits_per_pixel == 0) {
-            LOG_ERROR_FMT("[Worker] ERROR: Raw video worker requires width, height, and bits_per_pixel in config!");
+    if (is_raw_worker && !is_stream && !is_pattern && productionline::io::RawFrameFile::isRawFrameFile(path)) {
+        // RawFrameFile 自描述几何和像素格式：忽略配置中的格式参数
+        LOG_DEBUG("[Worker] BufferFillingWorkerFacade: Opening self-describing RawFrameFile");
+        return worker_base_uptr_->open(path);
+    } else if (config_.worker_type == BufferFillingWorkerFactory::WorkerType::MMAP_RAW &&
+               width == 0 && height == 0) {
+        // 未配置几何：mmap Worker 按魔数识别自描述的压缩输入（H.264 Annex-B 裸流 / MP4）
+        LOG_DEBUG("[Worker] BufferFillingWorkerFacade: Opening mmap input without geometry (H.264 / MP4)");
+        return worker_base_uptr_->open(path);
+    } else if (is_raw_worker) {
+        // Raw视频Worker：需要格式参数（设置了像素格式时 bits_per_pixel 由格式推导）
+        if (width == 0 || height == 0 || (bits_per_pixel == 0 && config_.output.pixel_format < 0)) {
+            LOG_ERROR_FMT("[Worker] ERROR: Raw video worker requires width, height, and bits_per_pixel (or pixel_format) in config!");
             return false;
         }
         LOG_DEBUG_FMT("[Worker] BufferFillingWorkerFacade: Opening raw video with format %dx%d@%dbpp",
@@ -96,6 +138,17 @@ bool BufferFillingWorkerFacade::fillBuffer(int frame_index, Buffer* buffer) {
     return worker_base_uptr_->fillBuffer(frame_index, buffer);
 }
 
+int BufferFillingWorkerFacade::fillBuffers(WorkerBase::FillRequest* requests, int count) {
+    if (!worker_base_uptr_) {
+        LOG_ERROR("[Worker] ERROR: Worker not initialized");
+        for (int i = 0; i < count; i++) {
+            requests[i].filled = false;
+        }
+        return 0;
+    }
+    return worker_base_uptr_->fillBuffers(requests, count);
+}
+
 // ============ 导航操作（门面转发） ============
 
 bool BufferFillingWorkerFacade::seek(int frame_index) {
@@ -172,6 +225,14 @@ bool BufferFillingWorkerFacade::isAtEnd() const {
     return worker_base_uptr_ && worker_base_uptr_->isAtEnd();
 }
 
+double BufferFillingWorkerFacade::getFrameRate() const {
+    return worker_base_uptr_ ? worker_base_uptr_->getFrameRate() : 0.0;
+}
+
+bool BufferFillingWorkerFacade::getFrameCacheStats(DecodedFrameCache::Stats* stats) const {
+    return worker_base_uptr_ ? worker_base_uptr_->getFrameCacheStats(stats) : false;
+}
+
 // ============ 提供原材料（BufferPool ID）============
 
 uint64_t BufferFillingWorkerFacade::getOutputBufferPoolId() {
@@ -181,3 +242,14 @@ uint64_t BufferFillingWorkerFacade::getOutputBufferPoolId() {
     return 0;
 }
 
+void BufferFillingWorkerFacade::adoptOutputBufferPool(uint64_t pool_id) {
+    adopted_pool_id_ = pool_id;
+    if (worker_base_uptr_) {
+        worker_base_uptr_->adoptOutputBufferPool(pool_id);
+    }
+}
+
+bool BufferFillingWorkerFacade::usesAVFrameBuffers() const {
+    return worker_base_uptr_ && worker_base_uptr_->usesAVFrameBuffers();
+}
+
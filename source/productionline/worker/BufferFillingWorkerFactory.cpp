@@ -4,6 +4,9 @@
 #include "productionline/worker/IoUringRawVideoFileWorker.hpp"
 #include "productionline/worker/FfmpegDecodeRtspWorker.hpp"
 #include "productionline/worker/FfmpegDecodeVideoFileWorker.hpp"
+#include "productionline/worker/ImageSequenceWorker.hpp"
+#include "productionline/worker/RawVideoStreamWorker.hpp"
+#include "productionline/worker/TestPatternWorker.hpp"
 #include <stdlib.h>
 #include <string.h>
 #include <liburing.h>
@@ -83,6 +86,9 @@ const char* BufferFillingWorkerFactory::typeToString(WorkerType type) {
         case WorkerType::IOURING_RAW:     return "IOURING_RAW";
         case WorkerType::FFMPEG_RTSP:     return "FFMPEG_RTSP";
         case WorkerType::FFMPEG_VIDEO_FILE: return "FFMPEG_VIDEO_FILE";
+        case WorkerType::IMAGE_SEQUENCE:  return "IMAGE_SEQUENCE";
+        case WorkerType::RAW_STREAM:      return "RAW_STREAM";
+        case WorkerType::TEST_PATTERN:    return "TEST_PATTERN";
         default:                          return "UNKNOWN";
     }
 }
@@ -134,6 +140,15 @@ std::unique_ptr<WorkerBase> BufferFillingWorkerFactory::createByType(WorkerType
         case WorkerType::FFMPEG_VIDEO_FILE:
             return std::make_unique<FfmpegDecodeVideoFileWorker>(config);  // ✅ 已经传递 config
             
+        case WorkerType::IMAGE_SEQUENCE:
+            return std::make_unique<ImageSequenceWorker>(config);
+            
+        case WorkerType::RAW_STREAM:
+            return std::make_unique<RawVideoStreamWorker>(config);
+            
+        case WorkerType::TEST_PATTERN:
+            return std::make_unique<TestPatternWorker>(config);
+            
         default:
             return autoDetect(config);
     }
@@ -153,6 +168,12 @@ BufferFillingWorkerFactory::WorkerType BufferFillingWorkerFactory::getTypeFromEn
         return WorkerType::FFMPEG_RTSP;
     } else if (strcmp(env, "ffmpeg") == 0 || strcmp(env, "ffmpeg_video_file") == 0) {
         return WorkerType::FFMPEG_VIDEO_FILE;
+    } else if (strcmp(env, "sequence") == 0 || strcmp(env, "image_sequence") == 0) {
+        return WorkerType::IMAGE_SEQUENCE;
+    } else if (strcmp(env, "stream") == 0 || strcmp(env, "raw_stream") == 0) {
+        return WorkerType::RAW_STREAM;
+    } else if (strcmp(env, "pattern") == 0 || strcmp(env, "test_pattern") == 0) {
+        return WorkerType::TEST_PATTERN;
     }
     
     return WorkerType::AUTO;
@@ -0,0 +1,261 @@
+#include "productionline/worker/DecodedFrameCache.hpp"
+#include "common/Logger.hpp"
+#include "common/FrameCopy.hpp"
+#include <climits>
+#include <cstring>
+
+extern "C" {
+#include <libavutil/buffer.h>
+#include <libavutil/frame.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+// ============================================================================
+// 构造/析构
+// ============================================================================
+
+DecodedFrameCache::DecodedFrameCache(size_t budget_bytes, bool compress)
+    : entries_()
+    , state_(State::RECORDING)
+    , frame_count_(0)
+    , width_(0)
+    , height_(0)
+    , format_(-1)
+    , frame_bytes_(0)
+    , layout_()
+    , budget_bytes_(budget_bytes)
+    , compress_(compress)
+    , scratch_raw_()
+    , scratch_lz4_()
+    , decode_pool_(nullptr)
+    , hits_(0)
+    , misses_(0)
+    , memory_bytes_(0)
+    , raw_bytes_(0)
+{
+#ifndef HAVE_LZ4
+    if (compress_) {
+        LOG_WARN("[FrameCache] LZ4 support not compiled in, caching frames uncompressed");
+        compress_ = false;
+    }
+#endif
+}
+
+DecodedFrameCache::~DecodedFrameCache() {
+    releaseEntries();
+}
+
+void DecodedFrameCache::releaseEntries() {
+    for (auto& entry : entries_) {
+        av_buffer_unref(&entry.data);
+    }
+    entries_.clear();
+    entries_.shrink_to_fit();
+    scratch_raw_.clear();
+    scratch_raw_.shrink_to_fit();
+    scratch_lz4_.clear();
+    scratch_lz4_.shrink_to_fit();
+    // 已取出的解压帧仍持有 pool 中的 buffer，av_buffer_pool_uninit 会等它们归还后再释放
+    if (decode_pool_) {
+        av_buffer_pool_uninit(&decode_pool_);
+    }
+    frame_count_.store(0, std::memory_order_release);
+    memory_bytes_.store(0);
+    raw_bytes_.store(0);
+}
+
+// ============================================================================
+// 记录（第一遍解码）
+// ============================================================================
+
+bool DecodedFrameCache::record(const AVFrame* frame) {
+    if (getState() != State::RECORDING) {
+        return false;
+    }
+
+    // 第一帧确定几何；帧必须可由 CPU 访问（硬件表面无法紧凑拷贝）
+    if (entries_.empty()) {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+        if (!desc || (desc->flags & AV_PIX_FMT_FLAG_HWACCEL)) {
+            disable("frames are not CPU accessible");
+            return false;
+        }
+        width_ = frame->width;
+        height_ = frame->height;
+        format_ = frame->format;
+        layout_ = productionline::io::RawFrameFileInfo();
+        layout_.width = width_;
+        layout_.height = height_;
+        layout_.pixel_format = format_;
+        if (!productionline::io::RawFrameFile::setImageLayout(&layout_) || layout_.frame_size > INT_MAX) {
+            disable("unsupported frame geometry");
+            return false;
+        }
+        frame_bytes_ = static_cast<int>(layout_.frame_size);
+    } else if (frame->width != width_ || frame->height != height_ || frame->format != format_) {
+        disable("frame geometry changed mid-stream");
+        return false;
+    }
+
+    if (raw_bytes_.load() + frame_bytes_ > budget_bytes_ && !compress_) {
+        disable("memory budget exceeded");
+        return false;
+    }
+
+    Entry entry;
+    if (!compress_) {
+        // 缓存写入后很久才读：FrameCopy 流式存储，不挤占解码器的缓存
+        entry.data = av_buffer_alloc(frame_bytes_);
+        if (!entry.data ||
+            !productionline::io::RawFrameFile::copyPlanes(layout_, frame->data, frame->linesize, entry.data->data)) {
+            av_buffer_unref(&entry.data);
+            disable("failed to copy frame");
+            return false;
+        }
+        memory_bytes_.fetch_add(frame_bytes_);
+    } else {
+#ifdef HAVE_LZ4
+        scratch_raw_.resize(frame_bytes_);
+        scratch_lz4_.resize(LZ4_compressBound(frame_bytes_));
+        // 紧接着由 LZ4 读取：普通存储，留在缓存里
+        if (av_image_copy_to_buffer(scratch_raw_.data(), frame_bytes_, frame->data, frame->linesize,
+                                    static_cast<AVPixelFormat>(format_), width_, height_, 1) < 0) {
+            disable("failed to copy frame");
+            return false;
+        }
+        int compressed = LZ4_compress_default(reinterpret_cast<const char*>(scratch_raw_.data()),
+                                              reinterpret_cast<char*>(scratch_lz4_.data()),
+                                              frame_bytes_, static_cast<int>(scratch_lz4_.size()));
+        // 不可压缩的帧按原样存储
+        const uint8_t* src = compressed > 0 && compressed < frame_bytes_ ? scratch_lz4_.data() : scratch_raw_.data();
+        int size = compressed > 0 && compressed < frame_bytes_ ? compressed : frame_bytes_;
+        if (memory_bytes_.load() + size > budget_bytes_) {
+            disable("memory budget exceeded");
+            return false;
+        }
+        entry.data = av_buffer_alloc(size);
+        if (!entry.data) {
+            disable("out of memory");
+            return false;
+        }
+        FrameCopy::getInstance().copy(entry.data->data, src, size);   // 缓存写入后很久才读：流式存储
+        entry.compressed_size = src == scratch_lz4_.data() ? size : 0;
+        memory_bytes_.fetch_add(size);
+#endif
+    }
+
+    entries_.push_back(entry);
+    raw_bytes_.fetch_add(frame_bytes_);
+    frame_count_.store(static_cast<int>(entries_.size()), std::memory_order_release);
+    return true;
+}
+
+void DecodedFrameCache::finish() {
+    if (getState() != State::RECORDING) {
+        return;
+    }
+    if (entries_.empty()) {
+        disable("no frames decoded");
+        return;
+    }
+
+    // 压缩缓冲区不再需要；解压输出改用引用计数的 buffer pool（帧在下游持有期间不能复用）
+    scratch_raw_.clear();
+    scratch_raw_.shrink_to_fit();
+    scratch_lz4_.clear();
+    scratch_lz4_.shrink_to_fit();
+    if (compress_) {
+        decode_pool_ = av_buffer_pool_init(frame_bytes_, av_buffer_alloc);
+        if (!decode_pool_) {
+            disable("failed to create decode pool");
+            return;
+        }
+    }
+
+    state_.store(State::COMPLETE, std::memory_order_release);
+    size_t memory = memory_bytes_.load();
+    size_t raw = raw_bytes_.load();
+    LOG_INFO_FMT("[FrameCache] Clip cached: %d frames, %.1f MB%s",
+                 getFrameCount(), memory / (1024.0 * 1024.0),
+                 compress_ ? (" (LZ4, " + std::to_string(memory > 0 ? raw * 100 / memory : 0) + "% of raw)").c_str() : "");
+}
+
+void DecodedFrameCache::disable(const std::string& reason) {
+    if (getState() == State::DISABLED) {
+        return;
+    }
+    LOG_INFO_FMT("[FrameCache] Disabled after %d frames: %s", getFrameCount(), reason.c_str());
+    state_.store(State::DISABLED, std::memory_order_release);
+    releaseEntries();
+}
+
+// ============================================================================
+// 取帧
+// ============================================================================
+
+bool DecodedFrameCache::fetch(int index, AVFrame* frame) {
+    if (!isComplete() || index < 0 || index >= static_cast<int>(entries_.size())) {
+        return false;
+    }
+    const Entry& entry = entries_[index];
+
+    AVBufferRef* ref = nullptr;
+    if (entry.compressed_size == 0) {
+        // 未压缩：共享缓存内存（引用计数，下游持有期间缓存被释放也安全）
+        ref = av_buffer_ref(entry.data);
+    } else {
+#ifdef HAVE_LZ4
+        ref = av_buffer_pool_get(decode_pool_);
+        if (ref && LZ4_decompress_safe(reinterpret_cast<const char*>(entry.data->data),
+                                       reinterpret_cast<char*>(ref->data),
+                                       entry.compressed_size, frame_bytes_) != frame_bytes_) {
+            LOG_ERROR_FMT("[FrameCache] LZ4 decompression failed for frame %d", index);
+            av_buffer_unref(&ref);
+        }
+#endif
+    }
+    if (!ref) {
+        return false;
+    }
+
+    av_frame_unref(frame);
+    frame->buf[0] = ref;
+    frame->format = format_;
+    frame->width = width_;
+    frame->height = height_;
+    av_image_fill_arrays(frame->data, frame->linesize, ref->data,
+                         static_cast<AVPixelFormat>(format_), width_, height_, 1);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// ============================================================================
+// 统计
+// ============================================================================
+
+DecodedFrameCache::Stats DecodedFrameCache::getStats() const {
+    Stats stats;
+    stats.state = getState();
+    stats.frames = getFrameCount();
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.memory_bytes = memory_bytes_.load();
+    stats.raw_bytes = raw_bytes_.load();
+    stats.budget_bytes = budget_bytes_;
+    stats.compressed = compress_;
+    return stats;
+}
+
+const char* DecodedFrameCache::stateName(State state) {
+    switch (state) {
+        case State::RECORDING: return "recording";
+        case State::COMPLETE:  return "complete";
+        case State::DISABLED:  return "disabled";
+    }
+    return "unknown";
+}
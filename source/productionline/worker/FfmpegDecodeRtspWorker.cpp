@@ -133,7 +133,7 @@ bool FfmpegDecodeRtspWorker::open(const char* path, int width, int height, int b
     int buffer_count = 4;  // RTSP流建议4-8个Buffer
     
     // v2.0: allocatePoolWithBuffers 返回 pool_id
-    buffer_pool_id_ = allocator_facade_.allocatePoolWithBuffers(
+    buffer_pool_id_ = allocateOutputPool(
         buffer_count,
         frame_size,
         std::string("FfmpegDecodeRtspWorker_") + std::string(path),
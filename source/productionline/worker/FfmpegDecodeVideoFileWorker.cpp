@@ -1,6 +1,7 @@
 #include "productionline/worker/FfmpegDecodeVideoFileWorker.hpp"
 #include "common/Logger.hpp"
 #include "buffer/bufferpool/BufferPoolRegistry.hpp"
+#include "productionline/io/FileAVIOContext.hpp"
 #include <cstring>
 #include <cstdio>
 
@@ -42,6 +43,7 @@ FfmpegDecodeVideoFileWorker::FfmpegDecodeVideoFileWorker()
     , use_hardware_decoder_(true)  // 默认启用硬件解码
     , decoder_name_()              // 默认自动选择（空字符串）
     , codec_options_ptr_(nullptr)
+    , spill_pending_(false)
     , decoded_frames_(0)
     , decode_errors_(0)
     , last_ffmpeg_error_(0)
@@ -72,6 +74,7 @@ FfmpegDecodeVideoFileWorker::FfmpegDecodeVideoFileWorker(const WorkerConfig& con
     , use_hardware_decoder_(config.decoder.enable_hardware)  // 🎯 从配置读取
     , decoder_name_(config.decoder.name.value_or(""))  // 🎯 从配置读取（使用 optional 的 value_or）
     , codec_options_ptr_(nullptr)
+    , spill_pending_(false)
     , decoded_frames_(0)
     , decode_errors_(0)
     , last_ffmpeg_error_(0)
@@ -120,7 +123,7 @@ bool FfmpegDecodeVideoFileWorker::open(const char* path) {
     int buffer_count = 1;  // 默认创建4个Buffer
     
     // v2.0: allocatePoolWithBuffers 返回 pool_id
-    buffer_pool_id_ = allocator_facade_.allocatePoolWithBuffers(
+    buffer_pool_id_ = allocateOutputPool(
         buffer_count,
         frame_size,
         std::string("FfmpegDecodeVideoFileWorker_") + std::string(path),
@@ -138,6 +141,15 @@ bool FfmpegDecodeVideoFileWorker::open(const char* path) {
     auto pool = pool_weak.lock();
     std::string pool_name = pool ? pool->getName() : "Unknown";
     
+    // 解码帧缓存：从第 0 帧开始记录，第一遍解码到 EOF 后循环播放从缓存取帧
+    if (worker_config_.cache.isFrameCacheEnabled()) {
+        frame_cache_uptr_ = std::make_unique<DecodedFrameCache>(
+            worker_config_.cache.frame_cache_bytes, worker_config_.cache.frame_cache_compress);
+    }
+    // raw 缓存文件：缺失或过期时在第一遍解码中写入（seek 重新打开时已写完的文件不会重写）
+    spill_writer_uptr_.reset();
+    spill_pending_ = worker_config_.cache.isSpillEnabled() && !isSpillFileValid(worker_config_);
+    
     is_open_.store(true, std::memory_order_release);
     current_frame_index_ = 0;
     eof_reached_ = false;
@@ -183,6 +195,12 @@ void FfmpegDecodeVideoFileWorker::close() {
         // Allocator 析构时会自动清理所有 Pool
         buffer_pool_id_ = 0;  // 只清除ID，不调用destroyPool
         
+        // 已取出的缓存帧由 AVBufferRef 引用计数持有，释放缓存不影响下游
+        frame_cache_uptr_.reset();
+        
+        // 未解码到 EOF 的 raw 缓存文件不完整，删除临时文件
+        abortSpill(nullptr);
+        
         closeFfmpegResources();
     }
     
@@ -208,10 +226,30 @@ bool FfmpegDecodeVideoFileWorker::openFfmpegResources() {
         return false;
     }
     
+    // 可选：自定义 AVIOContext（mmap / io_uring 预读），失败时回退 FFmpeg 默认 file 协议
+    custom_io_uptr_.reset();
+    if (worker_config_.file.io_mode != FileIoMode::DEFAULT) {
+        using productionline::io::FileAVIOContext;
+        auto io = std::make_unique<FileAVIOContext>();
+        FileAVIOContext::Mode mode = worker_config_.file.io_mode == FileIoMode::MMAP
+                                         ? FileAVIOContext::Mode::MMAP
+                                         : FileAVIOContext::Mode::IO_URING;
+        if (io->open(file_path_.c_str(), mode, worker_config_.file.readahead_bytes,
+                     worker_config_.file.readahead_depth)) {
+            format_ctx_ptr_->pb = io->get();
+            format_ctx_ptr_->flags |= AVFMT_FLAG_CUSTOM_IO;
+            custom_io_uptr_ = std::move(io);
+        } else {
+            LOG_WARN_FMT("[Worker] Custom AVIOContext unavailable for '%s', using default file protocol",
+                         file_path_.c_str());
+        }
+    }
+    
     int ret = avformat_open_input(&format_ctx_ptr_, file_path_.c_str(), nullptr, nullptr);
     if (ret < 0) {
         setError("Failed to open video file", ret);
         format_ctx_ptr_ = nullptr;
+        custom_io_uptr_.reset();    // 失败时 FFmpeg 已释放 AVFormatContext，但不释放自定义 pb
         return false;
     }
     
@@ -299,6 +337,9 @@ void FfmpegDecodeVideoFileWorker::closeFfmpegResources() {
         format_ctx_ptr_ = nullptr;
     }
     
+    // 释放自定义 AVIOContext（CUSTOM_IO 模式下 avformat_close_input 不释放 pb）
+    custom_io_uptr_.reset();
+    
     // 释放解码器选项
     if (codec_options_ptr_) {
         av_dict_free(&codec_options_ptr_);
@@ -504,6 +545,13 @@ int FfmpegDecodeVideoFileWorker::estimateTotalFrames() {
 
 bool FfmpegDecodeVideoFileWorker::seek(int frame_index) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
+    // 片段已完整缓存：直接定位缓存帧，不重新打开解码器
+    if (frame_cache_uptr_ && frame_cache_uptr_->isComplete()) {
+        int frame_count = frame_cache_uptr_->getFrameCount();
+        current_frame_index_ = frame_index < 0 ? 0 : (frame_index > frame_count ? frame_count : frame_index);
+        eof_reached_ = current_frame_index_ >= frame_count;
+        return true;
+    }
     close();
     open(file_path_.c_str());
     return true;
@@ -578,6 +626,32 @@ bool FfmpegDecodeVideoFileWorker::isAtEnd() const {
     return eof_reached_;
 }
 
+double FfmpegDecodeVideoFileWorker::getFrameRate() const {
+    if (!format_ctx_ptr_ || video_stream_index_ < 0) {
+        return 0.0;
+    }
+    AVStream* stream = format_ctx_ptr_->streams[video_stream_index_];
+    // 优先使用平均帧率，缺失时（部分裸流）退回到基础帧率
+    if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0) {
+        return av_q2d(stream->avg_frame_rate);
+    }
+    if (stream->r_frame_rate.num > 0 && stream->r_frame_rate.den > 0) {
+        return av_q2d(stream->r_frame_rate);
+    }
+    return 0.0;
+}
+
+bool FfmpegDecodeVideoFileWorker::getFrameCacheStats(DecodedFrameCache::Stats* stats) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!frame_cache_uptr_) {
+        return false;
+    }
+    if (stats) {
+        *stats = frame_cache_uptr_->getStats();
+    }
+    return true;
+}
+
 // ============================================================================
 // 核心功能：填充Buffer
 // ============================================================================
@@ -588,21 +662,47 @@ bool FfmpegDecodeVideoFileWorker::fillBuffer(int frame_index, Buffer* buffer) {
         return false;
     }
     
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    
     if (!is_open_.load(std::memory_order_acquire)) {
         LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
         return false;
     }
     
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    
-    // 步骤1: ⭐ v2.7改进：从 Buffer 获取关联的 AVFrame*
-    AVFrame* frame_ptr = buffer->getAVFrame();
-    if (!frame_ptr) {
-        LOG_ERROR_FMT("[Worker] ERROR: buffer->getAVFrame() is nullptr");
-        return false;
+    // 与 fillBuffers() 共用解码路径：一个 packet 解出的多帧留在解码器中逐帧交给后续 buffer，
+    // 非视频 packet 在内部跳过（不再让调用方把跳过计为失败帧）
+    return decodeNextFrame(buffer);
+}
+
+int FfmpegDecodeVideoFileWorker::fillBuffers(FillRequest* requests, int count) {
+    int filled = 0;
+    int i = 0;
+    if (!is_open_.load(std::memory_order_acquire)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
+    } else {
+        // 整批只加一次锁（解码本来就在锁内串行）
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        for (; i < count; i++) {
+            requests[i].filled = decodeNextFrame(requests[i].buffer);
+            if (requests[i].filled) {
+                filled++;
+            } else if (eof_reached_) {
+                i++;
+                break;
+            }
+        }
     }
-    
-    // 步骤2: 读取一个 packet（参考 ids_test_video3:2240）
+    for (; i < count; i++) {
+        requests[i].filled = false;
+    }
+    return filled;
+}
+
+// ============================================================================
+// 解码辅助
+// ============================================================================
+
+int FfmpegDecodeVideoFileWorker::readPacket() {
     // 🔧 修复：对于损坏帧，在内部循环尝试读取，而不是返回 false
     const int AVERROR_INVALIDDATA_VALUE = -1094995529;  // AVERROR(0x41444e49)
     const int MAX_CORRUPTED_RETRIES = 10;  // 最大重试次数，避免无限循环
@@ -620,7 +720,16 @@ bool FfmpegDecodeVideoFileWorker::fillBuffer(int frame_index, Buffer* buffer) {
                 // 循环逻辑由 ProductionLine 根据 loop_ 变量控制
                 av_packet_unref(packet_ptr_);
                 eof_reached_ = true;
-                return false;
+                // 第一遍解码结束：缓存完整则之后的循环从缓存播放
+                if (frame_cache_uptr_) {
+                    frame_cache_uptr_->finish();
+                }
+                if (spill_writer_uptr_) {
+                    spill_writer_uptr_->finish();
+                    spill_writer_uptr_.reset();
+                }
+                spill_pending_ = false;
+                return 0;
             } else if (read_ret == AVERROR_INVALIDDATA_VALUE) {
                 // 🔧 修复：遇到损坏帧时，在内部循环跳过，继续读取下一个 packet
                 corrupted_retries++;
@@ -634,7 +743,7 @@ bool FfmpegDecodeVideoFileWorker::fillBuffer(int frame_index, Buffer* buffer) {
                     // 连续多次都是损坏帧，可能文件确实损坏严重，返回失败
                     LOG_ERROR_FMT("[Worker] ERROR: Too many corrupted packets (%d), giving up\n", corrupted_retries);
                     av_packet_unref(packet_ptr_);
-                    return false;
+                    return -1;
                 }
             } else {
                 // 其他错误（非 EOF，非损坏帧）：记录错误并返回
@@ -642,70 +751,212 @@ bool FfmpegDecodeVideoFileWorker::fillBuffer(int frame_index, Buffer* buffer) {
                 av_strerror(read_ret, err_buf, sizeof(err_buf));
                 LOG_ERROR_FMT("[Worker] ERROR: av_read_frame failed: %d (%s)\n", read_ret, err_buf);
                 av_packet_unref(packet_ptr_);
-                return false;
+                return -1;
             }
-        } else {
-            // 成功读取到 packet，退出循环
-            break;
         }
+        
+        // 成功读取到 packet
+        return 1;
+    }
+}
+
+int FfmpegDecodeVideoFileWorker::receiveFrame(Buffer* buffer, AVFrame* frame_ptr) {
+    int ret = avcodec_receive_frame(codec_ctx_ptr_, frame_ptr);
+    if (ret < 0) {
+        return 0;  // EAGAIN / EOF / 错误：需要更多数据
     }
     
-    // 步骤3: 检查是否是视频流
-    if (packet_ptr_->stream_index != video_stream_index_) {
-        // 🔧 修复：不是视频流的packet需要释放，然后继续读取下一个
-        av_packet_unref(packet_ptr_);
-        return false;  // 让调用者再次调用以读取下一个packet
+    // ✅ 成功！提取物理地址（参考 ids_test_video3:2314-2338）
+    uint64_t phys_addr = 0;
+    uint32_t blk_id = 0;
+    
+    if (frame_ptr->metadata) {
+        AVDictionaryEntry* entry = av_dict_get(frame_ptr->metadata, "pool_blk_id", NULL, 0);
+        if (entry) {
+            blk_id = (uint32_t)atoi(entry->value);
+            phys_addr = taco_sys_handle2_phys_addr(blk_id);
+            
+            // 🎯 保存物理地址到 Buffer
+            buffer->setPhysicalAddress(phys_addr);
+        }
     }
     
-    // 步骤4: 发送 packet 到解码器（参考 ids_test_video3:2270）
-    int ret = avcodec_send_packet(codec_ctx_ptr_, packet_ptr_);
+    if (phys_addr == 0) {
+        LOG_WARN_FMT("[Worker]  Warning: Failed to extract physical address");
+        return -1;
+    }
     
-    // 🔧 修复：无论成功与否，都要释放packet引用
-    // avcodec_send_packet 会复制数据，不再需要原始packet
-    av_packet_unref(packet_ptr_);
+    // ⭐ v2.7改进：先更新虚拟地址为实际数据地址（frame->data[0]）
+    buffer->setVirtualAddress(frame_ptr->data[0]);
     
-    if (ret < 0) {
-        LOG_ERROR_FMT("[Worker] ERROR: avcodec_send_packet failed: %d", ret);
+    // ⭐ v2.6新增：从AVFrame设置图像元数据到Buffer
+    buffer->setImageMetadataFromAVFrame(frame_ptr);
+    
+    // 第一遍解码：按顺序记录到解码帧缓存
+    if (frame_cache_uptr_ && frame_cache_uptr_->getState() == DecodedFrameCache::State::RECORDING) {
+        frame_cache_uptr_->recordMiss();
+        frame_cache_uptr_->record(frame_ptr);
+    }
+    if (spill_pending_) {
+        spillFrame(frame_ptr);
+    }
+    
+    decoded_frames_++;
+    current_frame_index_++;
+    return 1;
+}
+
+bool FfmpegDecodeVideoFileWorker::decodeNextFrame(Buffer* buffer) {
+    AVFrame* frame_ptr = buffer ? buffer->getAVFrame() : nullptr;
+    if (!frame_ptr) {
+        LOG_ERROR_FMT("[Worker] ERROR: buffer->getAVFrame() is nullptr");
         return false;
     }
-    bool recv_frm = false;
-    // 步骤5: 🎯 循环调用 receive_frame，直到成功或需要更多数据（参考 ids_test_video3:2276-2354）
-    while (true) {
-        ret = avcodec_receive_frame(codec_ctx_ptr_, frame_ptr);
-        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF || ret < 0) {
-            break;
-        } 
-        // ✅ 成功！提取物理地址（参考 ids_test_video3:2314-2338）
-        uint64_t phys_addr = 0;
-        uint32_t blk_id = 0;
-        
-        if (frame_ptr->metadata) {
-            AVDictionaryEntry* entry = av_dict_get(frame_ptr->metadata, "pool_blk_id", NULL, 0);
-            if (entry) {
-                blk_id = (uint32_t)atoi(entry->value);
-                phys_addr = taco_sys_handle2_phys_addr(blk_id);
-                
-                // 🎯 保存物理地址到 Buffer
-                buffer->setPhysicalAddress(phys_addr);
-            }
+    
+    // 片段已完整缓存：不读取 packet，直接从缓存取帧
+    if (frame_cache_uptr_ && frame_cache_uptr_->isComplete()) {
+        return fillFromCache(buffer);
+    }
+    
+    // 先取解码器中已解出的帧（一个 packet 可能解出多帧，逐帧交给后续 buffer），
+    // 没有时再送入下一个视频 packet（跳过其他流的 packet）
+    int got = receiveFrame(buffer, frame_ptr);
+    while (got == 0) {
+        if (readPacket() <= 0) {
+            return false;
         }
-        
-        if (phys_addr == 0) {
-            LOG_WARN_FMT("[Worker]  Warning: Failed to extract physical address");
+        if (packet_ptr_->stream_index != video_stream_index_) {
+            av_packet_unref(packet_ptr_);
+            continue;
+        }
+        int ret = avcodec_send_packet(codec_ctx_ptr_, packet_ptr_);
+        av_packet_unref(packet_ptr_);
+        if (ret < 0) {
+            LOG_ERROR_FMT("[Worker] ERROR: avcodec_send_packet failed: %d", ret);
             return false;
         }
+        got = receiveFrame(buffer, frame_ptr);
+    }
+    return got > 0;
+}
+
+// ============================================================================
+// raw 缓存文件
+// ============================================================================
+
+uint64_t FfmpegDecodeVideoFileWorker::spillFingerprint(const WorkerConfig& config) {
+    const auto& taco = config.decoder.taco;
+    std::string key = config.file.file_path;
+    key += "|" + config.decoder.name.value_or("") + (config.decoder.enable_hardware ? "|hw" : "|sw");
+    key += "|" + std::to_string(config.output.width) + "x" + std::to_string(config.output.height) +
+           "@" + std::to_string(config.output.bits_per_pixel);
+    if (config.decoder.name.value_or("") == "h264_taco") {
+        key += "|" + std::to_string(taco.ch0_enable) + std::to_string(taco.ch1_enable) +
+               std::to_string(taco.ch1_rgb) + taco.ch1_rgb_format + taco.ch1_rgb_std;
+        key += "|" + std::to_string(taco.ch1_crop_x) + "," + std::to_string(taco.ch1_crop_y) + "," +
+               std::to_string(taco.ch1_crop_width) + "," + std::to_string(taco.ch1_crop_height);
+        key += "|" + std::to_string(taco.ch1_scale_width) + "x" + std::to_string(taco.ch1_scale_height);
+    }
+    return productionline::io::RawFrameFile::fingerprint(key);
+}
+
+bool FfmpegDecodeVideoFileWorker::isSpillFileValid(const WorkerConfig& config,
+                                                   productionline::io::RawFrameFileInfo* info) {
+    if (!config.cache.isSpillEnabled()) {
+        return false;
+    }
+    productionline::io::RawFrameFileInfo spill;
+    uint64_t source_size = 0;
+    int64_t source_mtime_ns = 0;
+    if (!productionline::io::RawFrameFile::readInfo(config.cache.spill_path.c_str(), &spill) ||
+        !productionline::io::RawFrameFile::statSource(config.file.file_path.c_str(), &source_size, &source_mtime_ns)) {
+        return false;
+    }
+    if (spill.source_size != source_size || spill.source_mtime_ns != source_mtime_ns ||
+        spill.source_fingerprint != spillFingerprint(config)) {
+        LOG_DEBUG_FMT("[Worker] Spill file '%s' is stale, will be rewritten", config.cache.spill_path.c_str());
+        return false;
+    }
+    if (info) {
+        *info = std::move(spill);
+    }
+    return true;
+}
+
+void FfmpegDecodeVideoFileWorker::spillFrame(const AVFrame* frame) {
+    AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+    
+    // 第一帧：确定几何并创建临时文件
+    if (!spill_writer_uptr_) {
+        productionline::io::RawFrameFileInfo info;
+        info.width = frame->width;
+        info.height = frame->height;
+        info.pixel_format = frame->format;
+        if (!productionline::io::RawFrameFile::setImageLayout(&info)) {
+            abortSpill("frames are not CPU accessible");
+            return;
+        }
+        info.frame_alignment = productionline::io::RawFrameFile::kDataAlignment;   // 读者可用 O_DIRECT
+        info.frame_rate = getFrameRate();
+        info.source_fingerprint = spillFingerprint(worker_config_);
+        if (!productionline::io::RawFrameFile::statSource(file_path_.c_str(), &info.source_size, &info.source_mtime_ns)) {
+            abortSpill("cannot stat source file");
+            return;
+        }
         
-        // ⭐ v2.7改进：先更新虚拟地址为实际数据地址（frame->data[0]）
-        buffer->setVirtualAddress(frame_ptr->data[0]);
-        
-        // ⭐ v2.6新增：从AVFrame设置图像元数据到Buffer
-        buffer->setImageMetadataFromAVFrame(frame_ptr);
-        
-        decoded_frames_++;
-        current_frame_index_++;
-        recv_frm = true;
+        spill_writer_uptr_ = std::make_unique<productionline::io::RawFrameFileWriter>();
+        if (!spill_writer_uptr_->open(worker_config_.cache.spill_path.c_str(), info)) {
+            abortSpill("cannot create spill file");
+            return;
+        }
+        spill_scratch_.resize(info.frame_size);
+        LOG_INFO_FMT("[Worker] Writing spill file '%s' (%dx%d, %zu bytes/frame)",
+                     worker_config_.cache.spill_path.c_str(), info.width, info.height, info.frame_size);
+    }
+    
+    int frame_bytes = av_image_get_buffer_size(format, frame->width, frame->height, 1);
+    if (frame_bytes != static_cast<int>(spill_scratch_.size())) {
+        abortSpill("frame geometry changed mid-stream");
+        return;
+    }
+    // 不走 FrameCopy：scratch 每帧复用且马上由 pwrite 读出，流式存储会让这次读取落到内存
+    if (av_image_copy_to_buffer(spill_scratch_.data(), frame_bytes, frame->data, frame->linesize,
+                                format, frame->width, frame->height, 1) < 0 ||
+        !spill_writer_uptr_->writeFrame(spill_scratch_.data())) {
+        abortSpill("write failed");
+    }
+}
+
+void FfmpegDecodeVideoFileWorker::abortSpill(const char* reason) {
+    if (reason && spill_pending_) {
+        LOG_WARN_FMT("[Worker]  Spill file '%s' abandoned: %s", worker_config_.cache.spill_path.c_str(), reason);
     }
-    return recv_frm;
+    spill_pending_ = false;
+    spill_writer_uptr_.reset();   // 析构时删除临时文件
+    spill_scratch_.clear();
+    spill_scratch_.shrink_to_fit();
+}
+
+bool FfmpegDecodeVideoFileWorker::fillFromCache(Buffer* buffer) {
+    if (current_frame_index_ >= frame_cache_uptr_->getFrameCount()) {
+        // 与解码路径一致：到达片段末尾只设置 EOF 标志，循环由 ProductionLine 决定
+        eof_reached_ = true;
+        return false;
+    }
+    
+    AVFrame* frame_ptr = buffer->getAVFrame();
+    if (!frame_cache_uptr_->fetch(current_frame_index_, frame_ptr)) {
+        decode_errors_++;
+        return false;
+    }
+    
+    // 缓存帧位于普通内存，没有物理地址
+    buffer->setPhysicalAddress(0);
+    buffer->setVirtualAddress(frame_ptr->data[0]);
+    buffer->setImageMetadataFromAVFrame(frame_ptr);
+    
+    current_frame_index_++;
+    return true;
 }
 
 // ============================================================================
@@ -755,5 +1006,16 @@ void FfmpegDecodeVideoFileWorker::printStats() const {
     LOG_INFO_FMT("[Worker]    Decoded frames: %d", decoded_frames_.load());
     LOG_INFO_FMT("[Worker]    Decode errors: %d", decode_errors_.load());
     LOG_INFO_FMT("[Worker]    EOF: %s", eof_reached_ ? "YES" : "NO");
+    if (worker_config_.cache.isSpillEnabled()) {
+        LOG_INFO_FMT("[Worker]    Spill file: %s (%s)", worker_config_.cache.spill_path.c_str(),
+                     spill_writer_uptr_ ? "writing" : (spill_pending_ ? "pending" : "idle"));
+    }
+    DecodedFrameCache::Stats cache;
+    if (getFrameCacheStats(&cache)) {
+        LOG_INFO_FMT("[Worker]    Frame cache: %s, %d frames, %.1f/%.1f MB, hit rate %.1f%%",
+                     DecodedFrameCache::stateName(cache.state), cache.frames,
+                     cache.memory_bytes / (1024.0 * 1024.0), cache.budget_bytes / (1024.0 * 1024.0),
+                     cache.hitRate() * 100.0);
+    }
 }
 
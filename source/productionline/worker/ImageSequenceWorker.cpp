@@ -0,0 +1,762 @@
+#include "productionline/worker/ImageSequenceWorker.hpp"
+#include "common/Logger.hpp"
+#include "common/FrameCopy.hpp"
+#include "productionline/io/RawFrameFile.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kStagingAlignment = 4096;
+
+/**
+ * 自然排序：数字段按数值比较（frame_2 < frame_10），其余按字节比较
+ */
+bool naturalLess(const std::string& a, const std::string& b) {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (isdigit(static_cast<unsigned char>(a[i])) && isdigit(static_cast<unsigned char>(b[j]))) {
+            size_t a_end = i;
+            size_t b_end = j;
+            while (a_end < a.size() && isdigit(static_cast<unsigned char>(a[a_end]))) a_end++;
+            while (b_end < b.size() && isdigit(static_cast<unsigned char>(b[b_end]))) b_end++;
+    
+            // 去掉前导零后先比位数，再逐位比较
+            while (i + 1 < a_end && a[i] == '0') i++;
+            while (j + 1 < b_end && b[j] == '0') j++;
+            if (a_end - i != b_end - j) {
+                return a_end - i < b_end - j;
+            }
+            int cmp = a.compare(i, a_end - i, b, j, b_end - j);
+            if (cmp != 0) {
+                return cmp < 0;
+            }
+            i = a_end;
+            j = b_end;
+        } else {
+            if (a[i] != b[j]) {
+                return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[j]);
+            }
+            i++;
+            j++;
+        }
+    }
+    return a.size() - i < b.size() - j;
+}
+
+/**
+ * printf 模式是否恰好包含一个整数转换（%d / %i / %u，可带标志和宽度，如 %06d）
+ */
+bool isFramePattern(const char* pattern) {
+    int conversions = 0;
+    for (const char* p = pattern; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+        p++;
+        while (*p && strchr("0-+ #", *p)) p++;
+        while (*p && isdigit(static_cast<unsigned char>(*p))) p++;
+        if (!*p || !strchr("diu", *p)) {
+            return false;
+        }
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+bool isRegularFile(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+void* chainData(int slot, int op) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(slot) << 2 | static_cast<uintptr_t>(op));
+}
+
+} // namespace
+
+// ============ 构造/析构 ============
+
+ImageSequenceWorker::ImageSequenceWorker()
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(0)
+    , frame_size_(0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , total_frames_(0)
+    , current_frame_index_(0)
+    , is_open_(false)
+    , ring_()
+    , ring_ready_(false)
+    , prefetch_depth_(0)
+    , prefetch_hits_(0)
+    , prefetch_misses_(0)
+{
+}
+
+ImageSequenceWorker::ImageSequenceWorker(const WorkerConfig& config)
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL, config)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(0)
+    , frame_size_(0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , total_frames_(0)
+    , current_frame_index_(0)
+    , is_open_(false)
+    , ring_()
+    , ring_ready_(false)
+    , prefetch_depth_(0)
+    , prefetch_hits_(0)
+    , prefetch_misses_(0)
+{
+}
+
+ImageSequenceWorker::~ImageSequenceWorker() {
+    close();
+}
+
+// ============ IVideoReader 接口实现 ============
+
+bool ImageSequenceWorker::open(const char* /*path*/) {
+    LOG_ERROR_FMT("[Worker] ERROR: ImageSequenceWorker needs the frame geometry");
+    LOG_ERROR("   Please use open(path, width, height, bits_per_pixel) for image sequences");
+    return false;
+}
+
+bool ImageSequenceWorker::open(const char* path, int width, int height, int bits_per_pixel) {
+    if (is_open_) {
+        LOG_WARN_FMT("[Worker]  Warning: Sequence already opened, closing previous sequence");
+        close();
+    }
+    
+    if (!configureFormat(width, height, bits_per_pixel)) {
+        return false;
+    }
+    
+    LOG_INFO_FMT("📂 Opening image sequence: %s", path);
+    if (!resolveFiles(path)) {
+        return false;
+    }
+    path_ = path;
+    total_frames_ = static_cast<int>(files_.size());
+    
+    LOG_INFO_FMT("   Format: %dx%d, %d bits per pixel, %d planes", width_, height_, bits_per_pixel_, plane_count_);
+    LOG_INFO_FMT("   Frame size: %zu bytes", frame_size_);
+    LOG_INFO_FMT("   Files: %d (%s ... %s)", total_frames_, files_.front().c_str(), files_.back().c_str());
+    
+    if (!initPrefetch()) {
+        LOG_WARN_FMT("[Worker]  Warning: io_uring open/read chains unavailable, reading files synchronously");
+    }
+    
+    if (!createBufferPool()) {
+        cleanupPrefetch();
+        files_.clear();
+        total_frames_ = 0;
+        return false;
+    }
+    
+    is_open_ = true;
+    current_frame_index_ = 0;
+    prefetch_hits_ = 0;
+    prefetch_misses_ = 0;
+    
+    LOG_DEBUG_FMT("[Worker] Image sequence opened successfully");
+    LOG_INFO_FMT("   Prefetch: %s", ring_ready_ ? "io_uring" : "disabled");
+    if (ring_ready_) {
+        LOG_INFO_FMT("   Prefetch depth: %d files", prefetch_depth_);
+    }
+    
+    return true;
+}
+
+void ImageSequenceWorker::close() {
+    if (!is_open_) {
+        return;
+    }
+    
+    cleanupPrefetch();
+    
+    // v2.0: BufferPool 生命周期由 Allocator 管理，只清除ID
+    buffer_pool_id_ = 0;
+    files_.clear();
+    total_frames_ = 0;
+    
+    is_open_ = false;
+    current_frame_index_ = 0;
+    
+    LOG_DEBUG_FMT("[Worker] Image sequence closed: %s (prefetch hits %lu, misses %lu)",
+                  path_.c_str(), prefetch_hits_, prefetch_misses_);
+}
+
+bool ImageSequenceWorker::isOpen() const {
+    return is_open_;
+}
+
+bool ImageSequenceWorker::seek(int frame_index) {
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Sequence not opened");
+        return false;
+    }
+    
+    if (frame_index < 0 || frame_index >= total_frames_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
+               frame_index, total_frames_ - 1);
+        return false;
+    }
+    
+    current_frame_index_ = frame_index;
+    return true;
+}
+
+bool ImageSequenceWorker::seekToBegin() {
+    return seek(0);
+}
+
+bool ImageSequenceWorker::seekToEnd() {
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Sequence not opened");
+        return false;
+    }
+    
+    current_frame_index_ = total_frames_;
+    return true;
+}
+
+bool ImageSequenceWorker::skip(int frame_count) {
+    int target_frame = current_frame_index_ + frame_count;
+    return seek(target_frame);
+}
+
+int ImageSequenceWorker::getTotalFrames() const {
+    return total_frames_;
+}
+
+int ImageSequenceWorker::getCurrentFrameIndex() const {
+    return current_frame_index_;
+}
+
+size_t ImageSequenceWorker::getFrameSize() const {
+    return frame_size_;
+}
+
+long ImageSequenceWorker::getFileSize() const {
+    // 每个文件只读取一帧：按读取的总字节数计算
+    return static_cast<long>(frame_size_ * total_frames_);
+}
+
+int ImageSequenceWorker::getWidth() const {
+    return width_;
+}
+
+int ImageSequenceWorker::getHeight() const {
+    return height_;
+}
+
+int ImageSequenceWorker::getBytesPerPixel() const {
+    return (bits_per_pixel_ + 7) / 8;
+}
+
+const char* ImageSequenceWorker::getPath() const {
+    return path_.c_str();
+}
+
+bool ImageSequenceWorker::hasMoreFrames() const {
+    return current_frame_index_ < total_frames_;
+}
+
+bool ImageSequenceWorker::isAtEnd() const {
+    return current_frame_index_ >= total_frames_;
+}
+
+double ImageSequenceWorker::getFrameRate() const {
+    return 0.0;
+}
+
+// ============================================================================
+// 核心功能：填充Buffer
+// ============================================================================
+
+bool ImageSequenceWorker::fillBuffer(int frame_index, Buffer* buffer) {
+    if (!buffer || !buffer->data()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid buffer");
+        return false;
+    }
+    
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
+        return false;
+    }
+    
+    if (frame_index < 0 || frame_index >= total_frames_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
+               frame_index, total_frames_ - 1);
+        return false;
+    }
+    
+    if (buffer->size() < frame_size_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small (need %zu, got %zu)\n",
+               frame_size_, buffer->size());
+        return false;
+    }
+    
+    uint8_t* dst = static_cast<uint8_t*>(buffer->data());
+    if (!ring_ready_) {
+        if (!readFileSync(frame_index, dst)) {
+            return false;
+        }
+        setMetadata(buffer);
+        return true;
+    }
+    
+    // 查找预取槽（未命中时当场提交该帧的链），等待链完成后固定该槽
+    Slot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slot = findSlot(frame_index);
+        if (slot) {
+            prefetch_hits_++;
+        } else {
+            prefetch_misses_++;
+            slot = queueChain(frame_index, frame_index);
+        }
+    
+        if (slot && slot->pending_ops > 0) {
+            // 未命中新准备的链，或之前提交失败留在队列中的链
+            int ret = io_uring_submit(&ring_);
+            if (ret < 0) {
+                LOG_ERROR_FMT("[Worker] ERROR: io_uring_submit failed: %s", strerror(-ret));
+                return false;
+            }
+        }
+    
+        if (slot) {
+            while (slot->pending_ops > 0) {
+                if (!reapOne()) {
+                    return false;
+                }
+            }
+            slot->pins++;
+        }
+    }
+    
+    // 拷贝在锁外进行：其他生产者可以同时取自己的槽
+    bool ok = false;
+    if (slot && slot->ready) {
+        FrameCopy::getInstance().copy(dst, slot->data, frame_size_);
+        ok = true;
+    } else {
+        if (slot) {
+            LOG_WARN_FMT("[Worker]  Warning: Prefetch of '%s' failed (%s), retrying synchronously",
+                         files_[frame_index].c_str(), strerror(slot->error));
+        }
+        ok = readFileSync(frame_index, dst);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slot) {
+            slot->pins--;
+            if (!slot->ready) {
+                slot->frame_index = -1;   // 失败的槽不保留，下次重新读取
+            }
+        }
+        prefetchAfter(frame_index);
+    }
+    
+    if (!ok) {
+        return false;
+    }
+    setMetadata(buffer);
+    return true;
+}
+
+// ============ 内部辅助方法 ============
+
+bool ImageSequenceWorker::configureFormat(int width, int height, int bits_per_pixel) {
+    const int pixel_format = worker_config_.output.pixel_format;
+    if (width <= 0 || height <= 0 || (bits_per_pixel <= 0 && pixel_format < 0)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid parameters");
+        LOG_INFO_FMT("   width=%d, height=%d, bits_per_pixel=%d\n",
+               width, height, bits_per_pixel);
+        return false;
+    }
+    
+    width_ = width;
+    height_ = height;
+    bits_per_pixel_ = bits_per_pixel;
+    pixel_format_ = -1;
+    plane_count_ = 0;
+    
+    if (pixel_format >= 0) {
+        // 已知像素格式：按紧凑 plane 布局计算帧大小，填充时设置 Buffer 图像元数据
+        productionline::io::RawFrameFileInfo layout;
+        layout.width = width;
+        layout.height = height;
+        layout.pixel_format = pixel_format;
+        if (!productionline::io::RawFrameFile::setImageLayout(&layout)) {
+            LOG_ERROR_FMT("[Worker] ERROR: Unsupported raw pixel format %d", pixel_format);
+            return false;
+        }
+        pixel_format_ = pixel_format;
+        plane_count_ = layout.plane_count;
+        memcpy(linesize_, layout.linesize, sizeof(linesize_));
+        memcpy(plane_offset_, layout.plane_offset, sizeof(plane_offset_));
+        bits_per_pixel_ = layout.bits_per_pixel;
+        frame_size_ = layout.frame_size;
+    } else {
+        size_t total_bits = (size_t)width_ * height_ * bits_per_pixel_;
+        frame_size_ = (total_bits + 7) / 8;
+    }
+    return true;
+}
+
+bool ImageSequenceWorker::resolveFiles(const char* path) {
+    files_.clear();
+    
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+        DIR* dir = opendir(path);
+        if (!dir) {
+            LOG_ERROR_FMT("[Worker] ERROR: Cannot open directory '%s': %s", path, strerror(errno));
+            return false;
+        }
+        std::string prefix(path);
+        if (prefix.back() != '/') {
+            prefix += '/';
+        }
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (entry->d_name[0] == '.') {
+                continue;   // . / .. / 隐藏文件
+            }
+            std::string file = prefix + entry->d_name;
+            if (entry->d_type == DT_REG ||
+                ((entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) && isRegularFile(file))) {
+                files_.push_back(std::move(file));
+            }
+        }
+        closedir(dir);
+        std::sort(files_.begin(), files_.end(), naturalLess);
+    } else if (strchr(path, '%')) {
+        if (!isFramePattern(path)) {
+            LOG_ERROR_FMT("[Worker] ERROR: '%s' must contain exactly one integer conversion (e.g. %%06d)", path);
+            return false;
+        }
+        char name[4096];
+        int first = 0;
+        snprintf(name, sizeof(name), path, 0);
+        if (!isRegularFile(name)) {
+            first = 1;
+        }
+        for (int i = first; ; i++) {
+            if (snprintf(name, sizeof(name), path, i) >= static_cast<int>(sizeof(name)) || !isRegularFile(name)) {
+                break;
+            }
+            files_.push_back(name);
+        }
+    } else {
+        LOG_ERROR_FMT("[Worker] ERROR: '%s' is neither a directory nor a printf pattern", path);
+        return false;
+    }
+    
+    if (files_.empty()) {
+        LOG_ERROR_FMT("[Worker] ERROR: No frame files found for '%s'", path);
+        return false;
+    }
+    return true;
+}
+
+bool ImageSequenceWorker::initPrefetch() {
+    // 槽数 = depth + 1：当前帧之后的 depth 帧预取时，当前帧的槽仍在窗口内
+    prefetch_depth_ = std::max(1, std::min(worker_config_.file.readahead_depth, kMaxPrefetchDepth));
+    int slot_count = std::min(prefetch_depth_ + 1, total_frames_);
+    
+    int ret = io_uring_queue_init(static_cast<unsigned>(slot_count * 3), &ring_, 0);
+    if (ret < 0) {
+        LOG_DEBUG_FMT("[Worker] io_uring_queue_init failed: %s", strerror(-ret));
+        return false;
+    }
+    
+    struct io_uring_probe* probe = io_uring_get_probe_ring(&ring_);
+    bool supported = probe && io_uring_opcode_supported(probe, IORING_OP_OPENAT) &&
+                     io_uring_opcode_supported(probe, IORING_OP_READ) &&
+                     io_uring_opcode_supported(probe, IORING_OP_CLOSE);
+    if (probe) {
+        io_uring_free_probe(probe);
+    }
+    
+    // 空的直接描述符表（-1）：openat 把文件装入槽号对应的位置，close 再移除，不占用进程 fd
+    std::vector<int> empty_files(slot_count, -1);
+    if (!supported || io_uring_register_files(&ring_, empty_files.data(), slot_count) < 0) {
+        io_uring_queue_exit(&ring_);
+        return false;
+    }
+    // opcode 探测只说明有 OPENAT：打开到直接描述符要 5.15，旧内核上每条链都会失败
+    if (!probeDirectOpen()) {
+        io_uring_unregister_files(&ring_);
+        io_uring_queue_exit(&ring_);
+        return false;
+    }
+    
+    size_t stride = (frame_size_ + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+    staging_.assign(stride * slot_count + kStagingAlignment, 0);
+    uintptr_t base = reinterpret_cast<uintptr_t>(staging_.data());
+    uint8_t* aligned = staging_.data() + ((kStagingAlignment - (base & (kStagingAlignment - 1))) & (kStagingAlignment - 1));
+    
+    slots_.assign(slot_count, Slot());
+    for (int i = 0; i < slot_count; i++) {
+        slots_[i].data = aligned + stride * i;
+    }
+    ring_ready_ = true;
+    return true;
+}
+
+bool ImageSequenceWorker::probeDirectOpen() {
+    // 每一步只提交一个 SQE 并等待它完成
+    auto run_one = [this](int* res) {
+        int ret;
+        do {
+            ret = io_uring_submit(&ring_);
+        } while (ret == -EINTR);
+        if (ret != 1) {
+            return false;
+        }
+        struct io_uring_cqe* cqe;
+        do {
+            ret = io_uring_wait_cqe(&ring_, &cqe);
+        } while (ret == -EINTR);
+        if (ret < 0) {
+            return false;
+        }
+        *res = cqe->res;
+        io_uring_cqe_seen(&ring_, cqe);
+        return true;
+    };
+    
+    int res = -1;
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+    io_uring_prep_openat_direct(sqe, AT_FDCWD, files_[0].c_str(), O_RDONLY, 0, 0);
+    if (!run_one(&res)) {
+        return false;
+    }
+    // 直接描述符成功时返回 0；不认识 file_index 的旧内核打开普通 fd（> 0）或返回 -EINVAL
+    if (res != 0) {
+        if (res > 0) {
+            ::close(res);
+        }
+        LOG_DEBUG_FMT("[Worker] io_uring openat_direct unsupported (result %d)", res);
+        return false;
+    }
+    
+    sqe = io_uring_get_sqe(&ring_);
+    io_uring_prep_close_direct(sqe, 0);
+    return run_one(&res) && res == 0;
+}
+
+void ImageSequenceWorker::cleanupPrefetch() {
+    if (!ring_ready_) {
+        return;
+    }
+    
+    // 等待在途的链结束（读取目标是暂存区）
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& slot : slots_) {
+            while (slot.pending_ops > 0 && reapOne()) {
+            }
+        }
+    }
+    io_uring_unregister_files(&ring_);
+    io_uring_queue_exit(&ring_);
+    ring_ready_ = false;
+    slots_.clear();
+    staging_.clear();
+    staging_.shrink_to_fit();
+}
+
+ImageSequenceWorker::Slot* ImageSequenceWorker::findSlot(int frame_index) {
+    for (auto& slot : slots_) {
+        if (slot.frame_index == frame_index) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+bool ImageSequenceWorker::inWindow(int frame_index, int base) const {
+    int distance = (frame_index - base + total_frames_) % total_frames_;
+    return distance <= prefetch_depth_;
+}
+
+ImageSequenceWorker::Slot* ImageSequenceWorker::queueChain(int frame_index, int base) {
+    // 优先用空槽，其次替换窗口外的旧帧；在途或正在拷贝的槽不可替换
+    Slot* victim = nullptr;
+    for (auto& slot : slots_) {
+        if (slot.pending_ops > 0 || slot.pins > 0) {
+            continue;
+        }
+        if (slot.frame_index < 0) {
+            victim = &slot;
+            break;
+        }
+        if (!victim && !inWindow(slot.frame_index, base)) {
+            victim = &slot;
+        }
+    }
+    if (!victim || io_uring_sq_space_left(&ring_) < 3) {
+        return nullptr;
+    }
+    
+    int index = static_cast<int>(victim - slots_.data());
+    
+    // openat 失败时后续操作被取消；read 用硬链接，读短时 close 仍然执行
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+    io_uring_prep_openat_direct(sqe, AT_FDCWD, files_[frame_index].c_str(), O_RDONLY, 0, index);
+    io_uring_sqe_set_flags(sqe, IOSQE_IO_LINK);
+    io_uring_sqe_set_data(sqe, chainData(index, OP_OPEN));
+    
+    sqe = io_uring_get_sqe(&ring_);
+    io_uring_prep_read(sqe, index, victim->data, static_cast<unsigned>(frame_size_), 0);
+    io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK);
+    io_uring_sqe_set_data(sqe, chainData(index, OP_READ));
+    
+    sqe = io_uring_get_sqe(&ring_);
+    io_uring_prep_close_direct(sqe, index);
+    io_uring_sqe_set_data(sqe, chainData(index, OP_CLOSE));
+    
+    victim->frame_index = frame_index;
+    victim->pending_ops = 3;
+    victim->ready = false;
+    victim->error = 0;
+    return victim;
+}
+
+bool ImageSequenceWorker::reapOne() {
+    struct io_uring_cqe* cqe;
+    int ret;
+    do {
+        ret = io_uring_wait_cqe(&ring_, &cqe);
+    } while (ret == -EINTR);
+    if (ret < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: io_uring_wait_cqe failed: %s", strerror(-ret));
+        return false;
+    }
+    
+    uintptr_t data = reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(&ring_, cqe);
+    
+    Slot& slot = slots_[data >> 2];
+    int op = static_cast<int>(data & 3);
+    
+    // 只记录第一个错误（openat 失败后 read / close 的 ECANCELED 不覆盖它）；close 的结果不影响数据
+    if (op != OP_CLOSE && slot.error == 0) {
+        if (res < 0) {
+            slot.error = -res;
+        } else if (op == OP_READ && static_cast<size_t>(res) < frame_size_) {
+            slot.error = ENODATA;   // 文件小于一帧
+        }
+    }
+    if (--slot.pending_ops == 0) {
+        slot.ready = slot.error == 0;
+    }
+    return true;
+}
+
+void ImageSequenceWorker::prefetchAfter(int base) {
+    int queued = 0;
+    for (int k = 1; k <= prefetch_depth_ && k < total_frames_; k++) {
+        int frame_index = (base + k) % total_frames_;
+        if (findSlot(frame_index)) {
+            continue;
+        }
+        if (!queueChain(frame_index, base)) {
+            break;
+        }
+        queued++;
+    }
+    
+    if (queued > 0) {
+        int ret = io_uring_submit(&ring_);
+        if (ret < 0) {
+            LOG_WARN_FMT("[Worker]  Warning: io_uring_submit failed: %s", strerror(-ret));
+        }
+    }
+}
+
+bool ImageSequenceWorker::readFileSync(int frame_index, uint8_t* dst) const {
+    const std::string& file = files_[frame_index];
+    int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Cannot open '%s': %s", file.c_str(), strerror(errno));
+        return false;
+    }
+    
+    size_t done = 0;
+    while (done < frame_size_) {
+        ssize_t n = pread(fd, dst + done, frame_size_ - done, static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    
+    if (done < frame_size_) {
+        LOG_ERROR_FMT("[Worker] ERROR: '%s' is smaller than one frame (got %zu, expected %zu)",
+                      file.c_str(), done, frame_size_);
+        return false;
+    }
+    return true;
+}
+
+void ImageSequenceWorker::setMetadata(Buffer* buffer) const {
+    if (plane_count_ > 0) {
+        buffer->setImageMetadata(width_, height_, static_cast<AVPixelFormat>(pixel_format_),
+                                 linesize_, plane_offset_, plane_count_);
+    }
+}
+
+bool ImageSequenceWorker::createBufferPool() {
+    // 🎯 Worker职责：在open()时自动创建BufferPool（通过调用Allocator）
+    int buffer_count = 4;
+    
+    buffer_pool_id_ = allocateOutputPool(
+        buffer_count,
+        frame_size_,
+        std::string("ImageSequenceWorker_") + path_,
+        "Video"
+    );
+    
+    if (buffer_pool_id_ == 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Failed to create BufferPool via Allocator");
+        return false;
+    }
+    
+    LOG_DEBUG_FMT("[Worker]    BufferPool: ID %lu, %d buffers, %zu bytes each",
+                  buffer_pool_id_, buffer_count, frame_size_);
+    return true;
+}
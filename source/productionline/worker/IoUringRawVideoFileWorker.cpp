@@ -1,18 +1,22 @@
 #include "productionline/worker/IoUringRawVideoFileWorker.hpp"
 #include "common/Logger.hpp"
+#include "productionline/io/RawFrameFile.hpp"
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <algorithm>
 
 // ============ 构造/析构 ============
 
 IoUringRawVideoFileWorker::IoUringRawVideoFileWorker(int queue_depth)
-    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL)  // 🎯 只需传递类型！
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::PAGE_ALIGNED)  // 页对齐 Buffer，可用 O_DIRECT
     , queue_depth_(queue_depth)
     , initialized_(false)
     , video_fd_(-1)
+    , direct_fd_(-1)
     , frame_size_(0)
     , file_size_(0)
     , total_frames_(0)
@@ -20,18 +24,26 @@ IoUringRawVideoFileWorker::IoUringRawVideoFileWorker(int queue_depth)
     , width_(0)
     , height_(0)
     , bits_per_pixel_(0)
+    , frame_rate_(0.0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , crop_()
     , is_open_(false)
+    , last_read_error_(0)
 {
-    // 🎯 父类已经创建好 NORMAL 类型的 allocator_facade_，无需任何初始化代码
+    // 🎯 父类已经创建好 PAGE_ALIGNED 类型的 allocator_facade_，无需任何初始化代码
     // io_uring 延迟初始化，在 open() 时初始化
 }
 
 // v2.2: 配置构造函数（新增）
 IoUringRawVideoFileWorker::IoUringRawVideoFileWorker(const WorkerConfig& config, int queue_depth)
-    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL, config)  // 传递 config 给父类
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::PAGE_ALIGNED, config)  // 传递 config 给父类
     , queue_depth_(queue_depth)
     , initialized_(false)
     , video_fd_(-1)
+    , direct_fd_(-1)
     , frame_size_(0)
     , file_size_(0)
     , total_frames_(0)
@@ -39,7 +51,14 @@ IoUringRawVideoFileWorker::IoUringRawVideoFileWorker(const WorkerConfig& config,
     , width_(0)
     , height_(0)
     , bits_per_pixel_(0)
+    , frame_rate_(0.0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , crop_()
     , is_open_(false)
+    , last_read_error_(0)
 {
     // io_uring 延迟初始化，在 open() 时初始化
 }
@@ -51,9 +70,69 @@ IoUringRawVideoFileWorker::~IoUringRawVideoFileWorker() {
 // ============ IVideoReader 接口实现 ============
 
 bool IoUringRawVideoFileWorker::open(const char* path) {
-    LOG_ERROR_FMT("[Worker] ERROR: IoUringVideoReader does not support auto-detect format");
-    LOG_ERROR("   Please use open(path, width, height, bits_per_pixel) for raw video files");
-    return false;
+    if (is_open_) {
+        LOG_WARN_FMT("[Worker]  Warning: File already opened, closing previous file");
+        close();
+    }
+    
+    if (!productionline::io::RawFrameFile::isRawFrameFile(path)) {
+        LOG_ERROR_FMT("[Worker] ERROR: IoUringVideoReader only auto-detects RawFrameFile containers");
+        LOG_ERROR("   Please use open(path, width, height, bits_per_pixel) for raw video files");
+        return false;
+    }
+    
+    LOG_INFO_FMT("📂 Opening RawFrameFile: %s", path);
+    
+    video_fd_ = ::open(path, O_RDONLY);
+    if (video_fd_ < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Cannot open file: %s", strerror(errno));
+        return false;
+    }
+    
+    productionline::io::RawFrameFileInfo info;
+    if (!productionline::io::RawFrameFile::readInfo(video_fd_, &info)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid or incomplete RawFrameFile header");
+        ::close(video_fd_);
+        video_fd_ = -1;
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(video_fd_, &st) < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Cannot get file size: %s", strerror(errno));
+        ::close(video_fd_);
+        video_fd_ = -1;
+        return false;
+    }
+    
+    video_path_ = path;
+    width_ = info.width;
+    height_ = info.height;
+    bits_per_pixel_ = info.bits_per_pixel;
+    frame_size_ = info.frame_size;
+    frame_rate_ = info.frame_rate;
+    file_size_ = st.st_size;
+    total_frames_ = info.frame_count;
+    frame_offsets_ = std::move(info.frame_offsets);
+    pixel_format_ = info.pixel_format;
+    plane_count_ = info.plane_count;
+    memcpy(linesize_, info.linesize, sizeof(linesize_));
+    memcpy(plane_offset_, info.plane_offset, sizeof(plane_offset_));
+    
+    // 帧按页对齐：额外打开 O_DIRECT 描述符（tmpfs 等不支持时 open 失败，只用普通读取）
+    if (info.frame_alignment >= productionline::io::RawFrameFile::kDataAlignment) {
+        direct_fd_ = ::open(path, O_RDONLY | O_DIRECT);
+        if (direct_fd_ < 0) {
+            LOG_DEBUG_FMT("[Worker] O_DIRECT unavailable for '%s': %s", path, strerror(errno));
+        }
+    }
+    
+    LOG_INFO_FMT("   Format: %dx%d, %d bits per pixel, %d planes", width_, height_, bits_per_pixel_, plane_count_);
+    LOG_INFO_FMT("   Frame size: %zu bytes", frame_size_);
+    LOG_INFO_FMT("   Direct I/O: %s", direct_fd_ >= 0 ? "enabled" : "disabled");
+    LOG_INFO_FMT("   Queue depth: %d", queue_depth_);
+    
+    return finishOpen();
 }
 
 bool IoUringRawVideoFileWorker::open(const char* path, int width, int height, int bits_per_pixel) {
@@ -62,7 +141,8 @@ bool IoUringRawVideoFileWorker::open(const char* path, int width, int height, in
         close();
     }
     
-    if (width <= 0 || height <= 0 || bits_per_pixel <= 0) {
+    const int pixel_format = worker_config_.output.pixel_format;
+    if (width <= 0 || height <= 0 || (bits_per_pixel <= 0 && pixel_format < 0)) {
         LOG_ERROR_FMT("[Worker] ERROR: Invalid parameters");
         return false;
     }
@@ -71,11 +151,37 @@ bool IoUringRawVideoFileWorker::open(const char* path, int width, int height, in
     width_ = width;
     height_ = height;
     bits_per_pixel_ = bits_per_pixel;
-    
-    frame_size_ = (size_t)width * height * (bits_per_pixel / 8);
+    frame_rate_ = 0.0;
+    frame_offsets_.clear();
+    plane_count_ = 0;
+    pixel_format_ = -1;
+    
+    if (pixel_format >= 0) {
+        // 已知像素格式：按紧凑 plane 布局计算帧大小，填充时设置 Buffer 图像元数据
+        productionline::io::RawFrameFileInfo layout;
+        layout.width = width;
+        layout.height = height;
+        layout.pixel_format = pixel_format;
+        if (!productionline::io::RawFrameFile::setImageLayout(&layout)) {
+            LOG_ERROR_FMT("[Worker] ERROR: Unsupported raw pixel format %d", pixel_format);
+            return false;
+        }
+        if (bits_per_pixel > 0 && bits_per_pixel != layout.bits_per_pixel) {
+            LOG_WARN_FMT("[Worker]  Warning: bits_per_pixel %d ignored, pixel format %d uses %d",
+                         bits_per_pixel, pixel_format, layout.bits_per_pixel);
+        }
+        pixel_format_ = pixel_format;
+        plane_count_ = layout.plane_count;
+        memcpy(linesize_, layout.linesize, sizeof(linesize_));
+        memcpy(plane_offset_, layout.plane_offset, sizeof(plane_offset_));
+        bits_per_pixel_ = layout.bits_per_pixel;
+        frame_size_ = layout.frame_size;
+    } else {
+        frame_size_ = (size_t)width * height * (bits_per_pixel / 8);
+    }
     
     LOG_INFO_FMT("📂 Opening raw video file: %s", path);
-    LOG_INFO_FMT("   Format: %dx%d, %d bits per pixel", width, height, bits_per_pixel);
+    LOG_INFO_FMT("   Format: %dx%d, %d bits per pixel, %d planes", width, height, bits_per_pixel_, plane_count_);
     LOG_INFO_FMT("   Frame size: %zu bytes", frame_size_);
     LOG_INFO("   Reader: IoUringVideoReader (async I/O)");
     LOG_INFO_FMT("   Queue depth: %d", queue_depth_);
@@ -106,22 +212,71 @@ bool IoUringRawVideoFileWorker::open(const char* path, int width, int height, in
         return false;
     }
     
+    return finishOpen();
+}
+
+bool IoUringRawVideoFileWorker::finishOpen() {
+    // ROI 行段不按页对齐：裁剪时不使用 O_DIRECT
+    if (!configureRoi()) {
+        ::close(video_fd_);
+        video_fd_ = -1;
+        if (direct_fd_ >= 0) {
+            ::close(direct_fd_);
+            direct_fd_ = -1;
+        }
+        return false;
+    }
+    if (crop_.isEnabled() && direct_fd_ >= 0) {
+        ::close(direct_fd_);
+        direct_fd_ = -1;
+    }
+    
     // 初始化 io_uring
     int ret = io_uring_queue_init(queue_depth_, &ring_, 0);
     if (ret < 0) {
         LOG_ERROR_FMT("[Worker] ERROR: io_uring_queue_init failed: %s", strerror(-ret));
         ::close(video_fd_);
         video_fd_ = -1;
+        if (direct_fd_ >= 0) {
+            ::close(direct_fd_);
+            direct_fd_ = -1;
+        }
         return false;
     }
-    
     initialized_ = true;
+    
+    // 🎯 Worker职责：在open()时自动创建BufferPool（通过调用Allocator）
+    // O_DIRECT 读取整页，Buffer 按页向上取整
+    int buffer_count = 4;
+    size_t buffer_size = direct_fd_ >= 0 ? directReadSize() : getOutputFrameSize();
+    buffer_pool_id_ = allocateOutputPool(
+        buffer_count,
+        buffer_size,
+        std::string("IoUringRawVideoFileWorker_") + video_path_,
+        "Video"
+    );
+    if (buffer_pool_id_ == 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Failed to create BufferPool via Allocator");
+        io_uring_queue_exit(&ring_);
+        initialized_ = false;
+        ::close(video_fd_);
+        video_fd_ = -1;
+        if (direct_fd_ >= 0) {
+            ::close(direct_fd_);
+            direct_fd_ = -1;
+        }
+        return false;
+    }
+    
     is_open_ = true;
     current_frame_index_ = 0;
+    last_read_error_ = 0;
     
     LOG_DEBUG_FMT("[Worker] Raw video file opened successfully");
     LOG_INFO_FMT("   File size: %ld bytes", file_size_);
     LOG_INFO_FMT("   Total frames: %d", total_frames_);
+    LOG_DEBUG_FMT("[Worker]    BufferPool: ID %lu, %d buffers, %zu bytes each",
+                  buffer_pool_id_, buffer_count, buffer_size);
     
     return true;
 }
@@ -141,6 +296,20 @@ void IoUringRawVideoFileWorker::close() {
         video_fd_ = -1;
     }
     
+    if (direct_fd_ >= 0) {
+        ::close(direct_fd_);
+        direct_fd_ = -1;
+    }
+    
+    // v2.0: BufferPool 生命周期由 Allocator 管理，只清除ID
+    buffer_pool_id_ = 0;
+    frame_offsets_.clear();
+    crop_.reset();
+    crop_reads_.clear();
+    crop_iov_dst_.clear();
+    crop_iovecs_.clear();
+    crop_sink_.clear();
+    
     is_open_ = false;
     current_frame_index_ = 0;
     
@@ -191,7 +360,7 @@ int IoUringRawVideoFileWorker::getCurrentFrameIndex() const {
 }
 
 size_t IoUringRawVideoFileWorker::getFrameSize() const {
-    return frame_size_;
+    return getOutputFrameSize();
 }
 
 long IoUringRawVideoFileWorker::getFileSize() const {
@@ -199,11 +368,11 @@ long IoUringRawVideoFileWorker::getFileSize() const {
 }
 
 int IoUringRawVideoFileWorker::getWidth() const {
-    return width_;
+    return crop_.isEnabled() ? crop_.getLayout().width : width_;
 }
 
 int IoUringRawVideoFileWorker::getHeight() const {
-    return height_;
+    return crop_.isEnabled() ? crop_.getLayout().height : height_;
 }
 
 int IoUringRawVideoFileWorker::getBytesPerPixel() const {
@@ -222,40 +391,116 @@ bool IoUringRawVideoFileWorker::isAtEnd() const {
     return current_frame_index_ >= total_frames_;
 }
 
+double IoUringRawVideoFileWorker::getFrameRate() const {
+    return frame_rate_;
+}
+
 // ============================================================================
 // 核心功能：填充Buffer
 // ============================================================================
 
 bool IoUringRawVideoFileWorker::fillBuffer(int frame_index, Buffer* buffer) {
-    if (!buffer || !buffer->data()) {
-        LOG_ERROR_FMT("[Worker] ERROR: Invalid buffer");
+    if (!checkFillRequest(frame_index, buffer)) {
         return false;
     }
     
-    if (!is_open_) {
-        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
-        return false;
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    
+    // ROI：readv 只读区域内的行段
+    if (crop_.isEnabled()) {
+        if (!readCropped(frame_index, buffer)) {
+            return false;
+        }
+        applyImageMetadata(buffer);
+        return true;
     }
     
-    if (frame_index < 0 || frame_index >= total_frames_) {
-        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
-               frame_index, total_frames_ - 1);
+    // O_DIRECT 要求 Buffer 地址和读取长度都按页对齐（外部 Buffer 不满足时走普通读取）
+    bool direct = canReadDirect(buffer);
+    
+    // 使用io_uring异步读取，等待完成
+    bool ok = readSync(frame_index, buffer->data(), buffer->size(), direct);
+    if (!ok && direct && last_read_error_ == EINVAL) {
+        LOG_WARN_FMT("[Worker]  Warning: O_DIRECT read rejected, falling back to buffered reads");
+        ::close(direct_fd_);
+        direct_fd_ = -1;
+        ok = readSync(frame_index, buffer->data(), buffer->size(), false);
+    }
+    if (!ok) {
         return false;
     }
     
-    if (buffer->size() < frame_size_) {
-        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small (need %zu, got %zu)\n", 
-               frame_size_, buffer->size());
-        return false;
+    applyImageMetadata(buffer);
+    return true;
+}
+
+int IoUringRawVideoFileWorker::fillBuffers(FillRequest* requests, int count) {
+    // ROI：每帧本身已是一批 readv，逐帧处理
+    if (crop_.isEnabled()) {
+        return WorkerBase::fillBuffers(requests, count);
     }
     
-    // 使用io_uring异步读取
-    if (!submitReadRequest(frame_index, buffer->data(), buffer->size())) {
-        return false;
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    
+    int filled = 0;
+    int next = 0;
+    std::vector<FillRequest*> rejected;  // O_DIRECT 被拒绝的请求（改为普通读取重试）
+    while (next < count) {
+        // 每批最多 queue_depth_ 个读取，一次提交后等齐完成事件
+        int inflight = 0;
+        for (; next < count && inflight < queue_depth_; next++) {
+            FillRequest* request = &requests[next];
+            request->filled = false;
+            if (!checkFillRequest(request->frame_index, request->buffer)) {
+                continue;
+            }
+            if (prepareRead(request->frame_index, request->buffer->data(), request->buffer->size(),
+                            canReadDirect(request->buffer), request)) {
+                inflight++;
+            }
+        }
+        if (inflight == 0) {
+            continue;
+        }
+        
+        // 提交失败时已完成的读取照常收割，未完成的请求保持 filled=false
+        bool reaped = submitAndReap(inflight);
+        for (const Completion& completion : completions_) {
+            FillRequest* request = static_cast<FillRequest*>(completion.user_data);
+            last_read_error_ = completion.res < 0 ? -completion.res : 0;
+            if (completion.res == -EINVAL && direct_fd_ >= 0) {
+                rejected.push_back(request);
+            } else if (completion.res < 0) {
+                LOG_ERROR_FMT("[Worker] ERROR: Read failed: %s", strerror(-completion.res));
+            } else if (static_cast<size_t>(completion.res) < frame_size_) {
+                LOG_ERROR_FMT("[Worker] ERROR: Incomplete read: got %d bytes, expected %zu",
+                              completion.res, frame_size_);
+            } else {
+                applyImageMetadata(request->buffer);
+                request->filled = true;
+                filled++;
+            }
+        }
+        if (!reaped) {
+            return filled;
+        }
     }
     
-    // 等待完成
-    return waitForCompletion();
+    // O_DIRECT 被拒绝：之后都走普通读取，本批被拒绝的帧逐个重读
+    if (!rejected.empty()) {
+        LOG_WARN_FMT("[Worker]  Warning: O_DIRECT read rejected, falling back to buffered reads");
+        ::close(direct_fd_);
+        direct_fd_ = -1;
+        for (FillRequest* request : rejected) {
+            Buffer* buffer = request->buffer;
+            if (readSync(request->frame_index, buffer->data(), buffer->size(), false)) {
+                applyImageMetadata(buffer);
+                request->filled = true;
+                filled++;
+            }
+        }
+    }
+    return filled;
 }
 
 // ============ IoUring 专有接口（保留原有功能）TODO: 需要重新实现 ============
@@ -276,14 +521,230 @@ int IoUringRawVideoFileWorker::submitBatchReads(BufferPool* pool,
 
 // ============ 内部辅助方法实现 ============
 
-bool IoUringRawVideoFileWorker::submitReadRequest(int frame_index, void* buffer, size_t buffer_size) {
+bool IoUringRawVideoFileWorker::configureRoi() {
+    crop_.reset();
+    crop_reads_.clear();
+    crop_iov_dst_.clear();
+    crop_iovecs_.clear();
+    crop_sink_.clear();
+    
+    const WorkerConfig::OutputConfig& output = worker_config_.output;
+    if (!output.hasRoi()) {
+        return true;
+    }
+    
+    productionline::io::RawFrameFileInfo source;
+    source.width = width_;
+    source.height = height_;
+    source.pixel_format = pixel_format_;
+    source.bits_per_pixel = bits_per_pixel_;
+    source.frame_size = frame_size_;
+    source.plane_count = plane_count_;
+    memcpy(source.linesize, linesize_, sizeof(linesize_));
+    memcpy(source.plane_offset, plane_offset_, sizeof(plane_offset_));
+    
+    if (!crop_.configure(source, output.roi_x, output.roi_y, output.roi_width, output.roi_height)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid ROI %d,%d %dx%d for %dx%d frames",
+                      output.roi_x, output.roi_y, output.roi_width, output.roi_height, width_, height_);
+        return false;
+    }
+    
+    // 每个 plane：连续的 ROI 行（间隔读入丢弃区）合成一个 readv；
+    // 间隔过大时每行单独一个读取，不为丢弃的字节付出带宽
+    size_t max_gap = 0;
+    for (int i = 0; i < crop_.getPlaneCount(); i++) {
+        const productionline::io::FrameCrop::Plane& plane = crop_.getPlane(i);
+        size_t gap = plane.src_stride - plane.row_bytes;
+        
+        if (gap == 0) {
+            // 整行宽度：plane 内的 ROI 是一段连续字节
+            CropRead read;
+            read.offset = plane.src_offset;
+            read.first_iov = static_cast<int>(crop_iov_dst_.size());
+            read.iov_count = 1;
+            read.length = plane.row_bytes * plane.rows;
+            addCropIovec(plane.dst_offset, read.length);
+            crop_reads_.push_back(read);
+            continue;
+        }
+        
+        int rows_per_read = gap > kMaxSkipBytes ? 1 : kMaxRowsPerRead;
+        if (rows_per_read > 1) {
+            max_gap = std::max(max_gap, gap);
+        }
+        for (int row = 0; row < plane.rows; row += rows_per_read) {
+            int rows = std::min(rows_per_read, plane.rows - row);
+            CropRead read;
+            read.offset = plane.src_offset + static_cast<uint64_t>(row) * plane.src_stride;
+            read.first_iov = static_cast<int>(crop_iov_dst_.size());
+            for (int r = 0; r < rows; r++) {
+                if (r > 0) {
+                    addCropIovec(SIZE_MAX, gap);
+                    read.length += gap;
+                }
+                addCropIovec(plane.dst_offset + static_cast<size_t>(row + r) * plane.row_bytes, plane.row_bytes);
+                read.length += plane.row_bytes;
+            }
+            read.iov_count = static_cast<int>(crop_iov_dst_.size()) - read.first_iov;
+            crop_reads_.push_back(read);
+        }
+    }
+    crop_sink_.resize(max_gap);
+    
+    // 丢弃区 iovec 的地址固定，只有 Buffer 内的 iovec 需要每帧设置地址
+    for (size_t i = 0; i < crop_iov_dst_.size(); i++) {
+        if (crop_iov_dst_[i] == SIZE_MAX) {
+            crop_iovecs_[i].iov_base = crop_sink_.data();
+        }
+    }
+    
+    LOG_INFO_FMT("   ROI: %dx%d at %d,%d (%zu of %zu bytes per frame, %zu reads)",
+                 crop_.getLayout().width, crop_.getLayout().height, output.roi_x, output.roi_y,
+                 crop_.getLayout().frame_size, frame_size_, crop_reads_.size());
+    return true;
+}
+
+void IoUringRawVideoFileWorker::addCropIovec(size_t dst_offset, size_t length) {
+    struct iovec iov;
+    iov.iov_base = nullptr;
+    iov.iov_len = length;
+    crop_iovecs_.push_back(iov);
+    crop_iov_dst_.push_back(dst_offset);
+}
+
+size_t IoUringRawVideoFileWorker::getOutputFrameSize() const {
+    return crop_.isEnabled() ? crop_.getLayout().frame_size : frame_size_;
+}
+
+bool IoUringRawVideoFileWorker::readCropped(int frame_index, Buffer* buffer) {
+    if (!initialized_ || video_fd_ < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: IoUring not initialized or file not open");
+        return false;
+    }
+    
+    uint64_t frame_offset = frame_offsets_.empty() ? static_cast<uint64_t>(frame_index) * frame_size_
+                                                   : frame_offsets_[frame_index];
+    uint8_t* dst = static_cast<uint8_t*>(buffer->data());
+    for (size_t i = 0; i < crop_iovecs_.size(); i++) {
+        if (crop_iov_dst_[i] != SIZE_MAX) {
+            crop_iovecs_[i].iov_base = dst + crop_iov_dst_[i];
+        }
+    }
+    last_read_error_ = 0;
+    
+    // 每批最多 queue_depth_ 个 readv，一次提交后等齐完成事件
+    size_t next = 0;
+    while (next < crop_reads_.size()) {
+        int batch = 0;
+        while (next < crop_reads_.size() && batch < queue_depth_) {
+            struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+            if (!sqe) {
+                break;
+            }
+            CropRead* read = &crop_reads_[next];
+            io_uring_prep_readv(sqe, video_fd_, &crop_iovecs_[read->first_iov], read->iov_count,
+                                frame_offset + read->offset);
+            io_uring_sqe_set_data(sqe, read);
+            next++;
+            batch++;
+        }
+        if (batch == 0) {
+            LOG_ERROR_FMT("[Worker] ERROR: Failed to get SQE from io_uring");
+            return false;
+        }
+        
+        bool ok = submitAndReap(batch);
+        for (const Completion& completion : completions_) {
+            const CropRead* read = static_cast<const CropRead*>(completion.user_data);
+            if (completion.res < 0) {
+                last_read_error_ = -completion.res;
+                LOG_ERROR_FMT("[Worker] ERROR: ROI read failed: %s", strerror(-completion.res));
+                ok = false;
+            } else if (static_cast<size_t>(completion.res) != read->length) {
+                LOG_ERROR_FMT("[Worker] ERROR: Incomplete ROI read: got %d bytes, expected %zu",
+                              completion.res, read->length);
+                ok = false;
+            }
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IoUringRawVideoFileWorker::checkFillRequest(int frame_index, Buffer* buffer) const {
+    if (!buffer || !buffer->data()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid buffer");
+        return false;
+    }
+    
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
+        return false;
+    }
+    
+    if (frame_index < 0 || frame_index >= total_frames_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
+               frame_index, total_frames_ - 1);
+        return false;
+    }
+    
+    if (buffer->size() < getOutputFrameSize()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small (need %zu, got %zu)\n", 
+               getOutputFrameSize(), buffer->size());
+        return false;
+    }
+    
+    return true;
+}
+
+bool IoUringRawVideoFileWorker::canReadDirect(const Buffer* buffer) const {
+    return direct_fd_ >= 0 &&
+           reinterpret_cast<uintptr_t>(buffer->data()) % productionline::io::RawFrameFile::kDataAlignment == 0 &&
+           buffer->size() >= directReadSize();
+}
+
+void IoUringRawVideoFileWorker::applyImageMetadata(Buffer* buffer) const {
+    if (crop_.isEnabled()) {
+        const productionline::io::RawFrameFileInfo& layout = crop_.getLayout();
+        if (layout.plane_count > 0) {
+            buffer->setImageMetadata(layout.width, layout.height, static_cast<AVPixelFormat>(layout.pixel_format),
+                                     layout.linesize, layout.plane_offset, layout.plane_count);
+        }
+        return;
+    }
+    
+    // RawFrameFile 自带像素格式和 plane 布局：下游（BufferWriter、显示）无需额外参数
+    if (plane_count_ > 0) {
+        buffer->setImageMetadata(width_, height_, static_cast<AVPixelFormat>(pixel_format_),
+                                 linesize_, plane_offset_, plane_count_);
+    }
+}
+
+size_t IoUringRawVideoFileWorker::directReadSize() const {
+    size_t page = productionline::io::RawFrameFile::kDataAlignment;
+    return (frame_size_ + page - 1) & ~(page - 1);
+}
+
+bool IoUringRawVideoFileWorker::prepareRead(int frame_index, void* buffer, size_t buffer_size, bool direct,
+                                            void* user_data) {
     if (!initialized_ || video_fd_ < 0) {
         LOG_ERROR_FMT("[Worker] ERROR: IoUring not initialized or file not open");
         return false;
     }
     
-    // 计算文件偏移量
-    off_t offset = static_cast<off_t>(frame_index) * frame_size_;
+    // 计算文件偏移量（RawFrameFile 使用帧索引）
+    off_t offset = frame_offsets_.empty() ? static_cast<off_t>(frame_index) * frame_size_
+                                          : static_cast<off_t>(frame_offsets_[frame_index]);
+    
+    // O_DIRECT 读取整页（最后一帧可能在文件末尾读短，完成时只要求 frame_size_ 字节）
+    int fd = direct ? direct_fd_ : video_fd_;
+    size_t length = direct ? directReadSize() : frame_size_;
+    if (length > buffer_size) {
+        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small for read (need %zu, got %zu)", length, buffer_size);
+        return false;
+    }
     
     // 获取 SQE（Submission Queue Entry）
     struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
@@ -293,49 +754,93 @@ bool IoUringRawVideoFileWorker::submitReadRequest(int frame_index, void* buffer,
     }
     
     // 准备读取请求
-    io_uring_prep_read(sqe, video_fd_, buffer, frame_size_, offset);
-    io_uring_sqe_set_data(sqe, buffer);  // 设置用户数据
-    
-    // 提交请求
-    int ret = io_uring_submit(&ring_);
-    if (ret < 0) {
-        LOG_ERROR_FMT("[Worker] ERROR: io_uring_submit failed: %s", strerror(-ret));
-        return false;
-    }
-    
+    io_uring_prep_read(sqe, fd, buffer, length, offset);
+    io_uring_sqe_set_data(sqe, user_data);  // 设置用户数据
     return true;
 }
 
-bool IoUringRawVideoFileWorker::waitForCompletion() {
-    if (!initialized_) {
-        LOG_ERROR_FMT("[Worker] ERROR: IoUring not initialized");
+bool IoUringRawVideoFileWorker::readSync(int frame_index, void* buffer, size_t buffer_size, bool direct) {
+    if (!prepareRead(frame_index, buffer, buffer_size, direct, buffer)) {
         return false;
     }
     
-    // 等待完成事件
-    struct io_uring_cqe* cqe;
-    int ret = io_uring_wait_cqe(&ring_, &cqe);
-    if (ret < 0) {
-        LOG_ERROR_FMT("[Worker] ERROR: io_uring_wait_cqe failed: %s", strerror(-ret));
+    if (!submitAndReap(1)) {
         return false;
     }
     
     // 检查读取结果
-    if (cqe->res < 0) {
-        LOG_ERROR_FMT("[Worker] ERROR: Read failed: %s", strerror(-cqe->res));
-        io_uring_cqe_seen(&ring_, cqe);
+    int res = completions_[0].res;
+    last_read_error_ = res < 0 ? -res : 0;
+    if (res < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Read failed: %s", strerror(-res));
         return false;
     }
     
-    if ((size_t)cqe->res != frame_size_) {
-        LOG_ERROR_FMT("[Worker] ERROR: Incomplete read: got %d bytes, expected %zu", 
-               cqe->res, frame_size_);
-        io_uring_cqe_seen(&ring_, cqe);
+    if (static_cast<size_t>(res) < frame_size_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Incomplete read: got %d bytes, expected %zu", res, frame_size_);
         return false;
     }
     
-    // 标记CQE已处理
-    io_uring_cqe_seen(&ring_, cqe);
-    
     return true;
 }
+
+bool IoUringRawVideoFileWorker::submitAndReap(int count) {
+    completions_.clear();
+    int pending = count;   // 已准备、尚未被内核接收的 SQE
+    int inflight = 0;      // 已提交、尚未收割的请求
+    int error = 0;
+    while (pending > 0 || inflight > 0) {
+        if (pending > 0) {
+            int ret = io_uring_submit(&ring_);
+            if (ret == -EINTR) {
+                continue;
+            }
+            if (ret > 0) {
+                pending -= ret;
+                inflight += ret;
+            } else if (inflight == 0) {
+                // 没有可收割的请求腾出空间，无法继续提交
+                error = ret < 0 ? -ret : EAGAIN;
+                LOG_ERROR_FMT("[Worker] ERROR: io_uring_submit failed: %s", strerror(error));
+                break;
+            }
+            // 部分提交（或 EAGAIN/EBUSY）：先收割一个完成事件再提交剩余的 SQE
+        }
+        if (inflight == 0) {
+            continue;
+        }
+        
+        struct io_uring_cqe* cqe;
+        int ret = io_uring_wait_cqe(&ring_, &cqe);
+        if (ret == -EINTR) {
+            continue;
+        }
+        if (ret < 0) {
+            error = -ret;
+            LOG_ERROR_FMT("[Worker] ERROR: io_uring_wait_cqe failed: %s", strerror(error));
+            break;
+        }
+        Completion completion;
+        completion.user_data = io_uring_cqe_get_data(cqe);
+        completion.res = cqe->res;
+        completions_.push_back(completion);
+        io_uring_cqe_seen(&ring_, cqe);
+        inflight--;
+    }
+    
+    // SQ 中残留的 SQE 和未收割的请求仍引用调用方的 user_data，重建 ring 丢弃，之后不会再被提交或收割
+    if (pending > 0 || inflight > 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Dropping %d unsubmitted and %d in-flight reads", pending, inflight);
+        resetRing();
+    }
+    return error == 0;
+}
+
+void IoUringRawVideoFileWorker::resetRing() {
+    io_uring_queue_exit(&ring_);
+    int ret = io_uring_queue_init(queue_depth_, &ring_, 0);
+    if (ret < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: io_uring_queue_init failed: %s", strerror(-ret));
+        initialized_ = false;
+    }
+}
@@ -1,5 +1,9 @@
 #include "productionline/worker/MmapRawVideoFileWorker.hpp"
 #include "common/Logger.hpp"
+#include "common/FrameCopy.hpp"
+#include "productionline/io/RawFrameFile.hpp"
+#include "productionline/io/H264AnnexBIndex.hpp"
+#include "productionline/io/Mp4SampleTable.hpp"
 #include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -7,6 +11,21 @@
 #include <sys/mman.h>
 #include <string.h>
 #include <errno.h>
+#include <algorithm>
+#include <chrono>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/mem.h>
+}
+
+namespace {
+
+// 映射区由 Worker 持有到 close()，AVPacket 只借用
+void noopFree(void* /*opaque*/, uint8_t* /*data*/) {
+}
+
+} // namespace
 
 // ============ 构造函数 ============
 
@@ -19,9 +38,23 @@ MmapRawVideoFileWorker::MmapRawVideoFileWorker()
     , height_(0)
     , bits_per_pixel_(0)
     , frame_size_(0)
+    , frame_rate_(0.0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , crop_()
     , file_size_(0)
     , total_frames_(0)
     , current_frame_index_(0)
+    , codec_ctx_ptr_(nullptr)
+    , packet_ptr_(nullptr)
+    , frame_ptr_(nullptr)
+    , next_sample_(0)
+    , next_output_index_(0)
+    , draining_(false)
+    , pending_decodes_(0)
+    , populate_supported_(true)
     , is_open_(false)
     , detected_format_(FileFormat::UNKNOWN)
 {
@@ -39,9 +72,23 @@ MmapRawVideoFileWorker::MmapRawVideoFileWorker(const WorkerConfig& config)
     , height_(0)
     , bits_per_pixel_(0)
     , frame_size_(0)
+    , frame_rate_(0.0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , crop_()
     , file_size_(0)
     , total_frames_(0)
     , current_frame_index_(0)
+    , codec_ctx_ptr_(nullptr)
+    , packet_ptr_(nullptr)
+    , frame_ptr_(nullptr)
+    , next_sample_(0)
+    , next_output_index_(0)
+    , draining_(false)
+    , pending_decodes_(0)
+    , populate_supported_(true)
     , is_open_(false)
     , detected_format_(FileFormat::UNKNOWN)
 {
@@ -75,22 +122,16 @@ bool MmapRawVideoFileWorker::open(const char* path) {
     detected_format_ = detectFileFormat();
     
     switch (detected_format_) {
+        case FileFormat::INDEXED:
+            LOG_INFO_FMT("📹 Detected format: RawFrameFile (indexed raw frames)");
+            break;
+            
         case FileFormat::MP4:
             LOG_INFO_FMT("📹 Detected format: MP4");
-            if (!parseMP4Header()) {
-                ::close(fd_);
-                fd_ = -1;
-                return false;
-            }
             break;
             
         case FileFormat::H264:
             LOG_INFO_FMT("📹 Detected format: H.264");
-            if (!parseH264Header()) {
-                ::close(fd_);
-                fd_ = -1;
-                return false;
-            }
             break;
             
         case FileFormat::H265:
@@ -125,12 +166,36 @@ bool MmapRawVideoFileWorker::open(const char* path) {
         return false;
     }
     
+    // 先映射再解析：H.264 / MP4 直接扫描映射区
     if (!mapFile()) {
         ::close(fd_);
         fd_ = -1;
         return false;
     }
     
+    bool parsed = false;
+    switch (detected_format_) {
+        case FileFormat::INDEXED: parsed = parseIndexedHeader(); break;
+        case FileFormat::MP4:     parsed = parseMP4Header(); break;
+        case FileFormat::H264:    parsed = parseH264Header(); break;
+        default: break;
+    }
+    if (!parsed || !configureRoi()) {
+        closeDecoder();
+        unmapFile();
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    
+    if (!createBufferPool()) {
+        closeDecoder();
+        unmapFile();
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    
     is_open_ = true;
     current_frame_index_ = 0;
     
@@ -142,6 +207,7 @@ bool MmapRawVideoFileWorker::open(const char* path) {
         case FileFormat::H264: LOG_INFO_FMT("H.264"); break;
         case FileFormat::H265: LOG_INFO_FMT("H.265"); break;
         case FileFormat::AVI:  LOG_INFO_FMT("AVI"); break;
+        case FileFormat::INDEXED: LOG_INFO_FMT("RawFrameFile"); break;
         default: LOG_INFO_FMT("UNKNOWN"); break;
     }
     LOG_INFO_FMT("   Resolution: %dx%d\n", width_, height_);
@@ -159,7 +225,8 @@ bool MmapRawVideoFileWorker::open(const char* path, int width, int height, int b
         close();
     }
     
-    if (width <= 0 || height <= 0 || bits_per_pixel <= 0) {
+    const int pixel_format = worker_config_.output.pixel_format;
+    if (width <= 0 || height <= 0 || (bits_per_pixel <= 0 && pixel_format < 0)) {
         LOG_ERROR_FMT("[Worker] ERROR: Invalid parameters");
         LOG_INFO_FMT("   width=%d, height=%d, bits_per_pixel=%d\n", 
                width, height, bits_per_pixel);
@@ -167,18 +234,44 @@ bool MmapRawVideoFileWorker::open(const char* path, int width, int height, int b
     }
     
     path_ = path;  // 使用 std::string 自动管理
+    frame_offsets_.clear();
+    frame_rate_ = 0.0;
+    plane_count_ = 0;
+    pixel_format_ = -1;
     width_ = width;
     height_ = height;
     bits_per_pixel_ = bits_per_pixel;
     
-    size_t total_bits = (size_t)width_ * height_ * bits_per_pixel_;
-    frame_size_ = (total_bits + 7) / 8;
+    if (pixel_format >= 0) {
+        // 已知像素格式：按紧凑 plane 布局计算帧大小，填充时设置 Buffer 图像元数据
+        productionline::io::RawFrameFileInfo layout;
+        layout.width = width;
+        layout.height = height;
+        layout.pixel_format = pixel_format;
+        if (!productionline::io::RawFrameFile::setImageLayout(&layout)) {
+            LOG_ERROR_FMT("[Worker] ERROR: Unsupported raw pixel format %d", pixel_format);
+            return false;
+        }
+        if (bits_per_pixel > 0 && bits_per_pixel != layout.bits_per_pixel) {
+            LOG_WARN_FMT("[Worker]  Warning: bits_per_pixel %d ignored, pixel format %d uses %d",
+                         bits_per_pixel, pixel_format, layout.bits_per_pixel);
+        }
+        pixel_format_ = pixel_format;
+        plane_count_ = layout.plane_count;
+        memcpy(linesize_, layout.linesize, sizeof(linesize_));
+        memcpy(plane_offset_, layout.plane_offset, sizeof(plane_offset_));
+        bits_per_pixel_ = layout.bits_per_pixel;
+        frame_size_ = layout.frame_size;
+    } else {
+        size_t total_bits = (size_t)width_ * height_ * bits_per_pixel_;
+        frame_size_ = (total_bits + 7) / 8;
+    }
     
     detected_format_ = FileFormat::RAW;
     
     LOG_INFO_FMT("📂 Opening raw video file: %s\n", path);
-    LOG_INFO_FMT("   Format: %dx%d, %d bits per pixel\n", 
-           width_, height_, bits_per_pixel_);
+    LOG_INFO_FMT("   Format: %dx%d, %d bits per pixel, %d planes\n", 
+           width_, height_, bits_per_pixel_, plane_count_);
     LOG_INFO_FMT("   Frame size: %zu bytes\n", frame_size_);
     LOG_INFO_FMT("   Worker: MmapRawVideoFileWorker (memory-mapped I/O)");
     
@@ -200,6 +293,13 @@ bool MmapRawVideoFileWorker::open(const char* path, int width, int height, int b
         return false;
     }
     
+    if (!configureRoi() || !createBufferPool()) {
+        unmapFile();
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    
     is_open_ = true;
     current_frame_index_ = 0;
     
@@ -215,6 +315,8 @@ void MmapRawVideoFileWorker::close() {
         return;
     }
     
+    // 解码器可能仍引用映射区中的数据，先于 munmap 释放
+    closeDecoder();
     unmapFile();
     
     if (fd_ >= 0) {
@@ -222,6 +324,11 @@ void MmapRawVideoFileWorker::close() {
         fd_ = -1;
     }
     
+    // v2.0: BufferPool 生命周期由 Allocator 管理，只清除ID
+    buffer_pool_id_ = 0;
+    frame_offsets_.clear();
+    crop_.reset();
+    
     is_open_ = false;
     current_frame_index_ = 0;
     
@@ -277,7 +384,7 @@ int MmapRawVideoFileWorker::getCurrentFrameIndex() const {
 }
 
 size_t MmapRawVideoFileWorker::getFrameSize() const {
-    return frame_size_;
+    return getOutputFrameSize();
 }
 
 long MmapRawVideoFileWorker::getFileSize() const {
@@ -285,11 +392,11 @@ long MmapRawVideoFileWorker::getFileSize() const {
 }
 
 int MmapRawVideoFileWorker::getWidth() const {
-    return width_;
+    return crop_.isEnabled() ? crop_.getLayout().width : width_;
 }
 
 int MmapRawVideoFileWorker::getHeight() const {
-    return height_;
+    return crop_.isEnabled() ? crop_.getLayout().height : height_;
 }
 
 int MmapRawVideoFileWorker::getBytesPerPixel() const {
@@ -308,40 +415,61 @@ bool MmapRawVideoFileWorker::isAtEnd() const {
     return current_frame_index_ >= total_frames_;
 }
 
+double MmapRawVideoFileWorker::getFrameRate() const {
+    return frame_rate_;
+}
+
 // ============================================================================
 // 核心功能：填充Buffer
 // ============================================================================
 
 bool MmapRawVideoFileWorker::fillBuffer(int frame_index, Buffer* buffer) {
-    if (!buffer || !buffer->data()) {
-        LOG_ERROR_FMT("[Worker] ERROR: Invalid buffer");
+    if (!checkFillRequest(frame_index, buffer)) {
         return false;
     }
     
-    if (!is_open_) {
-        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
-        return false;
+    // 压缩裸流：解码到 buffer
+    if (codec_ctx_ptr_) {
+        return decodeToBuffer(frame_index, buffer);
     }
     
-    if (frame_index < 0 || frame_index >= total_frames_) {
-        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
-               frame_index, total_frames_ - 1);
-        return false;
-    }
+    return copyFrame(frame_index, buffer);
+}
+
+int MmapRawVideoFileWorker::fillBuffers(FillRequest* requests, int count) {
+    int filled = 0;
     
-    if (buffer->size() < frame_size_) {
-        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small (need %zu, got %zu)\n", 
-               frame_size_, buffer->size());
-        return false;
+    // 压缩裸流：整批只加一次解码锁（解码状态本来就是顺序的）
+    if (codec_ctx_ptr_) {
+        pending_decodes_.fetch_add(1);
+        std::unique_lock<std::mutex> lock(decode_mutex_);
+        for (int i = 0; i < count; i++) {
+            requests[i].filled = false;
+            if (checkFillRequest(requests[i].frame_index, requests[i].buffer)) {
+                waitForDecodeTurn(lock, requests[i].frame_index);
+                requests[i].filled = decodeFrameLocked(requests[i].frame_index, requests[i].buffer);
+                decode_cv_.notify_all();
+            }
+            if (requests[i].filled) {
+                filled++;
+            }
+        }
+        pending_decodes_.fetch_sub(1);
+        return filled;
     }
     
-    // 从mmap区域拷贝数据到buffer
-    size_t frame_offset = (size_t)frame_index * frame_size_;
-    const char* frame_addr = (const char*)mapped_file_ptr_ + frame_offset;
-    
-    memcpy(buffer->data(), frame_addr, frame_size_);
-    
-    return true;
+    // 裸帧：先一次性预取整批帧的页，再逐帧拷贝
+    if (is_open_ && !crop_.isEnabled()) {
+        prefetchFrames(requests, count);
+    }
+    for (int i = 0; i < count; i++) {
+        requests[i].filled = checkFillRequest(requests[i].frame_index, requests[i].buffer) &&
+                             copyFrame(requests[i].frame_index, requests[i].buffer);
+        if (requests[i].filled) {
+            filled++;
+        }
+    }
+    return filled;
 }
 
 // ============ 内部辅助方法 ============
@@ -360,6 +488,11 @@ bool MmapRawVideoFileWorker::validateFile() {
         return false;
     }
     
+    // RawFrameFile / 压缩裸流：帧数和偏移来自映射后解析的索引
+    if (detected_format_ != FileFormat::RAW) {
+        return true;
+    }
+    
     total_frames_ = file_size_ / frame_size_;
     
     if (total_frames_ == 0) {
@@ -386,6 +519,11 @@ MmapRawVideoFileWorker::FileFormat MmapRawVideoFileWorker::detectFileFormat() {
         return FileFormat::UNKNOWN;
     }
     
+    // 检测 RawFrameFile（自描述 raw 帧文件）
+    if (productionline::io::RawFrameFile::hasMagic(header, bytes_read)) {
+        return FileFormat::INDEXED;
+    }
+    
     // 检测 MP4 (ftyp box)
     if (bytes_read >= 8 && 
         header[4] == 0x66 && header[5] == 0x74 && 
@@ -443,15 +581,443 @@ ssize_t MmapRawVideoFileWorker::readFileHeader(unsigned char* header, size_t siz
 }
 
 bool MmapRawVideoFileWorker::parseMP4Header() {
-    LOG_WARN_FMT("[Worker]  MP4 format detected but not yet fully supported");
-    LOG_INFO_FMT("   Please use a tool to extract raw frames, or provide format info");
-    return false;
+    productionline::io::Mp4SampleTable table;
+    if (!table.parse(static_cast<const uint8_t*>(mapped_file_ptr_), mapped_size_)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Cannot build MP4 sample table");
+        return false;
+    }
+    LOG_INFO_FMT("   Video track: %s %dx%d, %zu samples (%d sync)", table.getCodecTag().c_str(),
+                 table.getWidth(), table.getHeight(), table.getSamples().size(), table.getKeyframeCount());
+    
+    samples_ = table.getSamples();
+    int codec_id = table.getCodec() == productionline::io::Mp4SampleTable::Codec::HEVC ? AV_CODEC_ID_HEVC
+                                                                                      : AV_CODEC_ID_H264;
+    if (!openDecoder(codec_id, table.getExtradata())) {
+        return false;
+    }
+    // 容器帧率比码流 VUI 更可靠
+    if (table.getFrameRate() > 0.0) {
+        frame_rate_ = table.getFrameRate();
+    }
+    return true;
 }
 
 bool MmapRawVideoFileWorker::parseH264Header() {
-    LOG_WARN_FMT("[Worker]  H.264 format detected but not yet fully supported");
-    LOG_INFO_FMT("   Please use a tool to extract raw frames, or provide format info");
-    return false;
+    productionline::io::H264AnnexBIndex index;
+    if (!index.build(static_cast<const uint8_t*>(mapped_file_ptr_), mapped_size_)) {
+        LOG_ERROR_FMT("[Worker] ERROR: No H.264 access units found");
+        return false;
+    }
+    if (index.getKeyframeCount() == 0) {
+        LOG_WARN_FMT("[Worker]  Warning: No IDR frame in stream, seeking will decode from the start");
+    }
+    LOG_INFO_FMT("   Access units: %zu (%d NAL units, %d IDR)",
+                 index.getSamples().size(), index.getNalCount(), index.getKeyframeCount());
+    
+    samples_ = index.getSamples();
+    return openDecoder(AV_CODEC_ID_H264);
+}
+
+bool MmapRawVideoFileWorker::parseIndexedHeader() {
+    productionline::io::RawFrameFileInfo info;
+    if (!productionline::io::RawFrameFile::readInfo(fd_, &info)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid or incomplete RawFrameFile header");
+        return false;
+    }
+    
+    width_ = info.width;
+    height_ = info.height;
+    bits_per_pixel_ = info.bits_per_pixel;
+    frame_size_ = info.frame_size;
+    frame_rate_ = info.frame_rate;
+    total_frames_ = info.frame_count;
+    frame_offsets_ = std::move(info.frame_offsets);
+    pixel_format_ = info.pixel_format;
+    plane_count_ = info.plane_count;
+    memcpy(linesize_, info.linesize, sizeof(linesize_));
+    memcpy(plane_offset_, info.plane_offset, sizeof(plane_offset_));
+    return true;
+}
+
+bool MmapRawVideoFileWorker::openDecoder(int codec_id, const std::vector<uint8_t>& extradata) {
+    const AVCodec* codec = avcodec_find_decoder(static_cast<AVCodecID>(codec_id));
+    if (!codec) {
+        LOG_ERROR_FMT("[Worker] ERROR: No decoder for codec id %d", codec_id);
+        return false;
+    }
+    
+    codec_ctx_ptr_ = avcodec_alloc_context3(codec);
+    packet_ptr_ = av_packet_alloc();
+    frame_ptr_ = av_frame_alloc();
+    if (!codec_ctx_ptr_ || !packet_ptr_ || !frame_ptr_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Failed to allocate decoder resources");
+        closeDecoder();
+        return false;
+    }
+    
+    // 长度前缀的 NAL（MP4）需要 avcC / hvcC；extradata 由 avcodec_free_context 释放
+    if (!extradata.empty()) {
+        codec_ctx_ptr_->extradata = static_cast<uint8_t*>(av_mallocz(extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (!codec_ctx_ptr_->extradata) {
+            closeDecoder();
+            return false;
+        }
+        memcpy(codec_ctx_ptr_->extradata, extradata.data(), extradata.size());
+        codec_ctx_ptr_->extradata_size = static_cast<int>(extradata.size());
+    }
+    
+    int ret = avcodec_open2(codec_ctx_ptr_, codec, nullptr);
+    if (ret < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: avcodec_open2 failed (%d)", ret);
+        closeDecoder();
+        return false;
+    }
+    
+    keyframes_.clear();
+    for (size_t i = 0; i < samples_.size(); ++i) {
+        if (samples_[i].keyframe) {
+            keyframes_.push_back(static_cast<int>(i));
+        }
+    }
+    next_sample_ = 0;
+    next_output_index_ = 0;
+    draining_ = false;
+    
+    // 解码第一帧确定输出几何（BufferPool 大小、Buffer 元数据），之后从头开始
+    if (!receiveNextFrame()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Cannot decode first frame (%s)", codec->name);
+        closeDecoder();
+        return false;
+    }
+    
+    productionline::io::RawFrameFileInfo layout;
+    layout.width = frame_ptr_->width;
+    layout.height = frame_ptr_->height;
+    layout.pixel_format = frame_ptr_->format;
+    if (!productionline::io::RawFrameFile::setImageLayout(&layout)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Unsupported decoded pixel format %d", frame_ptr_->format);
+        closeDecoder();
+        return false;
+    }
+    
+    width_ = layout.width;
+    height_ = layout.height;
+    bits_per_pixel_ = layout.bits_per_pixel;
+    frame_size_ = layout.frame_size;
+    pixel_format_ = layout.pixel_format;
+    plane_count_ = layout.plane_count;
+    memcpy(linesize_, layout.linesize, sizeof(linesize_));
+    memcpy(plane_offset_, layout.plane_offset, sizeof(plane_offset_));
+    total_frames_ = static_cast<int>(samples_.size());
+    frame_rate_ = codec_ctx_ptr_->framerate.num > 0 && codec_ctx_ptr_->framerate.den > 0
+                  ? static_cast<double>(codec_ctx_ptr_->framerate.num) / codec_ctx_ptr_->framerate.den
+                  : 0.0;
+    
+    avcodec_flush_buffers(codec_ctx_ptr_);
+    next_sample_ = 0;
+    next_output_index_ = 0;
+    draining_ = false;
+    
+    LOG_INFO_FMT("   Decoder: %s (packets referenced from mapping, no demuxer)", codec->name);
+    return true;
+}
+
+void MmapRawVideoFileWorker::closeDecoder() {
+    if (codec_ctx_ptr_) {
+        avcodec_free_context(&codec_ctx_ptr_);
+    }
+    if (packet_ptr_) {
+        av_packet_free(&packet_ptr_);
+    }
+    if (frame_ptr_) {
+        av_frame_free(&frame_ptr_);
+    }
+    samples_.clear();
+    keyframes_.clear();
+    tail_packet_.clear();
+    tail_packet_.shrink_to_fit();
+    next_sample_ = 0;
+    next_output_index_ = 0;
+    draining_ = false;
+}
+
+bool MmapRawVideoFileWorker::checkFillRequest(int frame_index, Buffer* buffer) const {
+    if (!buffer || !buffer->data()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid buffer");
+        return false;
+    }
+    
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
+        return false;
+    }
+    
+    if (frame_index < 0 || frame_index >= total_frames_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
+               frame_index, total_frames_ - 1);
+        return false;
+    }
+    
+    if (buffer->size() < getOutputFrameSize()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small (need %zu, got %zu)\n", 
+               getOutputFrameSize(), buffer->size());
+        return false;
+    }
+    
+    return true;
+}
+
+bool MmapRawVideoFileWorker::copyFrame(int frame_index, Buffer* buffer) {
+    // 从mmap区域拷贝数据到buffer
+    size_t frame_offset = frame_offsets_.empty() ? (size_t)frame_index * frame_size_
+                                                 : (size_t)frame_offsets_[frame_index];
+    const char* frame_addr = (const char*)mapped_file_ptr_ + frame_offset;
+    
+    // ROI：只拷贝区域内的行段（源行跨度 → 紧凑布局）
+    if (crop_.isEnabled()) {
+        const productionline::io::RawFrameFileInfo& layout = crop_.getLayout();
+        crop_.copy(reinterpret_cast<const uint8_t*>(frame_addr), static_cast<uint8_t*>(buffer->data()));
+        if (layout.plane_count > 0) {
+            buffer->setImageMetadata(layout.width, layout.height, static_cast<AVPixelFormat>(layout.pixel_format),
+                                     layout.linesize, layout.plane_offset, layout.plane_count);
+        }
+        return true;
+    }
+    
+    FrameCopy::getInstance().copy(buffer->data(), frame_addr, frame_size_);
+    
+    // RawFrameFile 自带像素格式和 plane 布局：下游（BufferWriter、显示）无需额外参数
+    if (plane_count_ > 0) {
+        buffer->setImageMetadata(width_, height_, static_cast<AVPixelFormat>(pixel_format_),
+                                 linesize_, plane_offset_, plane_count_);
+    }
+    
+    return true;
+}
+
+void MmapRawVideoFileWorker::prefetchFrames(const FillRequest* requests, int count) {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    
+    // 按帧索引顺序合并相邻帧（CHUNKED 领取时整批通常是一段连续区域），每段一次 madvise
+    size_t run_begin = 0;
+    size_t run_end = 0;
+    for (int i = 0; i <= count; i++) {
+        bool valid = i < count && requests[i].frame_index >= 0 && requests[i].frame_index < total_frames_;
+        size_t begin = 0;
+        if (valid) {
+            int index = requests[i].frame_index;
+            begin = frame_offsets_.empty() ? (size_t)index * frame_size_ : (size_t)frame_offsets_[index];
+            if (run_end > run_begin && begin >= run_begin && begin <= run_end + page) {
+                run_end = std::max(run_end, begin + frame_size_);
+                continue;
+            }
+        }
+        
+        if (run_end > run_begin) {
+            size_t aligned = run_begin & ~(page - 1);
+            void* addr = static_cast<char*>(mapped_file_ptr_) + aligned;
+            size_t length = std::min(run_end, mapped_size_) - aligned;
+            int ret = -1;
+#ifdef MADV_POPULATE_READ
+            if (populate_supported_.load(std::memory_order_relaxed)) {
+                ret = madvise(addr, length, MADV_POPULATE_READ);
+                if (ret < 0 && errno == EINVAL) {
+                    populate_supported_.store(false, std::memory_order_relaxed);
+                }
+            }
+#endif
+            if (ret < 0) {
+                madvise(addr, length, MADV_WILLNEED);
+            }
+        }
+        run_begin = begin;
+        run_end = valid ? begin + frame_size_ : begin;
+    }
+}
+
+bool MmapRawVideoFileWorker::decodeToBuffer(int frame_index, Buffer* buffer) {
+    pending_decodes_.fetch_add(1);
+    std::unique_lock<std::mutex> lock(decode_mutex_);
+    waitForDecodeTurn(lock, frame_index);
+    bool ok = decodeFrameLocked(frame_index, buffer);
+    pending_decodes_.fetch_sub(1);
+    decode_cv_.notify_all();
+    return ok;
+}
+
+void MmapRawVideoFileWorker::waitForDecodeTurn(std::unique_lock<std::mutex>& lock, int frame_index) {
+    // 多生产者时帧索引按序领取、但进入解码锁的顺序不定：前序帧还在排队就先让它解码，
+    // 否则先解码 N 再解码 N-1 会从关键帧重新开始（每次乱序都重解整段 GOP）
+    while (frame_index > next_output_index_ && pending_decodes_.load() > 1) {
+        int waiting_for = next_output_index_;
+        bool progressed = decode_cv_.wait_for(lock, std::chrono::milliseconds(kDecodeOrderWaitMs),
+                                              [this, waiting_for]() { return next_output_index_ != waiting_for; });
+        if (!progressed) {
+            // 前序帧没有在解码（seek / 填充失败 / 排队的都是更后面的帧）：直接跳过去
+            break;
+        }
+    }
+}
+
+bool MmapRawVideoFileWorker::decodeFrameLocked(int frame_index, Buffer* buffer) {
+    // 向后 seek，或目标之前有更近的关键帧：清空解码器，从该关键帧开始
+    auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame_index);
+    int keyframe = it == keyframes_.begin() ? 0 : *(it - 1);
+    if (frame_index < next_output_index_ || keyframe > next_output_index_) {
+        avcodec_flush_buffers(codec_ctx_ptr_);
+        next_sample_ = keyframe;
+        next_output_index_ = keyframe;
+        draining_ = false;
+    }
+    
+    while (next_output_index_ <= frame_index) {
+        if (!receiveNextFrame()) {
+            LOG_ERROR_FMT("[Worker] ERROR: Decoder produced no frame %d", next_output_index_);
+            return false;
+        }
+        next_output_index_++;
+    }
+    
+    if (frame_ptr_->width != width_ || frame_ptr_->height != height_ || frame_ptr_->format != pixel_format_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Frame %d geometry changed (%dx%d)", frame_index,
+                      frame_ptr_->width, frame_ptr_->height);
+        return false;
+    }
+    
+    uint8_t* dst = static_cast<uint8_t*>(buffer->data());
+    
+    // ROI：直接从解码器输出的 plane 拷贝区域内的行段
+    if (crop_.isEnabled()) {
+        const productionline::io::RawFrameFileInfo& layout = crop_.getLayout();
+        crop_.copy(frame_ptr_->data, frame_ptr_->linesize, dst);
+        buffer->setImageMetadata(layout.width, layout.height, static_cast<AVPixelFormat>(layout.pixel_format),
+                                 layout.linesize, layout.plane_offset, layout.plane_count);
+        return true;
+    }
+    
+    // 按 plane 拷贝到紧凑布局（去掉解码器的 linesize 对齐填充）
+    for (int plane = 0; plane < plane_count_; plane++) {
+        if (!frame_ptr_->data[plane] || frame_ptr_->linesize[plane] < linesize_[plane]) {
+            LOG_ERROR_FMT("[Worker] ERROR: Failed to copy decoded frame %d (plane %d)", frame_index, plane);
+            return false;
+        }
+        size_t plane_end = plane + 1 < plane_count_ ? plane_offset_[plane + 1] : frame_size_;
+        int rows = static_cast<int>((plane_end - plane_offset_[plane]) / linesize_[plane]);
+        FrameCopy::getInstance().copyRows(dst + plane_offset_[plane], linesize_[plane],
+                                          frame_ptr_->data[plane], frame_ptr_->linesize[plane],
+                                          linesize_[plane], rows);
+    }
+    
+    buffer->setImageMetadata(width_, height_, static_cast<AVPixelFormat>(pixel_format_),
+                             linesize_, plane_offset_, plane_count_);
+    return true;
+}
+
+bool MmapRawVideoFileWorker::receiveNextFrame() {
+    while (true) {
+        int ret = avcodec_receive_frame(codec_ctx_ptr_, frame_ptr_);
+        if (ret == 0) {
+            return true;
+        }
+        if (ret != AVERROR(EAGAIN)) {
+            return false;   // AVERROR_EOF（已排空）或解码错误
+        }
+        
+        if (next_sample_ < static_cast<int>(samples_.size())) {
+            // 损坏的访问单元跳过，继续送下一个
+            if (!sendSample(next_sample_)) {
+                LOG_DEBUG_FMT("[Worker] Skipping undecodable sample %d", next_sample_);
+            }
+            next_sample_++;
+        } else if (!draining_) {
+            avcodec_send_packet(codec_ctx_ptr_, nullptr);
+            draining_ = true;
+        } else {
+            return false;
+        }
+    }
+}
+
+bool MmapRawVideoFileWorker::sendSample(int index) {
+    const productionline::io::CompressedSample& sample = samples_[index];
+    uint8_t* data = static_cast<uint8_t*>(mapped_file_ptr_) + sample.offset;
+    
+    // 解码器会越界读取最多 AV_INPUT_BUFFER_PADDING_SIZE 字节：映射区内后续的码流即可充当 padding，
+    // 只有文件末尾的 sample 需要复制一份补零（映射区之外不可读）
+    if (sample.offset + sample.size + AV_INPUT_BUFFER_PADDING_SIZE > mapped_size_) {
+        tail_packet_.assign(data, data + sample.size);
+        tail_packet_.resize(sample.size + AV_INPUT_BUFFER_PADDING_SIZE, 0);
+        data = tail_packet_.data();
+    }
+    
+    // 引用计数包装映射区（free 为空操作）：解码器 av_packet_ref 时不会复制数据
+    packet_ptr_->buf = av_buffer_create(data, sample.size, noopFree, nullptr, AV_BUFFER_FLAG_READONLY);
+    if (!packet_ptr_->buf) {
+        return false;
+    }
+    packet_ptr_->data = data;
+    packet_ptr_->size = static_cast<int>(sample.size);
+    packet_ptr_->flags = sample.keyframe ? AV_PKT_FLAG_KEY : 0;
+    
+    int ret = avcodec_send_packet(codec_ctx_ptr_, packet_ptr_);
+    av_packet_unref(packet_ptr_);
+    return ret >= 0;
+}
+
+bool MmapRawVideoFileWorker::configureRoi() {
+    const WorkerConfig::OutputConfig& output = worker_config_.output;
+    if (!output.hasRoi()) {
+        crop_.reset();
+        return true;
+    }
+    
+    productionline::io::RawFrameFileInfo source;
+    source.width = width_;
+    source.height = height_;
+    source.pixel_format = pixel_format_;
+    source.bits_per_pixel = bits_per_pixel_;
+    source.frame_size = frame_size_;
+    source.plane_count = plane_count_;
+    for (int i = 0; i < 4; i++) {
+        source.linesize[i] = linesize_[i];
+        source.plane_offset[i] = plane_offset_[i];
+    }
+    
+    if (!crop_.configure(source, output.roi_x, output.roi_y, output.roi_width, output.roi_height)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid ROI %d,%d %dx%d for %dx%d frames",
+                      output.roi_x, output.roi_y, output.roi_width, output.roi_height, width_, height_);
+        return false;
+    }
+    
+    LOG_INFO_FMT("   ROI: %dx%d at %d,%d (%zu of %zu bytes per frame)\n",
+                 crop_.getLayout().width, crop_.getLayout().height, output.roi_x, output.roi_y,
+                 crop_.getLayout().frame_size, frame_size_);
+    return true;
+}
+
+size_t MmapRawVideoFileWorker::getOutputFrameSize() const {
+    return crop_.isEnabled() ? crop_.getLayout().frame_size : frame_size_;
+}
+
+bool MmapRawVideoFileWorker::createBufferPool() {
+    // 🎯 Worker职责：在open()时自动创建BufferPool（通过调用Allocator）
+    int buffer_count = 4;
+    
+    buffer_pool_id_ = allocateOutputPool(
+        buffer_count,
+        getOutputFrameSize(),
+        std::string("MmapRawVideoFileWorker_") + path_,
+        "Video"
+    );
+    
+    if (buffer_pool_id_ == 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Failed to create BufferPool via Allocator");
+        return false;
+    }
+    
+    LOG_DEBUG_FMT("[Worker]    BufferPool: ID %lu, %d buffers, %zu bytes each",
+                  buffer_pool_id_, buffer_count, getOutputFrameSize());
+    return true;
 }
 
 bool MmapRawVideoFileWorker::mapFile() {
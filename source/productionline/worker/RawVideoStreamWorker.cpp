@@ -0,0 +1,444 @@
+#include "productionline/worker/RawVideoStreamWorker.hpp"
+#include "common/Logger.hpp"
+#include "productionline/io/RawFrameFile.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <climits>  // for INT_MAX
+#include <algorithm>
+
+namespace {
+
+constexpr const char* kUnixPrefix = "unix:";
+
+/**
+ * 系统允许的最大管道容量（/proc/sys/fs/pipe-max-size，读取失败时按默认 1 MiB）
+ */
+int pipeMaxSize() {
+    int max_size = 1024 * 1024;
+    FILE* f = fopen("/proc/sys/fs/pipe-max-size", "r");
+    if (f) {
+        if (fscanf(f, "%d", &max_size) != 1) {
+            max_size = 1024 * 1024;
+        }
+        fclose(f);
+    }
+    return max_size;
+}
+
+} // namespace
+
+// ============ 构造/析构 ============
+
+RawVideoStreamWorker::RawVideoStreamWorker()
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL)
+    , fd_(-1)
+    , is_socket_(false)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(0)
+    , frame_size_(0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , is_open_(false)
+    , eof_(false)
+    , frames_read_(0)
+    , bytes_read_(0)
+{
+}
+
+RawVideoStreamWorker::RawVideoStreamWorker(const WorkerConfig& config)
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL, config)
+    , fd_(-1)
+    , is_socket_(false)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(0)
+    , frame_size_(0)
+    , pixel_format_(-1)
+    , plane_count_(0)
+    , linesize_{0, 0, 0, 0}
+    , plane_offset_{0, 0, 0, 0}
+    , is_open_(false)
+    , eof_(false)
+    , frames_read_(0)
+    , bytes_read_(0)
+{
+}
+
+RawVideoStreamWorker::~RawVideoStreamWorker() {
+    close();
+}
+
+// ============ IVideoReader 接口实现 ============
+
+bool RawVideoStreamWorker::open(const char* /*path*/) {
+    LOG_ERROR_FMT("[Worker] ERROR: RawVideoStreamWorker needs the frame geometry");
+    LOG_ERROR("   Please use open(path, width, height, bits_per_pixel) for raw streams");
+    return false;
+}
+
+bool RawVideoStreamWorker::open(const char* path, int width, int height, int bits_per_pixel) {
+    if (is_open_) {
+        LOG_WARN_FMT("[Worker]  Warning: Stream already opened, closing previous stream");
+        close();
+    }
+    
+    if (!configureFormat(width, height, bits_per_pixel)) {
+        return false;
+    }
+    if (worker_config_.output.hasRoi()) {
+        LOG_WARN_FMT("[Worker]  Warning: ROI is not supported for raw streams, delivering full frames");
+    }
+    
+    LOG_INFO_FMT("📂 Opening raw stream: %s", path);
+    fd_ = openStream(path);
+    if (fd_ < 0) {
+        return false;
+    }
+    path_ = path;
+    tuneStreamBuffer();
+    
+    if (!createBufferPool()) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    
+    is_open_ = true;
+    eof_.store(false);
+    frames_read_.store(0);
+    bytes_read_.store(0);
+    
+    LOG_INFO_FMT("   Format: %dx%d, %d bits per pixel, %d planes", width_, height_, bits_per_pixel_, plane_count_);
+    LOG_INFO_FMT("   Frame size: %zu bytes", frame_size_);
+    LOG_DEBUG_FMT("[Worker] Raw stream opened successfully (%s)", is_socket_ ? "unix socket" : "pipe/file");
+    
+    return true;
+}
+
+void RawVideoStreamWorker::close() {
+    if (!is_open_) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(read_mutex_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    
+    // v2.0: BufferPool 生命周期由 Allocator 管理，只清除ID
+    buffer_pool_id_ = 0;
+    is_open_ = false;
+    
+    LOG_DEBUG_FMT("[Worker] Raw stream closed: %s (%lu frames, %lu bytes)",
+                  path_.c_str(), frames_read_.load(), bytes_read_.load());
+}
+
+bool RawVideoStreamWorker::isOpen() const {
+    return is_open_;
+}
+
+bool RawVideoStreamWorker::seek(int /*frame_index*/) {
+    LOG_WARN("[Worker]  Warning: Raw stream does not support seeking");
+    return false;
+}
+
+bool RawVideoStreamWorker::seekToBegin() {
+    LOG_WARN("[Worker]  Warning: Raw stream does not support seeking");
+    return false;
+}
+
+bool RawVideoStreamWorker::seekToEnd() {
+    LOG_WARN("[Worker]  Warning: Raw stream does not support seeking");
+    return false;
+}
+
+bool RawVideoStreamWorker::skip(int /*frame_count*/) {
+    LOG_WARN("[Worker]  Warning: Raw stream does not support frame skipping");
+    return false;
+}
+
+int RawVideoStreamWorker::getTotalFrames() const {
+    // 流的长度未知：与 RTSP Worker 一致返回 INT_MAX，流结束由 isAtEnd() 报告
+    return INT_MAX;
+}
+
+int RawVideoStreamWorker::getCurrentFrameIndex() const {
+    return static_cast<int>(frames_read_.load());
+}
+
+size_t RawVideoStreamWorker::getFrameSize() const {
+    return frame_size_;
+}
+
+long RawVideoStreamWorker::getFileSize() const {
+    // 流没有文件大小概念
+    return -1;
+}
+
+int RawVideoStreamWorker::getWidth() const {
+    return width_;
+}
+
+int RawVideoStreamWorker::getHeight() const {
+    return height_;
+}
+
+int RawVideoStreamWorker::getBytesPerPixel() const {
+    return (bits_per_pixel_ + 7) / 8;
+}
+
+const char* RawVideoStreamWorker::getPath() const {
+    return path_.c_str();
+}
+
+bool RawVideoStreamWorker::hasMoreFrames() const {
+    return is_open_ && !eof_.load();
+}
+
+bool RawVideoStreamWorker::isAtEnd() const {
+    return eof_.load();
+}
+
+// ============================================================================
+// 核心功能：填充Buffer
+// ============================================================================
+
+bool RawVideoStreamWorker::fillBuffer(int /*frame_index*/, Buffer* buffer) {
+    if (!buffer || !buffer->data()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid buffer");
+        return false;
+    }
+    
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
+        return false;
+    }
+    
+    if (buffer->size() < frame_size_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small (need %zu, got %zu)\n",
+               frame_size_, buffer->size());
+        return false;
+    }
+    
+    // 流按到达顺序读取：frame_index 只用于接口兼容
+    {
+        std::lock_guard<std::mutex> lock(read_mutex_);
+        if (eof_.load() || fd_ < 0) {
+            return false;
+        }
+        if (readFrame(static_cast<uint8_t*>(buffer->data())) <= 0) {
+            return false;
+        }
+    }
+    
+    setMetadata(buffer);
+    return true;
+}
+
+// ============ 内部辅助方法 ============
+
+bool RawVideoStreamWorker::configureFormat(int width, int height, int bits_per_pixel) {
+    const int pixel_format = worker_config_.output.pixel_format;
+    if (width <= 0 || height <= 0 || (bits_per_pixel <= 0 && pixel_format < 0)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid parameters");
+        LOG_INFO_FMT("   width=%d, height=%d, bits_per_pixel=%d\n",
+               width, height, bits_per_pixel);
+        return false;
+    }
+    
+    width_ = width;
+    height_ = height;
+    bits_per_pixel_ = bits_per_pixel;
+    pixel_format_ = -1;
+    plane_count_ = 0;
+    
+    if (pixel_format >= 0) {
+        // 已知像素格式：按紧凑 plane 布局计算帧大小，填充时设置 Buffer 图像元数据
+        productionline::io::RawFrameFileInfo layout;
+        layout.width = width;
+        layout.height = height;
+        layout.pixel_format = pixel_format;
+        if (!productionline::io::RawFrameFile::setImageLayout(&layout)) {
+            LOG_ERROR_FMT("[Worker] ERROR: Unsupported raw pixel format %d", pixel_format);
+            return false;
+        }
+        pixel_format_ = pixel_format;
+        plane_count_ = layout.plane_count;
+        memcpy(linesize_, layout.linesize, sizeof(linesize_));
+        memcpy(plane_offset_, layout.plane_offset, sizeof(plane_offset_));
+        bits_per_pixel_ = layout.bits_per_pixel;
+        frame_size_ = layout.frame_size;
+    } else {
+        size_t total_bits = (size_t)width_ * height_ * bits_per_pixel_;
+        frame_size_ = (total_bits + 7) / 8;
+    }
+    return true;
+}
+
+int RawVideoStreamWorker::openStream(const char* path) {
+    is_socket_ = false;
+    
+    if (strcmp(path, "-") == 0 || strcmp(path, "stdin") == 0) {
+        int fd = fcntl(STDIN_FILENO, F_DUPFD_CLOEXEC, 0);
+        if (fd < 0) {
+            LOG_ERROR_FMT("[Worker] ERROR: Cannot duplicate stdin: %s", strerror(errno));
+        }
+        return fd;
+    }
+    
+    const char* socket_path = nullptr;
+    struct stat st;
+    if (strncmp(path, kUnixPrefix, strlen(kUnixPrefix)) == 0) {
+        socket_path = path + strlen(kUnixPrefix);
+    } else if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        socket_path = path;
+    }
+    
+    if (socket_path) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+            LOG_ERROR_FMT("[Worker] ERROR: Unix socket path too long: %s", socket_path);
+            return -1;
+        }
+        strcpy(addr.sun_path, socket_path);
+    
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            LOG_ERROR_FMT("[Worker] ERROR: socket() failed: %s", strerror(errno));
+            return -1;
+        }
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+            LOG_ERROR_FMT("[Worker] ERROR: Cannot connect to '%s': %s", socket_path, strerror(errno));
+            ::close(fd);
+            return -1;
+        }
+        is_socket_ = true;
+        return fd;
+    }
+    
+    // FIFO：open 阻塞到写端打开
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Cannot open '%s': %s", path, strerror(errno));
+    }
+    return fd;
+}
+
+void RawVideoStreamWorker::tuneStreamBuffer() {
+    if (is_socket_) {
+        // 内核会把请求值翻倍并按 net.core.rmem_max 截断
+        int size = frame_size_ > INT_MAX ? INT_MAX : static_cast<int>(frame_size_);
+        if (setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) < 0) {
+            LOG_DEBUG_FMT("[Worker] SO_RCVBUF(%d) failed: %s", size, strerror(errno));
+        }
+        return;
+    }
+    
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || !S_ISFIFO(st.st_mode)) {
+        return;
+    }
+    
+    // 管道容量扩大到一帧；非特权进程超过 pipe-max-size 时 EPERM，按上限设置
+    int target = static_cast<int>(std::min(static_cast<size_t>(pipeMaxSize()), frame_size_));
+    int current = fcntl(fd_, F_GETPIPE_SZ);
+    if (target <= current) {
+        return;
+    }
+    int ret = fcntl(fd_, F_SETPIPE_SZ, target);
+    if (ret < 0) {
+        LOG_DEBUG_FMT("[Worker] F_SETPIPE_SZ(%d) failed: %s", target, strerror(errno));
+        return;
+    }
+    LOG_DEBUG_FMT("[Worker]    Pipe capacity: %d -> %d bytes", current, ret);
+}
+
+int RawVideoStreamWorker::readFrame(uint8_t* dst) {
+    size_t done = 0;
+    while (done < frame_size_) {
+        struct pollfd pfd;
+        pfd.fd = fd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ready = poll(&pfd, 1, kIdleWaitMs);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready < 0) {
+            LOG_ERROR_FMT("[Worker] ERROR: poll failed on '%s': %s", path_.c_str(), strerror(errno));
+            eof_.store(true);
+            return -1;
+        }
+        if (ready == 0) {
+            if (done == 0) {
+                return 0;   // 空闲：让生产者检查停止标志
+            }
+            continue;       // 一帧读到一半：等写端写完
+        }
+    
+        // POLLHUP 时仍然先读：写端关闭后管道中的剩余数据可读，读完返回 0
+        ssize_t n = read(fd_, dst + done, frame_size_ - done);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+            continue;
+        }
+        if (n < 0) {
+            LOG_ERROR_FMT("[Worker] ERROR: read failed on '%s': %s", path_.c_str(), strerror(errno));
+            eof_.store(true);
+            return -1;
+        }
+        if (n == 0) {
+            if (done > 0) {
+                LOG_WARN_FMT("[Worker]  Warning: Stream ended inside a frame, dropping %zu trailing bytes", done);
+            }
+            LOG_DEBUG_FMT("[Worker] Raw stream EOF after %lu frames", frames_read_.load());
+            eof_.store(true);
+            return -1;
+        }
+        done += static_cast<size_t>(n);
+        bytes_read_.fetch_add(static_cast<uint64_t>(n));
+    }
+    
+    frames_read_.fetch_add(1);
+    return 1;
+}
+
+void RawVideoStreamWorker::setMetadata(Buffer* buffer) const {
+    if (plane_count_ > 0) {
+        buffer->setImageMetadata(width_, height_, static_cast<AVPixelFormat>(pixel_format_),
+                                 linesize_, plane_offset_, plane_count_);
+    }
+}
+
+bool RawVideoStreamWorker::createBufferPool() {
+    // 🎯 Worker职责：在open()时自动创建BufferPool（通过调用Allocator）
+    int buffer_count = 4;
+    
+    buffer_pool_id_ = allocateOutputPool(
+        buffer_count,
+        frame_size_,
+        std::string("RawVideoStreamWorker_") + path_,
+        "Video"
+    );
+    
+    if (buffer_pool_id_ == 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Failed to create BufferPool via Allocator");
+        return false;
+    }
+    
+    LOG_DEBUG_FMT("[Worker]    BufferPool: ID %lu, %d buffers, %zu bytes each",
+                  buffer_pool_id_, buffer_count, frame_size_);
+    return true;
+}
@@ -0,0 +1,597 @@
+#include "productionline/worker/TestPatternWorker.hpp"
+#include "common/Logger.hpp"
+#include "common/FrameCopy.hpp"
+#include <string.h>
+#include <stdio.h>
+#include <climits>  // for INT_MAX
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace {
+
+struct Rgb {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+// 75% 彩条：白 黄 青 绿 品 红 蓝 黑
+const Rgb kBars[8] = {
+    {191, 191, 191}, {191, 191, 0}, {0, 191, 191}, {0, 191, 0},
+    {191, 0, 191}, {191, 0, 0}, {0, 0, 191}, {0, 0, 0}
+};
+
+const Rgb kCounterBackground = {48, 48, 48};
+const Rgb kGlyphOn = {255, 255, 255};
+const Rgb kGlyphOff = {0, 0, 0};
+
+// 3x5 点阵数字，每行低 3 位从左到右
+const uint8_t kFont[10][5] = {
+    {7, 5, 5, 5, 7}, {2, 6, 2, 2, 7}, {7, 1, 7, 4, 7}, {7, 1, 7, 1, 7}, {5, 5, 7, 1, 1},
+    {7, 4, 7, 1, 7}, {7, 4, 7, 5, 7}, {7, 1, 1, 1, 1}, {7, 5, 7, 5, 7}, {7, 5, 7, 1, 7}
+};
+
+/**
+ * 未设置 pixel_format 时按 bits_per_pixel 选择格式（-1=不支持）
+ */
+int formatForBitsPerPixel(int bits_per_pixel) {
+    switch (bits_per_pixel) {
+        case 32: return AV_PIX_FMT_BGRA;
+        case 24: return AV_PIX_FMT_BGR24;
+        case 16: return AV_PIX_FMT_RGB565LE;
+        case 12: return AV_PIX_FMT_NV12;
+        case 8:  return AV_PIX_FMT_GRAY8;
+        default: return -1;
+    }
+}
+
+/**
+ * plane 1/2 是色度平面（与 RawFrameFile::setImageLayout 一致）
+ */
+int planeShiftH(const AVPixFmtDescriptor* desc, int plane) {
+    return (plane == 1 || plane == 2) ? desc->log2_chroma_h : 0;
+}
+
+/**
+ * 宽度为 x 的一行在各 plane 中的字节数（x=0 时全为 0）
+ */
+void columnBytes(int pixel_format, int x, int bytes[4]) {
+    bytes[0] = bytes[1] = bytes[2] = bytes[3] = 0;
+    if (x > 0) {
+        av_image_fill_linesizes(bytes, static_cast<AVPixelFormat>(pixel_format), x);
+    }
+}
+
+/**
+ * 颜色分量值（RGB 直接取；YUV 按 BT.601 有限范围转换；alpha 不透明），按分量位深缩放
+ */
+uint16_t componentValue(const AVPixFmtDescriptor* desc, int c, const Rgb& color) {
+    int depth = desc->comp[c].depth;
+    if ((desc->flags & AV_PIX_FMT_FLAG_ALPHA) && c == desc->nb_components - 1) {
+        return static_cast<uint16_t>((1 << depth) - 1);
+    }
+    
+    int r = color.r;
+    int g = color.g;
+    int b = color.b;
+    int v;
+    if (desc->flags & AV_PIX_FMT_FLAG_RGB) {
+        v = c == 0 ? r : (c == 1 ? g : b);
+    } else if (c == 0) {
+        v = 16 + ((66 * r + 129 * g + 25 * b + 128) >> 8);
+    } else if (c == 1) {
+        v = ((-38 * r - 74 * g + 112 * b) + 128 * 256 + 128) >> 8;
+    } else {
+        v = ((112 * r - 94 * g - 18 * b) + 128 * 256 + 128) >> 8;
+    }
+    return static_cast<uint16_t>(depth >= 8 ? v << (depth - 8) : v >> (8 - depth));
+}
+
+/**
+ * 按目标格式渲染 width x height 的图像（color_at(x, y) 给出每个像素的颜色）
+ *
+ * 逐分量逐行调用 av_write_image_line，适用于所有 packed / planar 整数格式；只在 open 时对小图像使用
+ */
+template <typename ColorAt>
+bool renderImage(productionline::io::RawFrameFileInfo* layout, std::vector<uint8_t>* data,
+                 int pixel_format, int width, int height, ColorAt color_at) {
+    *layout = productionline::io::RawFrameFileInfo();
+    layout->width = width;
+    layout->height = height;
+    layout->pixel_format = pixel_format;
+    if (!productionline::io::RawFrameFile::setImageLayout(layout)) {
+        return false;
+    }
+    
+    // packed 格式的分量按位或写入，必须从 0 开始
+    data->assign(layout->frame_size, 0);
+    uint8_t* planes[4] = {nullptr, nullptr, nullptr, nullptr};
+    for (int i = 0; i < layout->plane_count; i++) {
+        planes[i] = data->data() + layout->plane_offset[i];
+    }
+    
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(pixel_format));
+    bool rgb = (desc->flags & AV_PIX_FMT_FLAG_RGB) != 0;
+    std::vector<uint16_t> line(static_cast<size_t>(width));
+    for (int c = 0; c < desc->nb_components; c++) {
+        bool chroma = !rgb && (c == 1 || c == 2) && desc->nb_components >= 3;
+        int shift_w = chroma ? desc->log2_chroma_w : 0;
+        int shift_h = chroma ? desc->log2_chroma_h : 0;
+        int component_width = AV_CEIL_RSHIFT(width, shift_w);
+        int component_height = AV_CEIL_RSHIFT(height, shift_h);
+        for (int y = 0; y < component_height; y++) {
+            for (int x = 0; x < component_width; x++) {
+                line[x] = componentValue(desc, c, color_at(x << shift_w, y << shift_h));
+            }
+            av_write_image_line(line.data(), planes, layout->linesize, desc, 0, y, c, component_width);
+        }
+    }
+    return true;
+}
+
+uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+// ============ 构造/析构 ============
+
+TestPatternWorker::TestPatternWorker()
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(0)
+    , frame_size_(0)
+    , pixel_format_(-1)
+    , layout_()
+    , pattern_(Pattern::BARS)
+    , stamp_(false)
+    , total_frames_(0)
+    , current_frame_index_(0)
+    , is_open_(false)
+    , x_align_(1)
+{
+}
+
+TestPatternWorker::TestPatternWorker(const WorkerConfig& config)
+    : WorkerBase(BufferAllocatorFactory::AllocatorType::NORMAL, config)
+    , width_(0)
+    , height_(0)
+    , bits_per_pixel_(0)
+    , frame_size_(0)
+    , pixel_format_(-1)
+    , layout_()
+    , pattern_(Pattern::BARS)
+    , stamp_(false)
+    , total_frames_(0)
+    , current_frame_index_(0)
+    , is_open_(false)
+    , x_align_(1)
+{
+}
+
+TestPatternWorker::~TestPatternWorker() {
+    close();
+}
+
+// ============ IVideoReader 接口实现 ============
+
+bool TestPatternWorker::open(const char* /*path*/) {
+    LOG_ERROR_FMT("[Worker] ERROR: TestPatternWorker needs the frame geometry");
+    LOG_ERROR("   Please use open(path, width, height, bits_per_pixel) for test patterns");
+    return false;
+}
+
+bool TestPatternWorker::open(const char* path, int width, int height, int bits_per_pixel) {
+    if (is_open_) {
+        LOG_WARN_FMT("[Worker]  Warning: Pattern already opened, closing previous pattern");
+        close();
+    }
+    
+    if (!parsePattern() || !configureFormat(width, height, bits_per_pixel) || !buildTemplates()) {
+        return false;
+    }
+    path_ = path ? path : worker_config_.pattern.name;
+    total_frames_ = worker_config_.pattern.total_frames > 0 ? worker_config_.pattern.total_frames : INT_MAX;
+    
+    if (!createBufferPool()) {
+        band_ = Image();
+        glyphs_ = Image();
+        return false;
+    }
+    
+    is_open_ = true;
+    current_frame_index_ = 0;
+    
+    LOG_INFO_FMT("🎨 Test pattern: %s%s", worker_config_.pattern.name.c_str(), stamp_ ? " + frame number" : "");
+    LOG_INFO_FMT("   Format: %dx%d %s, %d planes, %zu bytes per frame",
+                 width_, height_, av_get_pix_fmt_name(static_cast<AVPixelFormat>(pixel_format_)),
+                 layout_.plane_count, frame_size_);
+    if (worker_config_.pattern.frame_rate > 0.0) {
+        LOG_INFO_FMT("   Frame rate: %.2f fps", worker_config_.pattern.frame_rate);
+    }
+    
+    return true;
+}
+
+void TestPatternWorker::close() {
+    if (!is_open_) {
+        return;
+    }
+    
+    // v2.0: BufferPool 生命周期由 Allocator 管理，只清除ID
+    buffer_pool_id_ = 0;
+    band_ = Image();
+    glyphs_ = Image();
+    is_open_ = false;
+    current_frame_index_ = 0;
+    
+    LOG_DEBUG_FMT("[Worker] Test pattern closed: %s", path_.c_str());
+}
+
+bool TestPatternWorker::isOpen() const {
+    return is_open_;
+}
+
+bool TestPatternWorker::seek(int frame_index) {
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Pattern not opened");
+        return false;
+    }
+    
+    if (frame_index < 0 || frame_index >= total_frames_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
+               frame_index, total_frames_ - 1);
+        return false;
+    }
+    
+    current_frame_index_ = frame_index;
+    return true;
+}
+
+bool TestPatternWorker::seekToBegin() {
+    return seek(0);
+}
+
+bool TestPatternWorker::seekToEnd() {
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Pattern not opened");
+        return false;
+    }
+    
+    current_frame_index_ = total_frames_;
+    return true;
+}
+
+bool TestPatternWorker::skip(int frame_count) {
+    int target_frame = current_frame_index_ + frame_count;
+    return seek(target_frame);
+}
+
+int TestPatternWorker::getTotalFrames() const {
+    return total_frames_;
+}
+
+int TestPatternWorker::getCurrentFrameIndex() const {
+    return current_frame_index_;
+}
+
+size_t TestPatternWorker::getFrameSize() const {
+    return frame_size_;
+}
+
+long TestPatternWorker::getFileSize() const {
+    // 生成的图案没有文件大小概念
+    return -1;
+}
+
+int TestPatternWorker::getWidth() const {
+    return width_;
+}
+
+int TestPatternWorker::getHeight() const {
+    return height_;
+}
+
+int TestPatternWorker::getBytesPerPixel() const {
+    return (bits_per_pixel_ + 7) / 8;
+}
+
+const char* TestPatternWorker::getPath() const {
+    return path_.c_str();
+}
+
+bool TestPatternWorker::hasMoreFrames() const {
+    return current_frame_index_ < total_frames_;
+}
+
+bool TestPatternWorker::isAtEnd() const {
+    return current_frame_index_ >= total_frames_;
+}
+
+double TestPatternWorker::getFrameRate() const {
+    return worker_config_.pattern.frame_rate;
+}
+
+// ============================================================================
+// 核心功能：填充Buffer
+// ============================================================================
+
+bool TestPatternWorker::fillBuffer(int frame_index, Buffer* buffer) {
+    if (!buffer || !buffer->data()) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid buffer");
+        return false;
+    }
+    
+    if (!is_open_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Worker is not open");
+        return false;
+    }
+    
+    if (frame_index < 0 || frame_index >= total_frames_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid frame index %d (valid: 0-%d)\n",
+               frame_index, total_frames_ - 1);
+        return false;
+    }
+    
+    if (buffer->size() < frame_size_) {
+        LOG_ERROR_FMT("[Worker] ERROR: Buffer too small (need %zu, got %zu)\n",
+               frame_size_, buffer->size());
+        return false;
+    }
+    
+    uint8_t* dst = static_cast<uint8_t*>(buffer->data());
+    switch (pattern_) {
+        case Pattern::GRADIENT: {
+            int shift = static_cast<int>((static_cast<int64_t>(frame_index) * kGradientStep) % width_);
+            fillFromBand(dst, shift / x_align_ * x_align_);
+            break;
+        }
+        case Pattern::NOISE:
+            fillNoise(dst, frame_index);
+            break;
+        case Pattern::BARS:
+        case Pattern::COUNTER:
+        default:
+            fillFromBand(dst, 0);
+            break;
+    }
+    if (stamp_) {
+        drawFrameNumber(dst, frame_index);
+    }
+    
+    buffer->setImageMetadata(width_, height_, static_cast<AVPixelFormat>(pixel_format_),
+                             layout_.linesize, layout_.plane_offset, layout_.plane_count);
+    return true;
+}
+
+// ============ 内部辅助方法 ============
+
+bool TestPatternWorker::parsePattern() {
+    const std::string& name = worker_config_.pattern.name;
+    if (name == "bars") {
+        pattern_ = Pattern::BARS;
+    } else if (name == "gradient") {
+        pattern_ = Pattern::GRADIENT;
+    } else if (name == "noise") {
+        pattern_ = Pattern::NOISE;
+    } else if (name == "counter") {
+        pattern_ = Pattern::COUNTER;
+    } else {
+        LOG_ERROR_FMT("[Worker] ERROR: Unknown test pattern '%s' (bars / gradient / noise / counter)", name.c_str());
+        return false;
+    }
+    stamp_ = worker_config_.pattern.stamp_frame_number || pattern_ == Pattern::COUNTER;
+    return true;
+}
+
+bool TestPatternWorker::configureFormat(int width, int height, int bits_per_pixel) {
+    int pixel_format = worker_config_.output.pixel_format;
+    if (pixel_format < 0) {
+        pixel_format = formatForBitsPerPixel(bits_per_pixel);
+    }
+    if (width <= 0 || height <= 0 || pixel_format < 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Invalid parameters");
+        LOG_INFO_FMT("   width=%d, height=%d, bits_per_pixel=%d (set pixel_format, or bits_per_pixel 8/12/16/24/32)\n",
+               width, height, bits_per_pixel);
+        return false;
+    }
+    
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(pixel_format));
+    if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL |
+                                 AV_PIX_FMT_FLAG_BAYER | AV_PIX_FMT_FLAG_FLOAT))) {
+        LOG_ERROR_FMT("[Worker] ERROR: Pixel format %d cannot be generated", pixel_format);
+        return false;
+    }
+    for (int c = 0; c < desc->nb_components; c++) {
+        if (desc->comp[c].depth > 16) {
+            LOG_ERROR_FMT("[Worker] ERROR: Pixel format %s has components deeper than 16 bits", desc->name);
+            return false;
+        }
+    }
+    
+    layout_ = productionline::io::RawFrameFileInfo();
+    layout_.width = width;
+    layout_.height = height;
+    layout_.pixel_format = pixel_format;
+    if (!productionline::io::RawFrameFile::setImageLayout(&layout_)) {
+        LOG_ERROR_FMT("[Worker] ERROR: Unsupported pixel format %s", desc->name);
+        return false;
+    }
+    
+    width_ = width;
+    height_ = height;
+    pixel_format_ = pixel_format;
+    bits_per_pixel_ = layout_.bits_per_pixel;
+    frame_size_ = layout_.frame_size;
+    
+    // 列偏移必须落在色度采样边界和字节边界上（位流格式 8 像素对齐）
+    x_align_ = 1 << desc->log2_chroma_w;
+    if ((desc->flags & AV_PIX_FMT_FLAG_BITSTREAM) && x_align_ < 8) {
+        x_align_ = 8;
+    }
+    return true;
+}
+
+bool TestPatternWorker::buildTemplates() {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(pixel_format_));
+    int band_rows = std::min(1 << desc->log2_chroma_h, height_);
+    bool ok = true;
+    
+    switch (pattern_) {
+        case Pattern::BARS:
+            ok = renderImage(&band_.layout, &band_.data, pixel_format_, width_, band_rows,
+                             [this](int x, int) { return kBars[static_cast<int64_t>(x) * 8 / width_]; });
+            break;
+        case Pattern::GRADIENT:
+            // 两倍宽度：第 shift 列起的 width_ 列即左移 shift 像素的渐变
+            ok = renderImage(&band_.layout, &band_.data, pixel_format_, width_ * 2, band_rows,
+                             [this](int x, int) {
+                                 int v = static_cast<int>(static_cast<int64_t>(x % width_) * 255 / std::max(width_ - 1, 1));
+                                 return Rgb{static_cast<uint8_t>(v), static_cast<uint8_t>(255 - v), 128};
+                             });
+            break;
+        case Pattern::COUNTER:
+            ok = renderImage(&band_.layout, &band_.data, pixel_format_, width_, band_rows,
+                             [](int, int) { return kCounterBackground; });
+            break;
+        case Pattern::NOISE:
+        default:
+            break;
+    }
+    
+    if (ok && stamp_) {
+        ok = renderImage(&glyphs_.layout, &glyphs_.data, pixel_format_, kGlyphWidth * 10, kGlyphHeight,
+                         [](int x, int y) {
+                             int digit = x / kGlyphWidth;
+                             int column = (x % kGlyphWidth) / kGlyphScale;
+                             int row = y / kGlyphScale;
+                             bool on = column < 3 && row < 5 && ((kFont[digit][row] >> (2 - column)) & 1);
+                             return on ? kGlyphOn : kGlyphOff;
+                         });
+    }
+    
+    if (!ok) {
+        LOG_ERROR_FMT("[Worker] ERROR: Failed to render pattern templates for %s", desc->name);
+        band_ = Image();
+        glyphs_ = Image();
+    }
+    return ok;
+}
+
+void TestPatternWorker::fillFromBand(uint8_t* dst, int x) const {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(pixel_format_));
+    int x_bytes[4];
+    columnBytes(pixel_format_, x, x_bytes);
+    
+    for (int i = 0; i < layout_.plane_count; i++) {
+        int shift_h = planeShiftH(desc, i);
+        int rows = AV_CEIL_RSHIFT(height_, shift_h);
+        int band_rows = AV_CEIL_RSHIFT(band_.layout.height, shift_h);
+        size_t stride = static_cast<size_t>(layout_.linesize[i]);
+        size_t band_stride = static_cast<size_t>(band_.layout.linesize[i]);
+        const uint8_t* band = band_.data.data() + band_.layout.plane_offset[i] + x_bytes[i];
+        uint8_t* plane = dst + layout_.plane_offset[i];
+    
+        // 模板第 t 行 → 目标第 t, t + band_rows, t + 2 * band_rows ... 行（源行跨度 0）
+        for (int t = 0; t < band_rows && t < rows; t++) {
+            int count = (rows - t + band_rows - 1) / band_rows;
+            FrameCopy::getInstance().copyRows(plane + stride * t, stride * band_rows,
+                                              band + band_stride * t, 0, stride, count);
+        }
+    }
+}
+
+void TestPatternWorker::fillNoise(uint8_t* dst, int frame_index) const {
+    uint64_t seed = (static_cast<uint64_t>(worker_config_.pattern.seed) << 32) ^ static_cast<uint32_t>(frame_index);
+    uint64_t state[4];
+    for (auto& lane : state) {
+        lane = splitmix64(&seed) | 1;   // xorshift 状态不能为 0
+    }
+    
+    // 4 路独立状态：每轮 32 字节，循环体没有跨路依赖
+    size_t offset = 0;
+    for (; offset + sizeof(state) <= frame_size_; offset += sizeof(state)) {
+        for (auto& lane : state) {
+            lane ^= lane << 13;
+            lane ^= lane >> 7;
+            lane ^= lane << 17;
+        }
+        memcpy(dst + offset, state, sizeof(state));
+    }
+    if (offset < frame_size_) {
+        for (auto& lane : state) {
+            lane ^= lane << 13;
+            lane ^= lane >> 7;
+            lane ^= lane << 17;
+        }
+        memcpy(dst + offset, state, frame_size_ - offset);
+    }
+}
+
+void TestPatternWorker::drawFrameNumber(uint8_t* dst, int frame_index) const {
+    if (width_ < kStampMargin + kGlyphWidth || height_ < kStampMargin + kGlyphHeight) {
+        return;
+    }
+    
+    char digits[16];
+    int length = snprintf(digits, sizeof(digits), "%d", frame_index);
+    int fit = (width_ - kStampMargin) / kGlyphWidth;
+    
+    // 放不下时保留低位（仍能看出帧在变化）
+    const char* first = digits + std::max(0, length - fit);
+    for (int k = 0; first[k] != '\0'; k++) {
+        copyRect(dst, kStampMargin + k * kGlyphWidth, kStampMargin,
+                 glyphs_, (first[k] - '0') * kGlyphWidth, kGlyphWidth, kGlyphHeight);
+    }
+}
+
+void TestPatternWorker::copyRect(uint8_t* dst, int dst_x, int dst_y, const Image& src, int src_x,
+                                 int width, int height) const {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(pixel_format_));
+    int dst_bytes[4];
+    int src_bytes[4];
+    int row_bytes[4];
+    columnBytes(pixel_format_, dst_x, dst_bytes);
+    columnBytes(pixel_format_, src_x, src_bytes);
+    columnBytes(pixel_format_, width, row_bytes);
+    
+    for (int i = 0; i < layout_.plane_count; i++) {
+        int shift_h = planeShiftH(desc, i);
+        size_t stride = static_cast<size_t>(layout_.linesize[i]);
+        size_t src_stride = static_cast<size_t>(src.layout.linesize[i]);
+        FrameCopy::getInstance().copyRows(
+            dst + layout_.plane_offset[i] + stride * (dst_y >> shift_h) + dst_bytes[i], stride,
+            src.data.data() + src.layout.plane_offset[i] + src_bytes[i], src_stride,
+            static_cast<size_t>(row_bytes[i]), height >> shift_h);
+    }
+}
+
+bool TestPatternWorker::createBufferPool() {
+    // 🎯 Worker职责：在open()时自动创建BufferPool（通过调用Allocator）
+    int buffer_count = 4;
+    
+    buffer_pool_id_ = allocateOutputPool(
+        buffer_count,
+        frame_size_,
+        std::string("TestPatternWorker_") + path_,
+        "Video"
+    );
+    
+    if (buffer_pool_id_ == 0) {
+        LOG_ERROR_FMT("[Worker] ERROR: Failed to create BufferPool via Allocator");
+        return false;
+    }
+    
+    LOG_DEBUG_FMT("[Worker]    BufferPool: ID %lu, %d buffers, %zu bytes each",
+                  buffer_pool_id_, buffer_count, frame_size_);
+    return true;
+}
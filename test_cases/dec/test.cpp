@@ -15,6 +15,8 @@
 #include <stdlib.h>
 #include <signal.h>
 #include <string.h>
+#include <ctype.h>
+#include <sched.h>
 #include <string>
 #include <vector>
 #include <memory>
@@ -22,22 +24,42 @@
 #include <atomic>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <functional>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
 #include "display/LinuxFramebufferDevice.hpp"
 #include "productionline/worker/BufferFillingWorkerFacade.hpp"
+#include "productionline/worker/ImageSequenceWorker.hpp"
+#include "productionline/worker/DecodedFrameCache.hpp"
 #include "productionline/worker/WorkerConfig.hpp"
 #include "buffer/bufferpool/BufferPool.hpp"
 #include "buffer/bufferpool/BufferPoolRegistry.hpp"
+#include "buffer/bufferpool/SharedMemoryBufferPool.hpp"
 #include "productionline/VideoProductionLine.hpp"
+#include "productionline/MultiSourceProductionLine.hpp"
+#include "productionline/io/FileAVIOContext.hpp"
 #include "productionline/io/BufferWriter.hpp"
+#include "productionline/io/H264AnnexBIndex.hpp"
+#include "productionline/io/Mp4SampleTable.hpp"
+#include "productionline/io/RawFrameFile.hpp"
 #include "monitor/PerformanceMonitor.hpp"
 #include "common/Logger.hpp"
+#include "common/FrameCopy.hpp"
+#include "common/NumaPlacement.hpp"
 #include "framework/TestMacros.hpp"
 
 // FFmpeg头文件（解码器测试使用）
 extern "C" {
 #include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>  // avio_read() / avio_seek()
 #include <libavutil/pixfmt.h>
+#include <libavutil/frame.h>   // av_frame_alloc() / av_frame_unref()
 #include <libavutil/pixdesc.h>  // av_get_pix_fmt_name() 函数
 }
 
@@ -1534,6 +1556,3075 @@ static int test_buffer_writer_legacy(const char* video_path) {
     return success ? 0 : -1;
 }
 
+/**
+ * 测试：跨进程共享内存 BufferPool
+ * 
+ * 功能：
+ * - 父进程通过 Registry 创建共享内存 Pool（生产者）
+ * - 子进程按名称附加同一个 Pool（消费者，SharedMemoryBufferPool::attach() 重新映射共享内存段，
+ *   不经过 fork 继承的 Registry），零拷贝读取帧数据
+ * - 校验每帧首尾的帧号和图像元数据是否正确跨进程传递
+ * - 另一个子进程取走 buffer 后不归还直接退出，父进程 reclaimOrphanedBuffers() 回收
+ */
+static int test_shared_memory_pool(const char* pool_name) {
+    const std::string name = (pool_name && pool_name[0]) ? pool_name : "shm_test";
+    const int frame_count = 300;
+    const int width = 1920;
+    const int height = 1080;
+    const size_t frame_size = (size_t)width * height * 4;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO("  Test: Shared-memory cross-process BufferPool");
+    LOG_INFO_FMT("  Pool: %s, frames: %d", name.c_str(), frame_count);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    // 1. 创建共享内存 Pool（父进程）
+    uint64_t pool_id = BufferPoolRegistry::getInstance().createSharedPool(name, 4, frame_size, "Video");
+    auto pool = BufferPoolRegistry::getInstance().getSharedPool(pool_id).lock();
+    if (!pool) {
+        LOG_ERROR("Failed to create shared BufferPool");
+        return -1;
+    }
+    
+    // 2. 子进程：按名称附加并消费（fork 继承的 Registry 中是父进程的创建者对象，
+    //    直接 attach() 才会走附加进程的映射和校验路径）
+    pid_t child = fork();
+    if (child == 0) {
+        auto consumer_pool = SharedMemoryBufferPool::attach(name);
+        if (!consumer_pool || consumer_pool->isCreator()) {
+            _exit(1);
+        }
+        int errors = 0;
+        for (int i = 0; i < frame_count; i++) {
+            Buffer* buf = consumer_pool->acquireFilled(true, 2000);
+            if (buf == nullptr) {
+                _exit(2);
+            }
+            const uint32_t* pixels = (const uint32_t*)buf->data();
+            const uint32_t* last = (const uint32_t*)((const uint8_t*)buf->data() + frame_size) - 1;
+            if (pixels[0] != (uint32_t)i || *last != (uint32_t)i ||
+                buf->getImageWidth() != width || buf->getImageHeight() != height) {
+                errors++;
+            }
+            consumer_pool->releaseFilled(buf);
+        }
+        consumer_pool->printStats();
+        _exit(errors == 0 ? 0 : 3);
+    }
+    if (child < 0) {
+        LOG_ERROR("fork() failed");
+        BufferPoolRegistry::getInstance().releaseSharedPool(pool_id);
+        return -1;
+    }
+    
+    // 3. 父进程：生产帧（首像素写入帧号）
+    const int linesize[4] = {width * 4, 0, 0, 0};
+    const size_t plane_offset[4] = {0, 0, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    int produced = 0;
+    while (produced < frame_count && g_running) {
+        Buffer* buf = pool->acquireFree(true, 2000);
+        if (buf == nullptr) {
+            LOG_ERROR("Timed out waiting for a free buffer");
+            break;
+        }
+        memset(buf->data(), 0, frame_size);
+        ((uint32_t*)buf->data())[0] = (uint32_t)produced;
+        ((uint32_t*)((uint8_t*)buf->data() + frame_size))[-1] = (uint32_t)produced;
+        buf->setImageMetadata(width, height, AV_PIX_FMT_BGRA, linesize, plane_offset, 1);
+        pool->submitFilled(buf);
+        produced++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    int status = 0;
+    waitpid(child, &status, 0);
+    bool success = produced == frame_count && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    
+    // 4. 持有者崩溃：子进程取走一个空闲 buffer 后不归还直接退出，父进程回收
+    int free_before = pool->getFreeCount();
+    pid_t holder = fork();
+    if (holder == 0) {
+        auto holder_pool = SharedMemoryBufferPool::attach(name);
+        _exit(holder_pool && holder_pool->acquireFree(true, 2000) ? 0 : 1);
+    }
+    int holder_status = 0;
+    int reclaimed = 0;
+    if (holder > 0) {
+        waitpid(holder, &holder_status, 0);
+        reclaimed = pool->reclaimOrphanedBuffers();
+    }
+    bool reclaim_ok = holder > 0 && WIFEXITED(holder_status) && WEXITSTATUS(holder_status) == 0 &&
+                      reclaimed == 1 && pool->getFreeCount() == free_before;
+    LOG_INFO_FMT("Orphaned buffers reclaimed: %d (free %d -> %d)", reclaimed, free_before, pool->getFreeCount());
+    success = success && reclaim_ok;
+    
+    pool->printStats();
+    pool.reset();
+    BufferPoolRegistry::getInstance().releaseSharedPool(pool_id);
+    
+    LOG_INFO_FMT("Produced %d frames in %.2f s (%.1f fps), consumer exit code: %d",
+                 produced, seconds, seconds > 0 ? produced / seconds : 0.0,
+                 WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+    if (success) {
+        LOG_INFO("✅ Test PASSED");
+    } else {
+        LOG_ERROR("❌ Test FAILED");
+    }
+    return success ? 0 : -1;
+}
+
+/**
+ * 测试：生产线共享内存输出（采集 → 分析零拷贝）
+ * 
+ * 功能：
+ * - 测试图案生产线 setSharedOutput()：Worker 直接填充共享内存 Buffer，消费者线程提交到共享 filled 队列
+ * - 子进程按名称附加（分析进程），校验帧数和 NV12 元数据，归还后由生产线的归还线程放回工作 Pool
+ * - 共享 Pool 只有 4 个 Buffer，生产 300 帧必须依赖跨进程归还
+ * 
+ * 参数：共享内存 Pool 名称（可选）
+ */
+static int test_shared_output(const char* pool_name) {
+    const std::string name = (pool_name && pool_name[0]) ? pool_name : "vpl_output";
+    const int kTotalFrames = 300;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Production line shared-memory output - Pool: %s", name.c_str());
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    VideoProductionLine line(false, 2, false);  // loop=false, 2 个生产者线程
+    line.setSharedOutput(name, 4);
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(1920, 1080)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setPatternConfig(
+            PatternConfigBuilder()
+                .setName("bars")
+                .setTotalFrames(kTotalFrames)
+                .build()
+        )
+        .setWorkerType(WorkerType::TEST_PATTERN)
+        .build();
+    
+    // 分析进程：在 start() 之前 fork（此时还没有生产者线程，子进程不会继承被持有的日志 / malloc 锁），
+    // 父进程创建共享 Pool 后经管道通知子进程按名称附加，逐帧校验元数据后归还
+    int ready_pipe[2];
+    if (pipe(ready_pipe) != 0) {
+        LOG_ERROR("pipe() failed");
+        return -1;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        close(ready_pipe[1]);
+        char ready = 0;
+        ssize_t n;
+        do {
+            n = read(ready_pipe[0], &ready, 1);
+        } while (n < 0 && errno == EINTR);
+        if (n != 1) {
+            _exit(1);
+        }
+        auto consumer_pool = SharedMemoryBufferPool::attach(name);
+        if (!consumer_pool || consumer_pool->isCreator()) {
+            _exit(1);
+        }
+        int errors = 0;
+        for (int i = 0; i < kTotalFrames; i++) {
+            Buffer* buf = consumer_pool->acquireFilled(true, 2000);
+            if (buf == nullptr) {
+                _exit(2);
+            }
+            if (!buf->hasImageMetadata() || buf->getImageFormat() != AV_PIX_FMT_NV12 ||
+                buf->getImageWidth() != 1920 || buf->getImageHeight() != 1080) {
+                errors++;
+            }
+            consumer_pool->releaseFilled(buf);
+        }
+        _exit(errors == 0 ? 0 : 3);
+    }
+    close(ready_pipe[0]);
+    if (child < 0) {
+        LOG_ERROR("fork() failed");
+        close(ready_pipe[1]);
+        return -1;
+    }
+    
+    bool started = line.start(workerConfig);
+    if (started) {
+        char ready = 1;
+        started = write(ready_pipe[1], &ready, 1) == 1;
+    } else {
+        LOG_ERROR_FMT("Failed to start production line: %s", line.getLastError().c_str());
+    }
+    close(ready_pipe[1]);  // 启动失败时子进程读到 EOF 后退出
+    if (!started) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        line.stop();
+        return -1;
+    }
+    
+    int status = 0;
+    waitpid(child, &status, 0);
+    while (g_running && line.isRunning()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    line.printStats();
+    line.stop();
+    
+    int exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    LOG_INFO_FMT("Produced: %d / %d, analysis process exit code: %d, average FPS: %.2f",
+                 line.getProducedFrames(), kTotalFrames, exit_code, line.getAverageFPS());
+    
+    bool success = line.getProducedFrames() == kTotalFrames && exit_code == 0;
+    if (success) {
+        LOG_INFO("✅ Test PASSED");
+    } else {
+        LOG_ERROR("❌ Test FAILED");
+    }
+    return success ? 0 : -1;
+}
+
+/**
+ * 测试：回调式消费（FrameSink）
+ * 
+ * 功能：
+ * - 注册帧回调，由 VideoProductionLine 内部消费者线程分发已解码的 buffer
+ * - 多消费者线程 + 批量取出 + 自动归还
+ * - 校验 stop() 排空语义：回调收到的帧数 == 生产的帧数
+ */
+static int test_callback_consumer(const char* video_path) {
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Callback-driven consumer - File: %s", video_path);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    VideoProductionLine line(false, 2, true);  // loop=false, 2 个生产者线程, 启用性能监控
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setFileConfig(
+            FileConfigBuilder()
+                .setFilePath(video_path)
+                .build()
+        )
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(1920, 1080)
+                .setBitsPerPixel(32)
+                .build()
+        )
+        .setDecoderConfig(
+            DecoderConfigBuilder()
+                .useH264Taco()
+                .build()
+        )
+        .setWorkerType(WorkerType::FFMPEG_VIDEO_FILE)
+        .build();
+    
+    // 1. 注册帧回调（在消费者线程中调用，返回后 buffer 自动归还）
+    std::atomic<int> sink_frames(0);
+    line.addFrameSink([&sink_frames](Buffer* buffer) {
+        if (buffer && buffer->data()) {
+            sink_frames++;
+        }
+    });
+    line.setConsumerConfig(2, 4);  // 2 个消费者线程，每批最多 4 帧
+    
+    // 2. 启动：生产者和消费者一起运行
+    if (!line.start(workerConfig)) {
+        LOG_ERROR("Failed to start production line");
+        return -1;
+    }
+    
+    // 3. 等待自然结束（消费者排空后 isRunning() 才变为 false）
+    while (g_running && line.isRunning()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    line.printStats();
+    line.stop();
+    
+    LOG_INFO_FMT("Produced: %d, consumed: %d, sink frames: %d",
+                 line.getProducedFrames(), line.getConsumedFrames(), sink_frames.load());
+    
+    bool success = line.getProducedFrames() == sink_frames.load();
+    if (success) {
+        LOG_INFO("✅ Test PASSED");
+    } else {
+        LOG_ERROR("❌ Test FAILED");
+    }
+    return success ? 0 : -1;
+}
+
+/**
+ * 回调消费者播放一遍的统计结果（run_nv12_line 输出）
+ */
+struct Nv12LineResult {
+    int produced = 0;
+    int sink_frames = 0;
+    int bad_frames = 0;      // 没有期望格式的图像元数据，或 frame_check 返回 false 的帧
+    double fps = 0.0;
+    bool ended = false;      // 生产线自然结束（播放完一遍 / 流结束），没有超时
+};
+
+/**
+ * 以回调消费者播放一遍，等待生产线自然结束（sequence / stream / pattern 测试共用）
+ * 
+ * - 每帧检查图像元数据（像素格式为 format，默认 NV12），frame_check 非空时再做 Worker 特有的检查
+ * - 1 个消费者线程：回调串行执行，frame_check 可以按到达顺序检查（1 个生产者时即帧序）
+ * - timeout_ms > 0 时超过时限仍未结束即停止生产线（result->ended = false）
+ * 
+ * @param line 只用于这一次播放（frame sink 引用了本函数的局部变量）
+ * @return 生产线启动失败返回 false
+ */
+static bool run_nv12_line(VideoProductionLine& line, const WorkerConfig& worker_config,
+                          const std::function<bool(Buffer*)>& frame_check, int timeout_ms,
+                          Nv12LineResult* result, AVPixelFormat format = AV_PIX_FMT_NV12) {
+    *result = Nv12LineResult();
+    
+    std::atomic<int> sink_frames(0);
+    std::atomic<int> bad_frames(0);
+    line.addFrameSink([&sink_frames, &bad_frames, &frame_check, format](Buffer* buffer) {
+        if (!buffer || !buffer->hasImageMetadata() || buffer->getImageFormat() != format ||
+            (frame_check && !frame_check(buffer))) {
+            bad_frames++;
+        }
+        sink_frames++;
+    });
+    line.setConsumerConfig(1, 4);
+    
+    if (!line.start(worker_config)) {
+        LOG_ERROR_FMT("Failed to start production line: %s", line.getLastError().c_str());
+        return false;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (g_running && line.isRunning()) {
+        if (timeout_ms > 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    result->ended = !line.isRunning();
+    line.printStats();
+    line.stop();
+    
+    result->produced = line.getProducedFrames();
+    result->sink_frames = sink_frames.load();
+    result->bad_frames = bad_frames.load();
+    result->fps = line.getAverageFPS();
+    LOG_INFO_FMT("Produced: %d, sink frames: %d, bad frames: %d, average FPS: %.2f%s",
+                 result->produced, result->sink_frames, result->bad_frames, result->fps,
+                 result->ended ? "" : " (did not end)");
+    return true;
+}
+
+/**
+ * 输出测试结论，返回测试程序的退出码
+ */
+static int report_test_result(bool success) {
+    if (success) {
+        LOG_INFO("✅ Test PASSED");
+    } else {
+        LOG_ERROR("❌ Test FAILED");
+    }
+    return success ? 0 : -1;
+}
+
+/**
+ * 合成帧的帧序检查：第 N 个到达的帧（从 0 开始）首尾字节都必须是 (N + 1) & 0xFF
+ * 
+ * 合成输入（图像序列文件 / 写入 FIFO 的帧）按自然帧序把整帧填成 (N + 1) & 0xFF
+ */
+static std::function<bool(Buffer*)> make_sequence_check(std::shared_ptr<int> next_frame, size_t frame_size) {
+    return [next_frame, frame_size](Buffer* buffer) {
+        uint8_t expected = static_cast<uint8_t>(++*next_frame);
+        const uint8_t* data = static_cast<const uint8_t*>(buffer->data());
+        return buffer->size() >= frame_size && data[0] == expected && data[frame_size - 1] == expected;
+    };
+}
+
+/**
+ * 图像序列检查：合成序列的文件排序和 io_uring 预取
+ * 
+ * - 24 个 64x32 NV12 文件，文件名不补零（frame_1 .. frame_24，字典序 frame_10 在 frame_2 之前），
+ *   第 N 个文件的每个字节都是 N
+ * - 生产线播放一遍（1 个生产者）：帧必须按自然排序到达
+ * - 直接驱动 ImageSequenceWorker 顺序填充：除第一帧外都应命中预取
+ *   （内核不支持 IORING_OP_OPENAT 时退化为同步读取，不统计预取，跳过该项）
+ */
+static bool check_synthetic_image_sequence() {
+    const int kFrames = 24;
+    const int kWidth = 64;
+    const int kHeight = 32;
+    const size_t kFrameSize = kWidth * kHeight * 3 / 2;
+    
+    char dir_template[] = "/tmp/vpl_sequence_XXXXXX";
+    if (mkdtemp(dir_template) == nullptr) {
+        LOG_ERROR_FMT("mkdtemp failed: %s", strerror(errno));
+        return false;
+    }
+    const std::string dir = dir_template;
+    
+    bool ok = true;
+    std::vector<uint8_t> frame(kFrameSize);
+    for (int i = 1; i <= kFrames && ok; i++) {
+        std::string file = dir + "/frame_" + std::to_string(i) + ".nv12";
+        std::fill(frame.begin(), frame.end(), static_cast<uint8_t>(i));
+        FILE* fp = fopen(file.c_str(), "wb");
+        ok = fp != nullptr && fwrite(frame.data(), 1, frame.size(), fp) == frame.size();
+        if (fp) {
+            fclose(fp);
+        }
+    }
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setFileConfig(
+            FileConfigBuilder()
+                .setFilePath(dir)
+                .setReadahead(0, 8)
+                .build()
+        )
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(kWidth, kHeight)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setWorkerType(WorkerType::IMAGE_SEQUENCE)
+        .build();
+    
+    // 1. 生产线播放一遍：自然排序
+    if (ok) {
+        VideoProductionLine line(false, 1, false);  // loop=false, 1 个生产者线程（保持帧序）
+        Nv12LineResult result;
+        ok = run_nv12_line(line, workerConfig, make_sequence_check(std::make_shared<int>(0), kFrameSize),
+                           10000, &result) &&
+             result.ended && result.produced == kFrames && result.sink_frames == kFrames &&
+             result.bad_frames == 0;
+        LOG_INFO_FMT("Synthetic sequence order: %s", ok ? "natural (frame_2 before frame_10)" : "WRONG");
+    }
+    
+    // 2. 顺序填充：预取命中
+    if (ok) {
+        ImageSequenceWorker worker(workerConfig);
+        std::shared_ptr<BufferPool> pool;
+        if (worker.open(dir.c_str(), kWidth, kHeight, 12)) {
+            pool = BufferPoolRegistry::getInstance().getPool(worker.getOutputBufferPoolId()).lock();
+        }
+        ok = pool != nullptr;
+        for (int i = 0; i < kFrames && ok; i++) {
+            Buffer* buffer = pool->acquireFree(true, 1000);
+            ok = buffer != nullptr && worker.fillBuffer(i, buffer) &&
+                 static_cast<const uint8_t*>(buffer->data())[0] == static_cast<uint8_t>(i + 1);
+            if (buffer) {
+                pool->releaseFree(buffer);
+            }
+        }
+        pool.reset();
+        
+        uint64_t hits = worker.getPrefetchHits();
+        uint64_t misses = worker.getPrefetchMisses();
+        if (ok && hits + misses == 0) {
+            LOG_INFO("Synthetic sequence prefetch: synchronous fallback (no io_uring openat), skipped");
+        } else if (ok) {
+            ok = misses <= 1 && hits + misses == static_cast<uint64_t>(kFrames);
+            LOG_INFO_FMT("Synthetic sequence prefetch: %lu hits, %lu misses", hits, misses);
+        }
+        worker.close();
+    }
+    
+    for (int i = 1; i <= kFrames; i++) {
+        unlink((dir + "/frame_" + std::to_string(i) + ".nv12").c_str());
+    }
+    rmdir(dir.c_str());
+    return ok;
+}
+
+/**
+ * 测试：图像序列目录（ImageSequenceWorker，io_uring 预取，不显示）
+ * 
+ * 功能：
+ * - 先用合成序列检查文件排序和预取命中（check_synthetic_image_sequence）
+ * - 再播放参数指定的序列：每个文件是一帧 1920x1080 NV12（或 printf 模式，如 /data/seq/frame_%06d.nv12），
+ *   2 个生产者线程播放一遍，回调消费者检查每帧的图像元数据
+ * 
+ * 参数：序列目录或 printf 模式
+ */
+static int test_image_sequence(const char* sequence_path) {
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Image sequence (io_uring prefetch) - Path: %s", sequence_path);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    if (!check_synthetic_image_sequence()) {
+        LOG_ERROR("Synthetic image sequence check failed");
+        return report_test_result(false);
+    }
+    
+    VideoProductionLine line(false, 2, true);  // loop=false, 2 个生产者线程, 启用性能监控
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setFileConfig(
+            FileConfigBuilder()
+                .setFilePath(sequence_path)
+                .setReadahead(0, 8)  // 预取 8 个文件
+                .build()
+        )
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(1920, 1080)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setWorkerType(WorkerType::IMAGE_SEQUENCE)
+        .build();
+    
+    Nv12LineResult result;
+    if (!run_nv12_line(line, workerConfig, nullptr, 0, &result)) {
+        return -1;
+    }
+    return report_test_result(result.sink_frames > 0 && result.bad_frames == 0);
+}
+
+/**
+ * raw 帧流检查：写端关闭后生产线在 EOF 处自然结束
+ * 
+ * - 写线程向 FIFO 写入 48 帧 64x32 NV12（第 N 帧每个字节都是 N），然后关闭写端
+ * - 生产线（1 个生产者）必须在时限内自己结束，帧数一致且按写入顺序到达
+ */
+static bool check_raw_stream_eof() {
+    const int kFrames = 48;
+    const int kWidth = 64;
+    const int kHeight = 32;
+    const size_t kFrameSize = kWidth * kHeight * 3 / 2;
+    
+    char dir_template[] = "/tmp/vpl_stream_XXXXXX";
+    if (mkdtemp(dir_template) == nullptr) {
+        LOG_ERROR_FMT("mkdtemp failed: %s", strerror(errno));
+        return false;
+    }
+    const std::string dir = dir_template;
+    const std::string fifo = dir + "/frames.fifo";
+    if (mkfifo(fifo.c_str(), 0600) != 0) {
+        LOG_ERROR_FMT("mkfifo failed: %s", strerror(errno));
+        rmdir(dir.c_str());
+        return false;
+    }
+    
+    // 读端提前关闭时 write 返回 EPIPE，而不是终止测试进程
+    signal(SIGPIPE, SIG_IGN);
+    
+    std::thread writer([&fifo, kFrames, kFrameSize]() {
+        int fd = ::open(fifo.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        std::vector<uint8_t> frame(kFrameSize);
+        for (int i = 1; i <= kFrames; i++) {
+            std::fill(frame.begin(), frame.end(), static_cast<uint8_t>(i));
+            if (write(fd, frame.data(), frame.size()) != static_cast<ssize_t>(frame.size())) {
+                break;
+            }
+        }
+        ::close(fd);
+    });
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setFileConfig(
+            FileConfigBuilder()
+                .setFilePath(fifo)
+                .build()
+        )
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(kWidth, kHeight)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setWorkerType(WorkerType::RAW_STREAM)
+        .build();
+    
+    VideoProductionLine line(false, 1, false);  // loop=false, 1 个生产者线程（保持到达顺序）
+    Nv12LineResult result;
+    bool started = run_nv12_line(line, workerConfig, make_sequence_check(std::make_shared<int>(0), kFrameSize),
+                                 10000, &result);
+    if (!started) {
+        // 读端没有打开过 FIFO：以非阻塞方式打开一次，让写线程的 open 返回
+        int fd = ::open(fifo.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        writer.join();
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    } else {
+        writer.join();
+    }
+    unlink(fifo.c_str());
+    rmdir(dir.c_str());
+    
+    bool ok = started && result.ended && result.produced == kFrames && result.sink_frames == kFrames &&
+              result.bad_frames == 0;
+    LOG_INFO_FMT("Raw stream EOF: %s", ok ? "line ended after the writer closed" : "FAILED");
+    return ok;
+}
+
+/**
+ * 测试：raw 帧流输入（RawVideoStreamWorker，不显示）
+ * 
+ * 功能：
+ * - 先用 FIFO 检查写端关闭时的 EOF 处理（check_raw_stream_eof）
+ * - 再从参数指定的管道 / FIFO / Unix 流套接字读取 1920x1080 NV12 帧，流结束时生产线自然结束
+ * - 1 个生产者线程（保持到达顺序），回调消费者检查每帧的图像元数据
+ * 
+ * 用法示例：ffmpeg -i input.mp4 -f rawvideo -pix_fmt nv12 -s 1920x1080 - | ./test stream -
+ * 参数："-"（stdin）、FIFO 路径或 unix:/path/to.sock
+ */
+static int test_raw_stream(const char* stream_path) {
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Raw frame stream - Path: %s", stream_path);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    if (!check_raw_stream_eof()) {
+        LOG_ERROR("Raw stream EOF check failed");
+        return report_test_result(false);
+    }
+    
+    VideoProductionLine line(false, 1, true);  // loop=false（流不可定位）, 1 个生产者线程, 启用性能监控
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setFileConfig(
+            FileConfigBuilder()
+                .setFilePath(stream_path)
+                .build()
+        )
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(1920, 1080)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setWorkerType(WorkerType::RAW_STREAM)
+        .build();
+    
+    Nv12LineResult result;
+    if (!run_nv12_line(line, workerConfig, nullptr, 0, &result)) {
+        return -1;
+    }
+    return report_test_result(result.sink_frames > 0 && result.bad_frames == 0);
+}
+
+// 与 TestPatternWorker 的帧号字模一致：3x5 点阵（每行低 3 位从左到右），每点 8x8 像素，
+// 每个数字占 32 像素宽，距左上角 16 像素；亮点白色、暗点黑色
+static const int kStampDotSize = 8;
+static const int kStampGlyphWidth = 4 * kStampDotSize;
+static const int kStampMargin = 16;
+static const uint8_t kStampFont[10][5] = {
+    {7, 5, 5, 5, 7}, {2, 6, 2, 2, 7}, {7, 1, 7, 4, 7}, {7, 1, 7, 1, 7}, {5, 5, 7, 1, 1},
+    {7, 4, 7, 1, 7}, {7, 4, 7, 5, 7}, {7, 1, 1, 1, 1}, {7, 5, 7, 5, 7}, {7, 5, 7, 1, 7}
+};
+
+/**
+ * RGB → BT.601 有限范围亮度（与 TestPatternWorker 的转换一致）
+ */
+static int bt601_luma(int r, int g, int b) {
+    return 16 + ((66 * r + 129 * g + 25 * b + 128) >> 8);
+}
+
+/**
+ * 从 NV12 亮度平面读出 TestPatternWorker 叠加的帧号（取每个点阵点的中心像素）
+ * 
+ * @return 帧号（第一个位置就不是数字时返回 -1）
+ */
+static int read_stamped_frame_number(Buffer* buffer) {
+    const uint8_t* luma = buffer->getImagePlaneData(0);
+    const int stride = buffer->getImageLinesize()[0];
+    const int on = bt601_luma(255, 255, 255);
+    const int off = bt601_luma(0, 0, 0);
+    if (luma == nullptr || buffer->getImageHeight() < kStampMargin + 5 * kStampDotSize) {
+        return -1;
+    }
+    
+    int value = -1;
+    for (int k = 0; kStampMargin + (k + 1) * kStampGlyphWidth <= buffer->getImageWidth(); k++) {
+        uint8_t rows[5] = {0, 0, 0, 0, 0};
+        bool glyph = true;
+        for (int row = 0; row < 5 && glyph; row++) {
+            for (int column = 0; column < 3 && glyph; column++) {
+                int x = kStampMargin + k * kStampGlyphWidth + column * kStampDotSize + kStampDotSize / 2;
+                int y = kStampMargin + row * kStampDotSize + kStampDotSize / 2;
+                int v = luma[static_cast<size_t>(y) * stride + x];
+                if (v == on) {
+                    rows[row] |= static_cast<uint8_t>(1 << (2 - column));
+                } else if (v != off) {
+                    glyph = false;   // 图案背景：数字结束
+                }
+            }
+        }
+        
+        int digit = -1;
+        for (int d = 0; glyph && d < 10 && digit < 0; d++) {
+            if (memcmp(rows, kStampFont[d], sizeof(rows)) == 0) {
+                digit = d;
+            }
+        }
+        if (digit < 0) {
+            break;
+        }
+        value = (value < 0 ? 0 : value * 10) + digit;
+    }
+    return value;
+}
+
+/**
+ * 图案像素检查：最后一行（帧号之外）的亮度
+ * 
+ * - bars：8 个 75% 彩条中心的亮度
+ * - counter：灰色背景
+ * - gradient / noise 逐帧变化，只检查帧号
+ */
+static bool check_pattern_pixels(const std::string& pattern, Buffer* buffer) {
+    static const int kBars[8][3] = {
+        {191, 191, 191}, {191, 191, 0}, {0, 191, 191}, {0, 191, 0},
+        {191, 0, 191}, {191, 0, 0}, {0, 0, 191}, {0, 0, 0}
+    };
+    const int width = buffer->getImageWidth();
+    const uint8_t* last_row = buffer->getImagePlaneData(0) +
+                              static_cast<size_t>(buffer->getImageHeight() - 1) * buffer->getImageLinesize()[0];
+    
+    if (pattern == "bars") {
+        for (int bar = 0; bar < 8; bar++) {
+            if (last_row[(2 * bar + 1) * width / 16] != bt601_luma(kBars[bar][0], kBars[bar][1], kBars[bar][2])) {
+                return false;
+            }
+        }
+    } else if (pattern == "counter") {
+        return last_row[width - 1] == bt601_luma(48, 48, 48);
+    }
+    return true;
+}
+
+/**
+ * 测试：合成测试图案（TestPatternWorker，不读文件，不显示）
+ * 
+ * 功能：
+ * - 生成 600 帧 1920x1080 NV12 图案（叠加帧号），4 个生产者线程不限速
+ * - 回调消费者检查图像元数据和内容：读出的帧号覆盖 0..599 且不重复，图案像素与配置一致
+ * - 平均 FPS 即生产线（Pool + 消费者）的吞吐上限
+ * 
+ * 参数：图案名称 bars / gradient / noise / counter
+ */
+static int test_pattern_generator(const char* pattern_name) {
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Synthetic test pattern - Pattern: %s", pattern_name);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    const int kTotalFrames = 600;
+    VideoProductionLine line(false, 4, true);  // loop=false, 4 个生产者线程, 启用性能监控
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(1920, 1080)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setPatternConfig(
+            PatternConfigBuilder()
+                .setName(pattern_name)
+                .setStampFrameNumber(true)
+                .setTotalFrames(kTotalFrames)
+                .build()
+        )
+        .setWorkerType(WorkerType::TEST_PATTERN)
+        .build();
+    
+    // 回调串行执行（1 个消费者线程），seen 不需要加锁
+    const std::string pattern = pattern_name;
+    std::vector<char> seen(kTotalFrames, 0);
+    auto check = [&pattern, &seen, kTotalFrames](Buffer* buffer) {
+        int frame_number = read_stamped_frame_number(buffer);
+        if (frame_number < 0 || frame_number >= kTotalFrames || seen[frame_number]) {
+            return false;
+        }
+        seen[frame_number] = 1;
+        return check_pattern_pixels(pattern, buffer);
+    };
+    
+    Nv12LineResult result;
+    if (!run_nv12_line(line, workerConfig, check, 0, &result)) {
+        return -1;
+    }
+    
+    int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+    LOG_INFO_FMT("Expected frames: %d, distinct frame numbers read back: %d", kTotalFrames, stamped);
+    return report_test_result(result.produced == kTotalFrames && result.sink_frames == kTotalFrames &&
+                              result.bad_frames == 0 && stamped == kTotalFrames);
+}
+
+/**
+ * 测试：批量填充（WorkerBase::fillBuffers）
+ * 
+ * 功能：
+ * - 同一个 raw 文件（1920x1080 NV12）分别用 mmap / io_uring Worker 各播放一遍：逐帧填充 vs 批量填充 8 帧
+ * - 批量填充时使用 CHUNKED 帧索引分配，同一批帧连续（mmap 一次预取，io_uring 一次提交）
+ * - 每种配置的生产帧数和回调收到的帧数必须一致，输出平均 FPS 对比
+ * 
+ * 参数：raw 文件路径
+ */
+static int test_fill_batch(const char* raw_video_path) {
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Batched buffer filling - File: %s", raw_video_path);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    // 播放一遍，返回生产帧数（失败返回 -1）
+    auto run = [raw_video_path](WorkerType type, int batch_size, double* fps) -> int {
+        VideoProductionLine line(false, 2, false);  // loop=false, 2 个生产者线程
+        line.setFrameClaimMode(VideoProductionLine::FrameClaimMode::CHUNKED);
+        line.setFillBatchSize(batch_size);
+        
+        auto workerConfig = WorkerConfigBuilder()
+            .setFileConfig(
+                FileConfigBuilder()
+                    .setFilePath(raw_video_path)
+                    .build()
+            )
+            .setOutputConfig(
+                OutputConfigBuilder()
+                    .setResolution(1920, 1080)
+                    .setBitsPerPixel(12)
+                    .setPixelFormat(AV_PIX_FMT_NV12)
+                    .build()
+            )
+            .setWorkerType(type)
+            .build();
+        
+        std::atomic<int> sink_frames(0);
+        line.addFrameSink([&sink_frames](Buffer* /*buffer*/) {
+            sink_frames++;
+        });
+        line.setConsumerConfig(1, batch_size);
+        
+        if (!line.start(workerConfig)) {
+            LOG_ERROR("Failed to start production line");
+            return -1;
+        }
+        while (g_running && line.isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        line.printStats();
+        line.stop();
+        
+        *fps = line.getAverageFPS();
+        return line.getProducedFrames() == sink_frames.load() ? line.getProducedFrames() : -1;
+    };
+    
+    bool success = true;
+    const WorkerType types[] = {WorkerType::MMAP_RAW, WorkerType::IOURING_RAW};
+    for (WorkerType type : types) {
+        const char* name = type == WorkerType::MMAP_RAW ? "mmap" : "io_uring";
+        double single_fps = 0.0;
+        double batch_fps = 0.0;
+        int single_frames = run(type, 1, &single_fps);
+        int batch_frames = run(type, 8, &batch_fps);
+        LOG_INFO_FMT("%-8s per-frame: %d frames, %.2f fps | batch of 8: %d frames, %.2f fps",
+                     name, single_frames, single_fps, batch_frames, batch_fps);
+        if (single_frames <= 0 || batch_frames != single_frames) {
+            success = false;
+        }
+    }
+    
+    if (success) {
+        LOG_INFO("✅ Test PASSED");
+    } else {
+        LOG_ERROR("❌ Test FAILED");
+    }
+    return success ? 0 : -1;
+}
+
+/**
+ * 测试：整帧拷贝带宽（FrameCopy）
+ * 
+ * 功能：
+ * - 对比 libc memcpy、单线程流式拷贝、条带多线程流式拷贝的带宽
+ * - 每种方式拷贝后校验目标数据
+ * 
+ * 参数：帧大小（MB，默认 33 ≈ 3840x2160 ARGB）
+ */
+static int test_frame_copy_bench(const char* size_mb_arg) {
+    int size_mb = (size_mb_arg && atoi(size_mb_arg) > 0) ? atoi(size_mb_arg) : 33;
+    const size_t frame_size = (size_t)size_mb * 1024 * 1024;
+    const int iterations = 50;
+    const int hw_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO("  Test: FrameCopy bandwidth benchmark");
+    LOG_INFO_FMT("  Frame: %d MB, iterations: %d, ISA: %s", size_mb, iterations, FrameCopy::getIsaName());
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    // 源 / 目标各自页对齐（与 BufferPool 分配一致），先写一遍避免把缺页计入带宽
+    void* src_ptr = nullptr;
+    void* dst_ptr = nullptr;
+    if (posix_memalign(&src_ptr, 4096, frame_size) != 0 || posix_memalign(&dst_ptr, 4096, frame_size) != 0) {
+        LOG_ERROR("Failed to allocate benchmark buffers");
+        free(src_ptr);
+        return -1;
+    }
+    uint8_t* src = (uint8_t*)src_ptr;
+    uint8_t* dst = (uint8_t*)dst_ptr;
+    for (size_t i = 0; i < frame_size; i++) {
+        src[i] = (uint8_t)(i * 131 + 7);
+    }
+    memset(dst, 0, frame_size);
+    
+    FrameCopy& copier = FrameCopy::getInstance();
+    const int saved_helpers = copier.getHelperThreads();
+    const bool saved_streaming = copier.isStreaming();
+    bool success = true;
+    
+    auto measure = [&](const char* name, const std::function<void()>& copy_fn) {
+        copy_fn();  // 预热
+        memset(dst, 0, frame_size);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations && g_running; i++) {
+            copy_fn();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool valid = memcmp(dst, src, frame_size) == 0;
+        success = success && valid;
+        double gbps = seconds > 0 ? (double)frame_size * iterations / seconds / 1e9 : 0.0;
+        LOG_INFO_FMT("  %-28s %7.2f GB/s  %6.2f ms/frame  %s", name, gbps,
+                     seconds * 1000.0 / iterations, valid ? "OK" : "MISMATCH");
+    };
+    
+    measure("memcpy", [&] { memcpy(dst, src, frame_size); });
+    copier.setHelperThreads(0);
+    copier.setStreaming(true);
+    measure("FrameCopy streaming x1", [&] { copier.copy(dst, src, frame_size); });
+    for (int helpers = 1; helpers < std::min(hw_threads, 8); helpers = helpers * 2 + 1) {
+        copier.setHelperThreads(helpers);
+        char name[64];
+        snprintf(name, sizeof(name), "FrameCopy streaming x%d", helpers + 1);
+        measure(name, [&] { copier.copy(dst, src, frame_size); });
+    }
+    // 按行拷贝（1920x1080 ARGB 行宽，源行跨度带 256 字节填充）
+    const size_t row_bytes = 1920 * 4;
+    const int rows = (int)(frame_size / (row_bytes + 256));
+    copier.setHelperThreads(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations && g_running; i++) {
+        copier.copyRows(dst, row_bytes, src, row_bytes + 256, row_bytes, rows);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    bool rows_valid = true;
+    for (int r = 0; r < rows && rows_valid; r++) {
+        rows_valid = memcmp(dst + r * row_bytes, src + r * (row_bytes + 256), row_bytes) == 0;
+    }
+    success = success && rows_valid;
+    LOG_INFO_FMT("  %-28s %7.2f GB/s  %s", "FrameCopy copyRows x1",
+                 seconds > 0 ? (double)row_bytes * rows * iterations / seconds / 1e9 : 0.0,
+                 rows_valid ? "OK" : "MISMATCH");
+    
+    copier.setHelperThreads(saved_helpers);
+    copier.setStreaming(saved_streaming);
+    free(src_ptr);
+    free(dst_ptr);
+    
+    if (success) {
+        LOG_INFO("✅ Test PASSED");
+    } else {
+        LOG_ERROR("❌ Test FAILED");
+    }
+    return success ? 0 : -1;
+}
+
+/**
+ * 读入整个文件（索引 / sample 表检查用）
+ */
+static bool read_whole_file(const char* path, std::vector<uint8_t>* data) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        LOG_ERROR_FMT("Cannot open %s: %s", path, strerror(errno));
+        return false;
+    }
+    uint8_t chunk[65536];
+    size_t n = 0;
+    data->clear();
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        data->insert(data->end(), chunk, chunk + n);
+    }
+    fclose(fp);
+    return true;
+}
+
+/**
+ * 用 4 个生产者线程经 MmapRawVideoFileWorker 解码播放压缩文件一遍（H.264 Annex-B / MP4）
+ * 
+ * samples 以关键帧开始时生产帧数必须等于 sample 数（否则开头不可解码的帧会被跳过）
+ */
+static bool play_compressed_mmap(const char* path, const std::vector<productionline::io::CompressedSample>& samples) {
+    VideoProductionLine line(false, 4, false);  // loop=false, 4 个生产者线程
+    auto workerConfig = WorkerConfigBuilder()
+        .setFileConfig(
+            FileConfigBuilder()
+                .setFilePath(path)
+                .build()
+        )
+        .setWorkerType(WorkerType::MMAP_RAW)
+        .build();
+    
+    std::atomic<int> sink_frames(0);
+    std::atomic<int> bad_frames(0);
+    line.addFrameSink([&sink_frames, &bad_frames](Buffer* buffer) {
+        if (!buffer || !buffer->hasImageMetadata()) {
+            bad_frames++;
+        }
+        sink_frames++;
+    });
+    line.setConsumerConfig(1, 4);
+    
+    if (!line.start(workerConfig)) {
+        LOG_ERROR_FMT("Failed to start production line: %s", line.getLastError().c_str());
+        return false;
+    }
+    while (g_running && line.isRunning()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    line.printStats();
+    line.stop();
+    
+    int expected_frames = samples.front().keyframe ? static_cast<int>(samples.size()) : line.getProducedFrames();
+    LOG_INFO_FMT("Produced: %d (samples: %zu), sink frames: %d, frames without metadata: %d, average FPS: %.2f",
+                 line.getProducedFrames(), samples.size(), sink_frames.load(), bad_frames.load(),
+                 line.getAverageFPS());
+    return line.getProducedFrames() > 0 && line.getProducedFrames() == expected_frames &&
+           sink_frames.load() == line.getProducedFrames() && bad_frames.load() == 0;
+}
+
+/**
+ * H.264 Annex-B 索引检查：已知结构的合成码流
+ * 
+ * - 3 个 GOP，每个 GOP：IDR（AUD + SPS + PPS + 2 个 slice）+ 3 个 P 帧（2 个 slice，第 2 个 P 帧前有 SEI）
+ * - 4 字节 / 3 字节起始码混用（4 字节起始码的前导 0 属于本 NAL）
+ * - 逐项比较访问单元数、偏移、长度、关键帧集合和 NAL 数
+ */
+static bool check_synthetic_annexb_index() {
+    using productionline::io::CompressedSample;
+    using productionline::io::H264AnnexBIndex;
+    
+    std::vector<uint8_t> stream;
+    std::vector<CompressedSample> expected;
+    int nal_count = 0;
+    
+    // slice 的第一个载荷字节：first_mb_in_slice 为 ue(v)，0 编码为单个 '1' 比特（0x88），非 0 时最高位为 0（0x08）
+    auto add_nal = [&stream, &nal_count](int type, bool long_start_code, bool first_slice, size_t payload_size) {
+        if (long_start_code) {
+            stream.push_back(0);
+        }
+        stream.insert(stream.end(), {0, 0, 1, static_cast<uint8_t>(0x60 | type),
+                                     static_cast<uint8_t>(first_slice ? 0x88 : 0x08)});
+        stream.insert(stream.end(), payload_size, 0x55);
+        nal_count++;
+    };
+    auto begin_access_unit = [&stream, &expected](bool keyframe) {
+        if (!expected.empty()) {
+            expected.back().size = static_cast<uint32_t>(stream.size() - expected.back().offset);
+        }
+        CompressedSample sample;
+        sample.offset = stream.size();
+        sample.keyframe = keyframe;
+        expected.push_back(sample);
+    };
+    
+    for (int gop = 0; gop < 3; gop++) {
+        begin_access_unit(true);
+        add_nal(9, true, false, 1);                 // AUD
+        add_nal(7, true, false, 12);                // SPS
+        add_nal(8, false, false, 4);                // PPS
+        add_nal(5, true, true, 200 + gop);          // IDR slice 0
+        add_nal(5, false, false, 150);              // IDR slice 1
+        for (int p = 0; p < 3; p++) {
+            begin_access_unit(false);
+            if (p == 1) {
+                add_nal(6, true, false, 8);         // SEI
+            }
+            add_nal(1, p != 1, true, 60 + p);       // P slice 0
+            add_nal(1, false, false, 40);           // P slice 1
+        }
+    }
+    expected.back().size = static_cast<uint32_t>(stream.size() - expected.back().offset);
+    
+    H264AnnexBIndex index;
+    if (!index.build(stream.data(), stream.size())) {
+        LOG_ERROR("Synthetic Annex-B stream: no access units found");
+        return false;
+    }
+    
+    const std::vector<CompressedSample>& samples = index.getSamples();
+    bool ok = samples.size() == expected.size() && index.getNalCount() == nal_count &&
+              index.getKeyframeCount() == 3;
+    for (size_t i = 0; ok && i < samples.size(); i++) {
+        if (samples[i].offset != expected[i].offset || samples[i].size != expected[i].size ||
+            samples[i].keyframe != expected[i].keyframe) {
+            LOG_ERROR_FMT("Access unit %zu: offset %lu size %u key %d, expected offset %lu size %u key %d", i,
+                          (unsigned long)samples[i].offset, samples[i].size, samples[i].keyframe ? 1 : 0,
+                          (unsigned long)expected[i].offset, expected[i].size, expected[i].keyframe ? 1 : 0);
+            ok = false;
+        }
+    }
+    LOG_INFO_FMT("Synthetic Annex-B stream: %zu access units (expected %zu), %d NAL units (expected %d), %d IDR",
+                 samples.size(), expected.size(), index.getNalCount(), nal_count, index.getKeyframeCount());
+    return ok;
+}
+
+/**
+ * 测试：H.264 Annex-B 访问单元索引（H264AnnexBIndex + MmapRawVideoFileWorker 解码）
+ * 
+ * 功能：
+ * - 先用结构已知的合成码流逐项检查索引（check_synthetic_annexb_index）
+ * - 参数指定的 .h264 文件：访问单元首尾相接覆盖整个文件
+ * - 4 个生产者线程解码播放一遍（MmapRawVideoFileWorker 按帧序进入解码器），
+ *   码流以 IDR 开始时生产帧数必须等于访问单元数
+ * 
+ * 参数：H.264 Annex-B 裸流文件（.h264 / .264）
+ */
+static int test_h264_annexb_index(const char* h264_path) {
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: H.264 Annex-B access unit index - File: %s", h264_path);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    if (!check_synthetic_annexb_index()) {
+        LOG_ERROR("Synthetic Annex-B index check failed");
+        return report_test_result(false);
+    }
+    
+    // 1. 索引覆盖整个文件
+    std::vector<uint8_t> data;
+    if (!read_whole_file(h264_path, &data)) {
+        return -1;
+    }
+    
+    productionline::io::H264AnnexBIndex index;
+    if (!index.build(data.data(), data.size())) {
+        LOG_ERROR("No H.264 access units found");
+        return report_test_result(false);
+    }
+    const auto& samples = index.getSamples();
+    bool contiguous = samples.back().offset + samples.back().size == data.size();
+    for (size_t i = 1; contiguous && i < samples.size(); i++) {
+        contiguous = samples[i - 1].offset + samples[i - 1].size == samples[i].offset;
+    }
+    LOG_INFO_FMT("Access units: %zu (%d NAL units, %d IDR), contiguous: %s",
+                 samples.size(), index.getNalCount(), index.getKeyframeCount(), contiguous ? "yes" : "NO");
+    
+    // 2. 多生产者解码播放一遍
+    return report_test_result(contiguous && play_compressed_mmap(h264_path, samples));
+}
+
+/**
+ * 合成 MP4 的大端写入工具（bytes 不超过 8；box 头先写 0 长度，结束时回填）
+ */
+static void put_be(std::vector<uint8_t>* out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+        out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+static size_t begin_box(std::vector<uint8_t>* out, const char* type) {
+    size_t start = out->size();
+    put_be(out, 0, 4);
+    out->insert(out->end(), type, type + 4);
+    return start;
+}
+
+static void end_box(std::vector<uint8_t>* out, size_t start) {
+    uint32_t size = static_cast<uint32_t>(out->size() - start);
+    for (int i = 0; i < 4; i++) {
+        (*out)[start + i] = static_cast<uint8_t>(size >> (8 * (3 - i)));
+    }
+}
+
+/**
+ * 合成 MP4 的损坏方式（check_synthetic_mp4_table）
+ */
+enum class Mp4Corruption {
+    NONE,
+    HUGE_SAMPLE_COUNT,   // stsz 固定 sample 大小 1、sample 数 0xFFFFFFFF（远超文件大小）
+    WRAPPING_OFFSET      // 最后一个 chunk 的 co64 偏移接近 2^64（offset + size 溢出回绕）
+};
+
+/**
+ * MP4 sample 表检查：结构已知的合成文件
+ * 
+ * - ftyp + mdat + moov（moov 在 mdat 之后）；moov 中先是音频轨，再是 320x240 avc1 视频轨
+ * - 7 个 sample 分在 3 个 chunk（stsc 两个条目：3 + 3 + 1），chunk 之间有填充字节，
+ *   每个 sample 的数据是它的序号
+ * - stss = {1, 5}，stts = 7 x 3000 / timescale 90000（30 fps），avcC extradata
+ * - 分别用 stco 和 co64 写 chunk 偏移，逐项比较 sample 数、偏移、长度、关键帧集合、几何、extradata 和帧率
+ * - corruption 不是 NONE 时按对应方式损坏 sample 表，parse() 必须失败（不能按 sample 数分配或接受文件外的 sample）
+ */
+static bool check_synthetic_mp4_table(bool co64, Mp4Corruption corruption = Mp4Corruption::NONE) {
+    using productionline::io::CompressedSample;
+    using productionline::io::Mp4SampleTable;
+    
+    const uint32_t kSizes[7] = {900, 120, 130, 140, 800, 150, 160};
+    const int kChunkSamples[3] = {3, 3, 1};
+    const uint8_t kAvcC[] = {1, 0x64, 0x00, 0x1F, 0xFF, 0xE1, 0x00, 0x04, 0x67, 0x64, 0x00, 0x1F, 0x01, 0x00, 0x02, 0x68, 0xEE};
+    
+    std::vector<uint8_t> file;
+    std::vector<CompressedSample> expected;
+    std::vector<uint64_t> chunk_offsets;
+    
+    size_t box = begin_box(&file, "ftyp");
+    file.insert(file.end(), {'i', 's', 'o', 'm', 0, 0, 2, 0, 'i', 's', 'o', 'm', 'a', 'v', 'c', '1'});
+    end_box(&file, box);
+    
+    box = begin_box(&file, "mdat");
+    int sample = 0;
+    for (int chunk = 0; chunk < 3; chunk++) {
+        file.insert(file.end(), 16, 0xEE);   // chunk 之间的其他数据（如交错的音频）
+        chunk_offsets.push_back(file.size());
+        for (int i = 0; i < kChunkSamples[chunk]; i++, sample++) {
+            CompressedSample s;
+            s.offset = file.size();
+            s.size = kSizes[sample];
+            s.keyframe = sample == 0 || sample == 4;
+            expected.push_back(s);
+            file.insert(file.end(), kSizes[sample], static_cast<uint8_t>(sample));
+        }
+    }
+    end_box(&file, box);
+    
+    size_t moov = begin_box(&file, "moov");
+    // 音频轨：hdlr 不是 vide，必须跳过
+    size_t trak = begin_box(&file, "trak");
+    size_t mdia = begin_box(&file, "mdia");
+    box = begin_box(&file, "hdlr");
+    put_be(&file, 0, 8);
+    file.insert(file.end(), {'s', 'o', 'u', 'n'});
+    file.insert(file.end(), 12, 0);
+    file.push_back(0);
+    end_box(&file, box);
+    end_box(&file, mdia);
+    end_box(&file, trak);
+    
+    trak = begin_box(&file, "trak");
+    mdia = begin_box(&file, "mdia");
+    box = begin_box(&file, "mdhd");
+    file.insert(file.end(), 12, 0);  // version 0 / flags、creation、modification
+    put_be(&file, 90000, 4);         // timescale
+    put_be(&file, 21000, 4);         // duration
+    put_be(&file, 0, 4);             // language、pre_defined
+    end_box(&file, box);
+    box = begin_box(&file, "hdlr");
+    put_be(&file, 0, 8);
+    file.insert(file.end(), {'v', 'i', 'd', 'e'});
+    file.insert(file.end(), 12, 0);
+    file.push_back(0);
+    end_box(&file, box);
+    size_t minf = begin_box(&file, "minf");
+    size_t stbl = begin_box(&file, "stbl");
+    
+    box = begin_box(&file, "stsd");
+    put_be(&file, 0, 4);
+    put_be(&file, 1, 4);
+    size_t entry = begin_box(&file, "avc1");
+    put_be(&file, 0, 6);             // reserved
+    put_be(&file, 1, 2);             // data_reference_index
+    file.insert(file.end(), 16, 0);  // pre_defined / reserved
+    put_be(&file, 320, 2);
+    put_be(&file, 240, 2);
+    file.insert(file.end(), 78 - 28, 0);
+    size_t avcc = begin_box(&file, "avcC");
+    file.insert(file.end(), kAvcC, kAvcC + sizeof(kAvcC));
+    end_box(&file, avcc);
+    end_box(&file, entry);
+    end_box(&file, box);
+    
+    box = begin_box(&file, "stts");
+    put_be(&file, 0, 4);
+    put_be(&file, 1, 4);
+    put_be(&file, 7, 4);
+    put_be(&file, 3000, 4);
+    end_box(&file, box);
+    
+    box = begin_box(&file, "stss");
+    put_be(&file, 0, 4);
+    put_be(&file, 2, 4);
+    put_be(&file, 1, 4);
+    put_be(&file, 5, 4);
+    end_box(&file, box);
+    
+    box = begin_box(&file, "stsc");
+    put_be(&file, 0, 4);
+    put_be(&file, 2, 4);
+    put_be(&file, 1, 4);             // chunk 1..2：每 chunk 3 个 sample
+    put_be(&file, 3, 4);
+    put_be(&file, 1, 4);
+    put_be(&file, 3, 4);             // chunk 3..：每 chunk 1 个 sample
+    put_be(&file, 1, 4);
+    put_be(&file, 1, 4);
+    end_box(&file, box);
+    
+    box = begin_box(&file, "stsz");
+    put_be(&file, 0, 4);
+    if (corruption == Mp4Corruption::HUGE_SAMPLE_COUNT) {
+        put_be(&file, 1, 4);         // sample_size = 1：没有大小表约束 sample 数
+        put_be(&file, 0xFFFFFFFFu, 4);
+    } else {
+        put_be(&file, 0, 4);         // sample_size = 0：逐个给出
+        put_be(&file, 7, 4);
+        for (uint32_t size : kSizes) {
+            put_be(&file, size, 4);
+        }
+    }
+    end_box(&file, box);
+    
+    box = begin_box(&file, co64 ? "co64" : "stco");
+    put_be(&file, 0, 4);
+    put_be(&file, chunk_offsets.size(), 4);
+    if (corruption == Mp4Corruption::WRAPPING_OFFSET) {
+        chunk_offsets.back() = ~0ULL - 15;   // 加上 sample 大小后回绕到文件内
+    }
+    for (uint64_t offset : chunk_offsets) {
+        put_be(&file, offset, co64 ? 8 : 4);
+    }
+    end_box(&file, box);
+    
+    end_box(&file, stbl);
+    end_box(&file, minf);
+    end_box(&file, mdia);
+    end_box(&file, trak);
+    end_box(&file, moov);
+    
+    Mp4SampleTable table;
+    if (corruption != Mp4Corruption::NONE) {
+        bool rejected = !table.parse(file.data(), file.size());
+        LOG_INFO_FMT("Corrupted MP4 (%s): %s", corruption == Mp4Corruption::HUGE_SAMPLE_COUNT ?
+                     "sample count beyond file size" : "wrapping chunk offset", rejected ? "rejected" : "ACCEPTED");
+        return rejected;
+    }
+    if (!table.parse(file.data(), file.size())) {
+        LOG_ERROR_FMT("Synthetic MP4 (%s): parse failed", co64 ? "co64" : "stco");
+        return false;
+    }
+    
+    const std::vector<CompressedSample>& samples = table.getSamples();
+    bool ok = samples.size() == expected.size() && table.getKeyframeCount() == 2 &&
+              table.getCodec() == Mp4SampleTable::Codec::H264 && table.getCodecTag() == "avc1" &&
+              table.getWidth() == 320 && table.getHeight() == 240 &&
+              table.getExtradata() == std::vector<uint8_t>(kAvcC, kAvcC + sizeof(kAvcC)) &&
+              table.getFrameRate() > 29.99 && table.getFrameRate() < 30.01;
+    for (size_t i = 0; ok && i < samples.size(); i++) {
+        if (samples[i].offset != expected[i].offset || samples[i].size != expected[i].size ||
+            samples[i].keyframe != expected[i].keyframe || file[samples[i].offset] != static_cast<uint8_t>(i)) {
+            LOG_ERROR_FMT("Sample %zu: offset %lu size %u key %d, expected offset %lu size %u key %d", i,
+                          (unsigned long)samples[i].offset, samples[i].size, samples[i].keyframe ? 1 : 0,
+                          (unsigned long)expected[i].offset, expected[i].size, expected[i].keyframe ? 1 : 0);
+            ok = false;
+        }
+    }
+    LOG_INFO_FMT("Synthetic MP4 (%s): %zu samples (expected %zu), %d sync, %s %dx%d, %.2f fps, extradata %zu bytes",
+                 co64 ? "co64" : "stco", samples.size(), expected.size(), table.getKeyframeCount(),
+                 table.getCodecTag().c_str(), table.getWidth(), table.getHeight(), table.getFrameRate(),
+                 table.getExtradata().size());
+    return ok;
+}
+
+/**
+ * 测试：MP4 sample 表（Mp4SampleTable + MmapRawVideoFileWorker 解码）
+ * 
+ * 功能：
+ * - 先用结构已知的合成 MP4（stco / co64 各一次）逐项检查 sample 表（check_synthetic_mp4_table）
+ * - 损坏的合成 MP4（sample 数超出文件大小、co64 偏移回绕）必须解析失败
+ * - 参数指定的 MP4：sample 都在文件内、第一个 sample 是同步 sample、有 avcC / hvcC extradata
+ * - 4 个生产者线程解码播放一遍，生产帧数必须等于 sample 数
+ * 
+ * 参数：MP4 文件（H.264 / H.265 视频轨，非分片）
+ */
+static int test_mp4_sample_table(const char* mp4_path) {
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: MP4 sample table - File: %s", mp4_path);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    if (!check_synthetic_mp4_table(false) || !check_synthetic_mp4_table(true) ||
+        !check_synthetic_mp4_table(true, Mp4Corruption::HUGE_SAMPLE_COUNT) ||
+        !check_synthetic_mp4_table(true, Mp4Corruption::WRAPPING_OFFSET)) {
+        LOG_ERROR("Synthetic MP4 sample table check failed");
+        return report_test_result(false);
+    }
+    
+    // 1. sample 表与文件一致
+    std::vector<uint8_t> data;
+    if (!read_whole_file(mp4_path, &data)) {
+        return -1;
+    }
+    
+    productionline::io::Mp4SampleTable table;
+    if (!table.parse(data.data(), data.size())) {
+        LOG_ERROR("Cannot build MP4 sample table");
+        return report_test_result(false);
+    }
+    const auto& samples = table.getSamples();
+    bool in_file = true;
+    for (size_t i = 0; in_file && i < samples.size(); i++) {
+        in_file = samples[i].size > 0 && samples[i].offset + samples[i].size <= data.size();
+    }
+    LOG_INFO_FMT("Video track: %s %dx%d, %zu samples (%d sync), %.2f fps, extradata %zu bytes",
+                 table.getCodecTag().c_str(), table.getWidth(), table.getHeight(), samples.size(),
+                 table.getKeyframeCount(), table.getFrameRate(), table.getExtradata().size());
+    bool valid = in_file && samples.front().keyframe && !table.getExtradata().empty();
+    
+    // 2. 多生产者解码播放一遍
+    return report_test_result(valid && play_compressed_mmap(mp4_path, samples));
+}
+
+/**
+ * 测试：多阶段流水线（addStage，阶段顺序和输出）
+ * 
+ * 功能：
+ * - 320x240 NV12 counter 图案（叠加帧号）-> 阶段 mark1（2 个线程）-> 阶段 mark2 -> 回调消费者
+ * - 每个阶段整帧拷贝到自己的输出 Pool，并检查 / 改写帧末尾的标记字节：
+ *   mark1 写 0xA1，mark2 要求输入是 0xA1 后写 0xA2，回调要求 0xA2（阶段按顺序经过且只经过一次）
+ * - 回调读回帧号：覆盖全部帧且不重复；各阶段统计 frames_in == frames_out == 帧数，没有丢帧
+ * 
+ * 参数：帧数（默认 200）
+ */
+static int test_pipeline_stages(const char* frame_count_arg) {
+    const int total_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 200;
+    const int kWidth = 320;
+    const int kHeight = 240;
+    const size_t kFrameSize = kWidth * kHeight * 3 / 2;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Multi-stage pipeline - Frames: %d", total_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    // 拷贝整帧和图像元数据；输入标记不是 expected 时丢弃本帧（计入 frames_dropped）
+    auto mark_stage = [kFrameSize](int expected, uint8_t mark) {
+        return [kFrameSize, expected, mark](Buffer* input, Buffer* output) {
+            const uint8_t* src = static_cast<const uint8_t*>(input->data());
+            uint8_t* dst = static_cast<uint8_t*>(output->data());
+            if (input->size() < kFrameSize || output->size() < kFrameSize ||
+                (expected >= 0 && src[kFrameSize - 1] != expected)) {
+                return false;
+            }
+            memcpy(dst, src, kFrameSize);
+            dst[kFrameSize - 1] = mark;
+            output->setImageMetadata(input->getImageWidth(), input->getImageHeight(), input->getImageFormat(),
+                                     input->getImageLinesize(), input->getImagePlaneOffset(),
+                                     input->getImagePlaneCount());
+            return true;
+        };
+    };
+    
+    VideoProductionLine line(false, 1, false);  // loop=false, 1 个生产者线程
+    line.addStage(StageConfigBuilder()
+        .setName("mark1")
+        .setProcessFunction(mark_stage(-1, 0xA1))
+        .setThreadCount(2)
+        .build());
+    line.addStage(StageConfigBuilder()
+        .setName("mark2")
+        .setProcessFunction(mark_stage(0xA1, 0xA2))
+        .build());
+    
+    auto workerConfig = WorkerConfigBuilder()
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(kWidth, kHeight)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setPatternConfig(
+            PatternConfigBuilder()
+                .setName("counter")
+                .setTotalFrames(total_frames)
+                .build()
+        )
+        .setWorkerType(WorkerType::TEST_PATTERN)
+        .build();
+    
+    // 回调串行执行（1 个消费者线程），seen 不需要加锁
+    std::vector<char> seen(total_frames, 0);
+    auto check = [&seen, total_frames, kFrameSize](Buffer* buffer) {
+        int frame_number = read_stamped_frame_number(buffer);
+        if (buffer->size() < kFrameSize || static_cast<const uint8_t*>(buffer->data())[kFrameSize - 1] != 0xA2 ||
+            frame_number < 0 || frame_number >= total_frames || seen[frame_number]) {
+            return false;
+        }
+        seen[frame_number] = 1;
+        return true;
+    };
+    
+    Nv12LineResult result;
+    if (!run_nv12_line(line, workerConfig, check, 0, &result)) {
+        return -1;
+    }
+    
+    std::vector<PipelineStage::Stats> stats = line.getStageStats();
+    const char* kNames[3] = {"source", "mark1", "mark2"};
+    bool stages_ok = stats.size() == 3;
+    for (size_t i = 0; stages_ok && i < stats.size(); i++) {
+        LOG_INFO_FMT("Stage %-6s: in %lu, out %lu, dropped %lu, busy %.1f%%", stats[i].name.c_str(),
+                     (unsigned long)stats[i].frames_in, (unsigned long)stats[i].frames_out,
+                     (unsigned long)stats[i].frames_dropped, stats[i].busy_ratio * 100.0);
+        stages_ok = stats[i].name == kNames[i] && stats[i].frames_out == static_cast<uint64_t>(total_frames) &&
+                    (i == 0 || stats[i].frames_in == static_cast<uint64_t>(total_frames)) &&
+                    stats[i].frames_dropped == 0;
+    }
+    
+    int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+    LOG_INFO_FMT("Distinct frame numbers at the sink: %d / %d, stage statistics: %s",
+                 stamped, total_frames, stages_ok ? "consistent" : "WRONG");
+    return report_test_result(result.ended && result.produced == total_frames &&
+                              result.sink_frames == total_frames && result.bad_frames == 0 &&
+                              stamped == total_frames && stages_ok);
+}
+
+/**
+ * counter 图案（叠加帧号）的 NV12 生产者配置
+ */
+static WorkerConfig make_counter_pattern_config(int width, int height, int total_frames) {
+    return WorkerConfigBuilder()
+        .setOutputConfig(
+            OutputConfigBuilder()
+                .setResolution(width, height)
+                .setPixelFormat(AV_PIX_FMT_NV12)
+                .build()
+        )
+        .setPatternConfig(
+            PatternConfigBuilder()
+                .setName("counter")
+                .setTotalFrames(total_frames)
+                .build()
+        )
+        .setWorkerType(WorkerType::TEST_PATTERN)
+        .build();
+}
+
+/**
+ * 帧号检查：读回的帧号在 [0, seen->size()) 内且没有出现过（到达顺序不限）
+ * 
+ * 只能用于 1 个消费者线程（回调串行执行，seen 不加锁）
+ */
+static std::function<bool(Buffer*)> make_unique_stamp_check(std::vector<char>* seen) {
+    return [seen](Buffer* buffer) {
+        int frame_number = read_stamped_frame_number(buffer);
+        if (frame_number < 0 || frame_number >= static_cast<int>(seen->size()) || (*seen)[frame_number]) {
+            return false;
+        }
+        (*seen)[frame_number] = 1;
+        return true;
+    };
+}
+
+/**
+ * 执行器分组任务：忙等 spin_us 后重新提交自己，直到 stop 置位
+ */
+static void spin_executor_task(WorkStealingExecutor* executor, uint64_t group, int spin_us,
+                               const std::atomic<bool>* stop) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(spin_us);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+    if (!stop->load()) {
+        executor->submit(group, [executor, group, spin_us, stop]() {
+            spin_executor_task(executor, group, spin_us, stop);
+        });
+    }
+}
+
+/**
+ * 测试：共享执行器（WorkStealingExecutor + SHARED_EXECUTOR 生产线）
+ * 
+ * 功能：
+ * - 权重：1 个线程的执行器上两个分组（权重 1 / 3）各跑一个持续重新提交的忙等任务，
+ *   运行时间之比应接近 3（允许 2 ~ 4.5）
+ * - 生产线：2 个线程的执行器上同时运行两条 SHARED_EXECUTOR 生产线（各 3 个填充任务，权重 1 / 2），
+ *   每条都要产出全部帧，回调读回的帧号覆盖全部帧且不重复
+ * 
+ * 参数：每条生产线的帧数（默认 200）
+ */
+static int test_shared_executor(const char* frame_count_arg) {
+    const int total_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 200;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Shared executor - Frames per line: %d", total_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    bool weights_ok = false;
+    {
+        WorkStealingExecutor executor(1);
+        std::atomic<bool> stop(false);
+        uint64_t light = executor.registerGroup("light", 1);
+        uint64_t heavy = executor.registerGroup("heavy", 3);
+        executor.submit(light, [&executor, light, &stop]() { spin_executor_task(&executor, light, 200, &stop); });
+        executor.submit(heavy, [&executor, heavy, &stop]() { spin_executor_task(&executor, heavy, 200, &stop); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        
+        WorkStealingExecutor::GroupStats light_stats;
+        WorkStealingExecutor::GroupStats heavy_stats;
+        bool got_stats = executor.getGroupStats(light, &light_stats) && executor.getGroupStats(heavy, &heavy_stats);
+        stop = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));  // 等待在途任务结束（每个任务约 200us）
+        executor.printStats();
+        executor.unregisterGroup(light);
+        executor.unregisterGroup(heavy);
+        
+        double ratio = (got_stats && light_stats.run_time_ms > 0.0) ? heavy_stats.run_time_ms / light_stats.run_time_ms : 0.0;
+        weights_ok = ratio >= 2.0 && ratio <= 4.5;
+        LOG_INFO_FMT("Weighted groups: light %.1f ms (%lu tasks), heavy %.1f ms (%lu tasks), ratio %.2f (expected ~3)",
+                     light_stats.run_time_ms, (unsigned long)light_stats.executed,
+                     heavy_stats.run_time_ms, (unsigned long)heavy_stats.executed, ratio);
+    }
+    
+    WorkStealingExecutor executor(2);
+    const int kWeights[2] = {1, 2};
+    std::vector<char> seen[2] = {std::vector<char>(total_frames, 0), std::vector<char>(total_frames, 0)};
+    Nv12LineResult results[2];
+    bool started[2] = {false, false};
+    bool shared[2] = {false, false};
+    std::vector<std::thread> runners;
+    for (int i = 0; i < 2; i++) {
+        runners.emplace_back([&, i]() {
+            VideoProductionLine line(false, 3, false);  // loop=false, 3 个并发填充任务
+            if (!line.setExecutionMode(VideoProductionLine::ExecutionMode::SHARED_EXECUTOR, kWeights[i], &executor)) {
+                return;
+            }
+            shared[i] = line.getExecutionMode() == VideoProductionLine::ExecutionMode::SHARED_EXECUTOR;
+            started[i] = run_nv12_line(line, make_counter_pattern_config(320, 240, total_frames),
+                                       make_unique_stamp_check(&seen[i]), 0, &results[i]);
+        });
+    }
+    for (auto& runner : runners) {
+        runner.join();
+    }
+    
+    bool lines_ok = true;
+    for (int i = 0; i < 2; i++) {
+        int stamped = static_cast<int>(std::count(seen[i].begin(), seen[i].end(), 1));
+        LOG_INFO_FMT("Line %d (weight %d): produced %d, sink %d, bad %d, distinct frame numbers %d / %d",
+                     i, kWeights[i], results[i].produced, results[i].sink_frames, results[i].bad_frames,
+                     stamped, total_frames);
+        lines_ok = lines_ok && started[i] && shared[i] && results[i].ended &&
+                   results[i].produced == total_frames && results[i].sink_frames == total_frames &&
+                   results[i].bad_frames == 0 && stamped == total_frames;
+    }
+    return report_test_result(weights_ok && lines_ok);
+}
+
+/**
+ * 测试：固定帧率放行（setPacing）
+ * 
+ * 功能：
+ * - 320x240 NV12 counter 图案，2 个生产者，按目标帧率放行 2 秒的帧
+ * - 独占线程模式和共享执行器模式各运行一次
+ * - 检查：全部帧到达且帧号不重复；回调看到的首帧到末帧间隔 ≈ (帧数 - 1) / 帧率（±10%），
+ *   FramePacer 统计的放行帧数等于帧数、实际帧率 ≈ 目标帧率（±5%）
+ * 
+ * 参数：目标帧率（默认 50）
+ */
+static int test_frame_pacing(const char* fps_arg) {
+    const double target_fps = (fps_arg && atof(fps_arg) > 0.0) ? atof(fps_arg) : 50.0;
+    const int total_frames = std::max(2, static_cast<int>(target_fps * 2.0));
+    const double expected_span_ms = (total_frames - 1) * 1000.0 / target_fps;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Frame pacing - Target: %.2f fps, Frames: %d", target_fps, total_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    WorkStealingExecutor executor(2);
+    bool success = true;
+    for (int shared = 0; shared < 2; shared++) {
+        VideoProductionLine line(false, 2, false);  // loop=false, 2 个生产者
+        if (!line.setPacing(target_fps) ||
+            (shared && !line.setExecutionMode(VideoProductionLine::ExecutionMode::SHARED_EXECUTOR, 1, &executor))) {
+            LOG_ERROR("Failed to configure pacing / execution mode");
+            return report_test_result(false);
+        }
+        
+        // 回调串行执行（1 个消费者线程）
+        std::vector<char> seen(total_frames, 0);
+        auto stamp_check = make_unique_stamp_check(&seen);
+        std::chrono::steady_clock::time_point first_arrival;
+        std::chrono::steady_clock::time_point last_arrival;
+        int arrivals = 0;
+        auto check = [&](Buffer* buffer) {
+            last_arrival = std::chrono::steady_clock::now();
+            if (arrivals++ == 0) {
+                first_arrival = last_arrival;
+            }
+            return stamp_check(buffer);
+        };
+        
+        Nv12LineResult result;
+        if (!run_nv12_line(line, make_counter_pattern_config(320, 240, total_frames), check, 0, &result)) {
+            return report_test_result(false);
+        }
+        
+        FramePacer::Stats ps = line.getPacingStats();
+        double span_ms = std::chrono::duration<double, std::milli>(last_arrival - first_arrival).count();
+        int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+        LOG_INFO_FMT("%s: sink span %.1f ms (expected %.1f ms), pacer frames %lu, actual %.2f fps, "
+                     "late %lu, resyncs %lu, avg lateness %.3f ms, max %.3f ms, distinct frame numbers %d / %d",
+                     shared ? "Shared executor" : "Dedicated threads", span_ms, expected_span_ms,
+                     (unsigned long)ps.frames, ps.actual_fps, (unsigned long)ps.late_frames,
+                     (unsigned long)ps.resyncs, ps.avg_lateness_ms, ps.max_lateness_ms, stamped, total_frames);
+        success = success && result.ended && result.produced == total_frames &&
+                  result.sink_frames == total_frames && result.bad_frames == 0 && stamped == total_frames &&
+                  std::fabs(span_ms - expected_span_ms) <= expected_span_ms * 0.10 &&
+                  std::fabs(ps.target_fps - target_fps) < 0.01 && ps.frames == static_cast<uint64_t>(total_frames) &&
+                  std::fabs(ps.actual_fps - target_fps) <= target_fps * 0.05;
+    }
+    return report_test_result(success);
+}
+
+/**
+ * 从多源生产线的共享输出 Pool 消费帧，按来源ID计数并检查帧号
+ * @param max_frames 消费帧数上限（0=直到生产线结束且 Pool 中没有 filled buffer）
+ * @param loop 源是否循环播放（循环时允许重复帧号）
+ * @param seen 每个源的帧号记录（大小为该源的帧数）
+ * @param counts 每个源通过检查的帧数
+ * @return 帧号越界、来源ID无效或格式错误的帧数
+ */
+static int consume_multi_source(MultiSourceProductionLine& line, int max_frames, bool loop,
+                                std::vector<std::vector<char>>* seen, std::vector<int>* counts) {
+    auto pool_sptr = BufferPoolRegistry::getInstance().getPool(line.getOutputBufferPoolId()).lock();
+    if (!pool_sptr) {
+        LOG_ERROR("Shared output BufferPool not found");
+        return -1;
+    }
+    
+    int consumed = 0;
+    int bad_frames = 0;
+    while (g_running && (max_frames <= 0 || consumed < max_frames)) {
+        bool running = line.isRunning();
+        Buffer* buffer = pool_sptr->acquireFilled(true, 100);
+        if (!buffer) {
+            if (!running) {
+                break;
+            }
+            continue;
+        }
+        int source_id = buffer->getSourceId();
+        int frame_number = read_stamped_frame_number(buffer);
+        if (source_id < 0 || source_id >= static_cast<int>(seen->size()) || !buffer->hasImageMetadata() ||
+            buffer->getImageFormat() != AV_PIX_FMT_NV12 || frame_number < 0 ||
+            frame_number >= static_cast<int>((*seen)[source_id].size()) ||
+            (!loop && (*seen)[source_id][frame_number])) {
+            bad_frames++;
+        } else {
+            (*seen)[source_id][frame_number] = 1;
+            (*counts)[source_id]++;
+        }
+        consumed++;
+        pool_sptr->releaseFilled(buffer);
+    }
+    return bad_frames;
+}
+
+/**
+ * 测试：多源复用生产线（MultiSourceProductionLine）
+ * 
+ * 功能：三个 320x240 NV12 counter 图案源（权重 1 / 2 / 3），2 个生产者线程共享一个输出 Pool
+ * - 加权：循环播放，消费指定帧数后停止，每个源的帧数占比 ≈ 权重 / 6（±0.02），
+ *   getSourceStats() 的 share 与之一致
+ * - 完整性：不循环，各源 40 / 50 / 60 帧，生产线自行结束，每个源的帧全部到达且帧号不重复
+ * 
+ * 参数：加权阶段消费的帧数（默认 600）
+ */
+static int test_multi_source(const char* frame_count_arg) {
+    const int weighted_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 600;
+    const int kWeights[3] = {1, 2, 3};
+    const int kTotalWeight = 6;
+    const int kFinalFrames[3] = {40, 50, 60};
+    const int kLoopFrames = 30;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Multi-source production line - Weighted frames: %d", weighted_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    bool success = true;
+    for (int loop = 1; loop >= 0; loop--) {
+        MultiSourceProductionLine line(2);  // 2 个生产者线程服务所有源
+        std::vector<std::vector<char>> seen;
+        for (int i = 0; i < 3; i++) {
+            SourceConfig source;
+            source.worker = make_counter_pattern_config(320, 240, loop ? kLoopFrames : kFinalFrames[i]);
+            source.name = "weight" + std::to_string(kWeights[i]);
+            source.weight = kWeights[i];
+            source.loop = loop != 0;
+            if (line.addSource(source) != i) {
+                LOG_ERROR_FMT("Failed to add source %d", i);
+                return report_test_result(false);
+            }
+            seen.emplace_back(source.worker.pattern.total_frames, 0);
+        }
+        if (!line.start()) {
+            LOG_ERROR_FMT("Failed to start multi-source line: %s", line.getLastError().c_str());
+            return report_test_result(false);
+        }
+        
+        std::vector<int> counts(3, 0);
+        int bad_frames = consume_multi_source(line, loop ? weighted_frames : 0, loop != 0, &seen, &counts);
+        bool ended = !line.isRunning();
+        std::vector<MultiSourceProductionLine::SourceStats> stats = line.getSourceStats();
+        line.printStats();
+        line.stop();
+        
+        int consumed = counts[0] + counts[1] + counts[2];
+        bool phase_ok = bad_frames == 0 && stats.size() == 3;
+        for (int i = 0; phase_ok && i < 3; i++) {
+            int stamped = static_cast<int>(std::count(seen[i].begin(), seen[i].end(), 1));
+            double share = consumed > 0 ? static_cast<double>(counts[i]) / consumed : 0.0;
+            double expected_share = static_cast<double>(kWeights[i]) / kTotalWeight;
+            LOG_INFO_FMT("%s source %d (weight %d): frames %d, share %.3f (expected %.3f), stats share %.3f, "
+                         "distinct frame numbers %d / %zu", loop ? "Loop" : "Finite", i, kWeights[i], counts[i],
+                         share, expected_share, stats[i].share, stamped, seen[i].size());
+            if (loop) {
+                phase_ok = std::fabs(share - expected_share) <= 0.02 &&
+                           std::fabs(stats[i].share - expected_share) <= 0.02;
+            } else {
+                phase_ok = counts[i] == kFinalFrames[i] && stamped == kFinalFrames[i] && stats[i].ended &&
+                           stats[i].produced == static_cast<uint64_t>(kFinalFrames[i]) && stats[i].skipped == 0;
+            }
+        }
+        if (loop) {
+            phase_ok = phase_ok && consumed == weighted_frames;
+        } else {
+            phase_ok = phase_ok && ended;
+        }
+        LOG_INFO_FMT("%s phase: consumed %d, bad %d, %s", loop ? "Loop" : "Finite", consumed, bad_frames,
+                     phase_ok ? "OK" : "FAILED");
+        success = success && phase_ok;
+    }
+    return report_test_result(success);
+}
+
+/**
+ * 测试：生产线 CPU 亲和性和 NUMA 内存放置
+ * 
+ * 功能：
+ * - 放置配置：指定节点 + 该节点最后一个 CPU（pin_per_thread），2 个生产者，counter 图案
+ * - 消费者线程与生产者使用同一放置策略：回调中检查当前线程的 CPU 亲和性正好是配置的 CPU
+ * - 系统支持 NUMA 内存策略时，检查每帧 buffer 首尾页所在节点等于配置的节点
+ * - getNumaNode() 返回配置的节点
+ * 
+ * 参数：NUMA 节点编号（默认最后一个有 CPU 的节点）
+ */
+static int test_numa_placement(const char* node_arg) {
+    int node = (node_arg && isdigit(static_cast<unsigned char>(node_arg[0]))) ? atoi(node_arg) : -1;
+    for (int n = NumaPlacement::getNodeCount() - 1; node < 0 && n >= 0; n--) {
+        if (!NumaPlacement::getCpusOfNode(n).empty()) {
+            node = n;
+        }
+    }
+    std::vector<int> node_cpus = node >= 0 ? NumaPlacement::getCpusOfNode(node) : std::vector<int>();
+    const int total_frames = 100;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: NUMA / CPU placement - Node: %d, CPUs: %s, Memory policy: %s", node,
+                 NumaPlacement::formatCpuList(node_cpus).c_str(), NumaPlacement::isAvailable() ? "yes" : "no");
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    if (node_cpus.empty()) {
+        LOG_ERROR_FMT("NUMA node %d has no CPUs", node);
+        return report_test_result(false);
+    }
+    const int cpu = node_cpus.back();
+    
+    WorkerConfig worker_config = make_counter_pattern_config(320, 240, total_frames);
+    worker_config.placement = PlacementConfigBuilder()
+        .setNumaNode(node)
+        .setCpuAffinity({cpu})
+        .setPinPerThread(true)
+        .build();
+    
+    // 回调串行执行（1 个消费者线程）
+    std::vector<char> seen(total_frames, 0);
+    auto stamp_check = make_unique_stamp_check(&seen);
+    int wrong_cpu = 0;
+    int wrong_node = 0;
+    auto check = [&](Buffer* buffer) {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) != 0 || CPU_COUNT(&mask) != 1 || !CPU_ISSET(cpu, &mask)) {
+            wrong_cpu++;
+        }
+        const uint8_t* data = static_cast<const uint8_t*>(buffer->data());
+        if (NumaPlacement::isAvailable() && (NumaPlacement::getNodeOfAddress(data) != node ||
+                                             NumaPlacement::getNodeOfAddress(data + buffer->size() - 1) != node)) {
+            wrong_node++;
+        }
+        return stamp_check(buffer);
+    };
+    
+    VideoProductionLine line(false, 2, false);  // loop=false, 2 个生产者
+    Nv12LineResult result;
+    if (!run_nv12_line(line, worker_config, check, 0, &result)) {
+        return report_test_result(false);
+    }
+    
+    int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+    LOG_INFO_FMT("Line node: %d, frames with wrong CPU affinity: %d, on wrong node: %d, distinct frame numbers %d / %d",
+                 line.getNumaNode(), wrong_cpu, wrong_node, stamped, total_frames);
+    return report_test_result(result.ended && result.produced == total_frames && result.sink_frames == total_frames &&
+                              result.bad_frames == 0 && stamped == total_frames && line.getNumaNode() == node &&
+                              wrong_cpu == 0 && wrong_node == 0);
+}
+
+/**
+ * 测试：BufferPool eventfd 就绪通知
+ * 
+ * 功能：
+ * - 生产线不注册回调，消费者只用 poll() 等待 getFilledEventFd() 可读，
+ *   可读后先 clearFilledEvent()，再 acquireFilled(false, 0) 取空（不使用阻塞等待）
+ * - 任何一次漏发通知都会让 poll() 超时（2 秒）：全部帧到达即说明每次 filled 队列由空变非空都写了 eventfd
+ * - 取空之后的零帧唤醒计数只用于观察（清除与取空之间到达的帧会留下一次空唤醒）
+ * 
+ * 参数：帧数（默认 300）
+ */
+static int test_pool_eventfd(const char* frame_count_arg) {
+    const int total_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 300;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: BufferPool eventfd readiness - Frames: %d", total_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    VideoProductionLine line(false, 2, false);  // loop=false, 2 个生产者线程
+    if (!line.start(make_counter_pattern_config(320, 240, total_frames))) {
+        LOG_ERROR_FMT("Failed to start production line: %s", line.getLastError().c_str());
+        return report_test_result(false);
+    }
+    auto pool_sptr = BufferPoolRegistry::getInstance().getPool(line.getWorkingBufferPoolId()).lock();
+    int fd = pool_sptr ? pool_sptr->getFilledEventFd() : -1;
+    if (fd < 0) {
+        LOG_ERROR("Filled eventfd not available");
+        pool_sptr.reset();
+        line.stop();
+        return report_test_result(false);
+    }
+    
+    std::vector<char> seen(total_frames, 0);
+    auto stamp_check = make_unique_stamp_check(&seen);
+    int consumed = 0;
+    int bad_frames = 0;
+    int wakeups = 0;
+    int empty_wakeups = 0;
+    bool timed_out = false;
+    while (g_running && consumed < total_frames) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, 2000);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            timed_out = true;
+            break;
+        }
+        wakeups++;
+        pool_sptr->clearFilledEvent();
+        int drained = 0;
+        while (Buffer* buffer = pool_sptr->acquireFilled(false, 0)) {
+            if (!stamp_check(buffer)) {
+                bad_frames++;
+            }
+            pool_sptr->releaseFilled(buffer);
+            drained++;
+        }
+        consumed += drained;
+        if (drained == 0) {
+            empty_wakeups++;
+        }
+    }
+    pool_sptr.reset();
+    line.stop();
+    
+    int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+    LOG_INFO_FMT("Consumed: %d / %d, bad: %d, wakeups: %d (empty: %d), distinct frame numbers: %d%s",
+                 consumed, total_frames, bad_frames, wakeups, empty_wakeups, stamped,
+                 timed_out ? ", poll() timed out" : "");
+    return report_test_result(!timed_out && consumed == total_frames && bad_frames == 0 &&
+                              stamped == total_frames && wakeups > 0);
+}
+
+/**
+ * 测试：自动伸缩的配置与关闭
+ * 
+ * 功能（2 个生产者的生产线，评估周期 10 秒，运行期间不会做伸缩决策）：
+ * - setAutoscale(3, 4) 后再 setAutoscale(1, 4)：初始活跃数取构造函数的 2（不沿用上一次限制后的 3）
+ * - setAutoscale(1, 4) 后 disableAutoscale()：恢复 2 个固定生产者，统计中 enabled=false、max_threads=2
+ * - 两种配置都要产出全部帧（回调读回的帧号覆盖全部帧且不重复）
+ * 
+ * 参数：帧数（默认 200）
+ */
+static int test_autoscale_config(const char* frame_count_arg) {
+    const int total_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 200;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Autoscale configuration - Frames: %d", total_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    bool success = true;
+    for (int disable = 0; disable < 2; disable++) {
+        VideoProductionLine line(false, 2, false);  // loop=false, 2 个生产者
+        bool configured = disable ? line.setAutoscale(1, 4, 10000) && line.disableAutoscale()
+                                  : line.setAutoscale(3, 4, 10000) && line.setAutoscale(1, 4, 10000);
+        if (!configured) {
+            LOG_ERROR("Failed to configure autoscale");
+            return report_test_result(false);
+        }
+        
+        // 第一帧到达时记录统计（回调串行执行）
+        std::vector<char> seen(total_frames, 0);
+        auto stamp_check = make_unique_stamp_check(&seen);
+        VideoProductionLine::AutoscaleStats stats;
+        bool captured = false;
+        auto check = [&](Buffer* buffer) {
+            if (!captured) {
+                stats = line.getAutoscaleStats();
+                captured = true;
+            }
+            return stamp_check(buffer);
+        };
+        
+        Nv12LineResult result;
+        if (!run_nv12_line(line, make_counter_pattern_config(320, 240, total_frames), check, 0, &result)) {
+            return report_test_result(false);
+        }
+        
+        int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+        bool stats_ok = disable ? (!stats.enabled && stats.max_threads == 2 && stats.active_threads == 2)
+                                : (stats.enabled && stats.min_threads == 1 && stats.max_threads == 4 &&
+                                   stats.active_threads == 2);
+        LOG_INFO_FMT("%s: enabled %d, range [%d, %d], active %d, distinct frame numbers %d / %d",
+                     disable ? "Disabled" : "Re-applied range", stats.enabled, stats.min_threads,
+                     stats.max_threads, stats.active_threads, stamped, total_frames);
+        success = success && captured && stats_ok && result.ended && result.produced == total_frames &&
+                  result.sink_frames == total_frames && result.bad_frames == 0 && stamped == total_frames;
+    }
+    return report_test_result(success);
+}
+
+/**
+ * 测试：分块领取帧索引（FrameClaimMode::CHUNKED）
+ * 
+ * 功能（3 个生产者，块大小 K，帧数 = 10K + 3，最后一块在文件末尾截断）：
+ * - 同一块由一个生产者按顺序填充并提交：块内每帧（帧号不是 K 的倍数）都在前一帧之后到达回调
+ * - 原子领取次数不超过 ceil(帧数 / K) + 生产者数（每个生产者最后一次领取失败）
+ * - 全部帧到达且帧号不重复
+ * 
+ * 参数：块大小 K（默认 8）
+ */
+static int test_chunked_claim(const char* chunk_arg) {
+    const int chunk = (chunk_arg && atoi(chunk_arg) > 1) ? atoi(chunk_arg) : 8;
+    const int total_frames = chunk * 10 + 3;
+    const int kThreads = 3;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Chunked frame claiming - Chunk: %d, Frames: %d", chunk, total_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    VideoProductionLine line(false, kThreads, false);  // loop=false
+    if (!line.setFrameClaimMode(VideoProductionLine::FrameClaimMode::CHUNKED, chunk)) {
+        LOG_ERROR("Failed to set chunked claim mode");
+        return report_test_result(false);
+    }
+    
+    // 记录每个帧号的到达顺序（回调串行执行）
+    std::vector<char> seen(total_frames, 0);
+    auto stamp_check = make_unique_stamp_check(&seen);
+    std::vector<int> arrival(total_frames, -1);
+    int arrivals = 0;
+    auto check = [&](Buffer* buffer) {
+        int frame_number = read_stamped_frame_number(buffer);
+        if (!stamp_check(buffer)) {
+            return false;
+        }
+        arrival[frame_number] = arrivals++;
+        return true;
+    };
+    
+    Nv12LineResult result;
+    if (!run_nv12_line(line, make_counter_pattern_config(320, 240, total_frames), check, 0, &result)) {
+        return report_test_result(false);
+    }
+    
+    int out_of_order = 0;
+    for (int i = 1; i < total_frames; i++) {
+        if (i % chunk != 0 && (arrival[i] < 0 || arrival[i - 1] < 0 || arrival[i] < arrival[i - 1])) {
+            out_of_order++;
+        }
+    }
+    const uint64_t max_claims = static_cast<uint64_t>((total_frames + chunk - 1) / chunk + kThreads);
+    int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+    LOG_INFO_FMT("Claims: %lu (max %lu), frames out of order inside a chunk: %d, distinct frame numbers %d / %d",
+                 (unsigned long)line.getFrameClaims(), (unsigned long)max_claims, out_of_order,
+                 stamped, total_frames);
+    return report_test_result(result.ended && result.produced == total_frames &&
+                              result.sink_frames == total_frames && result.bad_frames == 0 &&
+                              stamped == total_frames && out_of_order == 0 &&
+                              line.getFrameClaims() <= max_claims);
+}
+
+/**
+ * 测试：播放列表切换处的帧序（多生产者 + 限速）
+ * 
+ * 功能：
+ * - 播放列表 counter 30 帧 -> bars 40 帧 -> counter 25 帧（都叠加帧号，用图案像素区分项），3 个生产者
+ * - 按到达顺序检查：三项依次成段到达（上一项的帧全部先于下一项），每项帧号覆盖全部帧且不重复
+ * - 后两项预填充的帧 0、1 先于该项其他任何帧到达（切换时预填充帧与新项生产者不颠倒）
+ * 
+ * 参数：目标帧率（默认 200，0=不限速）
+ */
+static int test_playlist_order(const char* fps_arg) {
+    const double target_fps = fps_arg ? atof(fps_arg) : 200.0;
+    const char* kPatterns[3] = {"counter", "bars", "counter"};
+    const int kFrames[3] = {30, 40, 25};
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Playlist transition order - Target: %.1f fps", target_fps);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    std::vector<WorkerConfig> items;
+    for (int i = 0; i < 3; i++) {
+        WorkerConfig item = make_counter_pattern_config(320, 240, kFrames[i]);
+        item.pattern.name = kPatterns[i];
+        item.pattern.stamp_frame_number = true;
+        items.push_back(item);
+    }
+    
+    VideoProductionLine line(false, 3, false);  // loop=false, 3 个生产者
+    if (target_fps > 0.0 && !line.setPacing(target_fps)) {
+        LOG_ERROR("Failed to set pacing");
+        return report_test_result(false);
+    }
+    
+    // 到达顺序：(图案, 帧号)，回调串行执行（1 个消费者线程）
+    std::vector<std::pair<std::string, int>> arrivals;
+    std::atomic<int> bad_frames(0);
+    line.addFrameSink([&arrivals, &bad_frames](Buffer* buffer) {
+        std::string pattern = check_pattern_pixels("counter", buffer) ? "counter" :
+                              check_pattern_pixels("bars", buffer) ? "bars" : "";
+        int frame_number = read_stamped_frame_number(buffer);
+        if (pattern.empty() || frame_number < 0) {
+            bad_frames++;
+            return;
+        }
+        arrivals.emplace_back(pattern, frame_number);
+    });
+    line.setConsumerConfig(1, 4);
+    
+    if (!line.startPlaylist(items)) {
+        LOG_ERROR_FMT("Failed to start playlist: %s", line.getLastError().c_str());
+        return report_test_result(false);
+    }
+    while (g_running && line.isRunning()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    bool ended = !line.isRunning();
+    line.printStats();
+    line.stop();
+    
+    // 按图案切分成段：必须正好三段，依次对应播放列表各项
+    bool success = ended && bad_frames.load() == 0;
+    size_t begin = 0;
+    for (int item = 0; item < 3; item++) {
+        size_t end = begin;
+        while (end < arrivals.size() && arrivals[end].first == kPatterns[item]) {
+            end++;
+        }
+        std::vector<char> seen(kFrames[item], 0);
+        int duplicates = 0;
+        int first_later_frame = -1;   // 该项第一个帧号 >= 2 的帧在段内的位置
+        int last_preroll_frame = -1;  // 该项帧 0、1 在段内的最后位置
+        for (size_t i = begin; i < end; i++) {
+            int frame_number = arrivals[i].second;
+            if (frame_number >= kFrames[item] || seen[frame_number]) {
+                duplicates++;
+                continue;
+            }
+            seen[frame_number] = 1;
+            int position = static_cast<int>(i - begin);
+            if (frame_number < 2) {
+                last_preroll_frame = position;
+            } else if (first_later_frame < 0) {
+                first_later_frame = position;
+            }
+        }
+        int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+        bool preroll_first = item == 0 || (last_preroll_frame >= 0 && last_preroll_frame < first_later_frame);
+        LOG_INFO_FMT("Item %d (%s): %zu frames, distinct %d / %d, duplicates %d, frames 0-1 first: %s",
+                     item, kPatterns[item], end - begin, stamped, kFrames[item], duplicates,
+                     preroll_first ? "yes" : "NO");
+        success = success && stamped == kFrames[item] && duplicates == 0 && preroll_first;
+        begin = end;
+    }
+    LOG_INFO_FMT("Arrivals: %zu, bad frames: %d%s", arrivals.size(), bad_frames.load(),
+                 begin == arrivals.size() ? "" : " (items interleaved at a transition)");
+    return report_test_result(success && begin == arrivals.size());
+}
+
+/**
+ * 测试：暂停 / 恢复和热重启
+ * 
+ * 功能（counter 图案 120 帧，3 个生产者，限速 300 fps）：
+ * - 暂停：pause() 返回后 300ms 内生产帧数不变，已提交的帧全部到达回调；已到达的帧号正好是 0..P-1
+ * - 恢复后继续生产，再次暂停；热重启（配置不变）：工作 / 输出 Pool ID 不变，从帧 0 重新开始
+ * - 热重启为 bars 图案（几何一致）：Pool ID 不变，新源的 120 帧全部到达且帧号不重复
+ * 
+ * 每次热重启前先暂停并等待回调取完，按阶段区分到达的帧
+ */
+static int test_pause_restart(const char* /*arg*/) {
+    const int total_frames = 120;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO("  Test: Pause / resume and warm restart");
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    WorkerConfig counter_config = make_counter_pattern_config(320, 240, total_frames);
+    WorkerConfig bars_config = counter_config;
+    bars_config.pattern.name = "bars";
+    bars_config.pattern.stamp_frame_number = true;
+    
+    VideoProductionLine line(false, 3, false);  // loop=false, 3 个生产者
+    line.setPacing(300.0);
+    
+    // 每个阶段到达的帧号（-1=图案或帧号不符）
+    std::mutex arrivals_mutex;
+    std::vector<int> arrivals[3];
+    std::atomic<int> phase(0);
+    line.addFrameSink([&](Buffer* buffer) {
+        int current = phase.load();
+        const char* expected = current == 2 ? "bars" : "counter";
+        int frame_number = check_pattern_pixels(expected, buffer) ? read_stamped_frame_number(buffer) : -1;
+        std::lock_guard<std::mutex> lock(arrivals_mutex);
+        arrivals[current].push_back(frame_number);
+    });
+    line.setConsumerConfig(1, 4);
+    
+    auto arrived = [&]() {
+        std::lock_guard<std::mutex> lock(arrivals_mutex);
+        return static_cast<int>(arrivals[phase.load()].size());
+    };
+    auto wait_for_arrivals = [&](int count) {
+        for (int i = 0; i < 200 && g_running && arrived() < count; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return arrived() >= count;
+    };
+    // 暂停后等待回调取完已提交的帧（最多 1 秒）
+    auto pause_and_drain = [&]() {
+        if (!line.pause()) {
+            return false;
+        }
+        for (int i = 0; i < 100 && arrived() < line.getProducedFrames(); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return arrived() == line.getProducedFrames();
+    };
+    // 本阶段到达的帧号正好是 0..count-1
+    auto is_prefix = [&](int p) {
+        std::vector<int> frames = arrivals[p];
+        std::sort(frames.begin(), frames.end());
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (frames[i] != static_cast<int>(i)) {
+                return false;
+            }
+        }
+        return !frames.empty();
+    };
+    
+    if (!line.start(counter_config)) {
+        LOG_ERROR_FMT("Failed to start production line: %s", line.getLastError().c_str());
+        return report_test_result(false);
+    }
+    const uint64_t working_pool_id = line.getWorkingBufferPoolId();
+    const uint64_t output_pool_id = line.getOutputBufferPoolId();
+    
+    // 阶段 0：暂停期间不生产，恢复后继续
+    bool pause_ok = wait_for_arrivals(30) && pause_and_drain() && line.isPaused();
+    int paused_frames = line.getProducedFrames();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    pause_ok = pause_ok && line.getProducedFrames() == paused_frames && arrived() == paused_frames &&
+               line.resume() && wait_for_arrivals(paused_frames + 30) && pause_and_drain();
+    int phase0_frames = arrived();
+    bool phase0_ok = pause_ok && is_prefix(0) && phase0_frames < total_frames;
+    
+    // 阶段 1：配置不变的热重启，从帧 0 重新开始
+    phase = 1;
+    bool restart_same = line.restart(counter_config);
+    bool same_pools = line.getWorkingBufferPoolId() == working_pool_id && line.getOutputBufferPoolId() == output_pool_id;
+    bool phase1_ok = restart_same && same_pools && wait_for_arrivals(30) && pause_and_drain() && is_prefix(1);
+    int phase1_frames = arrived();
+    
+    // 阶段 2：换成 bars 图案（几何一致）的热重启，播放到结束
+    phase = 2;
+    bool restart_bars = line.restart(bars_config);
+    bool bars_pools = line.getWorkingBufferPoolId() == working_pool_id && line.getOutputBufferPoolId() == output_pool_id;
+    while (g_running && line.isRunning()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    line.printStats();
+    line.stop();
+    bool phase2_ok = restart_bars && bars_pools && arrived() == total_frames && is_prefix(2);
+    
+    LOG_INFO_FMT("Phase 0: %d frames (paused at %d) %s, phase 1: %d frames %s (pools %s), phase 2: %d bars frames %s (pools %s)",
+                 phase0_frames, paused_frames, phase0_ok ? "OK" : "FAILED", phase1_frames,
+                 phase1_ok ? "OK" : "FAILED", same_pools ? "kept" : "CHANGED", arrived(),
+                 phase2_ok ? "OK" : "FAILED", bars_pools ? "kept" : "CHANGED");
+    return report_test_result(phase0_ok && phase1_ok && phase2_ok);
+}
+
+/**
+ * 解码帧缓存检查用的合成 NV12 帧：每帧像素由帧号和坐标决定，行间有填充（linesize > width）
+ */
+static void fill_cache_test_frame(AVFrame* frame, std::vector<uint8_t>* storage, int index, int width, int height) {
+    const int stride = width + 32;
+    storage->assign(static_cast<size_t>(stride) * (height + height / 2), 0xCD);
+    for (int y = 0; y < height + height / 2; y++) {
+        for (int x = 0; x < width; x++) {
+            (*storage)[static_cast<size_t>(y) * stride + x] = static_cast<uint8_t>(index * 31 + y * 7 + x);
+        }
+    }
+    frame->format = AV_PIX_FMT_NV12;
+    frame->width = width;
+    frame->height = height;
+    frame->data[0] = storage->data();
+    frame->data[1] = storage->data() + static_cast<size_t>(stride) * height;
+    frame->linesize[0] = stride;
+    frame->linesize[1] = stride;
+}
+
+static bool check_cache_test_frame(const AVFrame* frame, int index, int width, int height) {
+    if (frame->format != AV_PIX_FMT_NV12 || frame->width != width || frame->height != height) {
+        return false;
+    }
+    for (int y = 0; y < height + height / 2; y++) {
+        const uint8_t* row = y < height ? frame->data[0] + static_cast<size_t>(y) * frame->linesize[0]
+                                        : frame->data[1] + static_cast<size_t>(y - height) * frame->linesize[1];
+        for (int x = 0; x < width; x++) {
+            if (row[x] != static_cast<uint8_t>(index * 31 + y * 7 + x)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * 测试：解码帧缓存（DecodedFrameCache）命中统计
+ * 
+ * 功能（合成 NV12 帧，按 Worker 的调用顺序驱动缓存）：
+ * - 第一遍：每帧 recordMiss() + record()，finish() 后进入 COMPLETE；misses = 帧数，hits = 0
+ * - 之后 3 遍循环全部由 fetch() 命中：hits = 3 x 帧数，misses 不变，取出的像素与记录的帧逐字节一致
+ * - 越界取帧不命中且不计数
+ * - 预算不足 3 帧：第 3 帧记录失败，缓存进入 DISABLED 并释放内存，之后 fetch() 不命中
+ * 
+ * 参数：帧数（默认 12）
+ */
+static int test_frame_cache(const char* frame_count_arg) {
+    const int total_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 12;
+    const int width = 640;
+    const int height = 480;   // 单帧超过 FrameCopy::kStreamingThreshold：记录走流式按行拷贝
+    const int loops = 3;
+    const size_t frame_bytes = static_cast<size_t>(width) * height * 3 / 2;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Decoded frame cache - Frames: %d, %dx%d NV12, Loops: %d", total_frames, width, height, loops);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    AVFrame* frame = av_frame_alloc();
+    AVFrame* cached = av_frame_alloc();
+    if (!frame || !cached) {
+        LOG_ERROR("Failed to allocate AVFrame");
+        av_frame_free(&frame);
+        av_frame_free(&cached);
+        return -1;
+    }
+    std::vector<uint8_t> storage;
+    bool success = true;
+    
+    // 1. 第一遍解码：全部未命中，记录完整片段
+    {
+        DecodedFrameCache cache(frame_bytes * total_frames, false);
+        bool recorded = true;
+        for (int i = 0; i < total_frames; i++) {
+            fill_cache_test_frame(frame, &storage, i, width, height);
+            cache.recordMiss();
+            recorded = cache.record(frame) && recorded;
+        }
+        cache.finish();
+        DecodedFrameCache::Stats first = cache.getStats();
+        bool first_ok = recorded && first.state == DecodedFrameCache::State::COMPLETE &&
+                        first.frames == total_frames && first.hits == 0 &&
+                        first.misses == static_cast<uint64_t>(total_frames) &&
+                        first.raw_bytes == frame_bytes * total_frames;
+        LOG_INFO_FMT("First pass: state %s, %d frames, hits %lu, misses %lu, %zu bytes",
+                     DecodedFrameCache::stateName(first.state), first.frames,
+                     (unsigned long)first.hits, (unsigned long)first.misses, first.raw_bytes);
+        
+        // 2. 循环播放：全部命中，像素与记录的帧一致
+        int bad_frames = 0;
+        for (int loop = 0; loop < loops; loop++) {
+            for (int i = 0; i < total_frames; i++) {
+                if (!cache.fetch(i, cached) || !check_cache_test_frame(cached, i, width, height)) {
+                    bad_frames++;
+                }
+            }
+        }
+        bool out_of_range = cache.fetch(total_frames, cached) || cache.fetch(-1, cached);
+        av_frame_unref(cached);
+        DecodedFrameCache::Stats looped = cache.getStats();
+        bool loop_ok = bad_frames == 0 && !out_of_range &&
+                       looped.hits == static_cast<uint64_t>(loops) * total_frames &&
+                       looped.misses == static_cast<uint64_t>(total_frames);
+        LOG_INFO_FMT("Looped %d times: hits %lu, misses %lu, hit rate %.1f%%, bad frames %d, out-of-range hit: %s",
+                     loops, (unsigned long)looped.hits, (unsigned long)looped.misses, looped.hitRate() * 100.0,
+                     bad_frames, out_of_range ? "YES" : "no");
+        success = first_ok && loop_ok;
+    }
+    
+    // 3. 预算只够 2 帧：放弃缓存，之后透传给解码器
+    {
+        DecodedFrameCache cache(frame_bytes * 5 / 2, false);
+        int recorded = 0;
+        for (int i = 0; i < 3; i++) {
+            fill_cache_test_frame(frame, &storage, i, width, height);
+            cache.recordMiss();
+            recorded += cache.record(frame) ? 1 : 0;
+        }
+        cache.finish();
+        DecodedFrameCache::Stats over = cache.getStats();
+        bool fetched = cache.fetch(0, cached);
+        bool over_ok = recorded == 2 && over.state == DecodedFrameCache::State::DISABLED &&
+                       over.frames == 0 && over.memory_bytes == 0 && over.hits == 0 && over.misses == 3 && !fetched;
+        LOG_INFO_FMT("Over budget: recorded %d / 3, state %s, %d frames, %zu bytes, fetch hit: %s",
+                     recorded, DecodedFrameCache::stateName(over.state), over.frames, over.memory_bytes,
+                     fetched ? "YES" : "no");
+        success = success && over_ok;
+    }
+    
+    av_frame_unref(cached);
+    frame->data[0] = nullptr;
+    frame->data[1] = nullptr;
+    av_frame_free(&frame);
+    av_frame_free(&cached);
+    return report_test_result(success);
+}
+
+/**
+ * 列出目录中的文件名（不含 . 和 ..）
+ */
+static std::vector<std::string> list_directory(const std::string& dir) {
+    std::vector<std::string> names;
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        return names;
+    }
+    while (struct dirent* entry = readdir(d)) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(d);
+    return names;
+}
+
+/**
+ * 测试：同一进程内多个 RawFrameFileWriter 写同一路径（raw 缓存文件）
+ * 
+ * 功能（64x48 NV12，帧页对齐）：
+ * - 写入者 A / B / C 同时打开同一路径，交错写帧（每个写入者的帧内容不同）
+ * - C 中途 abort()：只删除自己的临时文件，不影响 A / B
+ * - A 先 finish()，B 后 finish()：两次都成功，最终文件是 B 的内容（最后完成的生效）
+ * - 读回：readInfo() 校验通过，几何、帧数一致，每帧按索引读出与 B 写入的数据逐字节相同
+ * - 目录中只剩最终文件（没有残留的临时文件）
+ * 
+ * 参数：每个写入者的帧数（默认 8）
+ */
+static int test_raw_file_writers(const char* frame_count_arg) {
+    using productionline::io::RawFrameFile;
+    using productionline::io::RawFrameFileInfo;
+    using productionline::io::RawFrameFileWriter;
+    
+    const int total_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 8;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Concurrent RawFrameFile writers - Frames: %d per writer", total_frames);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    char dir_template[] = "/tmp/vpl_rawfile_XXXXXX";
+    if (mkdtemp(dir_template) == nullptr) {
+        LOG_ERROR_FMT("mkdtemp failed: %s", strerror(errno));
+        return -1;
+    }
+    const std::string dir = dir_template;
+    const std::string path = dir + "/clip.rawvid";
+    
+    RawFrameFileInfo layout;
+    layout.width = 64;
+    layout.height = 48;
+    layout.pixel_format = AV_PIX_FMT_NV12;
+    if (!RawFrameFile::setImageLayout(&layout)) {
+        LOG_ERROR("Failed to compute NV12 layout");
+        rmdir(dir.c_str());
+        return report_test_result(false);
+    }
+    layout.frame_alignment = RawFrameFile::kDataAlignment;
+    
+    // 写入者 w 的第 i 帧：每个字节由写入者、帧号和位置决定
+    auto make_frame = [&](int w, int i) {
+        std::vector<uint8_t> frame(layout.frame_size);
+        for (size_t k = 0; k < frame.size(); k++) {
+            frame[k] = static_cast<uint8_t>(w * 101 + i * 13 + k);
+        }
+        return frame;
+    };
+    
+    RawFrameFileWriter writers[3];
+    bool opened = true;
+    for (auto& writer : writers) {
+        opened = writer.open(path.c_str(), layout) && opened;
+    }
+    bool written = opened;
+    for (int i = 0; written && i < total_frames; i++) {
+        for (int w = 0; w < 3; w++) {
+            if (writers[w].isOpen()) {
+                written = writers[w].writeFrame(make_frame(w, i).data()) && written;
+            }
+        }
+        if (i == total_frames / 2) {
+            writers[2].abort();
+        }
+    }
+    bool finished_a = written && writers[0].finish();
+    bool finished_b = written && writers[1].finish();
+    LOG_INFO_FMT("Writers: opened %s, written %s, A finished %s, B finished %s",
+                 opened ? "yes" : "NO", written ? "yes" : "NO", finished_a ? "yes" : "NO", finished_b ? "yes" : "NO");
+    
+    // 读回并逐帧比较
+    RawFrameFileInfo info;
+    bool valid = RawFrameFile::readInfo(path.c_str(), &info);
+    int matched = 0;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    std::vector<uint8_t> frame(layout.frame_size);
+    for (int i = 0; valid && fd >= 0 && i < info.frame_count && i < total_frames; i++) {
+        if (pread(fd, frame.data(), frame.size(), static_cast<off_t>(info.frame_offsets[i])) ==
+                static_cast<ssize_t>(frame.size()) &&
+            frame == make_frame(1, i)) {
+            matched++;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    bool layout_ok = valid && info.width == layout.width && info.height == layout.height &&
+                     info.pixel_format == layout.pixel_format && info.frame_size == layout.frame_size &&
+                     info.frame_count == total_frames;
+    LOG_INFO_FMT("Read back: valid %s, %dx%d, %d frames, %d / %d frames match writer B",
+                 valid ? "yes" : "NO", info.width, info.height, info.frame_count, matched, total_frames);
+    
+    std::vector<std::string> names = list_directory(dir);
+    bool no_leftovers = names.size() == 1 && names[0] == "clip.rawvid";
+    for (const auto& name : names) {
+        if (name != "clip.rawvid") {
+            LOG_ERROR_FMT("Leftover file: %s", name.c_str());
+        }
+        unlink((dir + "/" + name).c_str());
+    }
+    rmdir(dir.c_str());
+    
+    return report_test_result(finished_a && finished_b && layout_ok && matched == total_frames && no_leftovers);
+}
+
+/**
+ * 测试：自描述的 RawFrameFile 容器（BufferWriter::openIndexed 写入，raw Worker 不带格式参数打开）
+ * 
+ * 功能：
+ * - counter 图案 320x240 NV12（叠加帧号）播放一遍，回调中用 BufferWriter::openIndexed 写入容器
+ * - readInfo()：几何、像素格式、帧数、2 个 plane 的 linesize / 偏移与 NV12 紧凑布局一致，每帧从 4 KiB 边界开始
+ * - MMAP_RAW / IOURING_RAW Worker 只配置文件路径（不配置分辨率和 bpp），3 个生产者播放一遍：
+ *   帧数等于写入帧数，Buffer 元数据为 320x240 NV12，读出的帧号覆盖全部写入的帧且不重复
+ * 
+ * 参数：帧数（默认 30）
+ */
+static int test_raw_container(const char* frame_count_arg) {
+    using productionline::io::BufferWriter;
+    using productionline::io::RawFrameFile;
+    using productionline::io::RawFrameFileInfo;
+    
+    const int total_frames = (frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 30;
+    const int width = 320;
+    const int height = 240;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Self-describing RawFrameFile container - Frames: %d, %dx%d NV12", total_frames, width, height);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    char dir_template[] = "/tmp/vpl_container_XXXXXX";
+    if (mkdtemp(dir_template) == nullptr) {
+        LOG_ERROR_FMT("mkdtemp failed: %s", strerror(errno));
+        return -1;
+    }
+    const std::string dir = dir_template;
+    const std::string path = dir + "/counter.rawvid";
+    
+    // 1. 录制：回调串行执行，按到达顺序写入容器
+    BufferWriter writer;
+    bool recorded = false;
+    if (writer.openIndexed(path.c_str(), AV_PIX_FMT_NV12, width, height, 30.0)) {
+        VideoProductionLine line(false, 1, false);
+        Nv12LineResult result;
+        recorded = run_nv12_line(line, make_counter_pattern_config(width, height, total_frames),
+                                 [&writer](Buffer* buffer) { return writer.write(buffer); }, 0, &result) &&
+                   result.ended && result.bad_frames == 0 && writer.getWriteCount() == total_frames;
+        writer.close();
+    }
+    
+    // 2. 文件头和索引
+    RawFrameFileInfo info;
+    bool header_ok = RawFrameFile::readInfo(path.c_str(), &info) &&
+                     info.width == width && info.height == height && info.pixel_format == AV_PIX_FMT_NV12 &&
+                     info.frame_count == total_frames && info.frame_size == static_cast<size_t>(width) * height * 3 / 2 &&
+                     info.plane_count == 2 && info.linesize[0] == width && info.linesize[1] == width &&
+                     info.plane_offset[0] == 0 && info.plane_offset[1] == static_cast<size_t>(width) * height &&
+                     info.frame_alignment == RawFrameFile::kDataAlignment;
+    for (int i = 0; header_ok && i < info.frame_count; i++) {
+        header_ok = info.frame_offsets[i] % RawFrameFile::kDataAlignment == 0;
+    }
+    LOG_INFO_FMT("Recorded: %s, header: %dx%d format %d, %d frames, %d planes, alignment %zu - %s",
+                 recorded ? "yes" : "NO", info.width, info.height, info.pixel_format, info.frame_count,
+                 info.plane_count, info.frame_alignment, header_ok ? "OK" : "MISMATCH");
+    
+    // 3. raw Worker 只凭文件头打开
+    bool success = recorded && header_ok;
+    const WorkerType kTypes[2] = {WorkerType::MMAP_RAW, WorkerType::IOURING_RAW};
+    const char* kNames[2] = {"mmap", "io_uring"};
+    for (int t = 0; success && t < 2; t++) {
+        WorkerConfig worker_config = WorkerConfigBuilder()
+            .setFileConfig(
+                FileConfigBuilder()
+                    .setFilePath(path)
+                    .build()
+            )
+            .setWorkerType(kTypes[t])
+            .build();
+        
+        std::vector<char> seen(total_frames, 0);
+        auto stamp_check = make_unique_stamp_check(&seen);
+        auto check = [&](Buffer* buffer) {
+            return buffer->getImageWidth() == width && buffer->getImageHeight() == height &&
+                   buffer->getImageLinesize()[0] >= width && stamp_check(buffer);
+        };
+        VideoProductionLine line(false, 3, false);
+        Nv12LineResult result;
+        bool started = run_nv12_line(line, worker_config, check, 10000, &result);
+        int stamped = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+        LOG_INFO_FMT("%s worker: started %s, produced %d, sink %d, bad %d, distinct frame numbers %d / %d",
+                     kNames[t], started ? "yes" : "NO", result.produced, result.sink_frames, result.bad_frames,
+                     stamped, total_frames);
+        success = started && result.ended && result.produced == total_frames &&
+                  result.sink_frames == total_frames && result.bad_frames == 0 && stamped == total_frames;
+    }
+    
+    unlink(path.c_str());
+    rmdir(dir.c_str());
+    return report_test_result(success);
+}
+
+/**
+ * 测试：FileAVIOContext（FFmpeg 解复用的 mmap / io_uring 自定义 AVIO）
+ * 
+ * 功能（3 MiB + 12345 字节的伪随机文件，预读窗口 1 MiB，io_uring 4 个在途块）：
+ * - 两种后端分别通过 FFmpeg 的 avio_read / avio_seek 读取：avio_size() 等于文件大小
+ * - 顺序读到 EOF（每次读取长度不同、跨块边界）：读出的字节与文件逐字节相同，EOF 后读取返回 <= 0
+ * - seek 到块边界前后、文件中部和末尾附近（含向回 seek）后读取：内容与文件对应位置一致
+ * - seek 到文件末尾之后读取返回 EOF
+ * - 读取确实经过自定义回调（read 回调次数 > 0，后端有 I/O 系统调用）
+ * 
+ * 参数：预读窗口 KiB（默认 1024）
+ */
+static int test_file_avio(const char* window_arg) {
+    using productionline::io::FileAVIOContext;
+    
+    const size_t window_bytes = ((window_arg && atoi(window_arg) > 0) ? atoi(window_arg) : 1024) * 1024UL;
+    const size_t file_size = 3 * 1024 * 1024 + 12345;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: FileAVIOContext - File: %zu bytes, Window: %zu KiB", file_size, window_bytes / 1024);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    char path_template[] = "/tmp/vpl_avio_XXXXXX";
+    int fd = mkstemp(path_template);
+    if (fd < 0) {
+        LOG_ERROR_FMT("mkstemp failed: %s", strerror(errno));
+        return -1;
+    }
+    std::vector<uint8_t> data(file_size);
+    uint32_t state = 0x12345678u;
+    for (auto& byte : data) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<uint8_t>(state);
+    }
+    bool written = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    close(fd);
+    if (!written) {
+        LOG_ERROR("Failed to write test file");
+        unlink(path_template);
+        return -1;
+    }
+    
+    const FileAVIOContext::Mode kModes[2] = {FileAVIOContext::Mode::MMAP, FileAVIOContext::Mode::IO_URING};
+    const char* kNames[2] = {"mmap", "io_uring"};
+    bool success = true;
+    for (int m = 0; m < 2; m++) {
+        FileAVIOContext io;
+        if (!io.open(path_template, kModes[m], window_bytes, 4)) {
+            LOG_ERROR_FMT("%s: open failed", kNames[m]);
+            success = false;
+            continue;
+        }
+        AVIOContext* avio = io.get();
+        bool size_ok = avio_size(avio) == static_cast<int64_t>(file_size);
+        
+        // 1. 顺序读到 EOF
+        std::vector<uint8_t> chunk(300 * 1024);
+        size_t position = 0;
+        bool sequential_ok = true;
+        for (int i = 0; sequential_ok && position < file_size; i++) {
+            int want = 1 + (i * 40961) % static_cast<int>(chunk.size());
+            int n = avio_read(avio, chunk.data(), want);
+            sequential_ok = n > 0 && position + n <= file_size && memcmp(chunk.data(), data.data() + position, n) == 0;
+            position += n > 0 ? static_cast<size_t>(n) : 0;
+        }
+        sequential_ok = sequential_ok && position == file_size && avio_read(avio, chunk.data(), 1) <= 0;
+        
+        // 2. 随机 seek（含向回 seek 和跨块边界）
+        const int64_t kOffsets[] = {262143, 0, static_cast<int64_t>(file_size / 2 + 7), 5,
+                                    static_cast<int64_t>(file_size - 100), 1048575, static_cast<int64_t>(file_size - 1)};
+        bool seek_ok = true;
+        for (int64_t offset : kOffsets) {
+            int want = static_cast<int>(std::min<int64_t>(5000, static_cast<int64_t>(file_size) - offset));
+            int n = avio_seek(avio, offset, SEEK_SET) == offset ? avio_read(avio, chunk.data(), want) : -1;
+            if (n != want || memcmp(chunk.data(), data.data() + offset, want) != 0) {
+                LOG_ERROR_FMT("%s: read at offset %lld returned %d bytes (expected %d) or wrong data",
+                              kNames[m], (long long)offset, n, want);
+                seek_ok = false;
+            }
+        }
+        bool eof_ok = avio_seek(avio, static_cast<int64_t>(file_size) + 4096, SEEK_SET) >= 0 &&
+                      avio_read(avio, chunk.data(), 1) <= 0;
+        
+        bool used = io.getReadCallbackCount() > 0 && io.getSyscallCount() > 0;
+        LOG_INFO_FMT("%s: size %s, sequential %s, seek %s, EOF %s, %lu read callbacks, %lu I/O syscalls",
+                     kNames[m], size_ok ? "OK" : "MISMATCH", sequential_ok ? "OK" : "FAILED",
+                     seek_ok ? "OK" : "FAILED", eof_ok ? "OK" : "FAILED",
+                     (unsigned long)io.getReadCallbackCount(), (unsigned long)io.getSyscallCount());
+        success = success && size_ok && sequential_ok && seek_ok && eof_ok && used;
+        io.close();
+    }
+    
+    unlink(path_template);
+    return report_test_result(success);
+}
+
+/**
+ * ROI 测试用的合成 NV12 帧：第 i 帧 plane 内 (x, y) 处的字节为 (x + 2y + 17i) & 0xFF
+ * （17 是奇数，帧号在 256 帧内由任一字节唯一确定）
+ */
+static uint8_t roi_test_byte(int frame, int x, int y) {
+    return static_cast<uint8_t>(x + 2 * y + 17 * frame);
+}
+
+/**
+ * 测试：raw Worker 的 ROI 裁剪输出
+ * 
+ * 功能（320x240 NV12 合成帧，ROI 33,17 100x60 → 按 4:2:0 对齐到 32,16）：
+ * - RawFrameFile 容器和不带文件头的裸文件（配置分辨率和像素格式）各一份
+ * - MMAP_RAW / IOURING_RAW 分别播放一遍（3 个生产者）：
+ *   Buffer 元数据为 100x60 NV12（linesize 100 / 100，UV plane 偏移 6000），
+ *   Y / UV plane 的每个字节都等于源帧中对应位置的字节；帧号覆盖全部帧且不重复
+ * 
+ * 参数：帧数（默认 20，不超过 256）
+ */
+static int test_raw_roi(const char* frame_count_arg) {
+    using productionline::io::RawFrameFile;
+    using productionline::io::RawFrameFileInfo;
+    using productionline::io::RawFrameFileWriter;
+    
+    const int total_frames = std::min((frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 20, 256);
+    const int width = 320;
+    const int height = 240;
+    const int roi_x = 32;         // 配置 33，向下对齐到色度边界
+    const int roi_y = 16;         // 配置 17
+    const int roi_width = 100;
+    const int roi_height = 60;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Raw worker ROI - Frames: %d, %dx%d NV12, ROI 33,17 %dx%d",
+                 total_frames, width, height, roi_width, roi_height);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    char dir_template[] = "/tmp/vpl_roi_XXXXXX";
+    if (mkdtemp(dir_template) == nullptr) {
+        LOG_ERROR_FMT("mkdtemp failed: %s", strerror(errno));
+        return -1;
+    }
+    const std::string dir = dir_template;
+    const std::string container_path = dir + "/roi.rawvid";
+    const std::string raw_path = dir + "/roi.nv12";
+    
+    // 1. 写入容器和裸文件（帧内容相同）
+    RawFrameFileInfo layout;
+    layout.width = width;
+    layout.height = height;
+    layout.pixel_format = AV_PIX_FMT_NV12;
+    bool written = RawFrameFile::setImageLayout(&layout);
+    RawFrameFileWriter writer;
+    written = written && writer.open(container_path.c_str(), layout);
+    FILE* raw_file = fopen(raw_path.c_str(), "wb");
+    written = written && raw_file != nullptr;
+    std::vector<uint8_t> frame(layout.frame_size);
+    for (int i = 0; written && i < total_frames; i++) {
+        for (int y = 0; y < height + height / 2; y++) {
+            int plane_y = y < height ? y : y - height;
+            for (int x = 0; x < width; x++) {
+                frame[static_cast<size_t>(y) * width + x] = roi_test_byte(i, x, plane_y);
+            }
+        }
+        written = writer.writeFrame(frame.data()) && fwrite(frame.data(), 1, frame.size(), raw_file) == frame.size();
+    }
+    written = written && writer.finish();
+    if (raw_file) {
+        written = fclose(raw_file) == 0 && written;
+    }
+    
+    // 2. 每个 Buffer 逐字节比较 ROI（回调串行执行）
+    std::vector<char> seen;
+    auto roi_check = [&](Buffer* buffer) {
+        const int* linesize = buffer->getImageLinesize();
+        if (buffer->getImageWidth() != roi_width || buffer->getImageHeight() != roi_height ||
+            linesize[0] != roi_width || linesize[1] != roi_width ||
+            buffer->getImagePlaneData(1) != buffer->getImagePlaneData(0) + roi_width * roi_height) {
+            return false;
+        }
+        const uint8_t* y_plane = buffer->getImagePlaneData(0);
+        const uint8_t* uv_plane = buffer->getImagePlaneData(1);
+        int index = -1;
+        for (int i = 0; i < total_frames && index < 0; i++) {
+            index = y_plane[0] == roi_test_byte(i, roi_x, roi_y) ? i : -1;
+        }
+        if (index < 0 || seen[index]) {
+            return false;
+        }
+        seen[index] = 1;
+        for (int y = 0; y < roi_height; y++) {
+            for (int x = 0; x < roi_width; x++) {
+                if (y_plane[y * roi_width + x] != roi_test_byte(index, roi_x + x, roi_y + y)) {
+                    return false;
+                }
+            }
+        }
+        for (int y = 0; y < roi_height / 2; y++) {
+            for (int x = 0; x < roi_width; x++) {
+                if (uv_plane[y * roi_width + x] != roi_test_byte(index, roi_x + x, roi_y / 2 + y)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    
+    bool success = written;
+    const WorkerType kTypes[2] = {WorkerType::MMAP_RAW, WorkerType::IOURING_RAW};
+    const char* kNames[2] = {"mmap", "io_uring"};
+    for (int container = 1; success && container >= 0; container--) {
+        for (int t = 0; success && t < 2; t++) {
+            OutputConfigBuilder output;
+            if (!container) {
+                output.setResolution(width, height).setPixelFormat(AV_PIX_FMT_NV12);
+            }
+            output.setRoi(33, 17, roi_width, roi_height);
+            WorkerConfig worker_config = WorkerConfigBuilder()
+                .setFileConfig(
+                    FileConfigBuilder()
+                        .setFilePath(container ? container_path : raw_path)
+                        .build()
+                )
+                .setOutputConfig(output.build())
+                .setWorkerType(kTypes[t])
+                .build();
+            
+            seen.assign(total_frames, 0);
+            VideoProductionLine line(false, 3, false);
+            Nv12LineResult result;
+            bool started = run_nv12_line(line, worker_config, roi_check, 10000, &result);
+            int distinct = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+            LOG_INFO_FMT("%s worker (%s): started %s, produced %d, sink %d, bad %d, distinct frames %d / %d",
+                         kNames[t], container ? "RawFrameFile" : "raw file", started ? "yes" : "NO",
+                         result.produced, result.sink_frames, result.bad_frames, distinct, total_frames);
+            success = started && result.ended && result.produced == total_frames &&
+                      result.sink_frames == total_frames && result.bad_frames == 0 && distinct == total_frames;
+        }
+    }
+    
+    unlink(container_path.c_str());
+    unlink(raw_path.c_str());
+    rmdir(dir.c_str());
+    return report_test_result(success);
+}
+
+/**
+ * 测试：raw Worker 按像素格式输出 plane 元数据
+ * 
+ * 功能（98x66 裸文件，宽高为奇数倍色度采样时检查色度向上取整）：
+ * - YUV420P / BGRA / GRAY8 各写一份裸文件：第 i 帧第 p 个 plane 内 (x, y) 处的字节为 (x + 3y + 29p + 17i) & 0xFF
+ * - MMAP_RAW / IOURING_RAW 只配置分辨率和像素格式（不配置 bpp），3 个生产者播放一遍：
+ *   Buffer 的格式、宽高、plane 数、linesize、plane 偏移与 RawFrameFile::setImageLayout() 一致，
+ *   每个 plane 的每个字节与源帧一致，帧号覆盖全部帧且不重复
+ * 
+ * 参数：帧数（默认 12，不超过 256）
+ */
+static int test_raw_plane_metadata(const char* frame_count_arg) {
+    using productionline::io::RawFrameFile;
+    using productionline::io::RawFrameFileInfo;
+    
+    const int total_frames = std::min((frame_count_arg && atoi(frame_count_arg) > 0) ? atoi(frame_count_arg) : 12, 256);
+    const int width = 98;
+    const int height = 66;
+    
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    LOG_INFO_FMT("  Test: Raw worker plane metadata - Frames: %d, %dx%d", total_frames, width, height);
+    LOG_INFO("═══════════════════════════════════════════════════════");
+    
+    char dir_template[] = "/tmp/vpl_planes_XXXXXX";
+    if (mkdtemp(dir_template) == nullptr) {
+        LOG_ERROR_FMT("mkdtemp failed: %s", strerror(errno));
+        return -1;
+    }
+    const std::string dir = dir_template;
+    
+    auto plane_byte = [](int frame, int plane, int x, int y) {
+        return static_cast<uint8_t>(x + 3 * y + 29 * plane + 17 * frame);
+    };
+    
+    const AVPixelFormat kFormats[3] = {AV_PIX_FMT_YUV420P, AV_PIX_FMT_BGRA, AV_PIX_FMT_GRAY8};
+    const WorkerType kTypes[2] = {WorkerType::MMAP_RAW, WorkerType::IOURING_RAW};
+    const char* kNames[2] = {"mmap", "io_uring"};
+    bool success = true;
+    for (AVPixelFormat format : kFormats) {
+        const char* format_name = av_get_pix_fmt_name(format);
+        RawFrameFileInfo layout;
+        layout.width = width;
+        layout.height = height;
+        layout.pixel_format = format;
+        if (!RawFrameFile::setImageLayout(&layout)) {
+            LOG_ERROR_FMT("%s: cannot compute plane layout", format_name);
+            success = false;
+            break;
+        }
+        auto plane_rows = [&layout](int plane) {
+            size_t end = plane + 1 < layout.plane_count ? layout.plane_offset[plane + 1] : layout.frame_size;
+            return static_cast<int>((end - layout.plane_offset[plane]) / layout.linesize[plane]);
+        };
+        
+        // 1. 写入裸文件
+        const std::string path = dir + "/frames." + format_name;
+        FILE* fp = fopen(path.c_str(), "wb");
+        bool written = fp != nullptr;
+        std::vector<uint8_t> frame(layout.frame_size);
+        for (int i = 0; written && i < total_frames; i++) {
+            for (int p = 0; p < layout.plane_count; p++) {
+                for (int y = 0; y < plane_rows(p); y++) {
+                    for (int x = 0; x < layout.linesize[p]; x++) {
+                        frame[layout.plane_offset[p] + static_cast<size_t>(y) * layout.linesize[p] + x] = plane_byte(i, p, x, y);
+                    }
+                }
+            }
+            written = fwrite(frame.data(), 1, frame.size(), fp) == frame.size();
+        }
+        if (fp) {
+            written = fclose(fp) == 0 && written;
+        }
+        
+        // 2. 逐 Buffer 比较元数据和 plane 内容（回调串行执行）
+        std::vector<char> seen;
+        auto plane_check = [&](Buffer* buffer) {
+            if (buffer->getImageWidth() != width || buffer->getImageHeight() != height ||
+                buffer->getImagePlaneCount() != layout.plane_count) {
+                return false;
+            }
+            const uint8_t* base = static_cast<const uint8_t*>(buffer->data());
+            for (int p = 0; p < layout.plane_count; p++) {
+                if (buffer->getImageLinesize()[p] != layout.linesize[p] ||
+                    buffer->getImagePlaneOffset()[p] != layout.plane_offset[p] ||
+                    buffer->getImagePlaneData(p) != base + layout.plane_offset[p]) {
+                    return false;
+                }
+            }
+            int index = -1;
+            for (int i = 0; i < total_frames && index < 0; i++) {
+                index = base[0] == plane_byte(i, 0, 0, 0) ? i : -1;
+            }
+            if (index < 0 || seen[index]) {
+                return false;
+            }
+            seen[index] = 1;
+            for (int p = 0; p < layout.plane_count; p++) {
+                const uint8_t* plane = buffer->getImagePlaneData(p);
+                for (int y = 0; y < plane_rows(p); y++) {
+                    for (int x = 0; x < layout.linesize[p]; x++) {
+                        if (plane[static_cast<size_t>(y) * layout.linesize[p] + x] != plane_byte(index, p, x, y)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        };
+        
+        for (int t = 0; written && success && t < 2; t++) {
+            WorkerConfig worker_config = WorkerConfigBuilder()
+                .setFileConfig(
+                    FileConfigBuilder()
+                        .setFilePath(path)
+                        .build()
+                )
+                .setOutputConfig(
+                    OutputConfigBuilder()
+                        .setResolution(width, height)
+                        .setPixelFormat(format)
+                        .build()
+                )
+                .setWorkerType(kTypes[t])
+                .build();
+            
+            seen.assign(total_frames, 0);
+            VideoProductionLine line(false, 3, false);
+            Nv12LineResult result;
+            bool started = run_nv12_line(line, worker_config, plane_check, 10000, &result, format);
+            int distinct = static_cast<int>(std::count(seen.begin(), seen.end(), 1));
+            LOG_INFO_FMT("%s %s worker: %d planes, started %s, produced %d, sink %d, bad %d, distinct frames %d / %d",
+                         format_name, kNames[t], layout.plane_count, started ? "yes" : "NO", result.produced,
+                         result.sink_frames, result.bad_frames, distinct, total_frames);
+            success = started && result.ended && result.produced == total_frames &&
+                      result.sink_frames == total_frames && result.bad_frames == 0 && distinct == total_frames;
+        }
+        unlink(path.c_str());
+        success = success && written;
+        if (!success) {
+            break;
+        }
+    }
+    
+    rmdir(dir.c_str());
+    return report_test_result(success);
+}
+
 // ========== 测试用例注册 ==========
 // 使用新的测试框架，自动注册所有测试用例
 REGISTER_TEST(loop, "4-frame loop display", test_4frame_loop);
@@ -1546,6 +4637,32 @@ REGISTER_TEST(ffmpeg_multithread, "Multi-threaded FFmpeg video decoding (no disp
 REGISTER_TEST(writer, "BufferWriter - Save frames (NV12 format)", test_buffer_writer);
 REGISTER_TEST(writer_all, "BufferWriter - Test all supported formats", test_buffer_writer_all_formats);
 REGISTER_TEST(writer_legacy, "BufferWriter - Save frames (ARGB format, legacy)", test_buffer_writer_legacy);
+REGISTER_TEST(shm_pool, "Shared-memory BufferPool across processes (zero-copy)", test_shared_memory_pool);
+REGISTER_TEST(shm_output, "Production line output to a shared-memory pool (zero-copy capture -> analysis process)", test_shared_output);
+REGISTER_TEST(callback_consumer, "Callback-driven consumer (frame sinks, drain on stop)", test_callback_consumer);
+REGISTER_TEST(sequence, "Image sequence directory (io_uring prefetch, NV12 metadata)", test_image_sequence);
+REGISTER_TEST(stream, "Raw frame stream from a pipe, FIFO or unix socket (NV12, ends at EOF)", test_raw_stream);
+REGISTER_TEST(pattern, "Synthetic test pattern throughput (bars / gradient / noise / counter, no file I/O)", test_pattern_generator);
+REGISTER_TEST(batch, "Batched buffer filling (mmap prefetch / io_uring single submit vs per-frame)", test_fill_batch);
+REGISTER_TEST(copy_bench, "FrameCopy bandwidth benchmark (memcpy vs streaming / striped)", test_frame_copy_bench);
+REGISTER_TEST(h264_index, "H.264 Annex-B access unit index (synthetic stream + multi-producer mmap decode)", test_h264_annexb_index);
+REGISTER_TEST(mp4_table, "MP4 sample table (synthetic stco / co64 file + multi-producer mmap decode)", test_mp4_sample_table);
+REGISTER_TEST(pipeline, "Multi-stage pipeline (stage order, per-stage output pools, frame accounting)", test_pipeline_stages);
+REGISTER_TEST(executor, "Shared work-stealing executor (group weights + two lines on one executor)", test_shared_executor);
+REGISTER_TEST(pacing, "Target-fps pacing (frame interval on dedicated threads and the shared executor)", test_frame_pacing);
+REGISTER_TEST(multi_source, "Multi-source production line (weighted per-source frame shares + complete finite sources)", test_multi_source);
+REGISTER_TEST(numa, "CPU affinity and NUMA placement (consumer affinity, buffer page node)", test_numa_placement);
+REGISTER_TEST(pool_eventfd, "BufferPool eventfd readiness (poll-driven consumer, no blocking acquire)", test_pool_eventfd);
+REGISTER_TEST(autoscale, "Producer autoscale configuration (initial active count, disable restores fixed threads)", test_autoscale_config);
+REGISTER_TEST(chunked_claim, "Chunked frame-range claiming (in-chunk order, claim count, truncated last chunk)", test_chunked_claim);
+REGISTER_TEST(playlist_order, "Playlist transition frame order (3 producers, paced, prerolled frames first)", test_playlist_order);
+REGISTER_TEST(restart, "Pause / resume and warm restart (no production while paused, pools kept, restart from frame 0)", test_pause_restart);
+REGISTER_TEST(frame_cache, "Decoded frame cache (first pass misses, looped passes hit, pixels match, over-budget disable)", test_frame_cache);
+REGISTER_TEST(raw_file_writers, "Concurrent RawFrameFile writers on one path (unique temp files, last finish wins, read-back match)", test_raw_file_writers);
+REGISTER_TEST(raw_container, "Self-describing RawFrameFile container (BufferWriter::openIndexed, mmap / io_uring workers without geometry)", test_raw_container);
+REGISTER_TEST(avio, "FileAVIOContext custom AVIO (mmap / io_uring read-back, seeks, EOF through avio_read)", test_file_avio);
+REGISTER_TEST(raw_roi, "Raw worker ROI crop (mmap / io_uring, RawFrameFile and raw file, byte-exact cropped planes)", test_raw_roi);
+REGISTER_TEST(raw_planes, "Raw worker plane metadata by pixel format (YUV420P / BGRA / GRAY8 layout and plane bytes)", test_raw_plane_metadata);
 
 /**
  * 主函数